@@ -0,0 +1,1092 @@
+// Microbenchmarks for the pipeline's hot paths. Results are written as JSON so runs
+// can be archived and compared; a short table goes to stderr for humans.
+//
+// Build and run with `make bench`. Options:
+//   --output FILE   write JSON to FILE instead of stdout
+//   --filter TEXT   only run benchmarks whose name contains TEXT
+//   --quick         run a tenth of the iterations (smoke test)
+//
+// The IPC benchmarks create the same queue and shared-memory names as the
+// application, so do not run them while sensor_processor is running.
+
+// Header includes for the components under test
+#include "circular_buffer.hpp"
+#include "spsc_ring_buffer.hpp"
+#include "moving_average.hpp"
+#include "stats_kernels.hpp"
+#include "sensor_simulator.hpp"
+#include "data_processor.hpp"
+#include "ipc_manager.hpp"
+#include "latency_histogram.hpp"
+#include "window_aggregator.hpp"
+#include "fast_random.hpp"
+#include "decimator.hpp"
+#include "filter_bank.hpp"
+#include "channel_registry.hpp"
+#include "worker_pool.hpp"
+#include "telemetry_codec.hpp"
+#include "time_series_store.hpp"
+#include "anomaly_detector.hpp"
+
+// System header includes
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Using declaration for the sensor namespace
+using namespace sensor;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // Timed repetitions per benchmark; the fastest is reported as ns_per_op
+    constexpr int REPETITIONS = 3;
+
+    // One benchmark result row
+    struct Result {
+        std::string name;                                   // Benchmark name
+        std::vector<std::pair<std::string, std::string>> params; // Parameters that identify the variant
+        uint64_t ops = 0;                                   // Operations per repetition
+        double best_ns = 0.0;                               // Fastest repetition, ns per op
+        double mean_ns = 0.0;                               // Mean over repetitions, ns per op
+        std::vector<std::pair<std::string, double>> extra;  // Benchmark-specific counters
+    };
+
+    // Options from the command line
+    struct Options {
+        std::string output;  // JSON destination (empty = stdout)
+        std::string filter;  // Substring benchmark names must contain
+        uint64_t scale = 10; // Iteration multiplier (1 with --quick)
+    };
+
+    // Keeps the optimizer from discarding a computed value
+    template<typename T>
+    inline void doNotOptimize(const T& value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    // Seconds elapsed since start
+    inline double secondsSince(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Percentile of an already sorted sample set
+    double percentile(const std::vector<double>& sorted, double p) {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        const size_t index = static_cast<size_t>(p * static_cast<double>(sorted.size() - 1) + 0.5);
+        return sorted[std::min(index, sorted.size() - 1)];
+    }
+
+    // Sample whose every channel carries the same sequence number, so torn reads are detectable
+    SensorData makeSample(uint64_t sequence) {
+        SensorData data;
+        data.values.fill(static_cast<double>(sequence));
+        data.timestamp = std::chrono::system_clock::now();
+        return data;
+    }
+
+    // Message whose id and first value carry the send time for latency measurement
+    MQMessage makeMessage(uint64_t id) {
+        MQMessage msg{};
+        msg.msg_id = id;
+        msg.avg_values[0] = static_cast<double>(Clock::now().time_since_epoch().count());
+        msg.timestamp = std::chrono::system_clock::now();
+        return msg;
+    }
+
+    // Runner class: Filters, times and collects benchmark results
+    class Runner {
+    public:
+        explicit Runner(const Options& options) : m_options(options) {}
+
+        // Whether a benchmark name passes the --filter option
+        bool selected(const std::string& name) const {
+            return m_options.filter.empty() || name.find(m_options.filter) != std::string::npos;
+        }
+
+        // Scale a base iteration count by the --quick setting
+        uint64_t iterations(uint64_t base) const {
+            return std::max<uint64_t>(1, base * m_options.scale / 10);
+        }
+
+        // Time body(ops) REPETITIONS times after one warm-up; body performs ops operations
+        template<typename Body>
+        Result& time(const std::string& name,
+                     std::vector<std::pair<std::string, std::string>> params,
+                     uint64_t ops, Body&& body) {
+            body(std::max<uint64_t>(1, ops / 10));
+
+            Result result;
+            result.name = name;
+            result.params = std::move(params);
+            result.ops = ops;
+            result.best_ns = 1e300;
+            for (int rep = 0; rep < REPETITIONS; ++rep) {
+                const auto start = Clock::now();
+                body(ops);
+                const double ns = secondsSince(start) * 1e9 / static_cast<double>(ops);
+                result.best_ns = std::min(result.best_ns, ns);
+                result.mean_ns += ns / REPETITIONS;
+            }
+            return record(std::move(result));
+        }
+
+        // Add a result measured by the benchmark itself
+        Result& record(Result result) {
+            m_results.push_back(std::move(result));
+            const Result& r = m_results.back();
+            std::cerr << std::left << std::setw(28) << r.name;
+            std::string params;
+            for (const auto& [key, value] : r.params) {
+                params += key + "=" + value + " ";
+            }
+            std::cerr << std::setw(36) << params << std::right << std::fixed << std::setprecision(1)
+                      << std::setw(12) << r.best_ns << " ns/op\n";
+            return m_results.back();
+        }
+
+        // Serialize every result as one JSON document
+        void writeJson(std::ostream& os) const {
+            os << "{\n  \"simd_level\": \"" << statsKernels().name << "\",\n"
+               << "  \"hardware_threads\": " << std::thread::hardware_concurrency() << ",\n"
+               << "  \"benchmarks\": [";
+            for (size_t i = 0; i < m_results.size(); ++i) {
+                const Result& r = m_results[i];
+                os << (i ? "," : "") << "\n    {\"name\": \"" << r.name << "\", \"params\": {";
+                for (size_t p = 0; p < r.params.size(); ++p) {
+                    os << (p ? ", " : "") << "\"" << r.params[p].first << "\": \"" << r.params[p].second << "\"";
+                }
+                os << "}, \"ops\": " << r.ops
+                   << std::setprecision(3) << std::fixed
+                   << ", \"ns_per_op\": " << r.best_ns
+                   << ", \"mean_ns_per_op\": " << r.mean_ns
+                   << ", \"ops_per_sec\": " << (r.best_ns > 0.0 ? 1e9 / r.best_ns : 0.0);
+                for (const auto& [key, value] : r.extra) {
+                    os << ", \"" << key << "\": " << value;
+                }
+                os << "}";
+            }
+            os << "\n  ]\n}\n";
+        }
+
+    private:
+        Options m_options;            // Parsed command-line options
+        std::vector<Result> m_results; // Results in run order
+    };
+
+    // ---- Buffers ----
+
+    // Single-threaded push followed by pop, so the cost of one transfer without contention
+    template<typename Buffer>
+    void benchPushPop(Runner& runner, const std::string& type, size_t capacity) {
+        Buffer buffer(capacity);
+        const SensorData sample = makeSample(1);
+        runner.time("buffer_push_pop", {{"type", type}, {"capacity", std::to_string(capacity)}},
+                    runner.iterations(2000000), [&](uint64_t ops) {
+            for (uint64_t i = 0; i < ops; ++i) {
+                buffer.push(sample);
+                doNotOptimize(buffer.pop());
+            }
+        });
+    }
+
+    // Copy the most recent window out of a full mutex buffer
+    void benchGetWindow(Runner& runner, size_t capacity) {
+        CircularBuffer<SensorData> buffer(capacity);
+        for (size_t i = 0; i < capacity; ++i) {
+            buffer.push(makeSample(i));
+        }
+        Result& result = runner.time("buffer_get_window", {{"type", "mutex"}, {"window", std::to_string(capacity)}},
+                                     runner.iterations(20000000 / capacity), [&](uint64_t ops) {
+            for (uint64_t i = 0; i < ops; ++i) {
+                doNotOptimize(buffer.getWindow(capacity).size());
+            }
+        });
+        result.extra.emplace_back("ns_per_element", result.best_ns / static_cast<double>(capacity));
+    }
+
+    // The same window as benchGetWindow, seen in place and summed so every element is read
+    void benchWindowView(Runner& runner, size_t capacity) {
+        CircularBuffer<SensorData> buffer(capacity);
+        for (size_t i = 0; i < capacity + capacity / 2; ++i) {
+            buffer.push(makeSample(i));
+        }
+        Result& result = runner.time("buffer_window_view", {{"type", "mutex"}, {"window", std::to_string(capacity)}},
+                                     runner.iterations(20000000 / capacity), [&](uint64_t ops) {
+            for (uint64_t i = 0; i < ops; ++i) {
+                const auto view = buffer.window(capacity);
+                double sum = 0.0;
+                for (const auto& run : {view.first, view.second}) {
+                    for (size_t k = 0; k < run.size; ++k) {
+                        sum += run.data[k].values[0];
+                    }
+                }
+                doNotOptimize(sum);
+                doNotOptimize(buffer.valid(view));
+            }
+        });
+        result.extra.emplace_back("ns_per_element", result.best_ns / static_cast<double>(capacity));
+    }
+
+    // Fill and drain a mutex buffer batch items at a time, per item or with one lock per batch
+    void benchBatch(Runner& runner, size_t batch) {
+        CircularBuffer<SensorData> buffer(batch * 2);
+        std::vector<SensorData> in(batch);
+        std::vector<SensorData> out(batch);
+        for (size_t i = 0; i < batch; ++i) {
+            in[i] = makeSample(i);
+        }
+        const uint64_t iterations = runner.iterations(2000000 / batch);
+        Result& single = runner.time("buffer_batch", {{"method", "single"}, {"batch", std::to_string(batch)}},
+                                     iterations, [&](uint64_t ops) {
+            for (uint64_t i = 0; i < ops; ++i) {
+                for (const SensorData& sample : in) {
+                    buffer.push(sample);
+                }
+                while (auto sample = buffer.pop()) {
+                    doNotOptimize(sample->values[0]);
+                }
+            }
+        });
+        single.extra.emplace_back("ns_per_element", single.best_ns / static_cast<double>(batch));
+        Result& batched = runner.time("buffer_batch", {{"method", "batch"}, {"batch", std::to_string(batch)}},
+                                      iterations, [&](uint64_t ops) {
+            for (uint64_t i = 0; i < ops; ++i) {
+                buffer.pushBatch(in.data(), in.size());
+                doNotOptimize(buffer.popBatch(out.data(), out.size()));
+            }
+        });
+        batched.extra.emplace_back("ns_per_element", batched.best_ns / static_cast<double>(batch));
+    }
+
+    // Producer and consumer threads; checks that every sample arrives intact and in order.
+    // The mutex buffer overwrites when full, so its "lost" count is expected to be non-zero
+    // whenever the consumer falls behind; the SPSC ring must report zero lost and zero torn.
+    template<typename Buffer>
+    void benchContention(Runner& runner, const std::string& type, size_t capacity) {
+        const uint64_t count = runner.iterations(500000);
+        Buffer buffer(capacity);
+        uint64_t received = 0;
+        uint64_t lost = 0;
+        uint64_t torn = 0;
+        uint64_t reordered = 0;
+        std::atomic<bool> done{false};
+
+        const auto start = Clock::now();
+        std::thread producer([&]() {
+            for (uint64_t i = 0; i < count; ++i) {
+                const SensorData sample = makeSample(i);
+                while (!buffer.push(sample)) {
+                    std::this_thread::yield();
+                }
+            }
+            done.store(true, std::memory_order_release);
+        });
+
+        int64_t last = -1;
+        while (last + 1 < static_cast<int64_t>(count)) {
+            auto item = buffer.waitPop(std::chrono::microseconds(1000));
+            if (!item) {
+                if (done.load(std::memory_order_acquire) && buffer.empty()) {
+                    break;
+                }
+                continue;
+            }
+            const double first = item->values[0];
+            for (double v : item->values) {
+                torn += (v != first);
+            }
+            const int64_t sequence = static_cast<int64_t>(first);
+            if (sequence <= last) {
+                ++reordered;
+                continue;
+            }
+            lost += static_cast<uint64_t>(sequence - last - 1);
+            last = sequence;
+            ++received;
+        }
+        const double seconds = secondsSince(start);
+        producer.join();
+
+        Result result;
+        result.name = "buffer_contention";
+        result.params = {{"type", type}, {"capacity", std::to_string(capacity)}};
+        result.ops = count;
+        result.best_ns = result.mean_ns = seconds * 1e9 / static_cast<double>(count);
+        result.extra = {{"received", static_cast<double>(received)},
+                        {"lost", static_cast<double>(lost)},
+                        {"torn", static_cast<double>(torn)},
+                        {"reordered", static_cast<double>(reordered)}};
+        runner.record(std::move(result));
+    }
+
+    void runBufferBenchmarks(Runner& runner) {
+        if (runner.selected("buffer_push_pop")) {
+            for (size_t capacity : {16, 128, 1024, 8192}) {
+                benchPushPop<CircularBuffer<SensorData>>(runner, "mutex", capacity);
+                benchPushPop<SpscRingBuffer<SensorData>>(runner, "spsc", capacity);
+            }
+        }
+        if (runner.selected("buffer_get_window")) {
+            for (size_t capacity : {16, 128, 1024, 8192}) {
+                benchGetWindow(runner, capacity);
+            }
+        }
+        if (runner.selected("buffer_window_view")) {
+            for (size_t capacity : {16, 128, 1024, 8192}) {
+                benchWindowView(runner, capacity);
+            }
+        }
+        if (runner.selected("buffer_batch")) {
+            for (size_t batch : {8, 64, 512}) {
+                benchBatch(runner, batch);
+            }
+        }
+        if (runner.selected("buffer_contention")) {
+            for (size_t capacity : {16, 1024}) {
+                benchContention<CircularBuffer<SensorData>>(runner, "mutex", capacity);
+                benchContention<SpscRingBuffer<SensorData>>(runner, "spsc", capacity);
+            }
+        }
+    }
+
+    // ---- Processing ----
+
+    // DataProcessor::computeMovingAverage on the fixed six-channel path
+    void benchComputeMovingAverage(Runner& runner, int window) {
+        Config config;
+        config.moving_avg_window = window;
+        SensorSimulator simulator(config);
+        DataProcessor processor(config, simulator);
+
+        std::vector<SensorData> samples;
+        for (size_t i = 0; i < 1024; ++i) {
+            SensorData data;
+            data.values = simulator.generateSensorValues();
+            samples.push_back(data);
+        }
+
+        runner.time("compute_moving_average", {{"window", std::to_string(window)}},
+                    runner.iterations(2000000), [&](uint64_t ops) {
+            for (uint64_t i = 0; i < ops; ++i) {
+                doNotOptimize(processor.computeMovingAverage(samples[i & 1023]));
+            }
+        });
+    }
+
+    // MovingAverage::pushBlock on the registry path, per sample of every channel
+    void benchPushBlock(Runner& runner, size_t channels, size_t block) {
+        MovingAverage average(channels, 100);
+        SampleBlock in(channels, block);
+        SampleBlock out(channels, block);
+        for (size_t c = 0; c < channels; ++c) {
+            for (size_t k = 0; k < block; ++k) {
+                in.column(c)[k] = static_cast<double>(c + k);
+            }
+        }
+        in.setLength(block);
+
+        const uint64_t values = channels * block;
+        Result& result = runner.time("moving_average_push_block",
+                                     {{"channels", std::to_string(channels)}, {"block", std::to_string(block)}},
+                                     runner.iterations(std::max<uint64_t>(1, 20000000 / values)),
+                                     [&](uint64_t ops) {
+            for (uint64_t i = 0; i < ops; ++i) {
+                average.pushBlock(in, out);
+                doNotOptimize(out.column(0)[0]);
+            }
+        });
+        result.extra.emplace_back("ns_per_value", result.best_ns / static_cast<double>(values));
+    }
+
+    // MovingAverage sharded the way DataProcessor does with --workers, per sample of every channel
+    void benchShardedPushBlock(Runner& runner, size_t channels, size_t block, size_t threads) {
+        MovingAverage average(channels, 100);
+        SampleBlock in(channels, block);
+        SampleBlock out(channels, block);
+        for (size_t c = 0; c < channels; ++c) {
+            for (size_t k = 0; k < block; ++k) {
+                in.column(c)[k] = static_cast<double>(c + k);
+            }
+        }
+        in.setLength(block);
+
+        WorkerPool pool(threads, ThreadPolicy{});
+        const size_t per_shard = (channels + threads * 4 - 1) / (threads * 4);
+        const size_t shard_channels = roundUp(per_shard, 8);
+        const size_t shards = (channels + shard_channels - 1) / shard_channels;
+        const WorkerPool::Task task = [&](size_t shard) {
+            const size_t first = shard * shard_channels;
+            average.pushChannels(in, out, first, std::min(first + shard_channels, channels));
+        };
+
+        const uint64_t values = channels * block;
+        Result& result = runner.time("moving_average_sharded",
+                                     {{"channels", std::to_string(channels)}, {"block", std::to_string(block)},
+                                      {"threads", std::to_string(threads)}},
+                                     runner.iterations(std::max<uint64_t>(1, 20000000 / values)),
+                                     [&](uint64_t ops) {
+            for (uint64_t i = 0; i < ops; ++i) {
+                pool.run(shards, task);
+                average.commitBlock(in, out);
+                doNotOptimize(out.column(0)[0]);
+            }
+        });
+        result.extra.emplace_back("ns_per_value", result.best_ns / static_cast<double>(values));
+        result.extra.emplace_back("shards", static_cast<double>(shards));
+        result.extra.emplace_back("steals", static_cast<double>(pool.steals()));
+    }
+
+    // Decimator::pushBlock per input value, for a single stage and a 10 x 10 x 10 cascade
+    void benchDecimator(Runner& runner, size_t channels, size_t factor) {
+        Decimator decimator(channels, factor);
+        const size_t block = 64;
+        SampleBlock in(channels, block);
+        SampleBlock out(channels, decimator.maxOutputs(block));
+        for (size_t c = 0; c < channels; ++c) {
+            for (size_t k = 0; k < block; ++k) {
+                in.column(c)[k] = static_cast<double>(c + k);
+            }
+        }
+        in.setLength(block);
+
+        const uint64_t values = channels * block;
+        Result& result = runner.time("decimator_push_block",
+                                     {{"channels", std::to_string(channels)}, {"factor", std::to_string(factor)}},
+                                     runner.iterations(std::max<uint64_t>(1, 20000000 / values)),
+                                     [&](uint64_t ops) {
+            for (uint64_t i = 0; i < ops; ++i) {
+                decimator.pushBlock(in, out);
+                doNotOptimize(out.column(0)[0]);
+            }
+        });
+        result.extra.emplace_back("ns_per_value", result.best_ns / static_cast<double>(values));
+    }
+
+    // FilterBank::pushBlock per sample of every channel, every channel running one design
+    void benchFilterBank(Runner& runner, size_t channels, const std::string& spec) {
+        const size_t block = 64;
+        FilterBank filters(ChannelRegistry::synthetic(channels), {"*=" + spec}, 10000.0, block);
+        SampleBlock in(channels, block);
+        SampleBlock out(channels, block);
+        for (size_t c = 0; c < channels; ++c) {
+            for (size_t k = 0; k < block; ++k) {
+                in.column(c)[k] = static_cast<double>(c + k);
+            }
+        }
+        in.setLength(block);
+
+        const uint64_t values = channels * block;
+        Result& result = runner.time("filter_bank_push_block",
+                                     {{"channels", std::to_string(channels)}, {"filter", spec}},
+                                     runner.iterations(std::max<uint64_t>(1, 20000000 / values)),
+                                     [&](uint64_t ops) {
+            for (uint64_t i = 0; i < ops; ++i) {
+                filters.pushBlock(in, out);
+                doNotOptimize(out.column(0)[0]);
+            }
+        });
+        result.extra.emplace_back("ns_per_value", result.best_ns / static_cast<double>(values));
+    }
+
+    // Messages shaped like DataProcessor output: 10-sample moving averages of simulated readings
+    std::vector<MQMessage> syntheticMessages(size_t count) {
+        std::mt19937_64 rng(42);
+        std::normal_distribution<double> noise(0.0, 1.0);
+        const auto start = std::chrono::system_clock::time_point(std::chrono::seconds(1700000000));
+        std::vector<MQMessage> messages(count);
+        for (size_t i = 0; i < count; ++i) {
+            MQMessage& msg = messages[i];
+            msg.msg_id = i;
+            msg.timestamp = start + std::chrono::milliseconds(100 * i) + std::chrono::microseconds(rng() % 200);
+            const uint64_t generated = 1000000000 + i * 100000000 + rng() % 50000;
+            msg.stages = StageTimes{generated, generated + 20000 + rng() % 5000, generated + 25000 + rng() % 5000};
+            for (size_t s = 0; s < NUM_SENSORS; ++s) {
+                msg.avg_values[s] = SENSORS[s].mean + SENSORS[s].stddev * noise(rng) / std::sqrt(10.0);
+            }
+        }
+        return messages;
+    }
+
+    // MessageCodec packing and unpacking 4 KB frames (one IPC batch frame each)
+    void benchMessageCodec(Runner& runner, double precision) {
+        const std::vector<MQMessage> messages = syntheticMessages(1024);
+        const std::vector<double> steps(precision > 0.0 ? NUM_SENSORS : 0, precision);
+        const std::string label = precision > 0.0 ? std::to_string(precision).substr(0, 4) : "lossless";
+        MessageCodec codec(steps);
+
+        // Encode everything once to size the frames and measure the ratio
+        std::vector<std::vector<char>> frames;
+        size_t coded = 0;
+        for (size_t i = 0; i < messages.size();) {
+            std::vector<char> frame(MAX_MSG_SIZE);
+            codec.begin(frame.data(), frame.size());
+            while (i < messages.size() && codec.append(messages[i])) {
+                ++i;
+            }
+            frame.resize(codec.finish());
+            coded += frame.size();
+            frames.push_back(std::move(frame));
+        }
+        const double ratio = static_cast<double>(messages.size() * sizeof(MQMessage)) / static_cast<double>(coded);
+
+        std::vector<char> scratch(MAX_MSG_SIZE);
+        Result& encode = runner.time("telemetry_encode", {{"precision", label}},
+                                     runner.iterations(2000), [&](uint64_t ops) {
+            for (uint64_t op = 0; op < ops; ++op) {
+                codec.begin(scratch.data(), scratch.size());
+                for (const MQMessage& msg : messages) {
+                    if (!codec.append(msg)) {
+                        doNotOptimize(codec.finish());
+                        codec.begin(scratch.data(), scratch.size());
+                        codec.append(msg);
+                    }
+                }
+                doNotOptimize(codec.finish());
+            }
+        });
+        encode.extra.emplace_back("ns_per_message", encode.best_ns / static_cast<double>(messages.size()));
+        encode.extra.emplace_back("bytes_per_message", static_cast<double>(coded) / static_cast<double>(messages.size()));
+        encode.extra.emplace_back("ratio", ratio);
+
+        std::vector<MQMessage> decoded;
+        Result& decode = runner.time("telemetry_decode", {{"precision", label}},
+                                     runner.iterations(2000), [&](uint64_t ops) {
+            for (uint64_t op = 0; op < ops; ++op) {
+                for (const std::vector<char>& frame : frames) {
+                    codec.decode(frame.data(), frame.size(), decoded);
+                    doNotOptimize(decoded[0].avg_values[0]);
+                }
+            }
+        });
+        decode.extra.emplace_back("ns_per_message", decode.best_ns / static_cast<double>(messages.size()));
+        decode.extra.emplace_back("ratio", ratio);
+    }
+
+    // BlockCodec on a registry block of simulated readings, every channel at one precision
+    void benchBlockCodec(Runner& runner, size_t channels, double precision) {
+        const size_t block = 64;
+        const ChannelRegistry registry = ChannelRegistry::synthetic(channels);
+        std::mt19937_64 rng(42);
+        std::normal_distribution<double> noise(0.0, 1.0);
+        std::vector<double> values(channels * block);
+        std::vector<std::chrono::system_clock::time_point> timestamps(block);
+        for (size_t k = 0; k < block; ++k) {
+            timestamps[k] = std::chrono::system_clock::time_point(std::chrono::milliseconds(1700000000000 + k));
+        }
+        for (size_t c = 0; c < channels; ++c) {
+            for (size_t k = 0; k < block; ++k) {
+                values[c * block + k] = registry[c].mean + registry[c].stddev * noise(rng) / std::sqrt(10.0);
+            }
+        }
+
+        const std::string label = precision > 0.0 ? std::to_string(precision).substr(0, 4) : "lossless";
+        BlockCodec codec(std::vector<double>(channels, precision));
+        std::vector<char> frame(BlockCodec::maxFrameBytes(channels, block));
+        const size_t coded = codec.encode(0, StageTimes{}, timestamps.data(), values.data(), block, block,
+                                          frame.data(), frame.size());
+        const size_t raw = IPCManager::blockFrameBytes(channels, block);
+        const uint64_t count = channels * block;
+
+        Result& encode = runner.time("telemetry_block_encode",
+                                     {{"channels", std::to_string(channels)}, {"precision", label}},
+                                     runner.iterations(std::max<uint64_t>(1, 20000000 / count)),
+                                     [&](uint64_t ops) {
+            for (uint64_t op = 0; op < ops; ++op) {
+                doNotOptimize(codec.encode(op, StageTimes{}, timestamps.data(), values.data(), block, block,
+                                           frame.data(), frame.size()));
+            }
+        });
+        encode.extra.emplace_back("ns_per_value", encode.best_ns / static_cast<double>(count));
+        encode.extra.emplace_back("ratio", static_cast<double>(raw) / static_cast<double>(coded));
+
+        DecodedBlock decoded;
+        Result& decode = runner.time("telemetry_block_decode",
+                                     {{"channels", std::to_string(channels)}, {"precision", label}},
+                                     runner.iterations(std::max<uint64_t>(1, 20000000 / count)),
+                                     [&](uint64_t ops) {
+            for (uint64_t op = 0; op < ops; ++op) {
+                codec.decode(frame.data(), coded, decoded);
+                doNotOptimize(decoded.values[0]);
+            }
+        });
+        decode.extra.emplace_back("ns_per_value", decode.best_ns / static_cast<double>(count));
+        decode.extra.emplace_back("ratio", static_cast<double>(raw) / static_cast<double>(coded));
+    }
+
+    // Anomaly detector: every check on every channel of in-spec noise, plus the mean delay
+    // in samples before a check alerts on a step of the mean by some declared stddevs
+    void benchAnomalyDetector(Runner& runner, size_t channels) {
+        const size_t block_length = 64;
+        const ChannelRegistry registry = ChannelRegistry::synthetic(channels);
+        AnomalyDetector detector(registry, {"all"});
+        std::mt19937_64 rng(42);
+        std::normal_distribution<double> noise(0.0, 1.0);
+        SampleBlock block(channels, block_length);
+        block.setLength(block_length);
+        for (size_t c = 0; c < channels; ++c) {
+            for (size_t k = 0; k < block_length; ++k) {
+                block.column(c)[k] = registry[c].mean + registry[c].stddev * noise(rng);
+            }
+        }
+
+        std::vector<AnomalyAlert> alerts;
+        const uint64_t values = channels * block_length;
+        Result& result = runner.time("anomaly_detector_push_block", {{"channels", std::to_string(channels)}},
+                                     runner.iterations(std::max<uint64_t>(1, 20000000 / values)),
+                                     [&](uint64_t ops) {
+            for (uint64_t i = 0; i < ops; ++i) {
+                detector.pushBlock(block, alerts);
+                alerts.clear();
+            }
+        });
+        result.extra.emplace_back("ns_per_value", result.best_ns / static_cast<double>(values));
+
+        // Mean delay over trials of a step after 100 in-control readings; 0 = alert on the first reading
+        auto delay = [&](const std::string& spec, double step) {
+            const size_t trials = 200;
+            double total = 0.0;
+            for (size_t t = 0; t < trials; ++t) {
+                AnomalyDetector one(ChannelRegistry::builtin(), {"Temperature=" + spec});
+                double reading[NUM_SENSORS] = {};
+                for (size_t i = 0;; ++i) {
+                    reading[0] = SENSORS[0].mean + SENSORS[0].stddev * (noise(rng) + (i >= 100 ? step : 0.0));
+                    alerts.clear();
+                    one.push({}, 0, reading, alerts);
+                    if (i >= 100 && !alerts.empty()) {
+                        total += static_cast<double>(i - 100);
+                        break;
+                    }
+                }
+            }
+            return total / static_cast<double>(trials);
+        };
+        if (channels == NUM_SENSORS) {
+            result.extra.emplace_back("zscore_delay_8sigma", delay("zscore", 8.0));
+            result.extra.emplace_back("ewma_delay_1sigma", delay("ewma", 1.0));
+            result.extra.emplace_back("ewma_delay_3sigma", delay("ewma", 3.0));
+            result.extra.emplace_back("cusum_delay_1sigma", delay("cusum", 1.0));
+            result.extra.emplace_back("cusum_delay_3sigma", delay("cusum", 3.0));
+        }
+    }
+
+    // Time-series store: block ingestion, then queries while another thread keeps ingesting
+    void benchTimeSeriesStore(Runner& runner, size_t channels) {
+        const size_t block_length = 64;
+        const int64_t period_ns = 1000000; // 1 kHz, so 1 s buckets close every 1000 samples
+        TimeSeriesStore store(channels, 10000, block_length);
+        SampleBlock block(channels, block_length);
+        block.setLength(block_length);
+        for (size_t c = 0; c < channels; ++c) {
+            for (size_t k = 0; k < block_length; ++k) {
+                block.column(c)[k] = std::sin(static_cast<double>(c * block_length + k));
+            }
+        }
+        int64_t next_ns = 1700000000000000000LL;
+        auto fill = [&]() {
+            for (size_t k = 0; k < block_length; ++k) {
+                block.timestamps()[k] = std::chrono::system_clock::time_point(
+                    std::chrono::duration_cast<std::chrono::system_clock::duration>(std::chrono::nanoseconds(next_ns)));
+                next_ns += period_ns;
+            }
+        };
+
+        const uint64_t values = channels * block_length;
+        Result& ingest = runner.time("store_push_block", {{"channels", std::to_string(channels)}},
+                                     runner.iterations(std::max<uint64_t>(1, 20000000 / values)),
+                                     [&](uint64_t ops) {
+            for (uint64_t op = 0; op < ops; ++op) {
+                fill();
+                store.pushBlock(block);
+            }
+        });
+        ingest.extra.emplace_back("ns_per_value", ingest.best_ns / static_cast<double>(values));
+
+        // Ten minutes of history queried at 1 s while a writer adds a block every 100 us
+        const int64_t history_ns = next_ns;
+        while (next_ns < history_ns + 600 * 1000000000LL) {
+            fill();
+            store.pushBlock(block);
+        }
+        std::atomic<bool> ingesting(true);
+        std::thread writer([&]() {
+            while (ingesting.load(std::memory_order_relaxed)) {
+                fill();
+                store.pushBlock(block);
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+            }
+        });
+        std::vector<SeriesPoint> points;
+        Result& query = runner.time("store_query_under_ingest", {{"channels", std::to_string(channels)}},
+                                    runner.iterations(20000), [&](uint64_t ops) {
+            for (uint64_t op = 0; op < ops; ++op) {
+                doNotOptimize(store.query(op % channels, history_ns, history_ns + 600 * 1000000000LL,
+                                          1000000000LL, points));
+            }
+        });
+        ingesting.store(false);
+        writer.join();
+        query.extra.emplace_back("points", static_cast<double>(points.size()));
+    }
+
+    // Compensated column sum and sum of squared deviations at every instruction-set level
+    // the CPU supports
+    void benchStatsKernels(Runner& runner) {
+        std::vector<double> column(1 << 16);
+        for (size_t i = 0; i < column.size(); ++i) {
+            column[i] = std::sin(static_cast<double>(i)) * 100.0;
+        }
+        const double reference = statsKernels(SimdLevel::SCALAR).sum(column.data(), column.size());
+        const double mean = reference / static_cast<double>(column.size());
+
+        for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+            const StatsKernels& kernels = statsKernels(level);
+            if (kernels.level != level) {
+                continue;  // Not supported here
+            }
+            const double total = kernels.sum(column.data(), column.size());
+            Result& result = runner.time("stats_sum", {{"level", kernels.name}, {"n", std::to_string(column.size())}},
+                                         runner.iterations(2000), [&](uint64_t ops) {
+                for (uint64_t i = 0; i < ops; ++i) {
+                    doNotOptimize(kernels.sum(column.data(), column.size()));
+                }
+            });
+            result.extra.emplace_back("gb_per_sec", static_cast<double>(column.size() * sizeof(double)) / result.best_ns);
+            result.extra.emplace_back("abs_diff_vs_scalar", std::fabs(total - reference));
+
+            Result& squares = runner.time("stats_sum_squares", {{"level", kernels.name}, {"n", std::to_string(column.size())}},
+                                          runner.iterations(2000), [&](uint64_t ops) {
+                for (uint64_t i = 0; i < ops; ++i) {
+                    doNotOptimize(kernels.sumSquares(column.data(), column.size(), mean));
+                }
+            });
+            squares.extra.emplace_back("gb_per_sec", static_cast<double>(column.size() * sizeof(double)) / squares.best_ns);
+        }
+    }
+
+    // SensorSimulator::generateSensorValues (one reading of every sensor) with each engine
+    void benchGenerateValues(Runner& runner, RandomEngine engine) {
+        Config config;
+        config.random_engine = engine;
+        config.random_seed = 42;
+        SensorSimulator simulator(config);
+        runner.time("generate_sensor_values", {{"sensors", std::to_string(NUM_SENSORS)},
+                                               {"engine", engine == RandomEngine::FAST ? "fast" : "std"}},
+                    runner.iterations(2000000), [&](uint64_t ops) {
+            for (uint64_t i = 0; i < ops; ++i) {
+                doNotOptimize(simulator.generateSensorValues());
+            }
+        });
+    }
+
+    // Block of standard normals: std::normal_distribution over mt19937 vs the ziggurat sampler
+    void benchNormalFill(Runner& runner) {
+        std::vector<double> block(4096);
+        std::mt19937 rng(42);
+        std::normal_distribution<double> normal;
+        Result& std_result = runner.time("normal_fill", {{"engine", "std"}, {"n", std::to_string(block.size())}},
+                                         runner.iterations(2000), [&](uint64_t ops) {
+            for (uint64_t op = 0; op < ops; ++op) {
+                for (double& value : block) {
+                    value = normal(rng);
+                }
+                doNotOptimize(block[0]);
+            }
+        });
+        std_result.extra.emplace_back("ns_per_value", std_result.best_ns / static_cast<double>(block.size()));
+
+        NormalSampler sampler(42);
+        Result& fast_result = runner.time("normal_fill", {{"engine", "fast"}, {"n", std::to_string(block.size())}},
+                                          runner.iterations(2000), [&](uint64_t ops) {
+            for (uint64_t op = 0; op < ops; ++op) {
+                sampler.fill(block.data(), block.size());
+                doNotOptimize(block[0]);
+            }
+        });
+        fast_result.extra.emplace_back("ns_per_value", fast_result.best_ns / static_cast<double>(block.size()));
+    }
+
+    // WindowAggregator::push over three windows; cost should not grow with window length
+    void benchWindowAggregator(Runner& runner, size_t scale) {
+        const std::vector<size_t> windows = {10 * scale, 100 * scale, 600 * scale};
+        WindowAggregator aggregator(NUM_SENSORS, windows);
+        Config config;
+        SensorSimulator simulator(config);
+        std::vector<std::array<double, NUM_SENSORS>> samples;
+        for (size_t i = 0; i < 1024; ++i) {
+            samples.push_back(simulator.generateSensorValues());
+        }
+
+        std::array<double, NUM_SENSORS> mean, min, max, variance;
+        runner.time("window_aggregator_push", {{"windows", std::to_string(windows[0]) + "," +
+                                                std::to_string(windows[1]) + "," + std::to_string(windows[2])}},
+                    runner.iterations(2000000), [&](uint64_t ops) {
+            for (uint64_t i = 0; i < ops; ++i) {
+                aggregator.push(samples[i & 1023].data());
+                aggregator.stats(i % windows.size(), mean.data(), min.data(), max.data(), variance.data());
+                doNotOptimize(variance[0]);
+            }
+        });
+    }
+
+    // LatencyStats::record, the per-hop cost paid on every reading when tracking is on
+    void benchLatencyRecord(Runner& runner) {
+        LatencyStats stats;
+        runner.time("latency_record", {{"hops", "1"}}, runner.iterations(10000000), [&](uint64_t ops) {
+            for (uint64_t i = 0; i < ops; ++i) {
+                // Spread values over many buckets, as real latencies do
+                stats.record(LatencyHop::END_TO_END, 1, 2 + ((i * 2654435761u) & 0xfffff));
+            }
+        });
+    }
+
+    void runProcessingBenchmarks(Runner& runner) {
+        if (runner.selected("compute_moving_average")) {
+            for (int window : {10, 100, 1000, 10000}) {
+                benchComputeMovingAverage(runner, window);
+            }
+        }
+        if (runner.selected("moving_average_push_block")) {
+            for (size_t channels : {6, 64, 1024}) {
+                benchPushBlock(runner, channels, 64);
+            }
+        }
+        if (runner.selected("moving_average_sharded")) {
+            for (size_t threads : {1, 2, 4}) {
+                benchShardedPushBlock(runner, 4096, 64, threads);
+            }
+        }
+        if (runner.selected("decimator_push_block")) {
+            for (size_t factor : {10, 1000}) {
+                benchDecimator(runner, 64, factor);
+            }
+        }
+        if (runner.selected("filter_bank_push_block")) {
+            for (const char* spec : {"butterworth:4:200", "fir:31:200"}) {
+                benchFilterBank(runner, 6, spec);
+                benchFilterBank(runner, 1024, spec);
+            }
+        }
+        if (runner.selected("telemetry_encode") || runner.selected("telemetry_decode")) {
+            for (double precision : {0.0, 0.01}) {
+                benchMessageCodec(runner, precision);
+            }
+        }
+        if (runner.selected("telemetry_block")) {
+            for (double precision : {0.0, 0.01}) {
+                benchBlockCodec(runner, 1024, precision);
+            }
+        }
+        if (runner.selected("anomaly_detector_push_block")) {
+            for (size_t channels : {NUM_SENSORS, size_t{1024}}) {
+                benchAnomalyDetector(runner, channels);
+            }
+        }
+        if (runner.selected("store_push_block") || runner.selected("store_query_under_ingest")) {
+            for (size_t channels : {6, 256}) {
+                benchTimeSeriesStore(runner, channels);
+            }
+        }
+        if (runner.selected("stats_sum")) {
+            benchStatsKernels(runner);
+        }
+        if (runner.selected("generate_sensor_values")) {
+            benchGenerateValues(runner, RandomEngine::STD);
+            benchGenerateValues(runner, RandomEngine::FAST);
+        }
+        if (runner.selected("normal_fill")) {
+            benchNormalFill(runner);
+        }
+        if (runner.selected("window_aggregator_push")) {
+            for (size_t scale : {1, 100}) {
+                benchWindowAggregator(runner, scale);
+            }
+        }
+        if (runner.selected("latency_record")) {
+            benchLatencyRecord(runner);
+        }
+    }
+
+    // ---- IPC ----
+
+    const char* backendName(IPCBackend backend) {
+        return backend == IPCBackend::SHM ? "shm" : "mqueue";
+    }
+
+    // Sender and receiver in one thread: the cost of one send plus one receive
+    void benchIpcRoundTrip(Runner& runner, IPCBackend backend) {
+        IPCManager sender;
+        IPCManager receiver;
+        if (sender.initialize(true, backend) != ErrorCode::SUCCESS
+            || receiver.initialize(false, backend) != ErrorCode::SUCCESS) {
+            std::cerr << "Skipping ipc_round_trip/" << backendName(backend) << ": initialize failed\n";
+            return;
+        }
+
+        runner.time("ipc_round_trip", {{"backend", backendName(backend)}},
+                    runner.iterations(200000), [&](uint64_t ops) {
+            for (uint64_t i = 0; i < ops; ++i) {
+                sender.sendMessage(makeMessage(i));
+                doNotOptimize(receiver.receiveMessage());
+            }
+        });
+    }
+
+    // Batched sends drained with receiveBatch: amortized cost per message
+    void benchIpcBatched(Runner& runner, IPCBackend backend, size_t batch) {
+        IPCManager sender;
+        IPCManager receiver;
+        if (sender.initialize(true, backend) != ErrorCode::SUCCESS
+            || receiver.initialize(false, backend) != ErrorCode::SUCCESS) {
+            std::cerr << "Skipping ipc_batched/" << backendName(backend) << ": initialize failed\n";
+            return;
+        }
+        size_t limit = 0;
+        sender.enableBatching(batch, std::chrono::microseconds(1000000), limit);
+
+        Result& result = runner.time("ipc_batched", {{"backend", backendName(backend)}, {"batch", std::to_string(batch)}},
+                    runner.iterations(500000), [&](uint64_t ops) {
+            uint64_t received = 0;
+            for (uint64_t i = 0; i < ops; ++i) {
+                sender.sendMessage(makeMessage(i));
+                if ((i + 1) % batch == 0) {
+                    received += receiver.receiveBatch().size;
+                }
+            }
+            sender.flush();
+            for (MessageSpan span = receiver.receiveBatch(); !span.empty(); span = receiver.receiveBatch()) {
+                received += span.size;
+            }
+            doNotOptimize(received);
+        });
+        result.extra.emplace_back("messages_per_frame", static_cast<double>(limit));
+    }
+
+    // Sender and receiver threads in ping-pong: one-way latency including the receiver wakeup
+    void benchIpcLatency(Runner& runner, IPCBackend backend) {
+        IPCManager sender;
+        IPCManager receiver;
+        if (sender.initialize(true, backend) != ErrorCode::SUCCESS
+            || receiver.initialize(false, backend) != ErrorCode::SUCCESS) {
+            std::cerr << "Skipping ipc_latency/" << backendName(backend) << ": initialize failed\n";
+            return;
+        }
+
+        const uint64_t count = runner.iterations(2000);
+        std::vector<double> latencies;
+        latencies.reserve(count);
+        std::atomic<uint64_t> acked{0};
+        std::atomic<bool> consumer_done{false};
+
+        std::thread consumer([&]() {
+            for (uint64_t i = 0; i < count; ++i) {
+                auto msg = receiver.receiveMessage(std::chrono::milliseconds(1000));
+                if (!msg) {
+                    break;
+                }
+                const auto now = static_cast<double>(Clock::now().time_since_epoch().count());
+                latencies.push_back(now - msg->avg_values[0]);
+                acked.store(i + 1, std::memory_order_release);
+            }
+            consumer_done.store(true, std::memory_order_release);
+        });
+
+        for (uint64_t i = 0; i < count; ++i) {
+            sender.sendMessage(makeMessage(i));
+            // Wait for the receiver so each message measures an idle-to-woken handoff
+            while (acked.load(std::memory_order_acquire) <= i
+                   && !consumer_done.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+        consumer.join();
+
+        std::sort(latencies.begin(), latencies.end());
+        Result result;
+        result.name = "ipc_latency";
+        result.params = {{"backend", backendName(backend)}};
+        result.ops = latencies.size();
+        result.best_ns = percentile(latencies, 0.0);
+        for (double ns : latencies) {
+            result.mean_ns += ns / static_cast<double>(std::max<size_t>(1, latencies.size()));
+        }
+        result.extra = {{"p50_ns", percentile(latencies, 0.50)},
+                        {"p99_ns", percentile(latencies, 0.99)},
+                        {"p999_ns", percentile(latencies, 0.999)},
+                        {"max_ns", latencies.empty() ? 0.0 : latencies.back()}};
+        runner.record(std::move(result));
+    }
+
+    void runIpcBenchmarks(Runner& runner) {
+        for (IPCBackend backend : {IPCBackend::MQUEUE, IPCBackend::SHM}) {
+            if (runner.selected("ipc_round_trip")) {
+                benchIpcRoundTrip(runner, backend);
+            }
+            if (runner.selected("ipc_batched")) {
+                benchIpcBatched(runner, backend, IPCManager::MAX_BATCH);
+            }
+            if (runner.selected("ipc_latency")) {
+                benchIpcLatency(runner, backend);
+            }
+        }
+    }
+
+    // Parse benchmark command-line options
+    Options parseArguments(int argc, char* argv[]) {
+        Options options;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--output" && i + 1 < argc) {
+                options.output = argv[++i];
+            } else if (arg == "--filter" && i + 1 < argc) {
+                options.filter = argv[++i];
+            } else if (arg == "--quick") {
+                options.scale = 1;
+            } else {
+                throw std::invalid_argument("Unknown option: " + arg +
+                    "\nUsage: sensor_bench [--output FILE] [--filter TEXT] [--quick]");
+            }
+        }
+        return options;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        const Options options = parseArguments(argc, argv);
+        Runner runner(options);
+
+        runBufferBenchmarks(runner);
+        runProcessingBenchmarks(runner);
+        runIpcBenchmarks(runner);
+
+        if (options.output.empty()) {
+            runner.writeJson(std::cout);
+        } else {
+            std::ofstream file(options.output);
+            if (!file) {
+                throw std::runtime_error("Cannot open " + options.output);
+            }
+            runner.writeJson(file);
+            std::cerr << "Results written to " << options.output << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
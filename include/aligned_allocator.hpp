@@ -0,0 +1,42 @@
+#pragma once
+
+#include "common.hpp"
+#include <cstddef>
+#include <new>
+
+namespace sensor {
+
+// AlignedAllocator: Standard-library allocator returning Align-byte aligned storage,
+// so containers of hot data start on a cache line (and a full SIMD register width)
+template<typename T, size_t Align = CACHE_LINE_SIZE>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = AlignedAllocator<U, Align>;
+    };
+
+    AlignedAllocator() noexcept = default;
+
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) noexcept {}
+
+    // Allocate: Uses C++17 aligned operator new
+    T* allocate(size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+    }
+
+    // Deallocate: Must match the alignment used by allocate()
+    void deallocate(T* p, size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Align));
+    }
+
+    template<typename U>
+    bool operator==(const AlignedAllocator<U, Align>&) const noexcept { return true; }
+
+    template<typename U>
+    bool operator!=(const AlignedAllocator<U, Align>&) const noexcept { return false; }
+};
+
+} // namespace sensor
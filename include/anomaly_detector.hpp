@@ -0,0 +1,121 @@
+#pragma once
+
+#include "common.hpp"
+#include "channel_registry.hpp"
+#include "sample_block.hpp"
+#include <atomic>
+#include <chrono>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace sensor {
+
+// Checks AnomalyDetector can run on a channel
+enum class AnomalyKind : uint32_t {
+    ZSCORE,  // One reading further than Z declared stddevs from the declared mean
+    EWMA,    // Exponentially weighted mean drifted past its control limit
+    CUSUM,   // Two-sided cumulative sum of deviations passed its decision interval
+    RATE,    // Change between consecutive readings larger than R declared stddevs
+    COUNT    // Number of checks
+};
+
+// One anomaly, as sent on the alert path. Scores are in units of the channel's declared
+// stddev, signed by the direction of the deviation.
+struct AnomalyAlert {
+    uint64_t sample;        // Readings the detector had seen before this one
+    std::chrono::system_clock::time_point timestamp; // Time of the reading
+    uint64_t generated_ns;  // Monotonic creation stamp (registry mode: newest sample of the block)
+    uint32_t channel;       // Channel index (SENSORS or registry order)
+    AnomalyKind kind;       // Check that fired
+    double value;           // The reading
+    double score;           // Statistic that crossed the threshold
+    double threshold;       // The threshold it crossed
+};
+
+// Display name of a check, e.g. "cusum"
+const char* anomalyKindName(AnomalyKind kind);
+
+// AnomalyDetector class: Compares every reading with the mean and stddev its channel
+// declares (SENSORS or the registry) using up to four checks, each O(1) per sample with
+// a few doubles of state per channel: z-score, EWMA control chart, two-sided CUSUM and
+// rate of change. A check alerts on the reading that takes it past its threshold, so
+// detection latency is counted in samples, and stays quiet until it is back inside.
+// Sharded like MovingAverage: disjoint channel ranges may be pushed concurrently.
+class AnomalyDetector {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    // Constructor that assigns checks to channels. Each assignment is NAME=SPEC or just
+    // SPEC (every channel), NAME being a channel name, a prefix ending in '*' or '*':
+    //   zscore[:Z]          |x - mean| > Z stddev                        (default 6)
+    //   ewma[:LAMBDA[:L]]   EWMA of the z-scores beyond L sigma of the EWMA (0.1, 4)
+    //   cusum[:K[:H]]       CUSUM with slack K passing H, both in stddev  (0.5, 10)
+    //   roc[:R]             |x - previous x| > R stddev                  (default 8)
+    //   all                 every check with its defaults
+    //   none                remove the channel's checks
+    // Assignments add to earlier ones, and a later one of the same check replaces its
+    // parameters. Channels without a positive stddev are never checked. Throws
+    // std::invalid_argument for a malformed assignment or an unmatched pattern.
+    AnomalyDetector(const ChannelRegistry& channels, const std::vector<std::string>& assignments);
+
+    // Big 5: counters are atomic
+    AnomalyDetector(const AnomalyDetector&) = delete;
+    AnomalyDetector& operator=(const AnomalyDetector&) = delete;
+    AnomalyDetector(AnomalyDetector&&) = delete;
+    AnomalyDetector& operator=(AnomalyDetector&&) = delete;
+    ~AnomalyDetector() = default;
+
+    // Check one reading, values[ch] for every channel; appends alerts to out
+    void push(TimePoint time, uint64_t generated_ns, const double* values,
+              std::vector<AnomalyAlert>& out);
+
+    // Check a block: pushChannels() over every channel, then commitBlock()
+    void pushBlock(const SampleBlock& block, std::vector<AnomalyAlert>& out);
+
+    // Sharded pushBlock(): pushChannels() over disjoint channel ranges (concurrently if
+    // wanted, each with its own out), then commitBlock(). Alerts come channel by channel.
+    void pushChannels(const SampleBlock& block, size_t first, size_t last,
+                      std::vector<AnomalyAlert>& out);
+    void commitBlock(const SampleBlock& block);
+
+    // Print the checks configured and the alerts each one raised
+    void report(std::ostream& os) const;
+
+    // State query functions
+    size_t channels() const;                // Channels known to the detector
+    size_t checkedChannels() const;         // Channels running at least one check
+    uint64_t alerts(AnomalyKind kind) const; // Alerts raised by one check
+    uint64_t samples() const;               // Readings seen
+
+private:
+    // Parameters and running state of one channel; thresholds are in declared stddevs
+    struct Channel {
+        double mean;           // Declared mean
+        double inv_stddev;     // 1 / declared stddev (0 = never checked)
+        uint32_t checks;       // Bit per AnomalyKind
+        uint32_t active;       // Checks currently past their threshold
+        double z_limit;        // ZSCORE: Z
+        double lambda;         // EWMA: weight of the newest reading
+        double ewma_limit;     // EWMA: L * sqrt(lambda / (2 - lambda))
+        double cusum_k;        // CUSUM: slack
+        double cusum_h;        // CUSUM: decision interval
+        double rate_limit;     // RATE: R
+        double ewma;           // EWMA of the z-scores, starting at 0 (the declared mean)
+        double cusum_high;     // Upper CUSUM, clamped at 2H
+        double cusum_low;      // Lower CUSUM, clamped at 2H
+        double previous;       // Last z-score, for RATE
+        bool primed;           // Whether previous holds a reading
+    };
+
+    // Run every check of a channel over length readings
+    void check(size_t channel, const double* column, const TimePoint* times, size_t length,
+               uint64_t generated_ns, std::vector<AnomalyAlert>& out);
+
+    std::vector<Channel> m_channels;      // One per channel
+    std::vector<std::string> m_specs;     // Assignments as written, for reports
+    uint64_t m_samples;                   // Readings seen (advanced by push and commitBlock)
+    std::atomic<uint64_t> m_alerts[static_cast<size_t>(AnomalyKind::COUNT)]; // Per check
+};
+
+} // namespace sensor
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <atomic>
+
+namespace sensor {
+
+// Asymmetric fences for store/load handshakes where one side runs constantly and the
+// other rarely, such as a producer checking for a parked consumer. lightFence() and
+// heavyFence() together order like a seq_cst fence on each side. Where membarrier(2) is
+// available the heavy side forces a full barrier on every running thread of the process,
+// so the light side only has to stop the compiler from reordering. Elsewhere both are
+// plain seq_cst fences. Only threads of this process are covered, not shared memory peers.
+
+// Register the process for expedited membarrier(2); false where it is unavailable
+bool registerAsymmetricFence();
+
+// Whether heavyFence() is a process-wide barrier; registers on the first call
+inline bool asymmetricFenceAvailable() {
+    static const bool available = registerAsymmetricFence();
+    return available;
+}
+
+// Fast side: a compiler barrier when the heavy side covers it, else a full fence
+inline void lightFence() {
+    if (asymmetricFenceAvailable()) {
+        std::atomic_signal_fence(std::memory_order_seq_cst);
+    } else {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+
+// Slow side: a full barrier on every running thread of the process (one system call)
+void heavyFence();
+
+} // namespace sensor
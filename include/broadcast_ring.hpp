@@ -0,0 +1,104 @@
+#pragma once
+
+#include "common.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sensor {
+
+// BroadcastRing class: Single-producer/multi-consumer broadcast ring in POSIX shared
+// memory. Every message is delivered to every subscriber: the producer only advances
+// its write position, and each subscriber keeps its own read cursor in a slot table in
+// the segment. The producer never waits for anyone. It overwrites the oldest slot, and
+// a subscriber that falls a full lap behind skips ahead and counts what it lost. Slots
+// are seqlocked, so a read that races with an overwrite is detected and retried.
+// Subscribers claim a table entry with one compare-and-swap. The producer checks
+// subscriber lag every few publishes, flags slow subscribers and reclaims the entries of
+// processes that exited without unsubscribing.
+class BroadcastRing {
+public:
+    // Most subscribers attached at once
+    static constexpr size_t MAX_SUBSCRIBERS = 16;
+
+    // Snapshot of one subscriber, as seen by anyone mapping the segment
+    struct SubscriberStats {
+        uint32_t id;        // Subscriber table index
+        int pid;            // Process that claimed the entry
+        uint64_t lag;       // Messages published but not yet read
+        uint64_t received;  // Messages read
+        uint64_t lost;      // Messages overwritten before they were read
+        bool slow;          // Lag passed half the ring and has not recovered yet
+    };
+
+    // Create a new segment (producer); any stale segment with the same name is replaced
+    static std::unique_ptr<BroadcastRing> create(const std::string& name, size_t slot_size, size_t slots);
+
+    // Attach and claim a subscriber entry starting at the newest message; returns nullptr
+    // if the segment is absent or incompatible, or every entry is taken
+    static std::unique_ptr<BroadcastRing> subscribe(const std::string& name, size_t slot_size);
+
+    // Destructor releases the subscriber entry, or unlinks the segment for the creator
+    ~BroadcastRing();
+
+    // Disable copy and move operations, the mapping is owned by exactly one object
+    BroadcastRing(const BroadcastRing&) = delete;
+    BroadcastRing& operator=(const BroadcastRing&) = delete;
+    BroadcastRing(BroadcastRing&&) = delete;
+    BroadcastRing& operator=(BroadcastRing&&) = delete;
+
+    // Publish len bytes to every subscriber (producer); never blocks, false only if len is too large
+    bool publish(const void* data, size_t len);
+
+    // Copy the next message into out (subscriber), returns its length or 0 if nothing is new
+    size_t read(void* out, size_t max_len);
+
+    // Block until read() would return a message or timeout expires (subscriber)
+    bool waitReadable(std::chrono::milliseconds timeout);
+
+    // Messages this subscriber lost to overwrites
+    uint64_t lost() const;
+
+    // Every active subscriber, in table order
+    std::vector<SubscriberStats> subscribers() const;
+
+    // Times any subscriber was flagged slow
+    uint64_t slowEvents() const;
+
+    // Ring geometry
+    size_t slotSize() const;  // Maximum payload bytes per slot
+    size_t capacity() const;  // Number of slots (power of two)
+
+private:
+    struct Header;
+    struct SubscriberEntry;
+    struct SlotHeader;
+
+    BroadcastRing(const std::string& name, void* base, size_t mapped_size, bool owner, int subscriber);
+
+    // Address of the slot holding position pos
+    SlotHeader* slotAt(uint64_t pos) const;
+
+    // Producer: flag slow subscribers and reclaim entries of dead processes
+    void checkSubscribers(uint64_t write_pos);
+
+    // Producer: wake parked subscribers, only if any are parked
+    void wakeSubscribers();
+
+    // Subscriber: true if a message at or after the cursor has been published
+    bool readable() const;
+
+    std::string m_name;           // Segment name passed to shm_open
+    void* m_base;                 // Start of the mapping
+    size_t m_mapped_size;         // Bytes mapped
+    bool m_owner;                 // True for the creator, which unlinks on destruction
+    Header* m_header;             // Control block at the start of the mapping
+    SubscriberEntry* m_entries;   // Subscriber table after the header
+    char* m_slots;                // First slot, after the subscriber table
+    size_t m_stride;              // Bytes between consecutive slots
+    int m_subscriber;             // Claimed table entry (-1 for the producer)
+};
+
+} // namespace sensor
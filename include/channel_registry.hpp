@@ -0,0 +1,47 @@
+#pragma once
+
+#include "common.hpp"
+#include <string>
+#include <vector>
+
+namespace sensor {
+
+// Runtime description of one channel (the dynamic counterpart of SensorMetadata)
+struct ChannelInfo {
+    std::string name;   // Display name of the channel
+    std::string unit;   // Unit of measurement
+    double mean;        // Expected mean value for simulation
+    double stddev;      // Standard deviation for value simulation
+};
+
+// ChannelRegistry class: Channel count and metadata chosen at startup rather than
+// compiled in. Used by the registry (structure-of-arrays) pipeline mode.
+class ChannelRegistry {
+public:
+    // Registry holding the built-in SENSORS table
+    static ChannelRegistry builtin();
+
+    // Load channels from a text file: one "name,unit,mean,stddev" per line, '#' comments
+    static ChannelRegistry fromFile(const std::string& path);
+
+    // Generate count channels by cycling through the SENSORS table (load testing)
+    static ChannelRegistry synthetic(size_t count);
+
+    // Channel access
+    size_t size() const;                              // Number of channels
+    const ChannelInfo& operator[](size_t index) const; // Metadata of one channel
+
+    // Indices of the channels matching a name, a prefix ending in '*', or '*' for all
+    std::vector<size_t> find(const std::string& pattern) const;
+
+private:
+    explicit ChannelRegistry(std::vector<ChannelInfo> channels);
+
+    std::vector<ChannelInfo> m_channels; // Channels in transport/column order
+};
+
+// Fields of text between separators, untrimmed; a trailing separator adds no empty field.
+// Shared by the CHANNEL=SPEC parsers (filters, detectors) and channel files.
+std::vector<std::string> splitFields(const std::string& text, char separator);
+
+} // namespace sensor
@@ -3,18 +3,56 @@
 
 // Include required header files
 #include "common.hpp"
+#include "stage_counters.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <mutex>
 #include <optional>
+#include <type_traits>
 #include <vector>
 
 namespace sensor {
 
-// Thread-safe circular buffer implementation for generic type T
+// Thread-safe circular buffer implementation for generic type T. What push() does
+// when the buffer is full is set by its OverflowPolicy; every policy is supported
+// because both sides hold the same mutex. Counters are atomics written under that
+// mutex and read without it, so reporting never waits on the buffer.
+// Batch functions move any number of items per lock, and views expose items in place.
 template<typename T>
 class CircularBuffer {
 public:
-    // Constructor that initializes the buffer with specified size
-    explicit CircularBuffer(size_t size);
+    // Consecutive items in the buffer's storage
+    struct Span {
+        const T* data;  // First item
+        size_t size;    // Items
+    };
+
+    // Items seen in place, oldest first: first runs up to the end of the storage and second
+    // continues from its start. Taking a view copies nothing and releases the lock at once;
+    // the pointers stay good while the buffer lives, but a later push() may overwrite the
+    // items. That cannot happen while the reader is also the only producer; otherwise read,
+    // then check valid() and discard what was read if it returns false. Reading an item
+    // mid-write is only harmless for plain bytes, so views need a trivially copyable T.
+    struct View {
+        Span first;         // Items up to the end of the storage
+        Span second;        // Remaining items from the start of the storage
+        uint64_t start;     // Items written before the first one (its position)
+        uint64_t replaced;  // COALESCE replacements when the view was taken
+        bool newest;        // Whether the view ended at the newest item
+
+        size_t size() const { return first.size + second.size; }
+        bool empty() const { return size() == 0; }
+        const T& operator[](size_t index) const {
+            return index < first.size ? first.data[index] : second.data[index - first.size];
+        }
+    };
+
+    // Constructor that initializes the buffer with specified size and overflow policy;
+    // block_timeout bounds how long a BLOCK push waits for room
+    explicit CircularBuffer(size_t size, OverflowPolicy policy = OverflowPolicy::DROP_OLDEST,
+                            std::chrono::microseconds block_timeout = std::chrono::microseconds(0));
 
     // Big 5
     CircularBuffer(const CircularBuffer&) = delete;
@@ -23,28 +61,88 @@ public:
     CircularBuffer& operator=(CircularBuffer&&) noexcept = default;
     ~CircularBuffer() = default;
 
-    // Add an item to the buffer, returns false if buffer is full
+    // Add an item to the buffer, applying the overflow policy if it is full;
+    // returns false if the new item itself was dropped
     bool push(const T& item);
     
     // Remove and return the oldest item from the buffer
     std::optional<T> pop();
+
+    // Return a copy of the oldest item without removing it
+    std::optional<T> peek() const;
+
+    // Block until an item is available or timeout expires, then pop it
+    std::optional<T> waitPop(std::chrono::microseconds timeout);
     
     // Get a window of most recent items for processing
     std::vector<T> getWindow(size_t window_size) const;
 
+    // Add items in order under one lock, applying the overflow policy as push() would;
+    // a BLOCK batch drops the rest once a wait for room times out. Returns the number of
+    // items push() would have returned true for.
+    size_t pushBatch(const T* items, size_t count);
+
+    // Remove up to max_items oldest items into out under one lock; returns how many
+    size_t popBatch(T* out, size_t max_items);
+
+    // Block until an item is available or timeout expires, then popBatch()
+    size_t waitPopBatch(T* out, size_t max_items, std::chrono::microseconds timeout);
+
+    // Zero-copy views: the window_size most recent items (getWindow() in place), or the
+    // max_items oldest ones, to be handled in place and then removed with consume()
+    View window(size_t window_size) const;
+    View front(size_t max_items) const;
+
+    // Remove up to count oldest items without copying them; returns how many
+    size_t consume(size_t count);
+
+    // Whether none of a view's items has been overwritten since it was taken; says
+    // nothing about whether they are still queued
+    bool valid(const View& view) const;
+
     // Buffer state query functions
     bool empty() const;      // Check if buffer is empty
     bool full() const;       // Check if buffer is full
     size_t size() const;     // Get current number of items in buffer
     size_t capacity() const; // Get maximum capacity of buffer
 
+    // Overflow policy and produced/consumed/dropped accounting
+    OverflowPolicy policy() const;
+    StageCounters counters() const;
+
 private:
+    // Remove the item at the tail (mutex held, buffer not empty)
+    T takeOldest();
+
+    // Write count items at the head (mutex held, count no more than the free slots)
+    void store(const T* items, size_t count);
+
+    // Copy out and remove up to max_items oldest items (mutex held)
+    size_t takeBatch(T* out, size_t max_items);
+
+    // View of count items starting offset items after the tail (mutex held)
+    View makeView(size_t offset, size_t count) const;
+
+    // Record the current depth if it is the deepest so far (mutex held)
+    void raiseHighWater();
+
     const size_t m_size;     // Fixed capacity of the buffer
     std::vector<T> m_buffer; // Underlying storage for buffer elements
     size_t m_head;          // Index for next write position
     size_t m_tail;          // Index for next read position
     bool m_full;            // Flag indicating buffer is full
+    uint64_t m_written;     // Items written at the head so far (positions for views)
+    uint64_t m_replaced;    // Newest items replaced by COALESCE so far
+    const OverflowPolicy m_policy; // What push() does when the buffer is full
+    const std::chrono::microseconds m_block_timeout; // Longest wait of a BLOCK push
     mutable std::mutex m_mutex; // Mutex for thread-safe operations
+    std::condition_variable m_not_empty; // Signaled by push() to wake waitPop()
+    std::condition_variable m_not_full;  // Signaled by pop() to wake a BLOCK push()
+    // Written under m_mutex with bumpCounter, read by counters() without it
+    std::atomic<uint64_t> m_produced;  // Items offered to push()
+    std::atomic<uint64_t> m_consumed;  // Items popped or consumed
+    std::atomic<uint64_t> m_dropped;   // Items lost to the overflow policy
+    std::atomic<size_t> m_high_water;  // Deepest occupancy seen
 };
 
 } // namespace sensor
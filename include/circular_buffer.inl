@@ -3,51 +3,131 @@
 namespace sensor {
 
 // Use .inl because it's a template implementation and we need it for compiler to find it
-// Constructor: Initializes buffer with specified size and empty state
+// Constructor: Initializes buffer with specified size, overflow policy and empty state
 template<typename T>
-CircularBuffer<T>::CircularBuffer(size_t size)
+CircularBuffer<T>::CircularBuffer(size_t size, OverflowPolicy policy, std::chrono::microseconds block_timeout)
     : m_size(size)
     , m_buffer(size)
     , m_head(0)
     , m_tail(0)
     , m_full(false)
+    , m_written(0)
+    , m_replaced(0)
+    , m_policy(policy)
+    , m_block_timeout(block_timeout)
+    , m_produced(0)
+    , m_consumed(0)
+    , m_dropped(0)
+    , m_high_water(0)
 {}
 
-// Push: Adds new item to the buffer, overwrites oldest item if full
+// Push: Adds new item to the buffer; when full, the overflow policy decides what is lost
 template<typename T>
 bool CircularBuffer<T>::push(const T& item) {
-    std::lock_guard<std::mutex> lock(m_mutex);
-    
-    // Store item at head position
-    m_buffer[m_head] = item;
-    m_head = (m_head + 1) % m_size;
-    
-    if (m_full) {
-        // Buffer is full, move tail to overwrite oldest item
-        m_tail = (m_tail + 1) % m_size;
-    } else {
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        bumpCounter(m_produced);
+
+        if (m_full) {
+            switch (m_policy) {
+                case OverflowPolicy::DROP_OLDEST:
+                    // Move tail to overwrite oldest item
+                    m_tail = (m_tail + 1) % m_size;
+                    m_full = false;
+                    bumpCounter(m_dropped);
+                    break;
+                case OverflowPolicy::DROP_NEWEST:
+                    bumpCounter(m_dropped);
+                    return false;
+                case OverflowPolicy::BLOCK:
+                    // pop() signals m_not_full; give up once the timeout expires
+                    if (!m_not_full.wait_for(lock, m_block_timeout, [this] { return !m_full; })) {
+                        bumpCounter(m_dropped);
+                        return false;
+                    }
+                    break;
+                case OverflowPolicy::COALESCE:
+                    // Newest queued item is superseded; the consumer has nothing new to wake for
+                    m_buffer[(m_head + m_size - 1) % m_size] = item;
+                    ++m_replaced;
+                    bumpCounter(m_dropped);
+                    return true;
+            }
+        }
+
+        // Store item at head position
+        m_buffer[m_head] = item;
+        m_head = (m_head + 1) % m_size;
+        ++m_written;
+
         // Update full flag if head catches up to tail
         m_full = (m_head == m_tail);
+        raiseHighWater();
     }
-    
+
+    // Notify outside the lock so the woken consumer does not block on it immediately
+    m_not_empty.notify_one();
     return true;
 }
 
 // Pop: Removes and returns oldest item from buffer
 template<typename T>
 std::optional<T> CircularBuffer<T>::pop() {
+    std::optional<T> item;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Return empty optional if buffer is empty
+        if (empty()) {
+            return std::nullopt;
+        }
+        item = takeOldest();
+    }
+
+    // Only a BLOCK producer ever waits for room
+    if (m_policy == OverflowPolicy::BLOCK) {
+        m_not_full.notify_one();
+    }
+    return item;
+}
+
+// Peek: Copy of the oldest item, left in place
+template<typename T>
+std::optional<T> CircularBuffer<T>::peek() const {
     std::lock_guard<std::mutex> lock(m_mutex);
-    
-    // Return empty optional if buffer is empty
     if (empty()) {
         return std::nullopt;
     }
+    return m_buffer[m_tail];
+}
+
+// WaitPop: Sleeps until push() signals data or timeout expires, then removes oldest item
+template<typename T>
+std::optional<T> CircularBuffer<T>::waitPop(std::chrono::microseconds timeout) {
+    std::optional<T> item;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        // Return empty optional on timeout so callers can check for shutdown
+        if (!m_not_empty.wait_for(lock, timeout, [this] { return !empty(); })) {
+            return std::nullopt;
+        }
+        item = takeOldest();
+    }
+
+    if (m_policy == OverflowPolicy::BLOCK) {
+        m_not_full.notify_one();
+    }
+    return item;
+}
 
-    // Get item at tail and advance tail position
+// TakeOldest: Get item at tail and advance tail position
+template<typename T>
+T CircularBuffer<T>::takeOldest() {
     T item = m_buffer[m_tail];
     m_tail = (m_tail + 1) % m_size;
     m_full = false;
-    
+    bumpCounter(m_consumed);
     return item;
 }
 
@@ -56,24 +136,214 @@ template<typename T>
 std::vector<T> CircularBuffer<T>::getWindow(size_t window_size) const {
     std::lock_guard<std::mutex> lock(m_mutex);
     std::vector<T> window;
-    
+
     // Return empty vector if buffer is empty or window size is 0
     if (empty() || window_size == 0) {
         return window;
     }
 
-    // Calculate actual window size (minimum of requested size and available items)
-    size_t count = std::min(window_size, size());
+    // Copy the at most two runs of the window in one go each
+    const size_t count = std::min(window_size, size());
+    const View view = makeView(size() - count, count);
     window.reserve(count);
+    window.insert(window.end(), view.first.data, view.first.data + view.first.size);
+    window.insert(window.end(), view.second.data, view.second.data + view.second.size);
+    return window;
+}
 
-    // Calculate starting position and copy items to window
-    size_t current = (m_tail + size() - count) % m_size;
-    for (size_t i = 0; i < count; ++i) {
-        window.push_back(m_buffer[current]);
-        current = (current + 1) % m_size;
+// PushBatch: The whole batch under one lock and one wake-up of the consumers
+template<typename T>
+size_t CircularBuffer<T>::pushBatch(const T* items, size_t count) {
+    if (count == 0) {
+        return 0;
     }
+    size_t accepted = count;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        bumpCounter(m_produced, count);
 
-    return window;
+        const size_t room = m_size - size();
+        switch (m_policy) {
+            case OverflowPolicy::DROP_OLDEST: {
+                // Items the batch itself would evict are never written
+                const size_t skipped = count > m_size ? count - m_size : 0;
+                const size_t kept = count - skipped;
+                const size_t evicted = kept > room ? kept - room : 0;
+                m_tail = (m_tail + evicted) % m_size;
+                if (evicted > 0) {
+                    m_full = false;
+                }
+                bumpCounter(m_dropped, skipped + evicted);
+                store(items + skipped, kept);
+                break;
+            }
+            case OverflowPolicy::DROP_NEWEST:
+                accepted = std::min(count, room);
+                bumpCounter(m_dropped, count - accepted);
+                store(items, accepted);
+                break;
+            case OverflowPolicy::BLOCK: {
+                size_t stored = 0;
+                while (stored < count) {
+                    if (m_full) {
+                        // Consumers must see what is stored already before room can appear
+                        m_not_empty.notify_all();
+                        if (!m_not_full.wait_for(lock, m_block_timeout, [this] { return !m_full; })) {
+                            bumpCounter(m_dropped, count - stored);
+                            break;
+                        }
+                    }
+                    const size_t n = std::min(count - stored, m_size - size());
+                    store(items + stored, n);
+                    stored += n;
+                }
+                accepted = stored;
+                break;
+            }
+            case OverflowPolicy::COALESCE: {
+                // Whatever does not fit supersedes the newest item, so only the last one stays
+                const size_t n = std::min(count, room);
+                store(items, n);
+                if (n < count) {
+                    m_buffer[(m_head + m_size - 1) % m_size] = items[count - 1];
+                    ++m_replaced;
+                    bumpCounter(m_dropped, count - n);
+                }
+                break;
+            }
+        }
+        raiseHighWater();
+    }
+
+    m_not_empty.notify_all();
+    return accepted;
+}
+
+// PopBatch: Removes oldest items up to max_items
+template<typename T>
+size_t CircularBuffer<T>::popBatch(T* out, size_t max_items) {
+    size_t count = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        count = takeBatch(out, max_items);
+    }
+
+    if (count > 0 && m_policy == OverflowPolicy::BLOCK) {
+        m_not_full.notify_all();
+    }
+    return count;
+}
+
+// WaitPopBatch: Sleeps like waitPop(), then removes every item available up to max_items
+template<typename T>
+size_t CircularBuffer<T>::waitPopBatch(T* out, size_t max_items, std::chrono::microseconds timeout) {
+    size_t count = 0;
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (max_items == 0 || !m_not_empty.wait_for(lock, timeout, [this] { return !empty(); })) {
+            return 0;
+        }
+        count = takeBatch(out, max_items);
+    }
+
+    if (m_policy == OverflowPolicy::BLOCK) {
+        m_not_full.notify_all();
+    }
+    return count;
+}
+
+// Window: The newest items in place
+template<typename T>
+typename CircularBuffer<T>::View CircularBuffer<T>::window(size_t window_size) const {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Views read items a producer may be overwriting: T must be trivially copyable");
+    std::lock_guard<std::mutex> lock(m_mutex);
+    const size_t count = std::min(window_size, size());
+    return makeView(size() - count, count);
+}
+
+// Front: The oldest items in place
+template<typename T>
+typename CircularBuffer<T>::View CircularBuffer<T>::front(size_t max_items) const {
+    static_assert(std::is_trivially_copyable_v<T>,
+                  "Views read items a producer may be overwriting: T must be trivially copyable");
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return makeView(0, std::min(max_items, size()));
+}
+
+// Consume: Advance the tail past items already handled in place
+template<typename T>
+size_t CircularBuffer<T>::consume(size_t count) {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        count = std::min(count, size());
+        if (count == 0) {
+            return 0;
+        }
+        m_tail = (m_tail + count) % m_size;
+        m_full = false;
+        bumpCounter(m_consumed, count);
+    }
+
+    if (m_policy == OverflowPolicy::BLOCK) {
+        m_not_full.notify_all();
+    }
+    return count;
+}
+
+// Valid: The item at position p is overwritten by the write of position p + capacity, and
+// COALESCE rewrites the newest item in place (conservatively: any replacement since)
+template<typename T>
+bool CircularBuffer<T>::valid(const View& view) const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_written > view.start + m_size) {
+        return false;
+    }
+    return !view.newest || view.empty() || m_replaced == view.replaced;
+}
+
+// Store: Copy the items in at most two runs and advance the head
+template<typename T>
+void CircularBuffer<T>::store(const T* items, size_t count) {
+    if (count == 0) {
+        return;
+    }
+    const size_t contiguous = std::min(count, m_size - m_head);
+    std::copy(items, items + contiguous, m_buffer.begin() + m_head);
+    std::copy(items + contiguous, items + count, m_buffer.begin());
+    m_head = (m_head + count) % m_size;
+    m_written += count;
+    m_full = (m_head == m_tail);
+}
+
+// TakeBatch: Copy the oldest items in at most two runs and advance the tail
+template<typename T>
+size_t CircularBuffer<T>::takeBatch(T* out, size_t max_items) {
+    const size_t count = std::min(max_items, size());
+    if (count == 0) {
+        return 0;
+    }
+    const View view = makeView(0, count);
+    std::copy(view.first.data, view.first.data + view.first.size, out);
+    std::copy(view.second.data, view.second.data + view.second.size, out + view.first.size);
+    m_tail = (m_tail + count) % m_size;
+    m_full = false;
+    bumpCounter(m_consumed, count);
+    return count;
+}
+
+// MakeView: Split the items at the end of the storage
+template<typename T>
+typename CircularBuffer<T>::View CircularBuffer<T>::makeView(size_t offset, size_t count) const {
+    const size_t begin = (m_tail + offset) % m_size;
+    const size_t contiguous = std::min(count, m_size - begin);
+    View view;
+    view.first = Span{m_buffer.data() + begin, contiguous};
+    view.second = Span{m_buffer.data(), count - contiguous};
+    view.start = m_written - size() + offset;
+    view.replaced = m_replaced;
+    view.newest = offset + count == size();
+    return view;
 }
 
 // Empty: Returns true if buffer contains no items
@@ -103,4 +373,31 @@ size_t CircularBuffer<T>::capacity() const {
     return m_size;
 }
 
+// Policy: Returns the overflow policy applied by push()
+template<typename T>
+OverflowPolicy CircularBuffer<T>::policy() const {
+    return m_policy;
+}
+
+// Counters: Read without the mutex, so a reporter never stalls producer or consumer;
+// the fields may be a few operations apart from one another
+template<typename T>
+StageCounters CircularBuffer<T>::counters() const {
+    StageCounters counters;
+    counters.produced = m_produced.load(std::memory_order_relaxed);
+    counters.consumed = m_consumed.load(std::memory_order_relaxed);
+    counters.dropped = m_dropped.load(std::memory_order_relaxed);
+    counters.high_water = m_high_water.load(std::memory_order_relaxed);
+    return counters;
+}
+
+// RaiseHighWater: Record the current depth if it is the deepest so far (mutex held)
+template<typename T>
+void CircularBuffer<T>::raiseHighWater() {
+    const size_t depth = size();
+    if (depth > m_high_water.load(std::memory_order_relaxed)) {
+        m_high_water.store(depth, std::memory_order_relaxed);
+    }
+}
+
 } // namespace sensor 
\ No newline at end of file
@@ -3,8 +3,10 @@
 #include <array>
 #include <chrono>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <string_view>
+#include <vector>
 
 #ifdef __APPLE__
 // Mock mqueue types for macOS (IDE only)
@@ -20,8 +22,13 @@ namespace sensor {
 // System-wide constants
 constexpr size_t NUM_SENSORS = 6;           // Total number of sensors in the system
 constexpr size_t BUFFER_SIZE = 100;         // Size of circular buffer for sensor data
-constexpr size_t MAX_MSG_SIZE = 256;        // Maximum size of IPC message queue messages
+constexpr size_t MAX_MSG_SIZE = 4096;       // Maximum size of IPC message queue messages (one batch frame)
 constexpr const char* QUEUE_NAME = "/sensor_mq";  // Name of the IPC message queue
+constexpr const char* SHM_NAME = "/sensor_shm";   // Name of the shared-memory ring segment
+constexpr const char* BROADCAST_NAME = "/sensor_bcast"; // Name of the broadcast ring segment
+constexpr const char* INGEST_NAME = "/sensor_ingest";   // Name of the acquisition -> processing ring segment
+constexpr size_t CACHE_LINE_SIZE = 64;      // Alignment used to keep hot atomics on separate lines
+constexpr size_t MAX_AGGREGATE_WINDOWS = 3; // Aggregation windows a WindowReport can carry
 
 // Structure defining metadata for each sensor type
 struct SensorMetadata {
@@ -41,31 +48,198 @@ constexpr std::array<SensorMetadata, NUM_SENSORS> SENSORS = {{
     {"Gyroscope",      "°/s",    0.0, 1.0}   // Angular velocity near rest with noise
 }};
 
+// Smallest multiple of align at or above value
+inline size_t roundUp(size_t value, size_t align) {
+    return (value + align - 1) / align * align;
+}
+
+// Smallest power of two at or above value (1 for 0)
+inline size_t roundUpPow2(size_t value) {
+    size_t result = 1;
+    while (result < value) {
+        result <<= 1;
+    }
+    return result;
+}
+
+// Monotonic clock reading in nanoseconds, for latency stamps (immune to wall-clock steps)
+inline uint64_t monotonicNanos() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Monotonic stage timestamps carried with a reading through the pipeline (0 = not stamped)
+struct StageTimes {
+    uint64_t generated_ns = 0;  // SensorSimulator created the reading
+    uint64_t popped_ns = 0;     // DataProcessor took it from the sample buffer
+    uint64_t sent_ns = 0;       // DataProcessor handed the result to IPC
+};
+
 // Structure for raw sensor data readings
 struct SensorData {
     std::array<double, NUM_SENSORS> values;     // Array of sensor readings
     std::chrono::system_clock::time_point timestamp;  // Timestamp of the readings
+    uint64_t generated_ns = 0;                  // Monotonic creation time for latency tracking
+};
+
+// Statistics of every sensor over one aggregation window
+struct WindowSummary {
+    uint32_t window_ms;                         // Window length in milliseconds
+    uint32_t samples;                           // Samples currently in the window
+    std::array<double, NUM_SENSORS> mean;       // Mean per sensor
+    std::array<double, NUM_SENSORS> min;        // Minimum per sensor
+    std::array<double, NUM_SENSORS> max;        // Maximum per sensor
+    std::array<double, NUM_SENSORS> variance;   // Unbiased sample variance per sensor
+};
+
+// Statistics of every aggregation window as of one reading; sent as a frame of its own
+// every Config::windows_every_ms, so per-reading messages stay small
+struct WindowReport {
+    uint64_t next_msg_id;                       // Messages with lower ids precede the report
+    std::chrono::system_clock::time_point timestamp;  // Timestamp of the newest reading in the windows
+    uint32_t window_count;                      // Valid entries in windows
+    std::array<WindowSummary, MAX_AGGREGATE_WINDOWS> windows; // Multi-window statistics
 };
 
 // Structure for processed sensor data messages
 struct MQMessage {
     uint64_t msg_id;                            // Unique message identifier
-    std::array<double, NUM_SENSORS> avg_values; // Moving average of sensor values
+    std::array<double, NUM_SENSORS> avg_values; // Moving average (or filter output) of sensor values
     std::chrono::system_clock::time_point timestamp;  // Timestamp of the processed data
+    StageTimes stages;                          // Monotonic stage stamps of the underlying reading
+};
+
+// Buffer implementations available for the simulator-to-processor handoff
+enum class BufferType {
+    MUTEX,  // CircularBuffer: mutex-protected, supports every OverflowPolicy
+    SPSC,   // SpscRingBuffer: wait-free single producer/consumer, DROP_NEWEST or BLOCK only
+    SHM     // IngestRing: shared-memory ring read by a separate processing process (--role acquire)
+};
+
+// What a pipeline stage does with a new item when it is full
+enum class OverflowPolicy {
+    DROP_OLDEST,  // Evict the oldest queued item to make room
+    DROP_NEWEST,  // Reject the new item
+    BLOCK,        // Wait up to Config::overflow_block_us for room, then reject the new item
+    COALESCE      // Replace the newest queued item, so the consumer catches up to the latest
+};
+
+// Transports available to IPCManager
+enum class IPCBackend {
+    MQUEUE, // POSIX message queue: kernel copy on every send and receive
+    SHM,    // Shared-memory ring: slots read and written in place, no syscalls on the fast path
+    BROADCAST // Shared-memory broadcast ring: every subscriber reads every message at its own pace
 };
 
+// Pipeline stages run by this process
+enum class PipelineRole {
+    ALL,      // Simulator, processor and output in one process
+    ACQUIRE,  // Simulator only, publishing raw readings to the shared-memory ingest ring
+    PROCESS,  // Processor only, reading the ingest ring and sending to the IPC transport
+    OUTPUT    // Output only, receiving from the IPC transport of a running processing stage
+};
+
+// How pipeline threads wait for their next input
+enum class WakeupMode {
+    POLL,   // Sleep half a sampling period between non-blocking checks
+    EVENT   // Block until the upstream stage signals new data (or wait_timeout_ms expires)
+};
+
+// Layouts OutputHandler can write to stdout
+enum class OutputFormat {
+    PRETTY,   // Human-readable block per message (the original layout)
+    COMPACT,  // One line per message: timestamp, id, key=value pairs
+    CSV,      // Header line, then one row per message with exact (round-trip) values
+    BINARY    // Raw MQMessage records (fixed mode) or id/timestamp/values records (registry)
+};
+
+// Random number generators available to SensorSimulator
+enum class RandomEngine {
+    STD,    // std::mt19937 with std::normal_distribution per value
+    FAST    // xoshiro256++ with a ziggurat normal sampler, filled in blocks (fast_random.hpp)
+};
+
+// Scheduling options for one pipeline thread (see realtime.hpp)
+struct ThreadPolicy {
+    int rt_priority = 0;  // SCHED_FIFO priority 1-99; 0 keeps the default time-sharing scheduler
+    int cpu = -1;         // CPU to pin the thread to; -1 leaves it free to migrate
+};
+
+// Runtime channel set for the registry pipeline mode (see channel_registry.hpp)
+class ChannelRegistry;
+
+// Per-hop latency histograms shared by the pipeline stages (see latency_histogram.hpp)
+class LatencyStats;
+
 // Configuration parameters for the sensor system
 struct Config {
     int sampling_rate_ms = 100;   // Sampling rate in milliseconds (default: 100ms)
+    int64_t sampling_period_ns = 0; // Sampling period in nanoseconds; overrides sampling_rate_ms when set
+    int timer_spin_us = 0;        // Busy-wait this long before each deadline instead of sleeping
+    ThreadPolicy simulator_thread; // Scheduling of the SensorSimulator thread
+    ThreadPolicy processor_thread; // Scheduling of the DataProcessor thread
+    ThreadPolicy output_thread;    // Scheduling of the OutputHandler thread
     int moving_avg_window = 10;   // Number of samples in moving average window (default: 10)
+    std::vector<std::string> filters; // CHANNEL=SPEC filter bank assignments (see filter_bank.hpp)
+    double output_rate_hz = 0.0;  // Messages per second after decimation (0 = one per sample)
+    std::vector<std::string> detectors; // [CHANNEL=]SPEC anomaly checks of the raw readings (see anomaly_detector.hpp)
+    RandomEngine random_engine = RandomEngine::STD; // Generator behind the simulated readings
+    uint64_t random_seed = 0;     // Fixed seed for reproducible readings (0 = seed from the OS)
+    std::vector<int> aggregate_windows_ms = {1000, 10000, 60000}; // Statistics windows (empty = off)
+    int windows_every_ms = 0;     // Period of window reports (0 = the shortest window)
+    BufferType buffer_type = BufferType::SPSC;  // Sample buffer used by SensorSimulator
+    OverflowPolicy sample_overflow = OverflowPolicy::DROP_NEWEST; // Simulator -> processor buffer
+    OverflowPolicy ipc_overflow = OverflowPolicy::DROP_NEWEST;    // Processor backlog while the transport is full
+    OverflowPolicy output_overflow = OverflowPolicy::DROP_NEWEST; // Formatted records while every output chunk is queued
+    int overflow_block_us = 1000; // Longest wait of a BLOCK stage before it drops the item after all
+    size_t ipc_backlog = 64;      // Messages DataProcessor holds while the transport is full
+    WakeupMode wakeup_mode = WakeupMode::EVENT; // Polling or event-driven pipeline threads
+    int wait_timeout_ms = 100;    // Longest blocking wait before re-checking for shutdown
+    OutputFormat output_format = OutputFormat::PRETTY; // Layout of OutputHandler's stdout
+    IPCBackend ipc_backend = IPCBackend::MQUEUE; // Transport between processor and output
+    int ipc_batch_size = 1;       // Messages coalesced per mq_send (1 disables batching)
+    int ipc_flush_us = 1000;      // Longest time a message may wait in a partial batch
+    bool compress = false;        // Compressed IPC frames and binary output (see telemetry_codec.hpp)
+    std::vector<std::string> precision; // CHANNEL=STEP quantization of compressed values (default lossless)
+    PipelineRole role = PipelineRole::ALL; // Stages this process runs
+    std::shared_ptr<const ChannelRegistry> channel_registry; // Runtime channels; null = fixed SENSORS fast path
+    int block_size = 1;           // Samples per SampleBlock in registry mode
+    int processing_threads = 1;   // Threads sharing the registry mode channel math (1 = processor thread only)
+    std::shared_ptr<LatencyStats> latency_stats; // Stage latency histograms; null = not recorded
+    std::string metrics_socket;   // Unix socket answering with Prometheus text metrics (empty = off)
+    std::string metrics_file;     // File rewritten with Prometheus text metrics (empty = off)
+    int metrics_interval_ms = 1000; // Rate window and metrics file rewrite period
+    double store_seconds = 0.0;   // Raw history kept by the in-memory time-series store (0 = off)
+    std::string record_dir;       // Flight recorder directory for raw readings (empty = off)
+    bool record_messages = false; // Also record every MQMessage DataProcessor sends
+    size_t record_segment_bytes = 64 << 20; // Preallocated size of each recorder segment file
+    std::string replay_dir;       // Replay this recording instead of simulating (empty = simulate)
+    double replay_speed = 1.0;    // 1 = original pacing, N = N times faster, 0 = as fast as possible
 };
 
+// SamplingPeriod: Effective sampling period, nanosecond setting first
+inline std::chrono::nanoseconds samplingPeriod(const Config& config) {
+    if (config.sampling_period_ns > 0) {
+        return std::chrono::nanoseconds(config.sampling_period_ns);
+    }
+    return std::chrono::milliseconds(config.sampling_rate_ms);
+}
+
+// SamplingRateHz: Readings per second, from the effective sampling period
+inline double samplingRateHz(const Config& config) {
+    return 1e9 / static_cast<double>(samplingPeriod(config).count());
+}
+
 // Error codes for system operations
 enum class ErrorCode {
     SUCCESS = 0,           // Operation completed successfully
     QUEUE_OPEN_ERROR,      // Failed to open message queue
+    QUEUE_MSGSIZE_ERROR,   // Frames larger than the system lets a message queue carry
     QUEUE_SEND_ERROR,      // Failed to send message to queue
     QUEUE_RECEIVE_ERROR,   // Failed to receive message from queue
+    SHM_OPEN_ERROR,        // Failed to create or attach shared-memory ring
+    THREAD_POLICY_ERROR,   // Failed to apply real-time priority or CPU affinity
+    RECORDER_ERROR,        // Failed to create, map or extend a flight recorder segment
     BUFFER_FULL,          // Circular buffer is full
     BUFFER_EMPTY          // Circular buffer is empty
 };
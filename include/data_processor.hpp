@@ -1,18 +1,31 @@
 #pragma once
 
 #include "common.hpp"
-#include "sensor_simulator.hpp"
+#include "anomaly_detector.hpp"
+#include "circular_buffer.hpp"
+#include "decimator.hpp"
+#include "filter_bank.hpp"
+#include "sample_source.hpp"
+#include "time_series_store.hpp"
+#include "flight_recorder.hpp"
 #include "ipc_manager.hpp"
+#include "moving_average.hpp"
+#include "window_aggregator.hpp"
+#include "worker_pool.hpp"
 #include <atomic>
+#include <chrono>
+#include <memory>
+#include <ostream>
 #include <thread>
+#include <vector>
 
 namespace sensor {
 
 // DataProcessor class: Processes sensor data using moving average and manages IPC communication
 class DataProcessor {
 public:
-    // Constructor that initializes the processor with config and sensor simulator reference
-    explicit DataProcessor(const Config& config, SensorSimulator& simulator);
+    // Constructor that initializes the processor with config and the source it reads from
+    explicit DataProcessor(const Config& config, SampleSource& source);
     
     // Destructor ensures proper cleanup of resources
     ~DataProcessor();
@@ -31,21 +44,132 @@ public:
     // Stop the data processing and cleanup resources
     void stop();
 
+    // Print filters, decimation, anomaly detection, history store, worker pool and transport statistics (broadcast subscribers);
+    // nothing for a plain single processing thread on a point-to-point transport
+    void report(std::ostream& os) const;
+
+    // Accounting of the IPC stage (messages, or samples in registry mode), and of the
+    // alert path when anomaly detection is on
+    std::vector<StageReport> stages() const;
+
+    // Activity of the processing loop
+    std::vector<LoopReport> loops() const;
+
+    // Frames waiting in the IPC transport and how many it can hold
+    size_t transportDepth() const;
+    size_t transportCapacity() const;
+
+    // Raw and rolled-up history of every channel (null unless Config::store_seconds is
+    // set); safe to query from any thread while processing runs
+    const TimeSeriesStore* store() const;
+
+    // Fold a new reading into the running window and return the updated average per sensor
+    // (called by the processing thread; public so benchmarks can drive it directly)
+    std::array<double, NUM_SENSORS> computeMovingAverage(const SensorData& data);
+
 private:
     // Main processing loop that runs in a separate thread
     void processingLoop();
-    
-    // Compute moving average for each sensor using a window of historical data
-    std::array<double, NUM_SENSORS> computeMovingAverage(const std::vector<SensorData>& window);
+
+    // Registry mode loop: processes SampleBlocks column by column
+    void blockProcessingLoop();
+
+    // Record the queue and processing hops of a reading about to be sent
+    void recordLatency(const StageTimes& stages);
+
+    // Send the statistics of every aggregation window as of the newest reading, once no
+    // backlogged message would arrive after it
+    void sendWindowReport(std::chrono::system_clock::time_point timestamp);
+
+    // Hand a message to the transport, or to the backlog while the transport is full
+    void sendOrQueue(const MQMessage& msg);
+
+    // Send backlogged messages oldest first until the transport is full again
+    void drainBacklog();
+
+    // Send the alerts in m_alerts behind any backlogged ones, backlogging what the
+    // transport refuses; alerts never wait for the message backlog
+    void sendAlerts();
+
+    // Send backlogged alerts oldest first until the transport is full again
+    void drainAlertBacklog();
+
+    // Shutdown: keep draining the alert backlog while the transport takes it, until deadline
+    void drainAlertBacklogUntil(std::chrono::steady_clock::time_point deadline);
+
+    // Registry mode: send a block, waiting for room under the BLOCK policy
+    void sendOutputBlock(SampleBlock& block);
+
+    // Registry mode: check and store the raw block, fold it into the moving average, replace
+    // the filtered channels with their filter outputs, and decimate, sharded across the pool if any
+    void pushBlock(const SampleBlock& block);
 
     // Configuration parameters for the processor
     Config m_config;
     
-    // Reference to the sensor simulator for data acquisition
-    SensorSimulator& m_simulator;
+    // Source of readings: the live simulator or a replayed recording
+    SampleSource& m_source;
     
     // IPC manager for inter-process communication
     IPCManager m_ipc_manager;
+
+    // Messages the transport could not take yet; Config::ipc_overflow applies when it is
+    // full (fixed path only, registry mode never queues blocks)
+    std::unique_ptr<CircularBuffer<MQMessage>> m_backlog;
+
+    // IPC stage accounting, written by the processing thread only
+    std::atomic<uint64_t> m_ipc_produced; // Messages (registry: samples) to send
+    std::atomic<uint64_t> m_ipc_sent;     // Accepted by the transport
+    std::atomic<uint64_t> m_ipc_dropped;  // Refused by the transport outside the backlog
+
+    // Processing loop activity, written by the processing thread only
+    LoopCounters m_loop;
+
+    // Streaming accumulator holding the moving average window
+    MovingAverage m_moving_average;
+
+    // Per-channel FIR/IIR filters replacing the moving average (null = none configured)
+    std::unique_ptr<FilterBank> m_filters;
+
+    // Anti-aliasing decimation to Config::output_rate_hz (null = one message per sample)
+    std::unique_ptr<Decimator> m_decimator;
+
+    // Multi-window min/max/mean/variance (fixed path only; null when no windows are configured)
+    std::unique_ptr<WindowAggregator> m_aggregator;
+    std::vector<int> m_window_ms; // Length of each aggregator window in milliseconds
+    size_t m_report_every;        // Readings between window reports
+    size_t m_report_countdown;    // Readings left until the next report is due
+    bool m_report_due;            // A report waits for the backlog to empty
+
+    // History of the raw readings (null = not kept)
+    std::unique_ptr<TimeSeriesStore> m_store;
+
+    // Checks of the raw readings against their declared mean and stddev (null = off)
+    std::unique_ptr<AnomalyDetector> m_detector;
+    std::vector<AnomalyAlert> m_alerts;                     // Alerts of the current reading or block
+    std::vector<std::vector<AnomalyAlert>> m_shard_alerts;  // Registry mode: alerts of each shard
+    std::unique_ptr<CircularBuffer<AnomalyAlert>> m_alert_backlog; // Alerts the transport could not take yet
+
+    // Alert path accounting, written by the processing thread only
+    std::atomic<uint64_t> m_alerts_raised;  // Alerts the detector raised
+    std::atomic<uint64_t> m_alerts_sent;    // Accepted by the transport
+    std::atomic<uint64_t> m_alerts_dropped; // Refused by the transport outside the backlog
+
+    // Flight recorder for every sent message (null unless Config::record_messages is set)
+    std::unique_ptr<FlightRecorder> m_recorder;
+
+    // Registry mode: per-sample averages of the current block, one column per channel
+    std::unique_ptr<SampleBlock> m_output_block;
+
+    // Registry mode with decimation: the outputs each block completes, sent instead
+    std::unique_ptr<SampleBlock> m_decimated_block;
+
+    // Registry mode: threads sharing the channel math (null = processor thread alone).
+    // Channels are split into m_shards shards of m_shard_channels, a multiple of 8 so no
+    // two shards write to the same cache line of running sums or output columns.
+    std::unique_ptr<WorkerPool> m_pool;
+    size_t m_shard_channels;
+    size_t m_shards;
     
     // Background thread for processing
     std::thread m_thread;
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "common.hpp"
+#include "aligned_allocator.hpp"
+#include "sample_block.hpp"
+#include <vector>
+
+namespace sensor {
+
+// Decimator class: Multi-stage FIR decimation of every channel by a fixed factor, so
+// downstream stages run at the output rate instead of the sampling rate. The factor is
+// split into stages of at most MAX_STAGE_FACTOR (10 kHz -> 10 Hz is 10 x 10 x 10), and
+// each stage low-passes with a Blackman-windowed sinc of TAPS_PER_PHASE taps per unit of
+// its factor whose stopband starts at the stage's output Nyquist frequency, so nothing
+// above it aliases. Like a polyphase decimator, a stage only evaluates its filter for
+// the samples it keeps: one dot product per output, plus two history stores per input.
+// History is mirrored (each value stored twice), so the filter window is always one
+// contiguous run of memory; no allocation happens after construction. The first sample
+// fills every history, so outputs start at the signal's level instead of rising from zero.
+class Decimator {
+public:
+    // Constructor that designs the stages and preallocates their history; throws
+    // std::invalid_argument for zero channels or a zero factor
+    Decimator(size_t channels, size_t factor);
+
+    // Add one sample (one value per channel); writes one value per channel into out and
+    // returns true when this sample completes an output. out may be the values array.
+    bool push(const double* values, double* out);
+
+    // Add every sample of a block, channel by channel. out receives the outputs the block
+    // completes (possibly none), each stamped with the timestamp of the input sample that
+    // completed it; out's capacity must be at least maxOutputs(in.length()).
+    void pushBlock(const SampleBlock& in, SampleBlock& out);
+
+    // pushBlock() in two parts for sharded processing, as in MovingAverage: pushChannels()
+    // filters channels [first, last) only and may run concurrently on disjoint ranges;
+    // commitBlock() then advances the shared stage state and fills in out's length,
+    // sequence, stages and timestamps
+    void pushChannels(const SampleBlock& in, SampleBlock& out, size_t first, size_t last);
+    void commitBlock(const SampleBlock& in, SampleBlock& out);
+
+    // Discard all history; the next sample primes the filters again
+    void reset();
+
+    // Most outputs a block of length input samples can complete
+    size_t maxOutputs(size_t length) const;
+
+    // State query functions
+    size_t channels() const;              // Number of channels filtered
+    size_t factor() const;                // Input samples per output sample
+    size_t stageCount() const;            // Number of cascaded stages
+    size_t stageFactor(size_t stage) const; // Decimation factor of one stage
+    size_t stageTaps(size_t stage) const;   // Filter length of one stage
+    double delay() const;                 // Group delay in input samples
+
+private:
+    // One decimate-by-factor FIR stage; pos and phase are shared by every channel
+    struct Stage {
+        size_t factor;                                    // Inputs per output
+        size_t taps;                                      // Filter length
+        std::vector<double, AlignedAllocator<double>> coeffs;  // Unity-gain low-pass, oldest input first
+        std::vector<double, AlignedAllocator<double>> history; // Mirrored history: [channel * 2 * taps + slot]
+        size_t pos;                                       // Next history slot to write
+        size_t phase;                                     // Inputs since the last output
+    };
+
+    // Run length samples of one channel through every stage, starting from the committed
+    // stage state; returns the number of outputs written to out
+    size_t filterChannel(size_t channel, const double* in, size_t length, double* out);
+
+    // Advance every stage's shared state by length input samples
+    void advance(size_t length);
+
+    // Largest factor a single stage takes when the total factor can be split
+    static constexpr size_t MAX_STAGE_FACTOR = 10;
+
+    // Filter length per unit of stage factor; longer filters narrow the transition band
+    static constexpr size_t TAPS_PER_PHASE = 16;
+
+    size_t m_channels;           // Number of channels filtered
+    size_t m_factor;             // Product of the stage factors
+    std::vector<Stage> m_stages; // Cascade, highest rate first
+    size_t m_phase;              // Input samples since the last final output
+    bool m_primed;               // Whether histories hold real samples yet
+};
+
+} // namespace sensor
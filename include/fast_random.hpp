@@ -0,0 +1,72 @@
+#pragma once
+
+#include "common.hpp"
+
+namespace sensor {
+
+// Xoshiro256pp class: xoshiro256++ pseudo-random generator (Blackman & Vigna). 256 bits
+// of state, period 2^256 - 1, a handful of adds, shifts and rotates per 64-bit output.
+// Not cryptographic. Satisfies UniformRandomBitGenerator, so it also drives std
+// distributions.
+class Xoshiro256pp {
+public:
+    using result_type = uint64_t;
+
+    // Constructor that expands a 64-bit seed into the full state with splitmix64
+    explicit Xoshiro256pp(uint64_t seed);
+
+    // Next 64 random bits
+    uint64_t operator()() {
+        const uint64_t result = rotl(m_state[0] + m_state[3], 23) + m_state[0];
+        const uint64_t t = m_state[1] << 17;
+        m_state[2] ^= m_state[0];
+        m_state[3] ^= m_state[1];
+        m_state[1] ^= m_state[2];
+        m_state[0] ^= m_state[3];
+        m_state[2] ^= t;
+        m_state[3] = rotl(m_state[3], 45);
+        return result;
+    }
+
+    // Range of operator()
+    static constexpr uint64_t min() { return 0; }
+    static constexpr uint64_t max() { return ~uint64_t{0}; }
+
+private:
+    static uint64_t rotl(uint64_t x, int k) {
+        return (x << k) | (x >> (64 - k));
+    }
+
+    uint64_t m_state[4];  // Generator state; never all zero
+};
+
+// NormalSampler class: Standard normal variates from a 128-layer ziggurat (Marsaglia &
+// Tsang, with Doornik's correction) over xoshiro256++. About 99% of draws take one random
+// word, one table lookup and one multiply with no transcendental call; only the wedges
+// and the tail fall back to exp/log. fill() writes whole blocks at a time. The same seed
+// always yields the same sequence on every platform with IEEE doubles.
+class NormalSampler {
+public:
+    // Constructor that seeds the underlying generator
+    explicit NormalSampler(uint64_t seed);
+
+    // One standard normal variate
+    double operator()();
+
+    // Write n standard normal variates to out
+    void fill(double* out, size_t n);
+
+    // Write n variates of N(mean, stddev^2) to out
+    void fill(double* out, size_t n, double mean, double stddev);
+
+private:
+    // Slow path for draws outside the rectangle of their layer
+    double sampleSlow(int64_t bits, size_t layer);
+
+    Xoshiro256pp m_rng;  // Source of uniform bits
+};
+
+// Seed for a generator: Config::random_seed if set, otherwise a fresh nondeterministic value
+uint64_t randomSeed(const Config& config);
+
+} // namespace sensor
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "common.hpp"
+#include "aligned_allocator.hpp"
+#include "channel_registry.hpp"
+#include "filter_design.hpp"
+#include "sample_block.hpp"
+#include "stats_kernels.hpp"
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace sensor {
+
+// Structure of the filter one channel runs
+enum class FilterKind {
+    FIR,     // Finite impulse response: weighted sum of the last taps inputs
+    BIQUAD   // Cascade of second-order IIR sections
+};
+
+// One filter design, parsed from a --filter specification
+struct FilterSpec {
+    FilterKind kind;                // FIR or BIQUAD
+    std::vector<double> taps;       // FIR: h[0] (newest input) first
+    std::vector<Biquad> sections;   // BIQUAD: applied in order
+    std::string text;               // Specification as written, for reports
+};
+
+// Parse a filter specification, cutoffs in Hz at the given sampling rate:
+//   fir:TAPS:CUTOFF_HZ          windowed-sinc low-pass
+//   fir-file:PATH               taps loaded from a file (see loadTaps)
+//   butterworth:ORDER:CUTOFF_HZ Butterworth low-pass as biquads
+//   biquad:B0,B1,B2,A1,A2[/...] explicit sections, a0 = 1
+// Throws std::invalid_argument for a malformed specification.
+FilterSpec parseFilterSpec(const std::string& spec, double sample_rate_hz);
+
+// FilterBank class: Per-channel FIR and biquad IIR filters, as an alternative to the moving
+// average for the channels that need a real low-pass. Channels sharing a design are
+// processed together as lanes of a group (at most MAX_LANES per group): samples are
+// staged lane-interleaved, so every filter step is one loop across lanes over contiguous
+// state, run by SSE2/AVX2/AVX-512 kernels picked like the statistics kernels, even though
+// an IIR is serial in time. Groups are independent and may run concurrently. Each
+// filter's state starts from the steady state of the first sample, so outputs do not ramp
+// up from zero.
+class FilterBank {
+public:
+    // Constructor that assigns filters to channels. Each assignment is NAME=SPEC, where
+    // NAME is a channel name, a prefix ending in '*', or '*' for every channel, and SPEC
+    // is a parseFilterSpec() specification or "none"; later assignments win. block is the
+    // longest block pushBlock() will see. Throws std::invalid_argument for a malformed
+    // assignment or a pattern that matches no channel.
+    FilterBank(const ChannelRegistry& channels, const std::vector<std::string>& assignments,
+               double sample_rate_hz, size_t block);
+
+    // Filter one sample: reads values[ch] and overwrites out[ch] for filtered channels only
+    void push(const double* values, double* out);
+
+    // Filter a block: writes the columns of filtered channels in out, samples [0, in.length())
+    void pushBlock(const SampleBlock& in, SampleBlock& out);
+
+    // pushBlock() for one group only; distinct groups may run concurrently
+    void pushGroup(const SampleBlock& in, SampleBlock& out, size_t group);
+
+    // Print one line per design: specification and the number of channels running it
+    void report(std::ostream& os) const;
+
+    // Run the lane kernels of one instruction-set level, clamped to what the CPU supports
+    // as in statsKernels(level); the best level runs unless this is called
+    void setSimdLevel(SimdLevel level);
+
+    // State query functions
+    size_t groupCount() const;        // Independent lane groups
+    size_t filteredChannels() const;  // Channels with a filter
+    bool filters(size_t channel) const; // Whether channel has a filter (pushBlock() writes its column)
+    SimdLevel simdLevel() const;      // Level of the lane kernels
+
+private:
+    // Channels running one design, filtered side by side
+    struct Group {
+        size_t design;                 // Index into m_designs
+        std::vector<size_t> channels;  // Channel of each lane
+        size_t lanes;                  // channels.size()
+        // FIR: mirrored history [slot * lanes + lane], 2 * taps slots;
+        // BIQUAD: [(section * 2 + z) * lanes + lane], transposed direct form II
+        std::vector<double, AlignedAllocator<double>> state;
+        std::vector<double, AlignedAllocator<double>> rows; // Staging [sample * lanes + lane], filtered in place
+        size_t pos;                    // FIR: next history slot
+        bool primed;                   // Whether state holds real samples yet
+    };
+
+    // Run length staged rows of a group through its filter
+    void filter(Group& group, size_t length);
+
+    // Set a group's state to the steady state of its first staged row
+    void prime(Group& group);
+
+    // Most channels processed side by side in one group
+    static constexpr size_t MAX_LANES = 64;
+
+    std::vector<FilterSpec> m_designs;  // Distinct designs in assignment order
+    std::vector<std::vector<double, AlignedAllocator<double>>> m_coeffs; // FIR taps per design, oldest input first
+    std::vector<Group> m_groups;        // Lane groups, design by design
+    size_t m_filtered;                  // Channels with a filter
+    SimdLevel m_level;                  // Lane kernel level
+};
+
+} // namespace sensor
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace sensor {
+
+// One second-order IIR section, normalized so a0 = 1:
+// y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+struct Biquad {
+    double b0, b1, b2;  // Feed-forward coefficients
+    double a1, a2;      // Feedback coefficients
+};
+
+// Blackman-windowed sinc low-pass with unity gain at DC. cutoff is the -6 dB point in
+// cycles per sample (0 < cutoff < 0.5); the transition band is about 5.5 / taps wide.
+// Coefficients are symmetric, so their order does not matter.
+std::vector<double> windowedSincLowPass(size_t taps, double cutoff);
+
+// Butterworth low-pass of the given order as a cascade of biquads, designed with the
+// bilinear transform prewarped to cutoff (the -3 dB point, cycles per sample). An odd
+// order adds one first-order section (b2 = a2 = 0). Throws std::invalid_argument for
+// order < 1 or a cutoff outside (0, 0.5).
+std::vector<Biquad> butterworthLowPass(int order, double cutoff);
+
+// Load FIR taps from a text file, h[0] (weight of the newest input) first: numbers
+// separated by whitespace or commas, '#' starts a comment. Throws std::runtime_error if
+// the file cannot be read, holds a non-number or holds no taps.
+std::vector<double> loadTaps(const std::string& path);
+
+} // namespace sensor
@@ -0,0 +1,145 @@
+#pragma once
+
+#include "common.hpp"
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace sensor {
+
+// Kinds of record a flight recording stream can hold
+enum class RecordType : uint32_t {
+    SENSOR_DATA = 1,  // SensorData written by SensorSimulator
+    MQ_MESSAGE = 2    // MQMessage written by DataProcessor
+};
+
+// One entry of a stream's index file, at offset segment * sizeof(SegmentIndexEntry)
+struct SegmentIndexEntry {
+    uint32_t segment;      // Segment number (file <stream>_<segment>.seg)
+    uint32_t record_type;  // RecordType of every record in the segment
+    uint64_t count;        // Records in the segment when it was sealed (0 while open)
+    int64_t first_ns;      // Wall-clock time of the first record, ns since the epoch
+    int64_t last_ns;       // Wall-clock time of the last record, ns since the epoch
+};
+
+// Header at the start of every segment file (layout in flight_recorder.cpp)
+struct SegmentHeader;
+
+// FlightRecorder class: Append-only binary recorder for one stream of fixed-size
+// records. Records are copied straight into preallocated, memory-mapped segment files
+// (<directory>/<stream>_NNNNNN.seg), so an append is a memcpy and a counter store with
+// no syscall. The per-segment record count lives in the mapped header, so a crash
+// loses at most the record being written. Full segments are trimmed, unmapped and
+// listed in <directory>/<stream>.idx with their record count and time range.
+// Recording into an existing directory continues after the highest segment number.
+class FlightRecorder {
+public:
+    // Constructor that creates the directory if needed and opens the first segment
+    FlightRecorder(const std::string& directory, const std::string& stream, RecordType type,
+                   size_t segment_bytes);
+
+    // Destructor seals the open segment
+    ~FlightRecorder();
+
+    // Big 5: owns a mapping and file descriptors
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+    FlightRecorder(FlightRecorder&&) = delete;
+    FlightRecorder& operator=(FlightRecorder&&) = delete;
+
+    // Append one record; after a failure the recorder stays disabled and says so once on stderr
+    ErrorCode append(const SensorData& data);
+    ErrorCode append(const MQMessage& msg);
+
+    // State query functions
+    uint64_t recordCount() const;  // Records appended by this recorder
+    uint32_t segmentCount() const; // Segments opened by this recorder
+
+    // Bytes of each record of the given type
+    static size_t recordSize(RecordType type);
+
+private:
+    // Copy a record of m_record_size bytes into the open segment, rolling over when full
+    ErrorCode appendRecord(const void* record, int64_t timestamp_ns);
+
+    // Create, preallocate and map the next segment file
+    ErrorCode openSegment();
+
+    // Trim the open segment to its used size, unmap it and update its index entry
+    void sealSegment();
+
+    // Write one index entry at its fixed offset
+    void writeIndexEntry(const SegmentIndexEntry& entry);
+
+    std::string m_directory;    // Recording directory
+    std::string m_stream;       // File name prefix of this stream
+    RecordType m_type;          // Record type written
+    size_t m_record_size;       // Bytes per record
+    size_t m_capacity;          // Records per segment
+    int m_index_fd;             // Open index file
+    int m_segment_fd;           // Open segment file (-1 when none)
+    SegmentHeader* m_header;    // Mapped segment (nullptr when none)
+    size_t m_mapped_bytes;      // Size of the mapping
+    char* m_records;            // First record slot in the mapping
+    uint32_t m_segment;         // Number of the open segment
+    uint64_t m_count;           // Records in the open segment
+    uint64_t m_total;           // Records appended since construction
+    uint32_t m_segments_opened; // Segments created since construction
+    bool m_failed;              // Set after the first error; later appends are dropped
+};
+
+// FlightReader class: Sequential reader over every segment of one recorded stream,
+// in segment order. Segments are mapped read-only one at a time and records are
+// returned in place; the record count in each segment header is authoritative, so a
+// recording cut short by a crash reads back up to its last complete record.
+class FlightReader {
+public:
+    // Constructor that finds the stream's segments; throws if there are none
+    FlightReader(const std::string& directory, const std::string& stream, RecordType type);
+
+    // Destructor unmaps the current segment
+    ~FlightReader();
+
+    // Big 5: owns a mapping
+    FlightReader(const FlightReader&) = delete;
+    FlightReader& operator=(const FlightReader&) = delete;
+    FlightReader(FlightReader&&) = delete;
+    FlightReader& operator=(FlightReader&&) = delete;
+
+    // Pointer to the next record (valid until the next call), nullptr at the end
+    const void* next();
+
+    // Typed helpers around next() for the matching stream type
+    std::optional<SensorData> nextSensorData();
+    std::optional<MQMessage> nextMessage();
+
+    // Progress
+    uint64_t position() const;      // Records returned so far
+    uint64_t totalRecords() const;  // Records in all segments
+
+    // Segments in read order, built from the segment headers
+    const std::vector<SegmentIndexEntry>& segments() const;
+
+private:
+    // Map segment m_segments[which], returns false if it cannot be used
+    bool mapSegment(size_t which);
+
+    // Unmap the current segment
+    void unmapSegment();
+
+    std::string m_directory;              // Recording directory
+    std::string m_stream;                 // File name prefix of the stream
+    RecordType m_type;                    // Expected record type
+    size_t m_record_size;                 // Bytes per record
+    std::vector<SegmentIndexEntry> m_segments; // Segments with their actual record counts
+    size_t m_current;                     // Index into m_segments of the mapped segment
+    void* m_mapping;                      // Current mapping (nullptr when none)
+    size_t m_mapped_bytes;                // Size of the current mapping
+    const char* m_records;                // First record in the current mapping
+    uint64_t m_segment_count;             // Records in the current segment
+    uint64_t m_next;                      // Next record within the current segment
+    uint64_t m_position;                  // Records returned so far
+    uint64_t m_total;                     // Records in all segments
+};
+
+} // namespace sensor
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "common.hpp"
+#include "shm_ring.hpp"
+#include "stage_counters.hpp"
+#include <chrono>
+#include <memory>
+#include <optional>
+
+namespace sensor {
+
+// IngestRing class: Raw readings crossing from an acquisition process to a processing
+// process through a shared-memory ShmRing (INGEST_NAME). It has the same push/pop
+// interface as SpscRingBuffer<SensorData>, so SensorSimulator writes into it as its
+// sample buffer and IngestSource reads from it: each reading is copied once into its slot
+// and once out of it, exactly as with the in-process ring. Either process may start
+// first or be restarted while the other keeps running; positions and stage counters live
+// in the segment. Like SpscRingBuffer, only DROP_NEWEST and BLOCK are supported.
+class IngestRing {
+public:
+    // Constructor that joins or creates the segment; throws std::runtime_error if that
+    // fails and std::invalid_argument for policies that would evict queued readings
+    IngestRing(OverflowPolicy policy, std::chrono::microseconds block_timeout);
+
+    // Big 5: owns the mapping
+    IngestRing(const IngestRing&) = delete;
+    IngestRing& operator=(const IngestRing&) = delete;
+    IngestRing(IngestRing&&) = delete;
+    IngestRing& operator=(IngestRing&&) = delete;
+    ~IngestRing() = default;
+
+    // Publish a reading (acquisition process), returns false if it was dropped
+    bool push(const SensorData& item);
+
+    // Take the oldest reading (processing process)
+    std::optional<SensorData> pop();
+
+    // Block until a reading is available or timeout expires, then take it
+    std::optional<SensorData> waitPop(std::chrono::microseconds timeout);
+
+    // Ring state and accounting, identical in both processes
+    bool empty() const;       // No readings pending
+    size_t capacity() const;  // Slots in the ring
+    OverflowPolicy policy() const;
+    StageCounters counters() const;
+
+private:
+    std::unique_ptr<ShmRing> m_ring;                   // Shared segment
+    const OverflowPolicy m_policy;                     // DROP_NEWEST or BLOCK
+    const std::chrono::microseconds m_block_timeout;   // Longest wait of a BLOCK push
+
+    // Slots in the segment: about 200 ms at 20 kHz, so a processing restart loses nothing
+    static constexpr size_t INGEST_SLOTS = 4096;
+
+    // Pushes between samples of the ring depth for the high-water mark
+    static constexpr uint64_t DEPTH_SAMPLE_INTERVAL = 64;
+};
+
+} // namespace sensor
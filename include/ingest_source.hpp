@@ -0,0 +1,44 @@
+#pragma once
+
+#include "common.hpp"
+#include "ingest_ring.hpp"
+#include "sample_source.hpp"
+
+namespace sensor {
+
+// IngestSource class: Feeds DataProcessor from the shared-memory ingest ring that an
+// acquisition process (--role acquire) fills, in place of an in-process simulator.
+// There is no thread of its own: the processing thread reads the ring directly.
+class IngestSource : public SampleSource {
+public:
+    // Constructor that joins the ingest ring; throws like IngestRing
+    explicit IngestSource(const Config& config);
+
+    // Big 5: owns the ring mapping
+    IngestSource(const IngestSource&) = delete;
+    IngestSource& operator=(const IngestSource&) = delete;
+    IngestSource(IngestSource&&) = delete;
+    IngestSource& operator=(IngestSource&&) = delete;
+    ~IngestSource() override = default;
+
+    // Nothing to start or stop: the acquisition process produces on its own schedule
+    void start() override {}
+    void stop() override {}
+
+    // Take the oldest reading from the ring, returns empty optional if none is pending
+    std::optional<SensorData> getLatestData() override;
+
+    // Block until the acquisition process publishes a reading or timeout expires
+    std::optional<SensorData> waitForData(std::chrono::microseconds timeout) override;
+
+    // Print the ring state
+    void report(std::ostream& os) const override;
+
+    // Accounting of the ingest ring, shared with the acquisition process
+    std::vector<StageReport> stages() const override;
+
+private:
+    IngestRing m_ring; // Readings published by the acquisition process
+};
+
+} // namespace sensor
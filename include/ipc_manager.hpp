@@ -1,13 +1,78 @@
 #pragma once
 
 #include "common.hpp"
+#include "anomaly_detector.hpp"
+#include "shm_ring.hpp"
+#include "broadcast_ring.hpp"
+#include "sample_block.hpp"
+#include "telemetry_codec.hpp"
 #include <fcntl.h>
 #include <sys/stat.h>
+#include <chrono>
+#include <memory>
 #include <optional>
+#include <ostream>
+#include <vector>
 
 namespace sensor {
 
+// Header at the start of a batched queue message; count MQMessages follow it
+struct MQBatchHeader {
+    uint32_t magic;  // BATCH_MAGIC, distinguishes frames from legacy single messages
+    uint32_t count;  // Number of MQMessages in the frame
+};
+
+// Header of a registry-mode block frame; timestamps[length] and then channels
+// columns of length doubles (structure-of-arrays) follow it
+struct BlockFrameHeader {
+    uint32_t magic;         // BLOCK_MAGIC
+    uint32_t channels;      // Number of columns
+    uint32_t length;        // Samples per column
+    uint32_t reserved;      // Keeps the payload 8-byte aligned
+    uint64_t first_msg_id;  // Message id of sample 0
+    StageTimes stages;      // Stage stamps of the newest sample
+};
+
+// Header of an alert frame; count AnomalyAlerts follow it
+struct AlertFrameHeader {
+    uint32_t magic;  // ALERT_MAGIC
+    uint32_t count;  // Number of AnomalyAlerts in the frame
+};
+
+// Header of a window report frame; count WindowReports follow it
+struct WindowFrameHeader {
+    uint32_t magic;  // WINDOW_MAGIC
+    uint32_t count;  // Number of WindowReports in the frame
+};
+
+// Read-only view over a received block frame, valid until the next receive call
+struct BlockView {
+    uint64_t first_msg_id = 0;  // Message id of sample 0
+    size_t channels = 0;        // Number of columns
+    size_t length = 0;          // Samples per column
+    StageTimes stages;          // Stage stamps of the newest sample
+    const std::chrono::system_clock::time_point* timestamps = nullptr; // One per sample
+    const double* values = nullptr; // Column-major values
+
+    const double* column(size_t channel) const { return values + channel * length; }
+};
+
+// Read-only view over received messages, valid until the next receive call
+struct MessageSpan {
+    const MQMessage* data = nullptr;  // First message
+    size_t size = 0;                  // Number of messages
+
+    const MQMessage* begin() const { return data; }
+    const MQMessage* end() const { return data + size; }
+    bool empty() const { return size == 0; }
+};
+
 // IPCManager class: Manages inter-process communication using POSIX message queues
+// or, when selected, a shared-memory ring or broadcast ring with the same send/receive
+// interface. With compression enabled, batches and blocks travel as telemetry_codec.hpp
+// frames; receivers recognize and unpack them without any configuration. Anomaly alerts
+// skip batching and go out as frames of their own, at a higher message queue priority;
+// window reports also travel as frames of their own, in order with the messages.
 class IPCManager {
 public:
     // Default constructor
@@ -24,26 +89,174 @@ public:
     IPCManager(IPCManager&&) noexcept = default;
     IPCManager& operator=(IPCManager&&) noexcept = default;
 
-    // Initialize the message queue in either sender or receiver mode
-    ErrorCode initialize(bool is_sender);
+    // Largest batch that fits in one MAX_MSG_SIZE queue message
+    static constexpr size_t MAX_BATCH = (MAX_MSG_SIZE - sizeof(MQBatchHeader)) / sizeof(MQMessage);
+
+    // Most messages in one compressed batch frame
+    static constexpr size_t MAX_COMPRESSED_BATCH = 256;
+
+    // Bytes of a window report frame; senders of reports need slots at least this large
+    static constexpr size_t WINDOW_FRAME_BYTES = sizeof(WindowFrameHeader) + sizeof(WindowReport);
+
+    // Bytes needed to send a block of samples x channels with sendBlock()
+    static size_t blockFrameBytes(size_t channels, size_t samples, bool compressed = false);
+
+    // Largest message an unprivileged process may give a queue (fs.mqueue.msgsize_max),
+    // 0 if it cannot be read
+    static size_t queueMessageLimit();
+
+    // Initialize the selected transport in either sender or receiver mode.
+    // frame_bytes raises the per-message size for senders of block frames; a message queue
+    // the system refuses because of it fails with QUEUE_MSGSIZE_ERROR.
+    ErrorCode initialize(bool is_sender, IPCBackend backend = IPCBackend::MQUEUE,
+                         size_t frame_bytes = 0);
     
-    // Send a message to the queue
+    // Coalesce up to max_messages per queue message, flushing partial batches after flush_deadline.
+    // limit receives the messages a frame will actually hold: max_messages clamped to what
+    // fits, or 1 on the shared-memory rings when not compressing.
+    ErrorCode enableBatching(size_t max_messages, std::chrono::microseconds flush_deadline, size_t& limit);
+
+    // Compress batch and block frames, precision holding one entry per channel (0 =
+    // lossless). Batching is enabled on every backend; call enableBatching() afterwards
+    // to set its limit and deadline.
+    ErrorCode enableCompression(const std::vector<double>& precision);
+
+    // Send a message to the queue (appended to the pending batch when batching is enabled)
     ErrorCode sendMessage(const MQMessage& msg);
+
+    // Send the pending batch now, if any
+    ErrorCode flush();
+
+    // Send the pending batch if its oldest message has waited for the flush deadline
+    ErrorCode flushIfDue();
+
+    // Time until the pending batch is due, so callers can bound their waits
+    std::chrono::microseconds flushDelay() const;
+
+    // Sender: wait until the transport has room for another message or timeout expires
+    bool waitWritable(std::chrono::microseconds timeout);
     
     // Receive a message from the queue
     std::optional<MQMessage> receiveMessage();
+
+    // Receive a message, blocking until one arrives or timeout expires
+    std::optional<MQMessage> receiveMessage(std::chrono::milliseconds timeout);
+
+    // Send alerts ahead of everything batched or backlogged: as their own uncompressed
+    // frames, at ALERT_PRIORITY on the message queue so they overtake queued messages.
+    // sent reports how many went out; BUFFER_FULL leaves the rest to retry.
+    ErrorCode sendAlerts(const AnomalyAlert* alerts, size_t count, size_t& sent);
+
+    // Move the alerts received so far into out (replacing its contents); every receive
+    // call picks up alert frames on the way, so check after each one
+    size_t takeAlerts(std::vector<AnomalyAlert>& out);
+
+    // Send a window report behind every message handed over so far (the pending batch is
+    // flushed first), uncompressed and in a frame of its own
+    ErrorCode sendWindows(const WindowReport& report);
+
+    // Move the window reports received so far into out (replacing its contents); like
+    // alerts, they are picked up by every receive call on the way
+    size_t takeWindows(std::vector<WindowReport>& out);
+
+    // Send every sample of a block as one structure-of-arrays frame
+    ErrorCode sendBlock(const SampleBlock& block);
+
+    // Receive the next block frame without copying it out
+    std::optional<BlockView> receiveBlock();
+
+    // Receive the next block frame, blocking until one arrives or timeout expires
+    std::optional<BlockView> receiveBlock(std::chrono::milliseconds timeout);
+
+    // Receive all messages of the next frame without copying them out
+    MessageSpan receiveBatch();
+
+    // Receive the next frame, blocking until one arrives or timeout expires
+    MessageSpan receiveBatch(std::chrono::milliseconds timeout);
+    
+    // Messages this receiver lost to overwrites (broadcast subscribers only)
+    uint64_t lostMessages() const;
+
+    // Frames waiting in the transport: queued messages, unread ring slots, or the lag of
+    // the slowest broadcast subscriber (0 when unknown); safe to call from any thread
+    size_t queueDepth() const;
+
+    // Frames the transport can hold before sends are refused (broadcast: one ring lap)
+    size_t queueCapacity() const;
+
+    // Sender: print the compression ratio, and for broadcast every subscriber's progress
+    // and slow flags
+    void report(std::ostream& os) const;
     
     // Clean up resources and close the message queue
     void cleanup();
 
 private:
+    // Send one frame on the selected transport, mapping a full queue or ring to BUFFER_FULL;
+    // priority orders message queue frames and is ignored by the rings
+    ErrorCode sendFrame(const char* data, size_t len, unsigned priority = 0);
+
+    // Copy the next queue message or shared-memory slot into m_rx_frame, returns its length
+    size_t fetchSlot();
+
+    // fetchSlot(), setting alert and window frames aside until another frame arrives
+    size_t fetchRaw();
+
+    // Fetch and decode the next message or batch frame
+    bool fetchFrame();
+
+    // Block until the transport has something to fetch or timeout expires
+    bool waitReadable(std::chrono::milliseconds timeout);
+
+    // Hand out the unconsumed remainder of the receive frame
+    MessageSpan takePending();
+
     mqd_t m_queue;           // Message queue descriptor
+    std::unique_ptr<ShmRing> m_shm; // Shared-memory ring (SHM backend only)
+    std::unique_ptr<BroadcastRing> m_broadcast; // Broadcast ring (BROADCAST backend only)
+    IPCBackend m_backend;    // Transport selected at initialization
     bool m_is_initialized;    // Flag indicating if queue is initialized
     bool m_is_sender;        // Flag indicating if this instance is a sender
+
+    // Sender-side batching state
+    std::vector<char> m_tx_frame;   // Preallocated frame: header followed by pending messages
+    size_t m_tx_count;              // Messages pending in m_tx_frame
+    size_t m_batch_limit;           // Messages per frame (1 = batching disabled)
+    std::chrono::microseconds m_flush_deadline;           // Longest wait for a partial batch
+    std::chrono::steady_clock::time_point m_tx_first;     // When the oldest pending message arrived
+    size_t m_tx_capacity;           // Bytes one frame may use on the transport
+
+    // Sender-side compression state (null = frames are sent raw)
+    std::unique_ptr<MessageCodec> m_tx_codec;   // Packs pending messages into m_tx_frame
+    std::unique_ptr<BlockCodec> m_tx_blocks;    // Packs blocks into m_tx_frame
+    uint64_t m_coded_frames;        // Frames sent with compression enabled
+    uint64_t m_raw_bytes;           // Bytes the compressed frames would have taken raw
+    uint64_t m_coded_bytes;         // Bytes of the compressed frames sent
+    std::vector<char> m_alert_frame; // Preallocated alert frame, apart from the pending batch
+
+    // Receiver-side frame state
+    std::vector<char> m_rx_frame;   // Last received frame
+    const MQMessage* m_rx_data;     // First message in m_rx_frame
+    size_t m_rx_count;              // Messages in m_rx_frame
+    size_t m_rx_next;               // Next message not yet handed out
+    MessageCodec m_rx_codec;        // Unpacks compressed batch frames
+    BlockCodec m_rx_block_codec;    // Unpacks compressed block frames
+    std::vector<MQMessage> m_rx_messages; // Messages of the last compressed batch frame
+    DecodedBlock m_rx_block;        // Last compressed block frame
+    std::vector<AnomalyAlert> m_rx_alerts; // Alerts received and not yet taken
+    std::vector<WindowReport> m_rx_windows; // Window reports received and not yet taken
     
     // Message queue configuration constants
     static constexpr mode_t QUEUE_PERMISSIONS = 0660;  // rw-rw----
     static constexpr int MAX_MESSAGES = 10;           // Maximum messages in queue
+    static constexpr size_t SHM_SLOTS = 1024;         // Messages in the shared-memory ring
+    static constexpr size_t BROADCAST_SLOTS = 4096;   // Messages in the broadcast ring; a lap is the slack a subscriber gets
+    static constexpr size_t SHM_RING_BYTES = 16 << 20;  // Upper bound for large-slot rings
+    static constexpr uint32_t BATCH_MAGIC = 0x42415443; // "BATC"
+    static constexpr uint32_t BLOCK_MAGIC = 0x424c4f4b; // "BLOK"
+    static constexpr uint32_t ALERT_MAGIC = 0x414c5254; // "ALRT"
+    static constexpr uint32_t WINDOW_MAGIC = 0x57494e44; // "WIND"
+    static constexpr unsigned ALERT_PRIORITY = 1;       // mq_send priority of alert frames (messages use 0)
 };
 
 } // namespace sensor 
\ No newline at end of file
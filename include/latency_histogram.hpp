@@ -0,0 +1,97 @@
+#pragma once
+
+#include "common.hpp"
+#include <array>
+#include <atomic>
+#include <ostream>
+
+namespace sensor {
+
+// LatencyHistogram class: Lock-free log-linear (HDR-style) histogram of nanosecond
+// durations. Each power of two is split into SUB_BUCKETS linear buckets, so any
+// recorded value is reported within 1/SUB_BUCKETS (about 3%) of its true value,
+// from 1 ns up to the full 64-bit range, in fixed memory. record() is a handful of
+// relaxed atomic adds and may run concurrently with summarize() from another thread.
+class LatencyHistogram {
+public:
+    // Percentiles and totals of everything recorded so far
+    struct Summary {
+        uint64_t count = 0;  // Values recorded
+        double mean = 0.0;   // Arithmetic mean in ns
+        uint64_t p50 = 0;    // Median in ns
+        uint64_t p99 = 0;    // 99th percentile in ns
+        uint64_t p999 = 0;   // 99.9th percentile in ns
+        uint64_t max = 0;    // Largest value in ns (exact)
+    };
+
+    // Constructor that starts with every bucket empty
+    LatencyHistogram();
+
+    // Big 5: atomics are neither copyable nor movable
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+    LatencyHistogram(LatencyHistogram&&) = delete;
+    LatencyHistogram& operator=(LatencyHistogram&&) = delete;
+    ~LatencyHistogram() = default;
+
+    // Add one duration; wait-free apart from a rarely retried max update
+    void record(uint64_t ns);
+
+    // Snapshot the buckets and compute percentiles (consistent to within concurrent records)
+    Summary summarize() const;
+
+    // Discard everything recorded so far
+    void reset();
+
+    // Bucket holding value, and the largest value that maps to a bucket
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t bucketUpperBound(size_t index);
+
+    // Linear buckets per power of two
+    static constexpr unsigned SUB_BUCKET_BITS = 5;
+    static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+
+    // Enough buckets for any 64-bit value
+    static constexpr size_t BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+private:
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> m_sum;    // Sum of values for the mean
+    std::atomic<uint64_t> m_max;                             // Largest value recorded
+    std::array<std::atomic<uint64_t>, BUCKETS> m_buckets;    // Count per bucket
+};
+
+// Stage-to-stage hops tracked by LatencyStats
+enum class LatencyHop {
+    QUEUE,       // generated -> popped: time spent in the simulator's sample buffer
+    PROCESS,     // popped -> sent: moving average and message assembly
+    IPC,         // sent -> received: batching plus transport
+    OUTPUT,      // received -> printed: formatting and writing to stdout
+    END_TO_END,  // generated -> printed: how stale a displayed value is
+    ALERT,       // generated -> alerted: reading to its anomaly alert on stderr
+    COUNT        // Number of hops
+};
+
+// LatencyStats class: One LatencyHistogram per pipeline hop. Each hop is recorded
+// by a single stage thread, and a report can be printed at any time from another.
+class LatencyStats {
+public:
+    // Record the duration between two monotonic stamps; unstamped (0) or reversed pairs are ignored
+    void record(LatencyHop hop, uint64_t from_ns, uint64_t to_ns);
+
+    // Histogram of one hop
+    const LatencyHistogram& histogram(LatencyHop hop) const;
+
+    // Print count, mean, p50, p99, p99.9 and max per hop in microseconds
+    void report(std::ostream& os) const;
+
+    // Discard every hop's history
+    void reset();
+
+    // Display name of a hop, e.g. "generated->popped"
+    static const char* hopName(LatencyHop hop);
+
+private:
+    std::array<LatencyHistogram, static_cast<size_t>(LatencyHop::COUNT)> m_histograms; // Indexed by hop
+};
+
+} // namespace sensor
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "common.hpp"
+#include "stage_counters.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sensor {
+
+// Everything one metrics export reports, gathered from the running components
+struct MetricsSnapshot {
+    std::vector<StageReport> stages;    // Per-stage accounting; depth is produced - consumed - dropped
+    std::vector<LoopReport> loops;      // Main loop activity per pipeline thread
+    bool has_transport = false;         // Whether the transport fields below were filled in
+    size_t transport_depth = 0;         // Frames waiting in the IPC transport
+    size_t transport_capacity = 0;      // Frames the transport can hold
+    std::shared_ptr<const LatencyStats> latency; // Stage latency histograms (null = not recorded)
+};
+
+// MetricsExporter class: Publishes pipeline metrics in the Prometheus text format while
+// the program runs. A Unix domain socket (Config::metrics_socket) answers every
+// connection with a fresh snapshot, wrapped in an HTTP response when the client sends a
+// GET so `curl --unix-socket` works; a file (Config::metrics_file) is rewritten
+// atomically every interval for node_exporter's textfile collector. The exporter thread
+// only reads counters the pipeline threads already keep in atomics, so collection adds no
+// locks to their loops; rates are computed here from the counter deltas of each interval.
+// When a series handler is given, a GET of /series?QUERY on the socket is answered with
+// its CSV instead (see seriesCsv() in time_series_store.hpp).
+class MetricsExporter {
+public:
+    // Gathers a snapshot; always called on the exporter thread
+    using Collector = std::function<MetricsSnapshot()>;
+
+    // Answers the query string of a /series request; throws std::invalid_argument for a bad one
+    using SeriesHandler = std::function<std::string(const std::string&)>;
+
+    // Constructor that binds the socket, throws std::runtime_error if that fails
+    MetricsExporter(const Config& config, Collector collector, SeriesHandler series = nullptr);
+
+    // Destructor stops the thread and removes the socket
+    ~MetricsExporter();
+
+    // Big 5: owns a thread and a socket
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+    MetricsExporter(MetricsExporter&&) = delete;
+    MetricsExporter& operator=(MetricsExporter&&) = delete;
+
+    // Start and stop the exporter thread; stop() writes the file one last time
+    void start();
+    void stop();
+
+    // Text exposition of a snapshot, with the rates of the last completed interval
+    std::string render(const MetricsSnapshot& snapshot) const;
+
+private:
+    // Items per second offered to one stage over the last interval
+    struct StageRate {
+        std::string stage;      // Stage label
+        uint64_t produced;      // Produced count at the end of the interval
+        double per_second;      // Rate over the interval
+    };
+
+    // Tick every interval and serve socket clients in between
+    void exportLoop();
+
+    // Recompute stage rates from a new snapshot
+    void updateRates(const MetricsSnapshot& snapshot, std::chrono::steady_clock::time_point now);
+
+    // Answer one connected client and close it
+    void serveClient(int fd);
+
+    // Replace the metrics file through a temporary file and rename()
+    void writeFile(const std::string& text);
+
+    Collector m_collector;                  // Source of snapshots
+    SeriesHandler m_series;                 // /series answers (empty = metrics only)
+    std::string m_socket_path;              // Listening socket path (empty = off)
+    std::string m_file_path;                // Rewritten file (empty = off)
+    std::chrono::milliseconds m_interval;   // Rate window and file rewrite period
+    std::chrono::milliseconds m_poll;       // Longest wait before re-checking for shutdown
+    int m_listen_fd;                        // Listening socket, -1 when off
+
+    std::vector<StageRate> m_rates;         // Per-stage rates of the last interval
+    std::chrono::steady_clock::time_point m_last_tick; // End of the last interval
+
+    std::thread m_thread;                   // Exporter thread
+    std::atomic<bool> m_running;            // Thread keeps going while set
+};
+
+} // namespace sensor
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "common.hpp"
+#include "aligned_allocator.hpp"
+#include "sample_block.hpp"
+#include <vector>
+
+namespace sensor {
+
+// MovingAverage class: O(1) per-sample streaming moving average over a fixed window.
+// Keeps a running sum per channel (add newest, subtract evicted) with Neumaier
+// compensated summation, and periodically re-sums the window exactly so rounding
+// error cannot accumulate over long runs. History is stored one contiguous
+// column per channel, so no allocation happens after construction.
+class MovingAverage {
+public:
+    // Constructor that preallocates history for the given channel count and window length
+    MovingAverage(size_t channels, size_t window);
+
+    // Add one sample (one value per channel), evicting the oldest once the window is full
+    void push(const double* values);
+
+    // Add every sample of a block, channel by channel, writing the average after each
+    // sample into the matching slot of out (same channel count, capacity >= input length)
+    void pushBlock(const SampleBlock& in, SampleBlock& out);
+
+    // pushBlock() in two parts for sharded processing: pushChannels() runs the per-channel
+    // kernel on channels [first, last) only and may run concurrently on disjoint ranges;
+    // once every channel has been pushed, commitBlock() advances the shared window
+    // position and fills in the output block's sequence, stages and timestamps. Each
+    // channel's arithmetic is unchanged, so results are bit-identical to pushBlock().
+    void pushChannels(const SampleBlock& in, SampleBlock& out, size_t first, size_t last);
+    void commitBlock(const SampleBlock& in, SampleBlock& out);
+
+    // Leave a channel out of push(), pushBlock() and pushChannels(), for channels whose
+    // output another stage overwrites (a filter); its column in out is not written and
+    // averages() reports zero for it
+    void skipChannel(size_t channel);
+
+    // Write the current average of every channel into out (zeros if no samples yet)
+    void averages(double* out) const;
+
+    // Discard all history and running sums
+    void reset();
+
+    // State query functions
+    size_t channels() const;  // Number of channels tracked
+    size_t window() const;    // Maximum number of samples averaged
+    size_t count() const;     // Number of samples currently in the window
+
+private:
+    // Recompute the running sums of channels [first, last) exactly from the stored history
+    void renormalize(size_t first, size_t last);
+
+    // Whether a block of this many samples completes a renormalization period
+    bool renormalizeDue(size_t length) const;
+
+    // Number of full passes over the window between exact re-summations
+    static constexpr size_t RENORMALIZE_PASSES = 16;
+
+    size_t m_channels;             // Number of channels tracked
+    size_t m_window;               // Window length in samples
+    // Cache-line aligned, so shards of 8 channels never share a line of running sums
+    std::vector<double, AlignedAllocator<double>> m_history; // Channel-major history: [channel * window + slot]
+    std::vector<double, AlignedAllocator<double>> m_sums;    // Running sum per channel
+    std::vector<double, AlignedAllocator<double>> m_comps;   // Neumaier compensation term per channel
+    std::vector<char> m_skipped;   // Per channel: left out of block pushes
+    size_t m_pos;                  // Next history slot to write
+    size_t m_count;                // Samples currently in the window
+    size_t m_since_renormalize;    // Pushes since the last exact re-summation
+};
+
+} // namespace sensor
@@ -4,12 +4,23 @@
 // Include required header files
 #include "common.hpp"
 #include "ipc_manager.hpp"
+#include "output_writer.hpp"
+#include "telemetry_codec.hpp"
 #include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
 #include <thread>
+#include <vector>
 
 namespace sensor {
 
-// OutputHandler class: Handles the display and formatting of processed sensor data
+// OutputHandler class: Handles the display and formatting of processed sensor data.
+// Records are formatted with std::to_chars straight into OutputWriter's preallocated
+// chunks, and a separate writer thread performs the writes, so a slow terminal or pipe
+// never stalls the thread draining IPC. Config::output_format picks the layout; binary
+// output with Config::compress writes telemetry_codec.hpp frames instead of raw records.
+// Anomaly alerts skip the writer: each is written to stderr as soon as it is received.
 class OutputHandler {
 public:
     // Constructor that initializes the output handler with configuration parameters
@@ -32,13 +43,54 @@ public:
     // Stop the output handling and cleanup resources
     void stop();
 
+    // Accounting of the output stage (records handed to the writer thread)
+    std::vector<StageReport> stages() const;
+
+    // Activity of the output loop
+    std::vector<LoopReport> loops() const;
+
 private:
     // Main output loop that runs in a separate thread
     void outputLoop();
+
+    // Receive and print one frame, returns false if none arrived
+    bool printNext(bool blocking, std::chrono::milliseconds timeout);
     
-    // Format and print sensor data received through IPC
+    // Format sensor data received through IPC into the output buffer
     void printSensorData(const MQMessage& msg);
 
+    // Write the alerts received with the last frame to stderr, one line each
+    void printAlerts();
+
+    // Fixed mode: print the window reports received with the last frame
+    void printWindows();
+
+    // Registry mode: format a block frame with registry names (the latest sample in
+    // pretty mode, every sample in the machine-readable formats)
+    void printBlock(const BlockView& block);
+
+    // Compressed binary output: add a message to the open frame, writing it out when full
+    void appendCompressed(const MQMessage& msg);
+
+    // Compressed binary output: hand the open frame to the writer
+    void flushCompressed();
+
+    // CSV mode: write the column names once before the first row
+    void writeCsvHeader();
+
+    // Label for an aggregation window length
+    static std::string formatWindow(uint32_t window_ms);
+
+    // Append the formatWindow label without allocating
+    static char* appendWindow(char* out, uint32_t window_ms);
+
+    // Append a local timestamp, optionally with milliseconds; the date and time text is
+    // cached per second so only the millisecond digits change between messages
+    char* appendTimestamp(char* out, std::chrono::system_clock::time_point time, bool millis);
+
+    // Record the transport, output and end-to-end hops once a reading has been printed
+    void recordLatency(const StageTimes& stages, uint64_t received_ns);
+
     // Configuration parameters for the output handler
     Config m_config;
     
@@ -50,6 +102,35 @@ private:
     
     // Atomic flag for thread synchronization
     std::atomic<bool> m_running;
+
+    // Writer thread and output chunks
+    std::unique_ptr<OutputWriter> m_writer;
+
+    // Output loop activity, written by the output thread only
+    LoopCounters m_loop;
+
+    // Compressed binary output (null = raw records)
+    std::vector<double> m_precision;               // Quantization per channel
+    std::unique_ptr<MessageCodec> m_message_codec; // Fixed mode: messages packed into m_frame
+    std::unique_ptr<BlockCodec> m_block_codec;     // Registry mode: one frame per block
+    std::vector<char> m_frame;                     // Open compressed message frame
+    std::chrono::steady_clock::time_point m_frame_first; // When the open frame got its first message
+
+    // Channel names with spaces replaced, used as compact keys and CSV columns
+    std::vector<std::string> m_field_names;
+
+    // Alert lines, formatted apart from the stdout chunks
+    std::vector<AnomalyAlert> m_alerts;  // Alerts taken from the IPC manager
+    std::vector<char> m_alert_text;      // Their lines, written with one write()
+
+    // Window reports taken from the IPC manager, and the empty window columns of a CSV message row
+    std::vector<WindowReport> m_windows;
+    std::string m_csv_window_gap;
+
+    size_t m_name_width;      // Name column width in pretty registry output
+    size_t m_record_bytes;    // Upper bound on one formatted record
+    int64_t m_cached_second;  // Epoch second m_cached_prefix was formatted for
+    char m_cached_prefix[32]; // "YYYY-MM-DD HH:MM:SS" of m_cached_second
 };
 
 } // namespace sensor 
\ No newline at end of file
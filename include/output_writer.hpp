@@ -0,0 +1,100 @@
+#pragma once
+
+#include "common.hpp"
+#include "spsc_ring_buffer.hpp"
+#include "stage_counters.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace sensor {
+
+// OutputWriter class: Moves the write() syscalls for formatted output off the thread
+// that drains IPC. The formatting thread appends records into preallocated chunks and
+// hands filled chunks to a writer thread through an SPSC ring; the writer gathers every
+// queued chunk into one writev() call and returns them through a second ring. A chunk
+// is handed over as soon as the writer is idle, so output is prompt at low rates and
+// batches grow by themselves when the terminal or pipe is slow. If every chunk is still
+// queued, new records are dropped and counted rather than stalling the pipeline, or
+// under the BLOCK policy after waiting a bounded time for the writer to free a chunk.
+// reserve/commit/release/flush may only be called from one thread.
+class OutputWriter {
+public:
+    // Constructor that preallocates chunk_count chunks of chunk_bytes for file descriptor fd;
+    // policy must be DROP_NEWEST or BLOCK (queued text cannot be evicted or merged)
+    OutputWriter(int fd, size_t chunk_bytes, size_t chunk_count,
+                 OverflowPolicy policy = OverflowPolicy::DROP_NEWEST,
+                 std::chrono::microseconds block_timeout = std::chrono::microseconds(0));
+
+    // Destructor flushes and stops the writer thread
+    ~OutputWriter();
+
+    // Big 5: owns a thread and the chunk memory
+    OutputWriter(const OutputWriter&) = delete;
+    OutputWriter& operator=(const OutputWriter&) = delete;
+    OutputWriter(OutputWriter&&) = delete;
+    OutputWriter& operator=(OutputWriter&&) = delete;
+
+    // Start the writer thread (flushes std::cout first so earlier output stays in order)
+    void start();
+
+    // Flush everything committed so far, wait for it to be written and stop the writer thread
+    void stop();
+
+    // Space for a record of at most max_bytes, or nullptr if no chunk is free (record dropped)
+    char* reserve(size_t max_bytes);
+
+    // Keep the first bytes of the space returned by the last reserve()
+    void commit(size_t bytes);
+
+    // Hand the current chunk to the writer if the writer is idle (call after each batch)
+    void release();
+
+    // Hand the current chunk to the writer unconditionally
+    void flush();
+
+    // Counters
+    uint64_t droppedRecords() const; // Records dropped because every chunk was queued
+    uint64_t writeCalls() const;     // writev() calls made
+    uint64_t bytesWritten() const;   // Bytes written
+    StageCounters counters() const;  // Records in and out; high-water counts queued chunks
+
+private:
+    // Writer thread: gather queued chunks and write them with one writev()
+    void writerLoop();
+
+    // Queue the current chunk for the writer and start a new one on the next reserve()
+    void publish();
+
+    // Most chunks gathered into one writev()
+    static constexpr size_t MAX_GATHER = 64;
+
+    // Preallocated output chunk
+    struct Chunk {
+        std::unique_ptr<char[]> data; // chunk_bytes of storage
+        size_t used = 0;              // Bytes committed
+        size_t records = 0;           // Records committed
+    };
+
+    int m_fd;                             // Destination file descriptor
+    size_t m_chunk_bytes;                 // Capacity of every chunk
+    std::vector<Chunk> m_chunks;          // All chunks, indexed by the rings
+    SpscRingBuffer<uint32_t> m_filled;    // Formatting thread -> writer
+    SpscRingBuffer<uint32_t> m_free;      // Writer -> formatting thread
+    int64_t m_current;                    // Chunk being filled (-1 when none)
+    const OverflowPolicy m_policy;        // DROP_NEWEST or BLOCK
+    const std::chrono::microseconds m_block_timeout; // Longest wait for a free chunk
+    std::thread m_thread;                 // Writer thread
+    std::atomic<bool> m_running;          // Writer thread should keep going
+    std::atomic<bool> m_busy;             // Writer is inside writev()
+    std::atomic<uint64_t> m_records;      // Records offered to reserve()
+    std::atomic<uint64_t> m_dropped;      // Dropped records
+    std::atomic<uint64_t> m_written;      // Records whose chunk was written
+    std::atomic<size_t> m_high_water;     // Most chunks queued for the writer at once
+    std::atomic<uint64_t> m_write_calls;  // writev() calls
+    std::atomic<uint64_t> m_bytes;        // Bytes written
+};
+
+} // namespace sensor
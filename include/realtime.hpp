@@ -0,0 +1,67 @@
+#pragma once
+
+#include "common.hpp"
+#include "latency_histogram.hpp"
+#include <atomic>
+#include <chrono>
+#include <ostream>
+
+namespace sensor {
+
+// Apply SCHED_FIFO priority and CPU affinity to the calling thread. Each part that
+// fails (typically EPERM without CAP_SYS_NICE) is reported on stderr and skipped,
+// so the pipeline still runs unprivileged; returns THREAD_POLICY_ERROR if any did.
+ErrorCode applyThreadPolicy(const ThreadPolicy& policy, const char* thread_name);
+
+// DeadlineTimer class: Fixed-rate loop pacing against absolute deadlines. Deadline n
+// is start + n * period, so the time spent working between waits does not shift later
+// ticks and no drift accumulates. Sleeps with clock_nanosleep(TIMER_ABSTIME) on Linux
+// (sleep_until elsewhere), optionally busy-waiting the final spin interval to cut wakeup
+// jitter on isolated cores. Counters may be read from other threads while it runs.
+class DeadlineTimer {
+public:
+    // Constructor that sets the period and pre-deadline spin interval
+    explicit DeadlineTimer(std::chrono::nanoseconds period,
+                           std::chrono::nanoseconds spin = std::chrono::nanoseconds(0));
+
+    // Big 5: counters and histogram are atomics
+    DeadlineTimer(const DeadlineTimer&) = delete;
+    DeadlineTimer& operator=(const DeadlineTimer&) = delete;
+    DeadlineTimer(DeadlineTimer&&) = delete;
+    DeadlineTimer& operator=(DeadlineTimer&&) = delete;
+    ~DeadlineTimer() = default;
+
+    // Make the next deadline one period from now (call before the first wait)
+    void restart();
+
+    // Sleep until the next deadline. If it has already passed, return at once and count an
+    // overrun; whole periods that were missed entirely are skipped to keep the phase.
+    // Returns false on an overrun.
+    bool wait();
+
+    // Counters
+    uint64_t ticks() const;     // Deadlines reached
+    uint64_t overruns() const;  // Waits that started after their deadline had passed
+    uint64_t skipped() const;   // Whole periods dropped while catching up after overruns
+    std::chrono::nanoseconds period() const;  // Configured period
+
+    // Wakeup lateness (actual wake time minus deadline) per tick
+    const LatencyHistogram& jitter() const;
+
+    // Print counters and jitter percentiles on one line
+    void report(std::ostream& os) const;
+
+private:
+    // Sleep until the absolute monotonic time target_ns
+    static void sleepUntil(uint64_t target_ns);
+
+    uint64_t m_period_ns;            // Period between deadlines
+    uint64_t m_spin_ns;              // Busy-wait interval before each deadline
+    uint64_t m_next_ns;              // Next absolute deadline on the monotonic clock
+    std::atomic<uint64_t> m_ticks;    // Deadlines reached
+    std::atomic<uint64_t> m_overruns; // Late starts
+    std::atomic<uint64_t> m_skipped;  // Dropped periods
+    LatencyHistogram m_jitter;       // Wakeup lateness in ns
+};
+
+} // namespace sensor
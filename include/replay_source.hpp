@@ -0,0 +1,64 @@
+#pragma once
+
+#include "common.hpp"
+#include "flight_recorder.hpp"
+#include "sample_source.hpp"
+#include "spsc_ring_buffer.hpp"
+#include <atomic>
+#include <memory>
+#include <thread>
+
+namespace sensor {
+
+// ReplaySource class: Plays a flight recording of raw readings back into the pipeline
+// in place of SensorSimulator. Readings keep their recorded values and wall-clock
+// timestamps; gaps between them are reproduced divided by Config::replay_speed, or
+// dropped entirely at speed 0. Unlike live sampling, a full buffer makes the replay
+// thread wait rather than lose a reading, so every run sees the same input.
+class ReplaySource : public SampleSource {
+public:
+    // Constructor that opens the "samples" stream in Config::replay_dir; throws if absent
+    explicit ReplaySource(const Config& config);
+
+    // Destructor stops the replay thread
+    ~ReplaySource() override;
+
+    // Big 5: owns a thread and a mapping
+    ReplaySource(const ReplaySource&) = delete;
+    ReplaySource& operator=(const ReplaySource&) = delete;
+    ReplaySource(ReplaySource&&) = delete;
+    ReplaySource& operator=(ReplaySource&&) = delete;
+
+    // Start and stop the replay thread
+    void start() override;
+    void stop() override;
+
+    // Retrieve the oldest replayed reading, returns empty optional if none is pending
+    std::optional<SensorData> getLatestData() override;
+
+    // Block until a replayed reading is available or timeout expires
+    std::optional<SensorData> waitForData(std::chrono::microseconds timeout) override;
+
+    // True once every recorded reading has been replayed and consumed
+    bool finished() const override;
+
+    // Print replay progress
+    void report(std::ostream& os) const override;
+
+private:
+    // Replay thread: read, pace, push until the recording ends or stop() is called
+    void replayLoop();
+
+    // Readings queued between the replay thread and the consumer
+    static constexpr size_t REPLAY_BUFFER_SIZE = 1024;
+
+    Config m_config;                     // Configuration (replay_dir, replay_speed, thread policy)
+    FlightReader m_reader;               // Recording being replayed
+    SpscRingBuffer<SensorData> m_buffer; // Replayed readings awaiting the consumer
+    std::thread m_thread;                // Replay thread
+    std::atomic<bool> m_running;         // Replay thread should keep going
+    std::atomic<bool> m_exhausted;       // Replay thread pushed the last reading
+    std::atomic<uint64_t> m_replayed;    // Readings pushed so far
+};
+
+} // namespace sensor
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "common.hpp"
+#include "aligned_allocator.hpp"
+#include <chrono>
+#include <vector>
+
+namespace sensor {
+
+// SampleBlock class: Up to capacity consecutive samples of a runtime channel set,
+// stored structure-of-arrays: one contiguous, cache-line aligned column per channel.
+// Per-channel kernels walk a column linearly, so cost grows linearly with channels.
+class SampleBlock {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    // Constructor that allocates all columns up front
+    SampleBlock(size_t channels, size_t capacity);
+
+    // Column access: capacity() values for one channel, sample k at index k
+    double* column(size_t channel);
+    const double* column(size_t channel) const;
+
+    // Per-sample timestamps, parallel to every column
+    TimePoint* timestamps();
+    const TimePoint* timestamps() const;
+
+    // Number of valid samples and sequence number of the first one
+    size_t length() const;
+    void setLength(size_t length);
+    uint64_t firstSequence() const;
+    void setFirstSequence(uint64_t sequence);
+
+    // Monotonic stage stamps of the newest sample, for latency tracking
+    StageTimes& stages();
+    const StageTimes& stages() const;
+
+    // Geometry
+    size_t channels() const;  // Number of columns
+    size_t capacity() const;  // Samples per column
+    size_t stride() const;    // Doubles between column starts (capacity rounded up to a cache line)
+
+private:
+    size_t m_channels;        // Number of columns
+    size_t m_capacity;        // Samples per column
+    size_t m_stride;          // Doubles between column starts (cache-line multiple)
+    std::vector<double, AlignedAllocator<double>> m_values; // Column-major sample storage
+    std::vector<TimePoint> m_timestamps; // Timestamp per sample
+    size_t m_length;          // Valid samples in every column
+    uint64_t m_first_sequence; // Sequence number of sample 0
+    StageTimes m_stages;      // Stage stamps of the newest sample
+};
+
+} // namespace sensor
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "common.hpp"
+#include "sample_block.hpp"
+#include "stage_counters.hpp"
+#include <chrono>
+#include <optional>
+#include <ostream>
+#include <vector>
+
+namespace sensor {
+
+// SampleSource class: Where DataProcessor takes its readings from. SensorSimulator
+// generates them; ReplaySource plays back a flight recording. Registry-mode block
+// methods are optional and return nothing for sources that only produce SensorData.
+class SampleSource {
+public:
+    // Virtual destructor for polymorphic ownership
+    virtual ~SampleSource() = default;
+
+    // Start and stop the producing thread
+    virtual void start() = 0;
+    virtual void stop() = 0;
+
+    // Retrieve the oldest pending reading, returns empty optional if none is available
+    virtual std::optional<SensorData> getLatestData() = 0;
+
+    // Block until a reading is available or timeout expires, then retrieve it
+    virtual std::optional<SensorData> waitForData(std::chrono::microseconds timeout) = 0;
+
+    // Registry mode: take the next filled block, returns nullptr if none is ready
+    virtual SampleBlock* getLatestBlock() { return nullptr; }
+
+    // Registry mode: block until a filled block is ready or timeout expires
+    virtual SampleBlock* waitForBlock(std::chrono::microseconds timeout) {
+        (void)timeout;
+        return nullptr;
+    }
+
+    // Registry mode: hand a block obtained above back to the source for reuse
+    virtual void releaseBlock(SampleBlock* block) { (void)block; }
+
+    // True once a finite source has delivered its last reading
+    virtual bool finished() const { return false; }
+
+    // Print source-specific counters (timer statistics, replay progress)
+    virtual void report(std::ostream& os) const { (void)os; }
+
+    // Accounting of the buffer between the source and DataProcessor, if it can lose data
+    virtual std::vector<StageReport> stages() const { return {}; }
+
+    // Activity of the producing thread's loop, if it has one worth reporting
+    virtual std::vector<LoopReport> loops() const { return {}; }
+};
+
+} // namespace sensor
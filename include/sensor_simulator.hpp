@@ -2,20 +2,30 @@
 
 #include "common.hpp"
 #include "circular_buffer.hpp"
+#include "spsc_ring_buffer.hpp"
+#include "ingest_ring.hpp"
+#include "sample_block.hpp"
+#include "realtime.hpp"
+#include "sample_source.hpp"
+#include "flight_recorder.hpp"
+#include "fast_random.hpp"
 #include <atomic>
+#include <memory>
 #include <random>
 #include <thread>
+#include <variant>
+#include <vector>
 
 namespace sensor {
 
 // SensorSimulator class: Simulates multiple sensors generating data in real-time
-class SensorSimulator {
+class SensorSimulator : public SampleSource {
 public:
     // Constructor that initializes the simulator with configuration parameters
     explicit SensorSimulator(const Config& config);
     
     // Destructor ensures proper cleanup of resources
-    ~SensorSimulator();
+    ~SensorSimulator() override;
 
     // Disable copy operations to prevent multiple instances sharing resources
     SensorSimulator(const SensorSimulator&) = delete;
@@ -26,37 +36,104 @@ public:
     SensorSimulator& operator=(SensorSimulator&&) noexcept = delete;
 
     // Start the sensor simulation in a separate thread
-    void start();
+    void start() override;
     
     // Stop the sensor simulation and cleanup resources
-    void stop();
+    void stop() override;
     
     // Retrieve the most recent sensor data, returns empty optional if no data available
-    std::optional<SensorData> getLatestData();
+    std::optional<SensorData> getLatestData() override;
+
+    // Block until a reading is available or timeout expires, then retrieve it
+    std::optional<SensorData> waitForData(std::chrono::microseconds timeout) override;
+
+    // Generate simulated sensor values using normal distribution (also used by benchmarks);
+    // draws come from the engine selected by Config::random_engine
+    std::array<double, NUM_SENSORS> generateSensorValues();
+
+    // Sampling deadline timer, for its tick, overrun and jitter counters
+    const DeadlineTimer& timer() const;
+
+    // Print the sampling timer counters
+    void report(std::ostream& os) const override;
+
+    // Accounting of the sample buffer (readings, or samples in registry mode)
+    std::vector<StageReport> stages() const override;
+
+    // Simulation loop activity: one iteration per timer tick, never idle
+    std::vector<LoopReport> loops() const override;
+
+    // Registry mode: take the next filled block, returns nullptr if none is ready
+    SampleBlock* getLatestBlock() override;
+
+    // Registry mode: block until a filled block is ready or timeout expires
+    SampleBlock* waitForBlock(std::chrono::microseconds timeout) override;
+
+    // Registry mode: hand a block obtained above back to the simulator for reuse
+    void releaseBlock(SampleBlock* block) override;
 
 private:
     // Main simulation loop that runs in a separate thread
     void simulationLoop();
-    
-    // Generate simulated sensor values using normal distribution
-    std::array<double, NUM_SENSORS> generateSensorValues();
+
+    // Registry mode loop: fills SampleBlocks one sample at a time
+    void blockSimulationLoop();
+
+    // Append one simulated sample for every registry channel to the block
+    void generateBlockSample(SampleBlock& block);
+
+    // Fast engine: next count standard normal variates, refilling the noise block in bulk
+    const double* nextNoise(size_t count);
+
+    // Standard normals drawn per refill of the fast engine's noise block
+    static constexpr size_t NOISE_BLOCK = 4096;
+
+    // Sample buffer selected at construction time by Config::buffer_type
+    using SampleBuffer = std::variant<CircularBuffer<SensorData>, SpscRingBuffer<SensorData>, IngestRing>;
+    static SampleBuffer makeBuffer(const Config& config);
 
     // Configuration parameters for the simulator
     Config m_config;
     
-    // Circular buffer to store sensor data
-    CircularBuffer<SensorData> m_buffer;
+    // Buffer handing sensor data from the simulation thread to the consumer
+    SampleBuffer m_buffer;
     
     // Background thread for simulation
     std::thread m_thread;
     
     // Atomic flag for thread synchronization
     std::atomic<bool> m_running;
+
+    // Paces sampling against absolute deadlines
+    DeadlineTimer m_timer;
+
+    // Flight recorder for every generated reading (null unless Config::record_dir is set)
+    std::unique_ptr<FlightRecorder> m_recorder;
     
     // Random number generation components
     std::mt19937 m_rng;
     // Normal distribution models real-world sensor noise patterns the closests
     std::array<std::normal_distribution<double>, NUM_SENSORS> m_distributions;
+
+    // Fast engine: ziggurat sampler and a block of pre-drawn standard normals, sized to a
+    // whole number of samples so each reading takes one contiguous slice
+    std::unique_ptr<NormalSampler> m_normal;
+    std::vector<double> m_noise;
+    size_t m_noise_pos; // Next unused variate in m_noise
+
+    // Registry mode: blocks circulate simulator -> consumer -> simulator through two
+    // SPSC rings, so steady-state operation never allocates
+    std::vector<std::unique_ptr<SampleBlock>> m_block_pool;
+    std::unique_ptr<SpscRingBuffer<SampleBlock*>> m_ready_blocks; // Filled, awaiting the consumer
+    std::unique_ptr<SpscRingBuffer<SampleBlock*>> m_free_blocks;  // Released, awaiting refill
+    std::vector<std::normal_distribution<double>> m_channel_distributions;
+    SampleBlock* m_filling_block; // Block the simulation thread is currently writing
+    uint64_t m_sample_sequence; // Sequence number of the next generated sample
+
+    // Registry mode sample accounting; each counter has a single writing thread
+    std::atomic<uint64_t> m_block_produced; // Samples generated (simulation thread)
+    std::atomic<uint64_t> m_block_dropped;  // Samples lost for lack of a free block (simulation thread)
+    std::atomic<uint64_t> m_block_consumed; // Samples in blocks handed to the consumer (consumer thread)
 };
 
 } // namespace sensor 
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "common.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+
+namespace sensor {
+
+// ShmRing class: Single-producer/single-consumer ring of fixed-size slots in POSIX
+// shared memory (shm_open + mmap). Each slot carries a sequence number: the producer
+// publishes position p by storing p + 1, and the consumer frees it by storing
+// p + capacity. Both sides therefore read and write slots in place with no syscalls;
+// the kernel is only entered to park an idle consumer (futex on Linux).
+// Positions live in the segment, so a ring joined with attach() survives the restart of
+// either process: a new producer continues at the shared write position and a new
+// consumer at the shared read position.
+class ShmRing {
+public:
+    // Create a new segment (producer); any stale segment with the same name is replaced.
+    // slots is rounded up to a power of two, and to at least 2 so a published slot is
+    // never mistaken for a free slot of the next lap.
+    static std::unique_ptr<ShmRing> create(const std::string& name, size_t slot_size, size_t slots);
+
+    // Attach to an existing segment (consumer); returns nullptr if absent or incompatible.
+    // A consumer replacing one that died while parked starts with the wake-up flag cleared.
+    static std::unique_ptr<ShmRing> open(const std::string& name, size_t slot_size);
+
+    // Join the live segment with this name, or create it if there is none (either side,
+    // any start order); the last process to detach unlinks it. Returns nullptr on failure.
+    static std::unique_ptr<ShmRing> attach(const std::string& name, size_t slot_size, size_t slots);
+
+    // Destructor unmaps the segment and, for the creator (or last attached process), unlinks its name
+    ~ShmRing();
+
+    // Disable copy and move operations, the mapping is owned by exactly one object
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+    ShmRing(ShmRing&&) = delete;
+    ShmRing& operator=(ShmRing&&) = delete;
+
+    // Copy len bytes into the next free slot (producer), returns false if the ring is full
+    bool tryWrite(const void* data, size_t len);
+
+    // Pointer to the oldest published slot payload (consumer), or nullptr if empty
+    const void* front() const;
+
+    // Length in bytes of the payload returned by front()
+    size_t frontLength() const;
+
+    // Hand the slot returned by front() back to the producer (consumer)
+    void popFront();
+
+    // Block until front() would return a slot or timeout expires (consumer)
+    bool waitReadable(std::chrono::milliseconds timeout);
+
+    // Ring geometry and state
+    size_t slotSize() const;  // Maximum payload bytes per slot
+    size_t capacity() const;  // Number of slots (power of two, at least 2)
+    size_t size() const;      // Published but unconsumed slots (approximate)
+
+    // Producer-side accounting kept in the segment, so either process can report it
+    uint64_t written() const;        // Payloads published since the segment was created
+    uint64_t consumed() const;       // Payloads popped since the segment was created
+    uint64_t dropped() const;        // Writes the producer gave up on
+    size_t highWater() const;        // Deepest occupancy the producer recorded
+    bool consumerParked() const;     // Consumer asleep in waitReadable() (open() clears a stale flag)
+    void recordDrop();               // Count one abandoned write (producer)
+    void recordDepth(size_t depth);  // Raise the high-water mark (producer)
+
+private:
+    struct Header;
+    struct SlotHeader;
+
+    // How a mapping was obtained, which decides who removes the name
+    enum class Ownership {
+        CREATOR,  // create(): unlinks on destruction
+        OPENER,   // open(): leaves the name alone
+        SHARED    // attach(): the last process to detach unlinks
+    };
+
+    ShmRing(const std::string& name, void* base, size_t mapped_size, Ownership ownership);
+
+    // Size, map and initialize a freshly created, empty segment
+    static std::unique_ptr<ShmRing> initialize(const std::string& name, int fd, size_t slot_size,
+                                               size_t slots, Ownership ownership);
+
+    // Count this process in, unless the last holder is already removing the segment
+    bool join();
+
+    // Address of slot i's sequence header
+    SlotHeader* slotAt(uint64_t pos) const;
+
+    // Wake a consumer parked in waitReadable(), only if one is parked
+    void wakeConsumer();
+
+    std::string m_name;    // Segment name passed to shm_open
+    void* m_base;          // Start of the mapping
+    size_t m_mapped_size;  // Bytes mapped
+    Ownership m_ownership; // Who unlinks the name on destruction
+    Header* m_header;      // Control block at the start of the mapping
+    char* m_slots;         // First slot, directly after the header
+    size_t m_stride;       // Bytes between consecutive slots
+};
+
+} // namespace sensor
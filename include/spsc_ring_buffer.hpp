@@ -0,0 +1,100 @@
+// Prevent multiple inclusion of this header file
+#pragma once
+
+// Include required header files
+#include "common.hpp"
+#include "asymmetric_fence.hpp"
+#include "stage_counters.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sensor {
+
+// Wait-free single-producer/single-consumer ring buffer for generic type T.
+// Exactly one thread may call push() and exactly one thread may call pop();
+// no locks are taken on either side. Unlike CircularBuffer, push() never
+// overwrites unread items: it returns false when the ring is full.
+// A consumer may also block in waitPop(); the producer only pays for a
+// notification when the consumer has actually gone to sleep, and the barrier that
+// makes the check safe is paid by the consumer as it parks (asymmetric_fence.hpp).
+// Only the consumer may advance the tail, so the overflow policy is limited to
+// DROP_NEWEST and BLOCK (the producer yields until the consumer frees a slot).
+template<typename T>
+class SpscRingBuffer {
+public:
+    // Constructor that rounds the requested size up to the next power of two;
+    // throws std::invalid_argument for policies that would evict queued items
+    explicit SpscRingBuffer(size_t size, OverflowPolicy policy = OverflowPolicy::DROP_NEWEST,
+                            std::chrono::microseconds block_timeout = std::chrono::microseconds(0));
+
+    // Big 5
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+    SpscRingBuffer(SpscRingBuffer&&) noexcept = delete;
+    SpscRingBuffer& operator=(SpscRingBuffer&&) noexcept = delete;
+    ~SpscRingBuffer() = default;
+
+    // Add an item to the buffer (producer only), returns false if it was dropped
+    // because the buffer stayed full
+    bool push(const T& item);
+
+    // Remove and return the oldest item from the buffer (consumer only)
+    std::optional<T> pop();
+
+    // Block until an item is available or timeout expires, then pop it (consumer only)
+    std::optional<T> waitPop(std::chrono::microseconds timeout);
+
+    // Buffer state query functions (approximate while the other side is active)
+    bool empty() const;      // Check if buffer is empty
+    bool full() const;       // Check if buffer is full
+    size_t size() const;     // Get current number of items in buffer
+    size_t capacity() const; // Get maximum capacity of buffer
+
+    // Overflow policy and produced/consumed/dropped accounting (any thread)
+    OverflowPolicy policy() const;
+    StageCounters counters() const;
+
+private:
+    // BLOCK policy: yield until the consumer frees a slot or the timeout expires
+    bool waitForRoom(size_t head);
+
+    // Raise the high-water mark to depth if it is deeper (producer only)
+    void noteDepth(size_t depth);
+
+    // Pushes between refreshes of the cached tail used for the high-water mark
+    static constexpr size_t DEPTH_SAMPLE_INTERVAL = 64;
+
+    const size_t m_size;     // Fixed capacity of the buffer (power of two)
+    const size_t m_mask;     // m_size - 1, replaces modulo on every index
+    std::vector<T> m_buffer; // Underlying storage for buffer elements
+    const OverflowPolicy m_policy; // DROP_NEWEST or BLOCK
+    const std::chrono::microseconds m_block_timeout; // Longest wait of a BLOCK push
+
+    // Producer-owned cache line: next write position, last seen tail, and the producer's
+    // counters (accepted items are the head itself, consumed items the tail)
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head;
+    size_t m_cached_tail;
+    std::atomic<uint64_t> m_dropped;    // Pushes rejected while full
+    std::atomic<size_t> m_high_water;   // Deepest occupancy seen at a tail refresh
+
+    // Consumer-owned cache line: next read position and last seen head
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail;
+    size_t m_cached_head;
+
+    // Sleep/wake state, touched by the producer only while the consumer is parked
+    alignas(CACHE_LINE_SIZE) std::atomic<bool> m_waiting;
+    std::mutex m_wait_mutex;
+    std::condition_variable m_not_empty;
+};
+
+} // namespace sensor
+
+// Include template implementation
+#include "spsc_ring_buffer.inl"
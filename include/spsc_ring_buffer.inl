@@ -0,0 +1,175 @@
+#pragma once
+
+namespace sensor {
+
+// Constructor: Initializes ring with power-of-two capacity and empty state
+template<typename T>
+SpscRingBuffer<T>::SpscRingBuffer(size_t size, OverflowPolicy policy, std::chrono::microseconds block_timeout)
+    : m_size(roundUpPow2(size))
+    , m_mask(m_size - 1)
+    , m_buffer(m_size)
+    , m_policy(policy)
+    , m_block_timeout(block_timeout)
+    , m_head(0)
+    , m_cached_tail(0)
+    , m_dropped(0)
+    , m_high_water(0)
+    , m_tail(0)
+    , m_cached_head(0)
+    , m_waiting(false)
+{
+    if (policy != OverflowPolicy::DROP_NEWEST && policy != OverflowPolicy::BLOCK) {
+        throw std::invalid_argument(std::string("SPSC buffer cannot ") + overflowPolicyName(policy)
+                                    + ": only its consumer may remove items (use the mutex buffer)");
+    }
+}
+
+// Push: Publishes item at head, fails (or waits, under BLOCK) instead of overwriting when full
+template<typename T>
+bool SpscRingBuffer<T>::push(const T& item) {
+    // Head is only written by this thread, so a relaxed load is sufficient
+    const size_t head = m_head.load(std::memory_order_relaxed);
+
+    // Only touch the consumer's cache line when the cached tail says full, or now and
+    // then to sample the occupancy for the high-water mark
+    if (head - m_cached_tail == m_size) {
+        m_cached_tail = m_tail.load(std::memory_order_acquire);
+        if (head - m_cached_tail == m_size && !waitForRoom(head)) {
+            noteDepth(m_size);
+            bumpCounter(m_dropped);
+            return false;
+        }
+        noteDepth(head + 1 - m_cached_tail);
+    } else if ((head & (DEPTH_SAMPLE_INTERVAL - 1)) == 0) {
+        m_cached_tail = m_tail.load(std::memory_order_acquire);
+        noteDepth(head + 1 - m_cached_tail);
+    }
+
+    // Write slot first, then release it to the consumer
+    m_buffer[head & m_mask] = item;
+    m_head.store(head + 1, std::memory_order_release);
+
+    // Pairs with heavyFence() in waitPop(): either we see the waiter or it sees the new
+    // head. Only a compiler barrier here where membarrier(2) is available.
+    lightFence();
+    if (m_waiting.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(m_wait_mutex);
+        m_not_empty.notify_one();
+    }
+    return true;
+}
+
+// NoteDepth: Raise the high-water mark (producer only)
+template<typename T>
+void SpscRingBuffer<T>::noteDepth(size_t depth) {
+    if (depth > m_high_water.load(std::memory_order_relaxed)) {
+        m_high_water.store(depth, std::memory_order_relaxed);
+    }
+}
+
+// WaitForRoom: The consumer never signals the producer, so poll the tail until the deadline
+template<typename T>
+bool SpscRingBuffer<T>::waitForRoom(size_t head) {
+    if (m_policy != OverflowPolicy::BLOCK) {
+        return false;
+    }
+    const auto deadline = std::chrono::steady_clock::now() + m_block_timeout;
+    do {
+        std::this_thread::yield();
+        m_cached_tail = m_tail.load(std::memory_order_acquire);
+        if (head - m_cached_tail < m_size) {
+            return true;
+        }
+    } while (std::chrono::steady_clock::now() < deadline);
+    return false;
+}
+
+// Pop: Removes and returns oldest item, or empty optional if none published
+template<typename T>
+std::optional<T> SpscRingBuffer<T>::pop() {
+    // Tail is only written by this thread, so a relaxed load is sufficient
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+
+    // Only touch the producer's cache line when the cached head says empty
+    if (tail == m_cached_head) {
+        m_cached_head = m_head.load(std::memory_order_acquire);
+        if (tail == m_cached_head) {
+            return std::nullopt;
+        }
+    }
+
+    // Copy slot out before handing it back to the producer
+    T item = m_buffer[tail & m_mask];
+    m_tail.store(tail + 1, std::memory_order_release);
+    return item;
+}
+
+// WaitPop: Fast-path pop, otherwise park on the condition variable until push() or timeout
+template<typename T>
+std::optional<T> SpscRingBuffer<T>::waitPop(std::chrono::microseconds timeout) {
+    if (auto item = pop()) {
+        return item;
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(m_wait_mutex);
+        m_waiting.store(true, std::memory_order_relaxed);
+        heavyFence();
+
+        // Predicate re-reads head, so a push between pop() and here is never missed
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        m_not_empty.wait_for(lock, timeout, [this, tail] {
+            return m_head.load(std::memory_order_acquire) != tail;
+        });
+        m_waiting.store(false, std::memory_order_relaxed);
+    }
+
+    // Empty optional on timeout so callers can check for shutdown
+    return pop();
+}
+
+// Empty: Returns true if no items are currently published
+template<typename T>
+bool SpscRingBuffer<T>::empty() const {
+    return size() == 0;
+}
+
+// Full: Returns true if the producer cannot publish another item
+template<typename T>
+bool SpscRingBuffer<T>::full() const {
+    return size() == m_size;
+}
+
+// Size: Returns current number of items in buffer
+template<typename T>
+size_t SpscRingBuffer<T>::size() const {
+    // Load tail first so head can only have moved forward, never below tail
+    const size_t tail = m_tail.load(std::memory_order_acquire);
+    const size_t head = m_head.load(std::memory_order_acquire);
+    return head - tail;
+}
+
+// Capacity: Returns maximum number of items buffer can hold
+template<typename T>
+size_t SpscRingBuffer<T>::capacity() const {
+    return m_size;
+}
+
+// Policy: Returns the overflow policy applied by push()
+template<typename T>
+OverflowPolicy SpscRingBuffer<T>::policy() const {
+    return m_policy;
+}
+
+// Counters: Produced is every accepted push plus every rejected one; approximate while running
+template<typename T>
+StageCounters SpscRingBuffer<T>::counters() const {
+    StageCounters counters;
+    counters.consumed = m_tail.load(std::memory_order_acquire);
+    counters.dropped = m_dropped.load(std::memory_order_relaxed);
+    counters.produced = m_head.load(std::memory_order_acquire) + counters.dropped;
+    counters.high_water = m_high_water.load(std::memory_order_relaxed);
+    return counters;
+}
+
+} // namespace sensor
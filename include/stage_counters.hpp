@@ -0,0 +1,58 @@
+#pragma once
+
+#include "common.hpp"
+#include <atomic>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace sensor {
+
+// Accounting snapshot of one pipeline stage. Every item offered to a stage is either
+// consumed by the next stage or dropped by its overflow policy, so
+// produced - consumed - dropped is what the stage holds at the time of the snapshot.
+struct StageCounters {
+    uint64_t produced = 0;  // Items offered to the stage
+    uint64_t consumed = 0;  // Items taken out by the next stage
+    uint64_t dropped = 0;   // Items discarded by the overflow policy
+    size_t high_water = 0;  // Deepest occupancy observed
+};
+
+// One row of the stage table printed by reportStages()
+struct StageReport {
+    std::string name;        // Stage label
+    OverflowPolicy policy;   // What the stage does when full
+    size_t capacity;         // Items (output: chunks) the stage can hold
+    StageCounters counters;  // Counts at report time
+};
+
+// Live activity of one pipeline thread's main loop; each counter is written by that
+// thread only (with bumpCounter) and may be read from any other
+struct LoopCounters {
+    std::atomic<uint64_t> iterations{0};    // Passes through the loop
+    std::atomic<uint64_t> idle_wakeups{0};  // Passes that woke up without any work to do
+};
+
+// Snapshot of one thread's LoopCounters
+struct LoopReport {
+    std::string thread;         // Thread label
+    uint64_t iterations = 0;    // Passes through the loop
+    uint64_t idle_wakeups = 0;  // Passes without work (timeouts, empty polls)
+};
+
+// Add n to a counter written by exactly one thread: a plain load and store instead of a
+// locked read-modify-write, while other threads may still read it at any time
+inline void bumpCounter(std::atomic<uint64_t>& counter, uint64_t n = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+}
+
+// Policy name as accepted on the command line, e.g. "drop-oldest"
+const char* overflowPolicyName(OverflowPolicy policy);
+
+// Parse a policy name, throws std::invalid_argument for unknown names
+OverflowPolicy parseOverflowPolicy(const std::string& name);
+
+// Print one row per stage: policy, capacity, produced/consumed/dropped and high-water mark
+void reportStages(std::ostream& os, const std::vector<StageReport>& stages);
+
+} // namespace sensor
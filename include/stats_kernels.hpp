@@ -0,0 +1,44 @@
+#pragma once
+
+#include "common.hpp"
+
+namespace sensor {
+
+// Instruction-set levels the statistics kernels are built for
+enum class SimdLevel {
+    SCALAR,  // Portable C++ reference implementation
+    SSE2,    // 2 doubles per register (x86-64 baseline)
+    AVX2,    // 4 doubles per register
+    AVX512   // 8 doubles per register
+};
+
+// StatsKernels: Table of statistics kernels for one instruction set. Sums (and sums of
+// squared deviations) are Neumaier-compensated in every variant, so vector and scalar results differ only by
+// summation order: at most 4u|sum| + 4nu^2 sum|x| apart (u = 2^-53). On sensor-like
+// columns that means the same double, but under heavy cancellation the ULP distance
+// near zero can be large. mean() performs the same IEEE division per channel and is
+// bit-identical across variants.
+struct StatsKernels {
+    SimdLevel level;   // Instruction set this table was built for
+    const char* name;  // Human-readable level name
+
+    // Compensated sum of n contiguous values (one channel column)
+    double (*sum)(const double* values, size_t n);
+
+    // Compensated sum of (x - mean)^2 over n contiguous values, for exact variances
+    double (*sumSquares)(const double* values, size_t n, double mean);
+
+    // out[i] = (sums[i] + comps[i]) / count for n channels
+    void (*mean)(const double* sums, const double* comps, double count, double* out, size_t n);
+};
+
+// Best kernels for the running CPU, detected once via CPUID
+const StatsKernels& statsKernels();
+
+// Kernels for a specific level; falls back to the best supported level below it
+const StatsKernels& statsKernels(SimdLevel level);
+
+// Highest level supported by the running CPU and operating system
+SimdLevel detectSimdLevel();
+
+} // namespace sensor
@@ -0,0 +1,252 @@
+#pragma once
+
+#include "common.hpp"
+#include "channel_registry.hpp"
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace sensor {
+
+// BitWriter class: Appends bit fields most significant bit first into caller memory,
+// eight bytes at a time. The caller guarantees the memory is large enough.
+class BitWriter {
+public:
+    // Start writing at out; capacity is only reported back, never checked
+    void reset(unsigned char* out, size_t capacity);
+
+    // Append the low count bits of bits (1 <= count <= 64; higher bits must be zero)
+    void write(uint64_t bits, unsigned count);
+
+    // Store the pending bits (zero padded to a byte) and return the bytes used; writing
+    // may continue afterwards
+    size_t finish();
+
+    // State query functions
+    size_t bitCount() const;  // Bits written since reset
+    size_t capacity() const;  // Bytes available at out
+
+private:
+    unsigned char* m_out = nullptr; // Destination
+    size_t m_capacity = 0;          // Bytes available at m_out
+    size_t m_bytes = 0;             // Whole words stored, in bytes
+    uint64_t m_acc = 0;             // Pending bits, right aligned
+    unsigned m_fill = 0;            // Number of pending bits
+};
+
+// BitReader class: Reads the fields BitWriter wrote. Reading past the end returns zero
+// bits and sets overrun() instead of touching memory outside the buffer.
+class BitReader {
+public:
+    // Start reading size bytes at data
+    void reset(const unsigned char* data, size_t size);
+
+    // Next count bits (1 <= count <= 64)
+    uint64_t read(unsigned count);
+
+    // Whether a read went past the end of the buffer
+    bool overrun() const;
+
+private:
+    // Up to 32 bits at the current position
+    uint64_t readShort(unsigned count);
+
+    const unsigned char* m_data = nullptr; // Source
+    size_t m_size = 0;                     // Bytes at m_data
+    size_t m_pos = 0;                      // Bit position
+    bool m_overrun = false;                // Set by a read past the end
+};
+
+// TelemetryEncoder class: Streaming compressor for records of fixed shape: integer
+// fields (ids, timestamps) stored as delta-of-delta, and double fields stored either
+// Gorilla style as the XOR with the previous value of the field, or, when the field
+// has a precision, as the change of value / precision rounded to an integer. Small
+// changes cost a few bits and unchanged fields one bit. Each frame starts from zeroed
+// state and carries its own precision table, so frames decode independently.
+class TelemetryEncoder {
+public:
+    // Constructor for records of integers integer fields and precision.size() double
+    // fields; precision[i] > 0 quantizes field i to multiples of it (0 = lossless)
+    TelemetryEncoder(size_t integers, std::vector<double> precision);
+
+    // Start a frame in out; false if capacity cannot hold the table and one record
+    bool begin(unsigned char* out, size_t capacity);
+
+    // Append one record, values[i * stride] being double field i; false (and nothing
+    // written) if the frame might not have room for it
+    bool append(const uint64_t* integers, const double* values, size_t stride = 1);
+
+    // Bytes of the frame so far; the frame may still grow with append()
+    size_t finish();
+
+    // State query functions
+    size_t records() const;         // Records in the current frame
+    size_t maxRecordBytes() const;  // Worst-case size of one record
+    size_t maxTableBytes() const;   // Upper bound on the precision table
+
+private:
+    // Per-field state, zeroed at the start of every frame
+    struct IntegerState {
+        uint64_t prev;   // Previous value
+        uint64_t delta;  // Previous difference
+    };
+    struct ValueState {
+        uint64_t prev;   // Previous bit pattern (lossless) or quantized value
+        unsigned lead;   // Leading zeros of the previous XOR window (64 = none yet)
+        unsigned trail;  // Trailing zeros of the previous XOR window
+    };
+
+    // Variable-length signed integer: 1, 10, 19, 36 or 68 bits
+    void writeSigned(int64_t value);
+
+    std::vector<double> m_precision;       // Per double field, 0 = lossless
+    std::vector<IntegerState> m_integers;  // Integer field state
+    std::vector<ValueState> m_values;      // Double field state
+    BitWriter m_bits;                      // Frame being written
+    size_t m_records;                      // Records in the frame
+    size_t m_record_bytes;                 // Worst-case record size
+    size_t m_table_bytes;                  // Upper bound on the precision table
+};
+
+// TelemetryDecoder class: Reads frames written by a TelemetryEncoder of the same shape
+class TelemetryDecoder {
+public:
+    // Constructor for records of integers integer fields and values double fields
+    TelemetryDecoder(size_t integers, size_t values);
+
+    // Start reading a frame; false if its precision table is malformed
+    bool begin(const unsigned char* data, size_t size);
+
+    // Read the next record, writing double field i to values[i * stride]; false if the
+    // frame ends or is malformed
+    bool next(uint64_t* integers, double* values, size_t stride = 1);
+
+    // State query functions
+    size_t integers() const;  // Integer fields per record
+    size_t values() const;    // Double fields per record
+    size_t maxRecords(size_t bytes) const; // Most records bytes can hold, every field taking a bit or more
+
+private:
+    // Inverse of TelemetryEncoder::writeSigned
+    int64_t readSigned();
+
+    std::vector<double> m_precision;  // Read from the frame's table
+    std::vector<double> m_divisor;    // 1 / precision when that is a whole number, else 0
+    std::vector<uint64_t> m_prev;     // Previous integer values
+    std::vector<uint64_t> m_delta;    // Previous integer differences
+    std::vector<uint64_t> m_bits_prev; // Previous double bit patterns or quantized values
+    std::vector<unsigned> m_lead;     // Leading zeros of the previous XOR windows
+    std::vector<unsigned> m_trail;    // Trailing zeros of the previous XOR windows
+    BitReader m_bits;                 // Frame being read
+};
+
+// Header of a compressed message frame, followed by bytes of TelemetryEncoder output
+struct CompressedBatchHeader {
+    uint32_t magic;  // MessageCodec::MAGIC
+    uint32_t count;  // Messages in the frame
+    uint32_t bytes;  // Encoded bytes that follow
+    uint32_t reserved; // Zero
+};
+
+// Header of a compressed block frame; the encoded samples follow, each one record of
+// a timestamp and channels values
+struct CompressedBlockHeader {
+    uint32_t magic;         // BlockCodec::MAGIC
+    uint32_t channels;      // Values per sample
+    uint32_t length;        // Samples in the frame
+    uint32_t bytes;         // Encoded bytes that follow
+    uint64_t first_msg_id;  // Message id of sample 0 (ids are consecutive)
+    StageTimes stages;      // Stage stamps of the newest sample
+};
+
+// MessageCodec class: Packs MQMessages into compressed frames and unpacks them, each
+// sensor's average at that sensor's precision.
+class MessageCodec {
+public:
+    // Constructor taking one precision per sensor (empty = every field lossless)
+    explicit MessageCodec(const std::vector<double>& precision = {});
+
+    // Start a frame in out; false if capacity cannot hold one message
+    bool begin(char* out, size_t capacity);
+
+    // Append one message; false (message not added) when the frame is full
+    bool append(const MQMessage& msg);
+
+    // Write the frame header and return the frame size; appending may continue afterwards
+    size_t finish();
+
+    // Messages in the current frame
+    size_t count() const;
+
+    // Unpack every message of a frame into out; false if the frame is malformed
+    bool decode(const char* frame, size_t length, std::vector<MQMessage>& out);
+
+    // Whether data starts like a compressed message frame
+    static bool isFrame(const char* data, size_t length);
+
+    static constexpr uint32_t MAGIC = 0x4d53475a; // "MSGZ"
+
+private:
+    // Integer fields: id, timestamp and three stage stamps
+    static constexpr size_t INTEGERS = 5;
+    // Double fields: the average of every sensor
+    static constexpr size_t VALUES = NUM_SENSORS;
+
+    TelemetryEncoder m_encoder;     // Frame being packed
+    TelemetryDecoder m_decoder;     // Frame being unpacked
+    char* m_frame;                  // Start of the frame being packed
+    uint64_t m_integers[INTEGERS];  // One message as codec fields
+    double m_values[VALUES];        // One message as codec fields
+};
+
+// Fields of a decoded block frame, columns stored one after another
+struct DecodedBlock {
+    uint64_t first_msg_id = 0;  // Message id of sample 0
+    size_t channels = 0;        // Number of columns
+    size_t length = 0;          // Samples per column
+    StageTimes stages;          // Stage stamps of the newest sample
+    std::vector<std::chrono::system_clock::time_point> timestamps; // One per sample
+    std::vector<double> values; // Column-major values
+};
+
+// BlockCodec class: Compresses registry mode blocks, one record per sample holding its
+// timestamp and every channel, with one precision per channel
+class BlockCodec {
+public:
+    // Constructor taking one precision per channel (0 = lossless); decoding needs none
+    explicit BlockCodec(const std::vector<double>& precision = {});
+
+    // Compress length samples of column-major values into out, channel ch starting at
+    // values + ch * stride (stride >= length); returns the frame size, or 0 if it might
+    // not fit in capacity
+    size_t encode(uint64_t first_msg_id, const StageTimes& stages,
+                  const std::chrono::system_clock::time_point* timestamps, const double* values,
+                  size_t stride, size_t length, char* out, size_t capacity);
+
+    // Unpack a frame into block; false if the frame is malformed
+    bool decode(const char* frame, size_t length, DecodedBlock& block);
+
+    // Channels the encoder was built for
+    size_t channels() const;
+
+    // Largest frame encode() can produce for the given block shape
+    static size_t maxFrameBytes(size_t channels, size_t length);
+
+    // Whether data starts like a compressed block frame
+    static bool isFrame(const char* data, size_t length);
+
+    static constexpr uint32_t MAGIC = 0x424c4b5a; // "BLKZ"
+
+private:
+    size_t m_channels;            // Channels the encoder was built for
+    TelemetryEncoder m_encoder;   // Encoder over m_channels value fields
+    TelemetryDecoder m_decoder;   // Rebuilt when a frame has a different channel count
+};
+
+// Per-channel precision from PATTERN=STEP assignments: PATTERN is a channel name, a
+// prefix ending in '*' or '*', STEP a positive number or "lossless"; later assignments
+// win. Throws std::invalid_argument for a malformed assignment or an unmatched pattern.
+std::vector<double> parsePrecision(const ChannelRegistry& channels,
+                                   const std::vector<std::string>& assignments);
+
+} // namespace sensor
@@ -0,0 +1,169 @@
+#pragma once
+
+#include "common.hpp"
+#include "channel_registry.hpp"
+#include "sample_block.hpp"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace sensor {
+
+// One point of a query result: the samples of one channel that fall in
+// [start_ns, start_ns + duration_ns). A raw sample is a point of duration 0.
+struct SeriesPoint {
+    int64_t start_ns;     // Start of the interval, nanoseconds since the epoch
+    int64_t duration_ns;  // Interval length (0 = one raw sample)
+    uint64_t count;       // Samples folded into the point
+    double min;           // Smallest sample
+    double max;           // Largest sample
+    double mean;          // Average of the samples
+};
+
+// Width and length of one rollup tier
+struct RollupTier {
+    int64_t width_ns;  // Bucket width
+    size_t buckets;    // Buckets kept
+};
+
+// TimeSeriesStore class: In-memory history of every channel. The newest samples are kept
+// raw; older ones survive as min/max/sum buckets of 1 s, 1 min and 1 h, each tier rolled up
+// from the one below when a bucket closes. All memory is allocated by the constructor and
+// every tier is a ring ordered by time, so its timestamps double as a binary-searched index.
+// One thread pushes; any number of threads query at the same time without locks. Like
+// BroadcastRing, a writer announces the slots it is about to overwrite before touching them
+// and publishes them afterwards, and a reader drops whatever was announced while it copied,
+// so queries never hold up ingestion.
+class TimeSeriesStore {
+public:
+    using TimePoint = std::chrono::system_clock::time_point;
+
+    // Constructor for channels channels keeping raw_samples raw samples; block is the
+    // longest block pushBlock() will see. Throws std::invalid_argument for zero sizes.
+    // Samples leaving the raw ring before their 1 s bucket closes are not queryable until
+    // it does, so keep at least a second of raw samples.
+    TimeSeriesStore(size_t channels, size_t raw_samples, size_t block);
+
+    // Big 5: readers hold on to the rings while the store lives
+    TimeSeriesStore(const TimeSeriesStore&) = delete;
+    TimeSeriesStore& operator=(const TimeSeriesStore&) = delete;
+    TimeSeriesStore(TimeSeriesStore&&) = delete;
+    TimeSeriesStore& operator=(TimeSeriesStore&&) = delete;
+
+    // Store one sample, values[ch] for every channel
+    void push(TimePoint time, const double* values);
+
+    // Store a block: beginBlock(), pushChannels() over every channel, commitBlock()
+    void pushBlock(const SampleBlock& block);
+
+    // Sharded pushBlock(): beginBlock() first, then pushChannels() over disjoint channel
+    // ranges (concurrently if wanted), then commitBlock() to publish the block
+    void beginBlock(const SampleBlock& block);
+    void pushChannels(const SampleBlock& block, size_t first, size_t last);
+    void commitBlock(const SampleBlock& block);
+
+    // One channel between from_ns and to_ns (nanoseconds since the epoch) at resolution_ns:
+    // every stored point starting in [from_ns, to_ns), merged into resolution_ns wide
+    // buckets (0 = raw samples). Each part of the range comes from the coarsest tier no
+    // wider than the resolution that still holds it, else from the nearest tier that does,
+    // so points older than that tier's horizon may be wider than asked for. Replaces the
+    // contents of out and returns the number of points.
+    size_t query(size_t channel, int64_t from_ns, int64_t to_ns, int64_t resolution_ns,
+                 std::vector<SeriesPoint>& out) const;
+
+    // Print memory use and the time span each tier holds
+    void report(std::ostream& os) const;
+
+    // State query functions
+    size_t channels() const;      // Values per sample
+    size_t rawCapacity() const;   // Raw samples kept
+    size_t memoryBytes() const;   // Bytes allocated for samples and buckets
+
+    // Rollup tiers, finest first; each width divides the next
+    static constexpr size_t TIER_COUNT = 3;
+    static constexpr RollupTier TIERS[TIER_COUNT] = {
+        {1000000000LL, 3600},     // 1 s for an hour
+        {60000000000LL, 1440},    // 1 min for a day
+        {3600000000000LL, 168}    // 1 h for a week
+    };
+
+private:
+    // A ring of buckets (raw samples are buckets of one) that one writer fills in time order
+    struct Ring {
+        int64_t width;               // Bucket width (0 = raw samples)
+        size_t capacity;             // Slots
+        std::vector<int64_t> start;  // Bucket start (raw: sample time) per slot
+        std::vector<uint64_t> count; // Samples per slot (unused for raw)
+        std::vector<double> min;     // [channel * capacity + slot]; raw: the sample
+        std::vector<double> max;     // [channel * capacity + slot] (unused for raw)
+        std::vector<double> sum;     // [channel * capacity + slot] (unused for raw)
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> claim; // Slots announced
+        alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head;  // Slots published
+    };
+
+    // Bucket being filled for one rollup tier, private to the writer
+    struct OpenBucket {
+        int64_t start;            // Bucket start
+        uint64_t count;           // Samples so far (0 = none yet)
+        std::vector<double> min;  // Per channel
+        std::vector<double> max;  // Per channel
+        std::vector<double> sum;  // Per channel
+    };
+
+    // A change of 1 s bucket inside a block: closes rollup tiers [0, closes) before sample
+    struct Boundary {
+        size_t sample;    // First sample of the new bucket
+        size_t closes;    // Tiers whose open bucket ends here
+    };
+
+    // A copied bucket, before regrouping
+    struct Bucket {
+        int64_t start;   // Bucket start
+        uint64_t count;  // Samples
+        double min;      // Smallest sample
+        double max;      // Largest sample
+        double sum;      // Sum of the samples
+    };
+
+    // Clamp times so they never go backwards, find bucket boundaries and announce slots
+    void begin(const TimePoint* times, size_t length);
+
+    // Write length consecutive samples of one channel to the raw ring and the rollup tiers
+    void pushChannel(size_t channel, const double* column, size_t length);
+
+    // Publish every slot begin() announced
+    void commit();
+
+    // Oldest bucket start and end of the newest bucket of a ring; false while it is empty
+    bool span(const Ring& ring, int64_t& oldest, int64_t& end) const;
+
+    // Append the buckets of one channel starting in [from_ns, to_ns) to out; buckets
+    // overwritten while they were copied are left out
+    void copy(const Ring& ring, size_t channel, int64_t from_ns, int64_t to_ns,
+              std::vector<Bucket>& out) const;
+
+    // Ring of a level: 0 = raw, 1 + t = rollup tier t
+    const Ring& level(size_t index) const;
+
+    size_t m_channels;                      // Values per sample
+    Ring m_raw;                             // Newest samples
+    std::unique_ptr<Ring[]> m_tiers;        // One per TIERS entry
+    std::vector<OpenBucket> m_open;         // One per TIERS entry
+    std::vector<int64_t> m_times;           // Clamped times of the block being pushed
+    std::vector<Boundary> m_boundaries;     // Bucket boundaries of the block being pushed
+    size_t m_pending[TIER_COUNT];           // Buckets each tier closes in the block
+    int64_t m_newest;                       // Latest time pushed
+};
+
+// Answer a /series query of the metrics socket as CSV (start_ns,duration_ns,count,min,max,
+// mean). params is the URL query string: channel=NAME (required, percent-encoded),
+// from=S and to=S in seconds since the epoch, or relative to now when zero or negative
+// (defaults -60 and 0), and step=S, the resolution in seconds (default 0 = raw samples).
+// Throws std::invalid_argument for an unknown channel or a malformed parameter.
+std::string seriesCsv(const TimeSeriesStore& store, const ChannelRegistry& channels,
+                      const std::string& params);
+
+} // namespace sensor
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "common.hpp"
+#include <vector>
+
+namespace sensor {
+
+// WindowAggregator class: Mean, variance, min and max of every channel over several
+// sliding windows at once, updated in one pass per sample. All windows share one
+// sample history sized for the longest window. Moments use a sliding Welford update
+// (add newest, remove evicted) with periodic exact recomputation. Min and max use
+// monotonic deques of sample positions, so each sample enters and leaves each deque
+// at most once. Cost per sample is O(channels x windows) amortized and independent of
+// window length. Memory grows linearly with the longest window, measured in samples.
+class WindowAggregator {
+public:
+    // Constructor that preallocates history and deques for the given window lengths (in samples)
+    WindowAggregator(size_t channels, const std::vector<size_t>& windows);
+
+    // Add one sample (one value per channel) to every window
+    void push(const double* values);
+
+    // Write the statistics of one window for every channel. Each output array holds
+    // channels() values. Variance is the unbiased sample variance (0 below two samples).
+    void stats(size_t window, double* mean, double* min, double* max, double* variance) const;
+
+    // Discard all samples, keeping allocations
+    void reset();
+
+    // State query functions
+    size_t channels() const;                  // Number of channels tracked
+    size_t windowCount() const;               // Number of windows
+    size_t windowLength(size_t window) const; // Maximum samples in a window
+    size_t count(size_t window) const;        // Samples currently in a window
+
+private:
+    // Positions (sample sequence numbers, truncated to 32 bits to halve memory) kept in a
+    // power-of-two ring; head/tail only grow
+    struct MonotonicDeque {
+        size_t offset = 0;  // Start of this deque's ring in m_deque_storage
+        uint64_t head = 0;  // Position of the front entry
+        uint64_t tail = 0;  // Position one past the back entry
+    };
+
+    // Running state of one channel in one window
+    struct ChannelState {
+        double mean = 0.0;     // Running mean
+        double m2 = 0.0;       // Sum of squared deviations from the mean
+        MonotonicDeque min;    // Positions of ascending values: front is the minimum
+        MonotonicDeque max;    // Positions of descending values: front is the maximum
+    };
+
+    // One sliding window over the shared history
+    struct Window {
+        size_t length = 0;                 // Window length in samples
+        uint64_t deque_mask = 0;           // Deque ring capacity - 1
+        size_t count = 0;                  // Samples currently in the window
+        size_t since_renormalize = 0;      // Pushes since the last exact recomputation
+        bool cancelled = false;            // An eviction cancelled most of m2 since then
+        std::vector<ChannelState> states;  // One per channel
+    };
+
+    // Recompute one window's means and squared deviations exactly from the history
+    void renormalize(Window& window);
+
+    // Value of channel at sample position
+    double valueAt(size_t channel, uint64_t position) const;
+
+    // Number of full passes over a window between exact recomputations
+    static constexpr size_t RENORMALIZE_PASSES = 16;
+
+    // An eviction that shrinks m2 by more than this factor has lost most significant
+    // digits (a large outlier left the window), so recompute after one window length
+    static constexpr double CANCELLATION_RATIO = 1e6;
+
+    size_t m_channels;                   // Number of channels tracked
+    std::vector<Window> m_windows;       // Windows in configuration order
+    size_t m_history_capacity;           // Samples per history column (power of two)
+    uint64_t m_history_mask;             // m_history_capacity - 1
+    std::vector<double> m_history;       // Channel-major history: [channel * capacity + (position & mask)]
+    std::vector<uint32_t> m_deque_storage; // Ring storage of every monotonic deque (positions mod 2^32)
+    uint64_t m_position;                 // Sequence number of the next sample
+};
+
+} // namespace sensor
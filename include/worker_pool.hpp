@@ -0,0 +1,75 @@
+#pragma once
+
+#include "common.hpp"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace sensor {
+
+// WorkerPool class: Runs one task over a set of shards on a fixed group of threads, the
+// calling thread included. Each run() deals the shards out in contiguous ranges, one per
+// thread, so neighbouring shards (and the memory they touch) stay on one core; a thread
+// that finishes its range early steals shards from the back of another thread's range.
+// Ranges are single atomic words in cache-line padded slots, so claiming a shard is one
+// CAS and threads never write to each other's lines except to steal.
+class WorkerPool {
+public:
+    // Work for one shard; called with each shard index exactly once per run()
+    using Task = std::function<void(size_t shard)>;
+
+    // Constructor that starts threads - 1 workers; the thread calling run() is worker 0.
+    // Workers take the SCHED_FIFO priority of policy but are never pinned.
+    WorkerPool(size_t threads, const ThreadPolicy& policy);
+
+    // Destructor stops and joins the workers
+    ~WorkerPool();
+
+    // Big 5: owns threads that point back at this object
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+    WorkerPool(WorkerPool&&) = delete;
+    WorkerPool& operator=(WorkerPool&&) = delete;
+
+    // Run task on shards [0, shards) across the pool and return once every one has finished
+    void run(size_t shards, const Task& task);
+
+    // State query functions
+    size_t threads() const;   // Threads sharing the work, the caller included
+    uint64_t steals() const;  // Shards run by a thread other than the one they were dealt to
+
+private:
+    // Shards dealt to one thread: begin in the low 32 bits, end in the high 32 bits
+    struct alignas(CACHE_LINE_SIZE) Queue {
+        std::atomic<uint64_t> range{0};
+    };
+
+    // Sleep until a run starts, then help finish it
+    void workerLoop(size_t index, ThreadPolicy policy);
+
+    // Run shards from the own range, then from the others, until none are left
+    void drain(size_t index);
+
+    // Claim the next shard from the front of a thread's own range
+    bool popFront(size_t index, size_t& shard);
+
+    // Claim the last shard of some other thread's range
+    bool steal(size_t thief, size_t& shard);
+
+    std::vector<Queue> m_queues;            // One range per thread
+    std::vector<std::thread> m_workers;     // Threads 1..n-1
+    std::atomic<const Task*> m_task;        // Task of the current run
+    std::atomic<size_t> m_pending;          // Shards of the current run not finished yet
+    std::atomic<uint64_t> m_steals;         // Shards taken from another thread's range
+
+    std::mutex m_mutex;                     // Guards m_generation and m_stop
+    std::condition_variable m_wake;         // Signals a new run or shutdown
+    uint64_t m_generation;                  // Incremented by every run()
+    bool m_stop;                            // Set once to end the workers
+};
+
+} // namespace sensor
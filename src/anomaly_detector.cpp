@@ -0,0 +1,271 @@
+#include "anomaly_detector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace sensor {
+
+namespace {
+    // Default thresholds, in declared stddevs. On independent in-spec noise zscore and roc
+    // practically never fire, while ewma and cusum raise about one false alert per 25,000
+    // to 50,000 readings of a channel in exchange for catching a 1 stddev shift in about 18.
+    constexpr double DEFAULT_Z = 6.0;
+    constexpr double DEFAULT_LAMBDA = 0.1;
+    constexpr double DEFAULT_EWMA_L = 4.0;
+    constexpr double DEFAULT_CUSUM_K = 0.5;
+    constexpr double DEFAULT_CUSUM_H = 10.0;
+    constexpr double DEFAULT_RATE = 8.0;
+
+    // Bit: Mask of one check
+    constexpr uint32_t bit(AnomalyKind kind) {
+        return uint32_t{1} << static_cast<uint32_t>(kind);
+    }
+
+    // Parameter: Field index of a specification as a positive number, or fallback if absent
+    double parameter(const std::vector<std::string>& fields, size_t index, double fallback,
+                     const std::string& spec) {
+        if (index >= fields.size()) {
+            return fallback;
+        }
+        size_t used = 0;
+        double value = 0.0;
+        try {
+            value = std::stod(fields[index], &used);
+        } catch (const std::logic_error&) {
+            used = 0;
+        }
+        if (used != fields[index].size() || !(value > 0.0) || !std::isfinite(value)) {
+            throw std::invalid_argument("Detector parameters must be positive numbers: " + spec);
+        }
+        return value;
+    }
+}
+
+// AnomalyKindName: Short lowercase name, as accepted by the detector specifications
+const char* anomalyKindName(AnomalyKind kind) {
+    switch (kind) {
+        case AnomalyKind::ZSCORE: return "zscore";
+        case AnomalyKind::EWMA:   return "ewma";
+        case AnomalyKind::CUSUM:  return "cusum";
+        case AnomalyKind::RATE:   return "roc";
+        default:                  return "unknown";
+    }
+}
+
+// Constructor: Start every channel in control with the default thresholds, then apply
+// the assignments in order
+AnomalyDetector::AnomalyDetector(const ChannelRegistry& channels, const std::vector<std::string>& assignments)
+    : m_specs(assignments)
+    , m_samples(0)
+    , m_alerts{}
+{
+    m_channels.resize(channels.size());
+    for (size_t ch = 0; ch < channels.size(); ++ch) {
+        Channel& c = m_channels[ch];
+        c = Channel{};
+        c.mean = channels[ch].mean;
+        c.inv_stddev = channels[ch].stddev > 0.0 ? 1.0 / channels[ch].stddev : 0.0;
+        c.z_limit = DEFAULT_Z;
+        c.lambda = DEFAULT_LAMBDA;
+        c.ewma_limit = DEFAULT_EWMA_L * std::sqrt(DEFAULT_LAMBDA / (2.0 - DEFAULT_LAMBDA));
+        c.cusum_k = DEFAULT_CUSUM_K;
+        c.cusum_h = DEFAULT_CUSUM_H;
+        c.rate_limit = DEFAULT_RATE;
+    }
+
+    for (const std::string& assignment : assignments) {
+        const size_t eq = assignment.find('=');
+        const std::string pattern = eq == std::string::npos ? "*" : assignment.substr(0, eq);
+        const std::string spec = eq == std::string::npos ? assignment : assignment.substr(eq + 1);
+        const std::vector<std::string> fields = splitFields(spec, ':');
+        if (pattern.empty() || fields.empty()) {
+            throw std::invalid_argument("Detector assignments take the form [CHANNEL=]SPEC: " + assignment);
+        }
+        const std::string& name = fields[0];
+
+        // Parameter count per check: zscore and roc take one, ewma and cusum two
+        size_t allowed = 0;
+        if (name == "zscore" || name == "roc") {
+            allowed = 1;
+        } else if (name == "ewma" || name == "cusum") {
+            allowed = 2;
+        } else if (name != "all" && name != "none") {
+            throw std::invalid_argument("Unknown detector: " + assignment);
+        }
+        if (fields.size() > allowed + 1) {
+            throw std::invalid_argument("Too many detector parameters: " + assignment);
+        }
+
+        const std::vector<size_t> matched = channels.find(pattern);
+        if (matched.empty()) {
+            throw std::invalid_argument("Detector pattern matches no channel: " + pattern);
+        }
+        for (size_t ch : matched) {
+            Channel& c = m_channels[ch];
+            if (c.inv_stddev == 0.0) {
+                continue;
+            }
+            if (name == "none") {
+                c.checks = 0;
+            } else if (name == "all") {
+                c.checks = bit(AnomalyKind::ZSCORE) | bit(AnomalyKind::EWMA)
+                         | bit(AnomalyKind::CUSUM) | bit(AnomalyKind::RATE);
+            } else if (name == "zscore") {
+                c.checks |= bit(AnomalyKind::ZSCORE);
+                c.z_limit = parameter(fields, 1, DEFAULT_Z, assignment);
+            } else if (name == "ewma") {
+                c.checks |= bit(AnomalyKind::EWMA);
+                c.lambda = parameter(fields, 1, DEFAULT_LAMBDA, assignment);
+                if (c.lambda > 1.0) {
+                    throw std::invalid_argument("EWMA weight must not exceed 1: " + assignment);
+                }
+                // Limit at L standard deviations of the EWMA itself in steady state
+                c.ewma_limit = parameter(fields, 2, DEFAULT_EWMA_L, assignment)
+                             * std::sqrt(c.lambda / (2.0 - c.lambda));
+            } else if (name == "cusum") {
+                c.checks |= bit(AnomalyKind::CUSUM);
+                c.cusum_k = parameter(fields, 1, DEFAULT_CUSUM_K, assignment);
+                c.cusum_h = parameter(fields, 2, DEFAULT_CUSUM_H, assignment);
+            } else {
+                c.checks |= bit(AnomalyKind::RATE);
+                c.rate_limit = parameter(fields, 1, DEFAULT_RATE, assignment);
+            }
+        }
+    }
+}
+
+// Push: One reading of every channel, numbered by the readings seen so far
+void AnomalyDetector::push(TimePoint time, uint64_t generated_ns, const double* values,
+                           std::vector<AnomalyAlert>& out) {
+    for (size_t ch = 0; ch < m_channels.size(); ++ch) {
+        check(ch, values + ch, &time, 1, generated_ns, out);
+    }
+    ++m_samples;
+}
+
+// PushBlock: Every channel, then advance the reading count
+void AnomalyDetector::pushBlock(const SampleBlock& block, std::vector<AnomalyAlert>& out) {
+    pushChannels(block, 0, m_channels.size(), out);
+    commitBlock(block);
+}
+
+// PushChannels: Walk each column once; channels beyond the detector's are ignored
+void AnomalyDetector::pushChannels(const SampleBlock& block, size_t first, size_t last,
+                                   std::vector<AnomalyAlert>& out) {
+    last = std::min({last, m_channels.size(), block.channels()});
+    for (size_t ch = first; ch < last; ++ch) {
+        check(ch, block.column(ch), block.timestamps(), block.length(), block.stages().generated_ns, out);
+    }
+}
+
+// CommitBlock: The block's readings are numbered from here on
+void AnomalyDetector::commitBlock(const SampleBlock& block) {
+    m_samples += block.length();
+}
+
+// Check: Update each enabled statistic from the z-score of the reading; an alert marks
+// the reading that takes a statistic past its threshold, and the check re-arms once the
+// statistic is back inside. Non-finite readings leave the state untouched.
+void AnomalyDetector::check(size_t channel, const double* column, const TimePoint* times, size_t length,
+                            uint64_t generated_ns, std::vector<AnomalyAlert>& out) {
+    if (m_channels[channel].checks == 0) {
+        return;
+    }
+
+    // Work on a copy so the state stays in registers across alerts appended to out
+    Channel c = m_channels[channel];
+    const uint64_t first = m_samples;
+    for (size_t s = 0; s < length; ++s) {
+        const double z = (column[s] - c.mean) * c.inv_stddev;
+        if (!std::isfinite(z)) {
+            continue;
+        }
+        double score[static_cast<size_t>(AnomalyKind::COUNT)] = {};
+        double limit[static_cast<size_t>(AnomalyKind::COUNT)] = {};
+        uint32_t crossed = 0;
+
+        if (c.checks & bit(AnomalyKind::ZSCORE)) {
+            score[0] = z;
+            limit[0] = c.z_limit;
+            crossed |= std::fabs(z) > c.z_limit ? bit(AnomalyKind::ZSCORE) : 0;
+        }
+        if (c.checks & bit(AnomalyKind::EWMA)) {
+            c.ewma += c.lambda * (z - c.ewma);
+            score[1] = c.ewma;
+            limit[1] = c.ewma_limit;
+            crossed |= std::fabs(c.ewma) > c.ewma_limit ? bit(AnomalyKind::EWMA) : 0;
+        }
+        if (c.checks & bit(AnomalyKind::CUSUM)) {
+            // Clamped so a long fault does not delay re-arming by as long again
+            const double ceiling = 2.0 * c.cusum_h;
+            c.cusum_high = std::min(std::max(0.0, c.cusum_high + z - c.cusum_k), ceiling);
+            c.cusum_low = std::min(std::max(0.0, c.cusum_low - z - c.cusum_k), ceiling);
+            score[2] = c.cusum_high >= c.cusum_low ? c.cusum_high : -c.cusum_low;
+            limit[2] = c.cusum_h;
+            crossed |= std::fabs(score[2]) > c.cusum_h ? bit(AnomalyKind::CUSUM) : 0;
+        }
+        if (c.checks & bit(AnomalyKind::RATE)) {
+            score[3] = c.primed ? z - c.previous : 0.0;
+            limit[3] = c.rate_limit;
+            crossed |= std::fabs(score[3]) > c.rate_limit ? bit(AnomalyKind::RATE) : 0;
+            c.previous = z;
+            c.primed = true;
+        }
+
+        // Usually zero, so the common path is the statistics above and nothing else
+        const uint32_t rising = crossed & ~c.active;
+        c.active = crossed;
+        if (rising == 0) {
+            continue;
+        }
+        for (size_t k = 0; k < static_cast<size_t>(AnomalyKind::COUNT); ++k) {
+            if (rising & bit(static_cast<AnomalyKind>(k))) {
+                out.push_back(AnomalyAlert{first + s, times[s], generated_ns,
+                                           static_cast<uint32_t>(channel), static_cast<AnomalyKind>(k),
+                                           column[s], score[k], limit[k]});
+                m_alerts[k].fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+    m_channels[channel] = c;
+}
+
+// Report: One line with the assignments, then the alerts per check
+void AnomalyDetector::report(std::ostream& os) const {
+    os << "Anomaly detection: " << checkedChannels() << " of " << m_channels.size() << " channels (";
+    for (size_t i = 0; i < m_specs.size(); ++i) {
+        os << (i ? ", " : "") << m_specs[i];
+    }
+    os << "), " << m_samples << " readings, alerts:";
+    for (size_t k = 0; k < static_cast<size_t>(AnomalyKind::COUNT); ++k) {
+        os << " " << anomalyKindName(static_cast<AnomalyKind>(k)) << " "
+           << m_alerts[k].load(std::memory_order_relaxed);
+    }
+    os << "\n";
+}
+
+// Channels: Returns the number of channels known to the detector
+size_t AnomalyDetector::channels() const {
+    return m_channels.size();
+}
+
+// CheckedChannels: Channels with at least one check enabled
+size_t AnomalyDetector::checkedChannels() const {
+    size_t checked = 0;
+    for (const Channel& c : m_channels) {
+        checked += c.checks != 0;
+    }
+    return checked;
+}
+
+// Alerts: Returns the alerts raised by one check so far
+uint64_t AnomalyDetector::alerts(AnomalyKind kind) const {
+    return m_alerts[static_cast<size_t>(kind)].load(std::memory_order_relaxed);
+}
+
+// Samples: Returns the readings seen so far
+uint64_t AnomalyDetector::samples() const {
+    return m_samples;
+}
+
+} // namespace sensor
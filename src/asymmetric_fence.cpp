@@ -0,0 +1,36 @@
+#include "asymmetric_fence.hpp"
+
+#ifdef __linux__
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace sensor {
+
+// RegisterAsymmetricFence: Query for the private expedited command, then register for it
+bool registerAsymmetricFence() {
+#if defined(__linux__) && defined(SYS_membarrier)
+    const long commands = syscall(SYS_membarrier, MEMBARRIER_CMD_QUERY, 0, 0);
+    if (commands < 0 || !(commands & MEMBARRIER_CMD_PRIVATE_EXPEDITED)) {
+        return false;
+    }
+    return syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+#else
+    return false;
+#endif
+}
+
+// HeavyFence: membarrier(2) once registered; it cannot fail after registration, but a
+// failure still falls back to ordering the calling thread
+void heavyFence() {
+#if defined(__linux__) && defined(SYS_membarrier)
+    if (asymmetricFenceAvailable()
+        && syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0) == 0) {
+        return;
+    }
+#endif
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+} // namespace sensor
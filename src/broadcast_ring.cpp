@@ -0,0 +1,431 @@
+#include "broadcast_ring.hpp"
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <climits>
+#include <new>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
+namespace sensor {
+
+namespace {
+    constexpr uint32_t BROADCAST_MAGIC = 0x42435231;  // "BCR1"
+    constexpr uint32_t BROADCAST_VERSION = 1;
+    constexpr mode_t SHM_PERMISSIONS = 0660;          // rw-rw----
+
+    // Subscriber entry states
+    constexpr uint32_t ENTRY_FREE = 0;      // Available to claim
+    constexpr uint32_t ENTRY_CLAIMING = 1;  // Being initialized by a new subscriber
+    constexpr uint32_t ENTRY_ACTIVE = 2;    // Reading; visible to the producer's lag checks
+
+    // Publishes between two producer scans of the subscriber table (power of two)
+    constexpr uint64_t SCAN_INTERVAL = 64;
+}
+
+// Control block at the start of the mapping; producer and wakeup fields on separate lines
+struct BroadcastRing::Header {
+    std::atomic<uint32_t> magic;   // BROADCAST_MAGIC once the creator finished initializing
+    uint32_t version;              // Layout version
+    uint64_t slot_size;            // Maximum payload bytes per slot
+    uint64_t capacity;             // Number of slots (power of two)
+    uint64_t stride;               // Bytes between consecutive slots
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> write_pos;  // Next position to publish
+    std::atomic<uint64_t> slow_events;                         // Slow flags raised so far
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> wake_seq;   // Futex word bumped on wakeups
+    std::atomic<uint32_t> waiters;                             // Subscribers parked on wake_seq
+};
+
+// One subscriber; written by its owner except for the producer-maintained slow flag and reclaim
+struct alignas(CACHE_LINE_SIZE) BroadcastRing::SubscriberEntry {
+    std::atomic<uint32_t> state;     // ENTRY_FREE, ENTRY_CLAIMING or ENTRY_ACTIVE
+    std::atomic<uint32_t> slow;      // Set by the producer while the subscriber lags
+    std::atomic<int32_t> pid;        // Owner process
+    std::atomic<uint64_t> cursor;    // Next position the subscriber will read
+    std::atomic<uint64_t> received;  // Messages read
+    std::atomic<uint64_t> lost;      // Messages overwritten before they were read
+};
+
+// Per-slot header; the payload follows immediately
+struct BroadcastRing::SlotHeader {
+    std::atomic<uint64_t> seq;     // pos + 1 once position pos is published, 0 while rewriting
+    std::atomic<uint64_t> length;  // Payload bytes
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "futex word must be lock-free");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "slot sequence must be lock-free");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be 32 bits");
+
+// Create: Replace any stale segment, size it, and initialize header, table and slots
+std::unique_ptr<BroadcastRing> BroadcastRing::create(const std::string& name, size_t slot_size, size_t slots) {
+    shm_unlink(name.c_str());
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, SHM_PERMISSIONS);
+    if (fd == -1) {
+        return nullptr;
+    }
+
+    const size_t capacity = roundUpPow2(slots);
+    const size_t stride = roundUp(sizeof(SlotHeader) + slot_size, CACHE_LINE_SIZE);
+    const size_t table = roundUp(sizeof(Header), CACHE_LINE_SIZE) + MAX_SUBSCRIBERS * sizeof(SubscriberEntry);
+    const size_t total = table + stride * capacity;
+
+    if (ftruncate(fd, static_cast<off_t>(total)) == -1) {
+        close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    void* base = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    // Construct everything in the zero-filled segment
+    Header* header = new (base) Header;
+    header->version = BROADCAST_VERSION;
+    header->slot_size = slot_size;
+    header->capacity = capacity;
+    header->stride = stride;
+    header->write_pos.store(0, std::memory_order_relaxed);
+    header->slow_events.store(0, std::memory_order_relaxed);
+    header->wake_seq.store(0, std::memory_order_relaxed);
+    header->waiters.store(0, std::memory_order_relaxed);
+
+    char* entries = static_cast<char*>(base) + roundUp(sizeof(Header), CACHE_LINE_SIZE);
+    for (size_t i = 0; i < MAX_SUBSCRIBERS; ++i) {
+        SubscriberEntry* entry = new (entries + i * sizeof(SubscriberEntry)) SubscriberEntry;
+        entry->state.store(ENTRY_FREE, std::memory_order_relaxed);
+        entry->slow.store(0, std::memory_order_relaxed);
+        entry->pid.store(0, std::memory_order_relaxed);
+        entry->cursor.store(0, std::memory_order_relaxed);
+        entry->received.store(0, std::memory_order_relaxed);
+        entry->lost.store(0, std::memory_order_relaxed);
+    }
+
+    char* slot_base = static_cast<char*>(base) + table;
+    for (size_t i = 0; i < capacity; ++i) {
+        SlotHeader* slot = new (slot_base + i * stride) SlotHeader;
+        slot->seq.store(0, std::memory_order_relaxed);
+        slot->length.store(0, std::memory_order_relaxed);
+    }
+
+    // Publish the layout last so an early subscribe() never sees a half-built ring
+    header->magic.store(BROADCAST_MAGIC, std::memory_order_release);
+
+    return std::unique_ptr<BroadcastRing>(new BroadcastRing(name, base, total, true, -1));
+}
+
+// Subscribe: Map an existing segment, validate it and claim a free subscriber entry
+std::unique_ptr<BroadcastRing> BroadcastRing::subscribe(const std::string& name, size_t slot_size) {
+    int fd = shm_open(name.c_str(), O_RDWR, SHM_PERMISSIONS);
+    if (fd == -1) {
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        close(fd);
+        return nullptr;
+    }
+
+    const size_t total = static_cast<size_t>(st.st_size);
+    void* base = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return nullptr;
+    }
+
+    const Header* header = static_cast<const Header*>(base);
+    const size_t table = roundUp(sizeof(Header), CACHE_LINE_SIZE) + MAX_SUBSCRIBERS * sizeof(SubscriberEntry);
+    const bool valid = header->magic.load(std::memory_order_acquire) == BROADCAST_MAGIC
+        && header->version == BROADCAST_VERSION
+        && header->slot_size >= slot_size
+        && table + header->stride * header->capacity <= total;
+    if (!valid) {
+        munmap(base, total);
+        return nullptr;
+    }
+
+    // First free entry wins; the producer ignores it until it is marked active
+    auto* entries = reinterpret_cast<SubscriberEntry*>(static_cast<char*>(base)
+                                                       + roundUp(sizeof(Header), CACHE_LINE_SIZE));
+    for (size_t i = 0; i < MAX_SUBSCRIBERS; ++i) {
+        uint32_t expected = ENTRY_FREE;
+        if (entries[i].state.compare_exchange_strong(expected, ENTRY_CLAIMING, std::memory_order_acq_rel)) {
+            SubscriberEntry& entry = entries[i];
+            entry.pid.store(static_cast<int32_t>(getpid()), std::memory_order_relaxed);
+            entry.cursor.store(header->write_pos.load(std::memory_order_acquire), std::memory_order_relaxed);
+            entry.received.store(0, std::memory_order_relaxed);
+            entry.lost.store(0, std::memory_order_relaxed);
+            entry.slow.store(0, std::memory_order_relaxed);
+            entry.state.store(ENTRY_ACTIVE, std::memory_order_release);
+            return std::unique_ptr<BroadcastRing>(new BroadcastRing(name, base, total, false, static_cast<int>(i)));
+        }
+    }
+
+    munmap(base, total);
+    return nullptr;
+}
+
+// Constructor: Adopt an initialized mapping
+BroadcastRing::BroadcastRing(const std::string& name, void* base, size_t mapped_size, bool owner, int subscriber)
+    : m_name(name)
+    , m_base(base)
+    , m_mapped_size(mapped_size)
+    , m_owner(owner)
+    , m_header(static_cast<Header*>(base))
+    , m_entries(reinterpret_cast<SubscriberEntry*>(static_cast<char*>(base)
+                                                   + roundUp(sizeof(Header), CACHE_LINE_SIZE)))
+    , m_slots(reinterpret_cast<char*>(m_entries + MAX_SUBSCRIBERS))
+    , m_stride(m_header->stride)
+    , m_subscriber(subscriber)
+{}
+
+// Destructor: Give the subscriber entry back, unmap, and let the creator remove the name
+BroadcastRing::~BroadcastRing() {
+    if (m_subscriber >= 0) {
+        m_entries[m_subscriber].state.store(ENTRY_FREE, std::memory_order_release);
+    }
+    munmap(m_base, m_mapped_size);
+    if (m_owner) {
+        shm_unlink(m_name.c_str());
+    }
+}
+
+// SlotAt: Masked position to slot address
+BroadcastRing::SlotHeader* BroadcastRing::slotAt(uint64_t pos) const {
+    return reinterpret_cast<SlotHeader*>(m_slots + (pos & (m_header->capacity - 1)) * m_stride);
+}
+
+// Publish: Seqlock write of the next slot; whoever has not read the old contents loses them
+bool BroadcastRing::publish(const void* data, size_t len) {
+    if (len > m_header->slot_size) {
+        return false;
+    }
+
+    const uint64_t pos = m_header->write_pos.load(std::memory_order_relaxed);
+    SlotHeader* slot = slotAt(pos);
+
+    // Mark the slot as being rewritten before touching the payload
+    slot->seq.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot->length.store(len, std::memory_order_relaxed);
+    memcpy(reinterpret_cast<char*>(slot) + sizeof(SlotHeader), data, len);
+    slot->seq.store(pos + 1, std::memory_order_release);
+    m_header->write_pos.store(pos + 1, std::memory_order_release);
+
+    if (((pos + 1) & (SCAN_INTERVAL - 1)) == 0) {
+        checkSubscribers(pos + 1);
+    }
+    wakeSubscribers();
+    return true;
+}
+
+// CheckSubscribers: Only reads cursors and flips flags, so no subscriber can stall the producer
+void BroadcastRing::checkSubscribers(uint64_t write_pos) {
+    const uint64_t capacity = m_header->capacity;
+    for (size_t i = 0; i < MAX_SUBSCRIBERS; ++i) {
+        SubscriberEntry& entry = m_entries[i];
+        if (entry.state.load(std::memory_order_acquire) != ENTRY_ACTIVE) {
+            continue;
+        }
+        const uint64_t cursor = entry.cursor.load(std::memory_order_relaxed);
+        const uint64_t lag = write_pos > cursor ? write_pos - cursor : 0;
+
+        // Hysteresis: flag at half a lap behind, clear again below a quarter
+        if (lag >= capacity / 2 && entry.slow.load(std::memory_order_relaxed) == 0) {
+            entry.slow.store(1, std::memory_order_relaxed);
+            m_header->slow_events.fetch_add(1, std::memory_order_relaxed);
+        } else if (lag < capacity / 4 && entry.slow.load(std::memory_order_relaxed) != 0) {
+            entry.slow.store(0, std::memory_order_relaxed);
+        }
+
+        // A subscriber more than a lap behind whose process is gone will never unsubscribe
+        if (lag > capacity) {
+            const pid_t pid = static_cast<pid_t>(entry.pid.load(std::memory_order_relaxed));
+            if (pid > 0 && kill(pid, 0) == -1 && errno == ESRCH) {
+                uint32_t expected = ENTRY_ACTIVE;
+                entry.state.compare_exchange_strong(expected, ENTRY_FREE, std::memory_order_acq_rel);
+            }
+        }
+    }
+}
+
+// WakeSubscribers: Pairs with waitReadable(); only enters the kernel if someone is parked
+void BroadcastRing::wakeSubscribers() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_header->waiters.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    m_header->wake_seq.fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+    // Shared futex, every parked subscriber wants every message
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_header->wake_seq), FUTEX_WAKE, INT_MAX,
+            nullptr, nullptr, 0);
+#endif
+}
+
+// Read: Copy the message at the cursor, skipping ahead past anything already overwritten
+size_t BroadcastRing::read(void* out, size_t max_len) {
+    if (m_subscriber < 0) {
+        return 0;
+    }
+    SubscriberEntry& entry = m_entries[m_subscriber];
+    const uint64_t capacity = m_header->capacity;
+    uint64_t cursor = entry.cursor.load(std::memory_order_relaxed);
+    uint64_t lost = 0;
+
+    for (;;) {
+        const uint64_t write_pos = m_header->write_pos.load(std::memory_order_acquire);
+        if (cursor == write_pos) {
+            break;
+        }
+        if (write_pos - cursor > capacity) {
+            // Lapped: the oldest message that can still be intact is one lap back
+            lost += write_pos - capacity - cursor;
+            cursor = write_pos - capacity;
+        }
+
+        SlotHeader* slot = slotAt(cursor);
+        const uint64_t seq = slot->seq.load(std::memory_order_acquire);
+        if (seq != cursor + 1) {
+            // Overwritten (or being overwritten) since write_pos was read
+            ++lost;
+            ++cursor;
+            continue;
+        }
+
+        const size_t length = std::min<size_t>({slot->length.load(std::memory_order_relaxed),
+                                                m_header->slot_size, max_len});
+        memcpy(out, reinterpret_cast<const char*>(slot) + sizeof(SlotHeader), length);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->seq.load(std::memory_order_relaxed) != seq) {
+            // The producer lapped us during the copy: the bytes may be torn
+            ++lost;
+            ++cursor;
+            continue;
+        }
+
+        entry.cursor.store(cursor + 1, std::memory_order_release);
+        entry.received.fetch_add(1, std::memory_order_relaxed);
+        if (lost > 0) {
+            entry.lost.fetch_add(lost, std::memory_order_relaxed);
+        }
+        return length;
+    }
+
+    entry.cursor.store(cursor, std::memory_order_release);
+    if (lost > 0) {
+        entry.lost.fetch_add(lost, std::memory_order_relaxed);
+    }
+    return 0;
+}
+
+// Readable: Something was published past the cursor
+bool BroadcastRing::readable() const {
+    return m_subscriber >= 0
+        && m_header->write_pos.load(std::memory_order_acquire)
+           != m_entries[m_subscriber].cursor.load(std::memory_order_relaxed);
+}
+
+// WaitReadable: Park on the futex word until the producer publishes or timeout
+bool BroadcastRing::waitReadable(std::chrono::milliseconds timeout) {
+    if (readable()) {
+        return true;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;) {
+        const uint32_t seen = m_header->wake_seq.load(std::memory_order_acquire);
+        m_header->waiters.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // Re-check after announcing ourselves so a concurrent publish cannot be missed
+        if (readable()) {
+            m_header->waiters.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        const auto remaining = deadline - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::steady_clock::duration::zero()) {
+            m_header->waiters.fetch_sub(1, std::memory_order_relaxed);
+            return false;
+        }
+
+#ifdef __linux__
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+        struct timespec ts;
+        ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+        ts.tv_nsec = static_cast<long>(ns % 1000000000);
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_header->wake_seq), FUTEX_WAIT, seen,
+                &ts, nullptr, 0);
+#else
+        (void)seen;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+#endif
+        m_header->waiters.fetch_sub(1, std::memory_order_relaxed);
+
+        if (readable()) {
+            return true;
+        }
+    }
+}
+
+// Lost: Returns messages this subscriber lost to overwrites
+uint64_t BroadcastRing::lost() const {
+    return m_subscriber >= 0 ? m_entries[m_subscriber].lost.load(std::memory_order_relaxed) : 0;
+}
+
+// Subscribers: Relaxed snapshot of every active entry
+std::vector<BroadcastRing::SubscriberStats> BroadcastRing::subscribers() const {
+    std::vector<SubscriberStats> result;
+    const uint64_t write_pos = m_header->write_pos.load(std::memory_order_acquire);
+    for (size_t i = 0; i < MAX_SUBSCRIBERS; ++i) {
+        const SubscriberEntry& entry = m_entries[i];
+        if (entry.state.load(std::memory_order_acquire) != ENTRY_ACTIVE) {
+            continue;
+        }
+        const uint64_t cursor = entry.cursor.load(std::memory_order_relaxed);
+        result.push_back(SubscriberStats{
+            static_cast<uint32_t>(i),
+            entry.pid.load(std::memory_order_relaxed),
+            write_pos > cursor ? write_pos - cursor : 0,
+            entry.received.load(std::memory_order_relaxed),
+            entry.lost.load(std::memory_order_relaxed),
+            entry.slow.load(std::memory_order_relaxed) != 0
+        });
+    }
+    return result;
+}
+
+// SlowEvents: Returns slow flags raised so far
+uint64_t BroadcastRing::slowEvents() const {
+    return m_header->slow_events.load(std::memory_order_relaxed);
+}
+
+// SlotSize: Returns maximum payload bytes per slot
+size_t BroadcastRing::slotSize() const {
+    return m_header->slot_size;
+}
+
+// Capacity: Returns number of slots
+size_t BroadcastRing::capacity() const {
+    return m_header->capacity;
+}
+
+} // namespace sensor
@@ -0,0 +1,124 @@
+#include "channel_registry.hpp"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace sensor {
+
+namespace {
+    // Trim: Strip leading and trailing whitespace from a configuration field
+    std::string trim(const std::string& text) {
+        const auto first = text.find_first_not_of(" \t\r");
+        if (first == std::string::npos) {
+            return std::string();
+        }
+        const auto last = text.find_last_not_of(" \t\r");
+        return text.substr(first, last - first + 1);
+    }
+}
+
+// Constructor: Adopt a validated channel list
+ChannelRegistry::ChannelRegistry(std::vector<ChannelInfo> channels)
+    : m_channels(std::move(channels))
+{
+    if (m_channels.empty()) {
+        throw std::runtime_error("Channel registry must contain at least one channel");
+    }
+}
+
+// Builtin: Mirror the compile-time SENSORS table
+ChannelRegistry ChannelRegistry::builtin() {
+    std::vector<ChannelInfo> channels;
+    channels.reserve(NUM_SENSORS);
+    for (const auto& sensor : SENSORS) {
+        channels.push_back({std::string(sensor.name), std::string(sensor.unit),
+                            sensor.mean, sensor.stddev});
+    }
+    return ChannelRegistry(std::move(channels));
+}
+
+// FromFile: Parse one channel per line, failing loudly on malformed entries
+ChannelRegistry ChannelRegistry::fromFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot open channel file: " + path);
+    }
+
+    std::vector<ChannelInfo> channels;
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(file, line)) {
+        ++line_number;
+        line = trim(line);
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        // Split into exactly four comma-separated fields
+        std::vector<std::string> fields = splitFields(line, ',');
+        for (std::string& field : fields) {
+            field = trim(field);
+        }
+        if (fields.size() != 4 || fields[0].empty()) {
+            throw std::runtime_error(path + ":" + std::to_string(line_number) +
+                                     ": expected name,unit,mean,stddev");
+        }
+
+        try {
+            channels.push_back({fields[0], fields[1], std::stod(fields[2]), std::stod(fields[3])});
+        } catch (const std::logic_error&) {
+            throw std::runtime_error(path + ":" + std::to_string(line_number) +
+                                     ": mean and stddev must be numbers");
+        }
+    }
+    return ChannelRegistry(std::move(channels));
+}
+
+// Synthetic: Repeat the built-in sensor types with an index suffix
+ChannelRegistry ChannelRegistry::synthetic(size_t count) {
+    std::vector<ChannelInfo> channels;
+    channels.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        const auto& sensor = SENSORS[i % NUM_SENSORS];
+        channels.push_back({std::string(sensor.name) + " " + std::to_string(i / NUM_SENSORS),
+                            std::string(sensor.unit), sensor.mean, sensor.stddev});
+    }
+    return ChannelRegistry(std::move(channels));
+}
+
+// Size: Returns number of channels
+size_t ChannelRegistry::size() const {
+    return m_channels.size();
+}
+
+// Operator[]: Returns metadata of one channel
+const ChannelInfo& ChannelRegistry::operator[](size_t index) const {
+    return m_channels[index];
+}
+
+// Find: Exact name, NAME* prefix, or * for every channel
+std::vector<size_t> ChannelRegistry::find(const std::string& pattern) const {
+    const bool prefix = !pattern.empty() && pattern.back() == '*';
+    const size_t length = prefix ? pattern.size() - 1 : pattern.size();
+    std::vector<size_t> matched;
+    for (size_t i = 0; i < m_channels.size(); ++i) {
+        const std::string& name = m_channels[i].name;
+        if (prefix ? name.compare(0, length, pattern, 0, length) == 0 : name == pattern) {
+            matched.push_back(i);
+        }
+    }
+    return matched;
+}
+
+// SplitFields: getline semantics, so "a:b:" is two fields and "" none
+std::vector<std::string> splitFields(const std::string& text, char separator) {
+    std::vector<std::string> fields;
+    std::stringstream stream(text);
+    std::string field;
+    while (std::getline(stream, field, separator)) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+} // namespace sensor
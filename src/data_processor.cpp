@@ -1,19 +1,216 @@
 #include "data_processor.hpp"
-#include <numeric>
+#include "channel_registry.hpp"
+#include "latency_histogram.hpp"
+#include "realtime.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
 
 namespace sensor {
 
-// Constructor: Initialize processor with config and simulator reference, set up IPC
-DataProcessor::DataProcessor(const Config& config, SensorSimulator& simulator)
+namespace {
+    // ChannelCount: Registry size in registry mode, otherwise the fixed SENSORS count
+    size_t channelCount(const Config& config) {
+        return config.channel_registry ? config.channel_registry->size() : NUM_SENSORS;
+    }
+
+    // BlockSize: Samples per block, at least one
+    size_t blockSize(const Config& config) {
+        return static_cast<size_t>(std::max(config.block_size, 1));
+    }
+
+    // BacklogPolicy: BLOCK waits on the transport before the backlog is full, so the
+    // backlog itself only ever has to reject
+    OverflowPolicy backlogPolicy(OverflowPolicy policy) {
+        return policy == OverflowPolicy::BLOCK ? OverflowPolicy::DROP_NEWEST : policy;
+    }
+
+    // Longest wait for new data while messages are backlogged, so they are retried promptly
+    constexpr std::chrono::milliseconds BACKLOG_RETRY(1);
+
+    // DecimationFactor: Sampling rate over output rate, 1 when decimation is off
+    size_t decimationFactor(const Config& config) {
+        if (config.output_rate_hz <= 0.0) {
+            return 1;
+        }
+        const double factor = std::round(samplingRateHz(config) / config.output_rate_hz);
+        if (factor < 1.0) {
+            throw std::invalid_argument("Output rate must not exceed the sampling rate");
+        }
+        return static_cast<size_t>(factor);
+    }
+
+    // Alerts held while the transport is full; more than this means it is down, not busy
+    constexpr size_t ALERT_BACKLOG = 256;
+
+    // Shards dealt to each worker thread, and the channel multiple every shard is rounded
+    // up to (one cache line of doubles)
+    constexpr size_t SHARDS_PER_THREAD = 4;
+    constexpr size_t SHARD_ALIGN = CACHE_LINE_SIZE / sizeof(double);
+}
+
+// Constructor: Initialize processor with config and source reference, set up IPC
+DataProcessor::DataProcessor(const Config& config, SampleSource& source)
     : m_config(config)
-    , m_simulator(simulator)
+    , m_source(source)
+    , m_ipc_produced(0)
+    , m_ipc_sent(0)
+    , m_ipc_dropped(0)
+    , m_moving_average(channelCount(config), static_cast<size_t>(std::max(config.moving_avg_window, 1)))
+    , m_report_every(0)
+    , m_report_countdown(0)
+    , m_report_due(false)
+    , m_alerts_raised(0)
+    , m_alerts_sent(0)
+    , m_alerts_dropped(0)
+    , m_shard_channels(0)
+    , m_shards(0)
     , m_running(false)
     , m_msg_counter(0)
 {
+    // Time-based statistics windows, converted to sample counts at the configured rate
+    if (!m_config.channel_registry && !m_config.aggregate_windows_ms.empty()) {
+        if (m_config.aggregate_windows_ms.size() > MAX_AGGREGATE_WINDOWS) {
+            throw std::invalid_argument("At most " + std::to_string(MAX_AGGREGATE_WINDOWS) +
+                                        " aggregation windows are supported");
+        }
+        const double period_ns = static_cast<double>(samplingPeriod(m_config).count());
+        std::vector<size_t> lengths;
+        for (int ms : m_config.aggregate_windows_ms) {
+            if (ms <= 0) {
+                throw std::invalid_argument("Aggregation windows must be positive");
+            }
+            lengths.push_back(std::max<size_t>(1, static_cast<size_t>(std::llround(ms * 1e6 / period_ns))));
+        }
+        m_aggregator = std::make_unique<WindowAggregator>(NUM_SENSORS, lengths);
+        m_window_ms = m_config.aggregate_windows_ms;
+
+        // Reports go out at a low rate of their own, by default once per shortest window
+        if (m_config.windows_every_ms < 0) {
+            throw std::invalid_argument("Window report period must not be negative");
+        }
+        const int every_ms = m_config.windows_every_ms > 0
+            ? m_config.windows_every_ms
+            : *std::min_element(m_window_ms.begin(), m_window_ms.end());
+        m_report_every = std::max<size_t>(1, static_cast<size_t>(std::llround(every_ms * 1e6 / period_ns)));
+        m_report_countdown = m_report_every;
+    }
+
+    // Channels with a configured filter report it instead of their moving average
+    if (!m_config.filters.empty()) {
+        const ChannelRegistry channels = m_config.channel_registry ? *m_config.channel_registry
+                                                                   : ChannelRegistry::builtin();
+        m_filters = std::make_unique<FilterBank>(channels, m_config.filters, samplingRateHz(m_config),
+                                                 blockSize(m_config));
+        // The filter overwrites the channel's output, so neither path averages it first
+        for (size_t ch = 0; ch < channels.size(); ++ch) {
+            if (m_filters->filters(ch)) {
+                m_moving_average.skipChannel(ch);
+            }
+        }
+    }
+
+    // Low-pass and decimate the averages down to the output rate
+    const size_t factor = decimationFactor(m_config);
+    if (factor > 1) {
+        m_decimator = std::make_unique<Decimator>(channelCount(config), factor);
+    }
+
+    // Raw history sized for the configured horizon at the sampling rate
+    if (m_config.store_seconds > 0.0) {
+        const double samples = std::ceil(m_config.store_seconds * samplingRateHz(m_config));
+        m_store = std::make_unique<TimeSeriesStore>(channelCount(config), static_cast<size_t>(samples),
+                                                    blockSize(m_config));
+    }
+
+    // Processed messages are recorded next to the raw readings (fixed path only)
+    if (m_config.record_messages && !m_config.record_dir.empty() && !m_config.channel_registry) {
+        m_recorder = std::make_unique<FlightRecorder>(m_config.record_dir, "messages",
+                                                      RecordType::MQ_MESSAGE,
+                                                      m_config.record_segment_bytes);
+    }
+
+    // Registry mode sends whole blocks, so the transport must fit one block frame;
+    // compressed batches need the full frame size on the shared-memory rings too
+    size_t frame_bytes = m_config.compress ? MAX_MSG_SIZE : 0;
+    if (m_aggregator) {
+        frame_bytes = std::max(frame_bytes, IPCManager::WINDOW_FRAME_BYTES);
+    }
+    if (m_config.channel_registry) {
+        // Only one output block exists, so nothing queued can be evicted or replaced
+        if (m_config.ipc_overflow != OverflowPolicy::DROP_NEWEST
+            && m_config.ipc_overflow != OverflowPolicy::BLOCK) {
+            throw std::invalid_argument(std::string("Registry IPC stage cannot ")
+                                        + overflowPolicyName(m_config.ipc_overflow));
+        }
+        m_output_block = std::make_unique<SampleBlock>(channelCount(config), blockSize(config));
+        frame_bytes = IPCManager::blockFrameBytes(channelCount(config), blockSize(config), m_config.compress);
+        if (m_decimator) {
+            m_decimated_block = std::make_unique<SampleBlock>(channelCount(config),
+                                                              m_decimator->maxOutputs(blockSize(config)));
+        }
+
+        // About SHARDS_PER_THREAD shards per thread leaves slack for stealing to even out
+        if (m_config.processing_threads > 1) {
+            const size_t threads = static_cast<size_t>(m_config.processing_threads);
+            const size_t channels = channelCount(config);
+            const size_t per_shard = (channels + threads * SHARDS_PER_THREAD - 1) / (threads * SHARDS_PER_THREAD);
+            m_shard_channels = roundUp(per_shard, SHARD_ALIGN);
+            m_shards = (channels + m_shard_channels - 1) / m_shard_channels;
+            m_pool = std::make_unique<WorkerPool>(threads, m_config.processor_thread);
+        }
+    }
+
+    // Raw readings are checked against the mean and stddev their channel declares
+    if (!m_config.detectors.empty()) {
+        const ChannelRegistry channels = m_config.channel_registry ? *m_config.channel_registry
+                                                                   : ChannelRegistry::builtin();
+        m_detector = std::make_unique<AnomalyDetector>(channels, m_config.detectors);
+        m_shard_alerts.resize(m_shards);
+        m_alert_backlog = std::make_unique<CircularBuffer<AnomalyAlert>>(ALERT_BACKLOG, OverflowPolicy::DROP_NEWEST);
+    }
+
+    m_backlog = std::make_unique<CircularBuffer<MQMessage>>(std::max<size_t>(m_config.ipc_backlog, 1),
+                                                            backlogPolicy(m_config.ipc_overflow));
+
     // Initialize IPC manager in sender mode
-    if (m_ipc_manager.initialize(true) != ErrorCode::SUCCESS) {
+    const ErrorCode opened = m_ipc_manager.initialize(true, m_config.ipc_backend, frame_bytes);
+    if (opened == ErrorCode::QUEUE_MSGSIZE_ERROR) {
+        throw std::runtime_error("Block frames of " + std::to_string(frame_bytes)
+                                 + " bytes exceed the message queue limit of "
+                                 + std::to_string(IPCManager::queueMessageLimit())
+                                 + " bytes (fs.mqueue.msgsize_max); use --ipc shm, fewer channels"
+                                   " or a smaller --block-size, or raise the limit");
+    }
+    if (opened != ErrorCode::SUCCESS) {
         throw std::runtime_error("Failed to initialize IPC manager");
     }
+
+    // Compressed frames hold as many messages as fit unless --batch sets a limit
+    if (m_config.compress) {
+        const ChannelRegistry channels = m_config.channel_registry ? *m_config.channel_registry
+                                                                   : ChannelRegistry::builtin();
+        if (m_ipc_manager.enableCompression(parsePrecision(channels, m_config.precision)) != ErrorCode::SUCCESS) {
+            throw std::runtime_error("Failed to enable IPC compression");
+        }
+    }
+
+    // Coalesce messages into framed queue messages when configured; a --batch the frame
+    // cannot hold is clamped, and said so
+    if (config.ipc_batch_size > 1 || m_config.compress) {
+        const size_t requested = config.ipc_batch_size > 1 ? static_cast<size_t>(config.ipc_batch_size)
+                                                           : IPCManager::MAX_COMPRESSED_BATCH;
+        size_t limit = 0;
+        if (m_ipc_manager.enableBatching(requested, std::chrono::microseconds(config.ipc_flush_us), limit)
+            != ErrorCode::SUCCESS) {
+            throw std::runtime_error("Failed to enable IPC batching");
+        }
+        if (config.ipc_batch_size > 1 && limit < requested) {
+            std::cerr << "Warning: --batch " << requested << " reduced to " << limit
+                      << (limit == 1 ? " message" : " messages") << " per frame on this transport\n";
+        }
+    }
 }
 
 // Destructor: Ensure processing thread is stopped
@@ -25,7 +222,16 @@ DataProcessor::~DataProcessor() {
 void DataProcessor::start() {
     if (!m_running) {
         m_running = true;
-        m_thread = std::thread(&DataProcessor::processingLoop, this);
+        // Start each run with an empty window
+        m_moving_average.reset();
+        if (m_aggregator) {
+            m_aggregator->reset();
+            m_report_countdown = m_report_every;
+            m_report_due = false;
+        }
+        m_thread = m_config.channel_registry
+            ? std::thread(&DataProcessor::blockProcessingLoop, this)
+            : std::thread(&DataProcessor::processingLoop, this);
     }
 }
 
@@ -40,61 +246,447 @@ void DataProcessor::stop() {
     }
 }
 
+// Report: Filter designs, decimation cascade, worker pool balance, then subscriber progress
+// as seen by the sending side of the transport
+void DataProcessor::report(std::ostream& os) const {
+    if (m_filters) {
+        m_filters->report(os);
+    }
+    if (m_decimator) {
+        os << "Decimation: " << m_decimator->factor() << "x in " << m_decimator->stageCount() << " stages (";
+        for (size_t s = 0; s < m_decimator->stageCount(); ++s) {
+            os << (s ? ", " : "") << m_decimator->stageFactor(s) << "x/" << m_decimator->stageTaps(s) << " taps";
+        }
+        const double delay_ms = m_decimator->delay() * static_cast<double>(samplingPeriod(m_config).count()) / 1e6;
+        os << "), group delay " << delay_ms << " ms\n";
+    }
+    if (m_detector) {
+        m_detector->report(os);
+    }
+    if (m_store) {
+        m_store->report(os);
+    }
+    if (m_pool) {
+        os << "Workers: " << m_pool->threads() << " threads, " << m_shards << " shards of "
+           << m_shard_channels << " channels, " << m_pool->steals() << " shards stolen\n";
+    }
+    m_ipc_manager.report(os);
+}
+
+// Stages: Backlog drops and transport refusals together make up the IPC stage's losses
+std::vector<StageReport> DataProcessor::stages() const {
+    const StageCounters backlog = m_backlog->counters();
+    StageCounters counters;
+    counters.produced = m_ipc_produced.load(std::memory_order_relaxed);
+    counters.consumed = m_ipc_sent.load(std::memory_order_relaxed);
+    counters.dropped = m_ipc_dropped.load(std::memory_order_relaxed) + backlog.dropped;
+    counters.high_water = backlog.high_water;
+    // Registry mode never queues blocks: a block the transport refuses is dropped at once
+    const size_t capacity = m_config.channel_registry ? 0 : m_backlog->capacity();
+    std::vector<StageReport> reports{StageReport{"ipc", m_config.ipc_overflow, capacity, counters}};
+
+    if (m_detector) {
+        const StageCounters held = m_alert_backlog->counters();
+        StageCounters alerts;
+        alerts.produced = m_alerts_raised.load(std::memory_order_relaxed);
+        alerts.consumed = m_alerts_sent.load(std::memory_order_relaxed);
+        alerts.dropped = m_alerts_dropped.load(std::memory_order_relaxed) + held.dropped;
+        alerts.high_water = held.high_water;
+        reports.push_back(StageReport{"alerts", m_alert_backlog->policy(), m_alert_backlog->capacity(), alerts});
+    }
+    return reports;
+}
+
+// Loops: Passes of whichever processing loop is running, and those that found no input
+std::vector<LoopReport> DataProcessor::loops() const {
+    return {LoopReport{"processor", m_loop.iterations.load(std::memory_order_relaxed),
+                       m_loop.idle_wakeups.load(std::memory_order_relaxed)}};
+}
+
+// TransportDepth: Queue depth as the sending side sees it
+size_t DataProcessor::transportDepth() const {
+    return m_ipc_manager.queueDepth();
+}
+
+// TransportCapacity: Frames the transport holds before sends are refused
+size_t DataProcessor::transportCapacity() const {
+    return m_ipc_manager.queueCapacity();
+}
+
+// Store: Returns the history of the raw readings, null when not kept
+const TimeSeriesStore* DataProcessor::store() const {
+    return m_store.get();
+}
+
 // ProcessingLoop: Main loop that processes sensor data and computes moving averages
 void DataProcessor::processingLoop() {
-    // Create buffer to store data window for moving average calculation
-    CircularBuffer<SensorData> window_buffer(m_config.moving_avg_window);
-    
+    applyThreadPolicy(m_config.processor_thread, "processor");
+    const bool event_driven = (m_config.wakeup_mode == WakeupMode::EVENT);
+    const std::chrono::microseconds timeout = std::chrono::milliseconds(m_config.wait_timeout_ms);
+
     while (m_running) {
-        // Attempt to get latest sensor reading
-        if (auto data = m_simulator.getLatestData()) {
-            // Add new data to window buffer
-            window_buffer.push(*data);
-            
-            // Get window of data for moving average calculation
-            auto window = window_buffer.getWindow(m_config.moving_avg_window);
-            if (!window.empty()) {
-                // Compute moving averages for all sensors
-                auto avg_values = computeMovingAverage(window);
-                
+        // Never sleep past the flush deadline of a partially filled batch, nor long while
+        // messages are backlogged
+        auto wait = std::min(timeout, m_ipc_manager.flushDelay());
+        if (!m_backlog->empty() || (m_alert_backlog && !m_alert_backlog->empty())) {
+            wait = std::min<std::chrono::microseconds>(wait, BACKLOG_RETRY);
+        }
+
+        // Wait for the source to signal a reading, or just check in polling mode
+        auto data = event_driven ? m_source.waitForData(wait) : m_source.getLatestData();
+        bumpCounter(m_loop.iterations);
+        if (data) {
+            const uint64_t popped_ns = monotonicNanos();
+            if (m_store) {
+                m_store->push(data->timestamp, data->values.data());
+            }
+
+            // Alerts leave before the message of the same reading, ahead of any backlog
+            if (m_detector) {
+                m_detector->push(data->timestamp, data->generated_ns, data->values.data(), m_alerts);
+                sendAlerts();
+            }
+
+            // Update moving averages for all sensors in O(1) per sensor
+            auto avg_values = computeMovingAverage(*data);
+            if (m_filters) {
+                m_filters->push(data->values.data(), avg_values.data());
+            }
+            if (m_aggregator) {
+                m_aggregator->push(data->values.data());
+                if (--m_report_countdown == 0) {
+                    m_report_countdown = m_report_every;
+                    m_report_due = true;
+                }
+            }
+
+            // With decimation only every factor-th reading completes a message, so the
+            // transport and output stage run at the output rate
+            if (!m_decimator || m_decimator->push(avg_values.data(), avg_values.data())) {
                 // Create and send message with processed data
                 MQMessage msg{
                     m_msg_counter++,
                     avg_values,
-                    data->timestamp
+                    data->timestamp,
+                    StageTimes{data->generated_ns, popped_ns, 0}
                 };
-                
-                m_ipc_manager.sendMessage(msg);
+                msg.stages.sent_ns = monotonicNanos();
+                recordLatency(msg.stages);
+
+                sendOrQueue(msg);
+                if (m_recorder) {
+                    m_recorder->append(msg);
+                }
+            }
+            if (m_report_due) {
+                sendWindowReport(data->timestamp);
             }
+        } else {
+            // No new data: retry the backlogs and send a partial batch whose deadline has passed
+            bumpCounter(m_loop.idle_wakeups);
+            if (m_detector) {
+                drainAlertBacklog();
+            }
+            drainBacklog();
+            m_ipc_manager.flushIfDue();
         }
         
-        // Sleep for half the sampling interval to ensure no data is missed
-        std::this_thread::sleep_for(std::chrono::milliseconds(m_config.sampling_rate_ms / 2));
+        if (!event_driven) {
+            // Sleep for half the sampling interval to ensure no data is missed
+            std::this_thread::sleep_for(samplingPeriod(m_config) / 2);
+        }
     }
+
+    // The output stage stops after us; give it one timeout to take both backlogs
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    drainAlertBacklogUntil(deadline);
+    drainBacklog();
+    while (!m_backlog->empty() && std::chrono::steady_clock::now() < deadline) {
+        m_ipc_manager.waitWritable(BACKLOG_RETRY);
+        drainBacklog();
+    }
+
+    // Do not strand the last partial batch on shutdown
+    m_ipc_manager.flush();
 }
 
-// ComputeMovingAverage: Calculate moving average for each sensor from window of readings
-std::array<double, NUM_SENSORS> DataProcessor::computeMovingAverage(
-    const std::vector<SensorData>& window)
-{
+// SendOrQueue: Messages leave in order, so nothing bypasses a non-empty backlog
+void DataProcessor::sendOrQueue(const MQMessage& msg) {
+    bumpCounter(m_ipc_produced);
+    drainBacklog();
+
+    if (m_backlog->empty()) {
+        const ErrorCode result = m_ipc_manager.sendMessage(msg);
+        if (result == ErrorCode::SUCCESS) {
+            bumpCounter(m_ipc_sent);
+            return;
+        }
+        if (result != ErrorCode::BUFFER_FULL) {
+            bumpCounter(m_ipc_dropped);
+            return;
+        }
+    }
+
+    // BLOCK: give the transport a bounded time to make room before the backlog rejects
+    if (m_config.ipc_overflow == OverflowPolicy::BLOCK && m_backlog->full()) {
+        const auto deadline = std::chrono::steady_clock::now()
+                              + std::chrono::microseconds(m_config.overflow_block_us);
+        while (m_backlog->full()) {
+            const auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(
+                deadline - std::chrono::steady_clock::now());
+            if (remaining.count() <= 0 || !m_ipc_manager.waitWritable(remaining)) {
+                break;
+            }
+            drainBacklog();
+        }
+    }
+
+    // Full backlog: drop-newest rejects, drop-oldest evicts, coalesce replaces the newest
+    m_backlog->push(msg);
+}
+
+// DrainBacklog: Only this thread touches the backlog, so empty() needs no lock and the
+// messages can be sent straight from the ring, then consumed in one go
+void DataProcessor::drainBacklog() {
+    if (m_backlog->empty()) {
+        return;
+    }
+    const auto pending = m_backlog->front(m_backlog->capacity());
+    size_t handled = 0;
+    for (; handled < pending.size(); ++handled) {
+        const ErrorCode result = m_ipc_manager.sendMessage(pending[handled]);
+        if (result == ErrorCode::BUFFER_FULL) {
+            break;
+        }
+        bumpCounter(result == ErrorCode::SUCCESS ? m_ipc_sent : m_ipc_dropped);
+    }
+    m_backlog->consume(handled);
+}
+
+// SendAlerts: Backlogged alerts go first so alerts stay in order among themselves
+void DataProcessor::sendAlerts() {
+    drainAlertBacklog();
+    if (m_alerts.empty()) {
+        return;
+    }
+    bumpCounter(m_alerts_raised, m_alerts.size());
+
+    size_t sent = 0;
+    if (m_alert_backlog->empty()) {
+        const ErrorCode result = m_ipc_manager.sendAlerts(m_alerts.data(), m_alerts.size(), sent);
+        bumpCounter(m_alerts_sent, sent);
+        if (result != ErrorCode::SUCCESS && result != ErrorCode::BUFFER_FULL) {
+            bumpCounter(m_alerts_dropped, m_alerts.size() - sent);
+            sent = m_alerts.size();
+        }
+    }
+    m_alert_backlog->pushBatch(m_alerts.data() + sent, m_alerts.size() - sent);
+    m_alerts.clear();
+}
+
+// DrainAlertBacklog: Frames are cut straight from the ring, one run of it at a time; a
+// backlog only builds up while the transport is full
+void DataProcessor::drainAlertBacklog() {
+    if (m_alert_backlog->empty()) {
+        return;
+    }
+    const auto pending = m_alert_backlog->front(ALERT_BACKLOG);
+    for (const auto& run : {pending.first, pending.second}) {
+        size_t sent = 0;
+        const ErrorCode result = m_ipc_manager.sendAlerts(run.data, run.size, sent);
+        bumpCounter(m_alerts_sent, sent);
+        if (result == ErrorCode::BUFFER_FULL) {
+            m_alert_backlog->consume(sent);
+            return;
+        }
+        if (result != ErrorCode::SUCCESS) {
+            bumpCounter(m_alerts_dropped, run.size - sent);
+        }
+        m_alert_backlog->consume(run.size);
+    }
+}
+
+// DrainAlertBacklogUntil: Shutdown; wait for the transport to take the backlogged alerts
+// until the deadline, as for the message backlog
+void DataProcessor::drainAlertBacklogUntil(std::chrono::steady_clock::time_point deadline) {
+    if (!m_detector) {
+        return;
+    }
+    drainAlertBacklog();
+    while (!m_alert_backlog->empty() && std::chrono::steady_clock::now() < deadline) {
+        m_ipc_manager.waitWritable(BACKLOG_RETRY);
+        drainAlertBacklog();
+    }
+}
+
+// SendOutputBlock: One retry after waiting for room; counts every sample of the block
+void DataProcessor::sendOutputBlock(SampleBlock& block) {
+    const uint64_t samples = block.length();
+    bumpCounter(m_ipc_produced, samples);
+
+    ErrorCode result = m_ipc_manager.sendBlock(block);
+    if (result == ErrorCode::BUFFER_FULL && m_config.ipc_overflow == OverflowPolicy::BLOCK
+        && m_ipc_manager.waitWritable(std::chrono::microseconds(m_config.overflow_block_us))) {
+        result = m_ipc_manager.sendBlock(block);
+    }
+    bumpCounter(result == ErrorCode::SUCCESS ? m_ipc_sent : m_ipc_dropped, samples);
+}
+
+// BlockProcessingLoop: Average each block channel by channel and send it as one frame
+void DataProcessor::blockProcessingLoop() {
+    applyThreadPolicy(m_config.processor_thread, "processor");
+    const bool event_driven = (m_config.wakeup_mode == WakeupMode::EVENT);
+    const std::chrono::microseconds timeout = std::chrono::milliseconds(m_config.wait_timeout_ms);
+
+    while (m_running) {
+        SampleBlock* block = event_driven ? m_source.waitForBlock(timeout)
+                                          : m_source.getLatestBlock();
+        bumpCounter(m_loop.iterations);
+        if (!block) {
+            bumpCounter(m_loop.idle_wakeups);
+            if (m_detector) {
+                drainAlertBacklog();
+            }
+        } else {
+            const uint64_t popped_ns = monotonicNanos();
+
+            pushBlock(*block);
+            m_source.releaseBlock(block);
+
+            // Alerts of the block leave before its averages, oldest reading first
+            if (m_detector) {
+                std::stable_sort(m_alerts.begin(), m_alerts.end(),
+                                 [](const AnomalyAlert& a, const AnomalyAlert& b) { return a.sample < b.sample; });
+                sendAlerts();
+            }
+
+            // A decimated block holds only the outputs this block completed, often none
+            SampleBlock& out = m_decimated_block ? *m_decimated_block : *m_output_block;
+            if (out.length() > 0) {
+                out.setFirstSequence(m_msg_counter);
+                m_msg_counter += out.length();
+
+                StageTimes& stages = out.stages();
+                stages.popped_ns = popped_ns;
+                stages.sent_ns = monotonicNanos();
+                recordLatency(stages);
+
+                sendOutputBlock(out);
+            }
+        }
+
+        if (!event_driven) {
+            // Sleep for half the sampling interval to ensure no data is missed
+            std::this_thread::sleep_for(samplingPeriod(m_config) / 2);
+        }
+    }
+
+    // Blocks are never queued, but alerts may be: give the output stage one timeout for them
+    drainAlertBacklogUntil(std::chrono::steady_clock::now() + timeout);
+}
+
+// PushBlock: Shards write disjoint channel columns, so the merged block is the same for any
+// thread count; shared window and filter state advance once every shard has finished
+void DataProcessor::pushBlock(const SampleBlock& block) {
+    // Cost is linear in channels x samples, each column walked contiguously
+    if (!m_pool) {
+        if (m_detector) {
+            m_detector->pushBlock(block, m_alerts);
+        }
+        if (m_store) {
+            m_store->pushBlock(block);
+        }
+        m_moving_average.pushBlock(block, *m_output_block);
+        if (m_filters) {
+            m_filters->pushBlock(block, *m_output_block);
+        }
+        if (m_decimator) {
+            m_decimator->pushBlock(*m_output_block, *m_decimated_block);
+        }
+        return;
+    }
+    // The store announces the slots it overwrites before any shard writes them
+    const size_t channels = block.channels();
+    if (m_store) {
+        m_store->beginBlock(block);
+    }
+    m_pool->run(m_shards, [&](size_t shard) {
+        const size_t first = shard * m_shard_channels;
+        const size_t last = std::min(first + m_shard_channels, channels);
+        if (m_detector) {
+            m_detector->pushChannels(block, first, last, m_shard_alerts[shard]);
+        }
+        if (m_store) {
+            m_store->pushChannels(block, first, last);
+        }
+        m_moving_average.pushChannels(block, *m_output_block, first, last);
+    });
+    if (m_detector) {
+        m_detector->commitBlock(block);
+        for (std::vector<AnomalyAlert>& alerts : m_shard_alerts) {
+            m_alerts.insert(m_alerts.end(), alerts.begin(), alerts.end());
+            alerts.clear();
+        }
+    }
+    if (m_store) {
+        m_store->commitBlock(block);
+    }
+    m_moving_average.commitBlock(block, *m_output_block);
+
+    // Filter groups keep all their state to themselves, so each group is a shard
+    if (m_filters) {
+        m_pool->run(m_filters->groupCount(), [&](size_t group) {
+            m_filters->pushGroup(block, *m_output_block, group);
+        });
+    }
+
+    // The decimator reads the length of the averages, set by the commit above
+    if (m_decimator) {
+        m_pool->run(m_shards, [&](size_t shard) {
+            const size_t first = shard * m_shard_channels;
+            m_decimator->pushChannels(*m_output_block, *m_decimated_block, first,
+                                      std::min(first + m_shard_channels, channels));
+        });
+        m_decimator->commitBlock(*m_output_block, *m_decimated_block);
+    }
+}
+
+// RecordLatency: Buffer wait and processing time of one reading, when latency tracking is on
+void DataProcessor::recordLatency(const StageTimes& stages) {
+    if (LatencyStats* stats = m_config.latency_stats.get()) {
+        stats->record(LatencyHop::QUEUE, stages.generated_ns, stages.popped_ns);
+        stats->record(LatencyHop::PROCESS, stages.popped_ns, stages.sent_ns);
+    }
+}
+
+// SendWindowReport: Copy out each window's statistics; a report waits while messages are
+// backlogged, and one the transport refuses is retried with the next reading
+void DataProcessor::sendWindowReport(std::chrono::system_clock::time_point timestamp) {
+    if (!m_backlog->empty()) {
+        return;
+    }
+    WindowReport report{};
+    report.next_msg_id = m_msg_counter;
+    report.timestamp = timestamp;
+    for (size_t w = 0; w < m_aggregator->windowCount(); ++w) {
+        WindowSummary& summary = report.windows[w];
+        summary.window_ms = static_cast<uint32_t>(m_window_ms[w]);
+        summary.samples = static_cast<uint32_t>(m_aggregator->count(w));
+        m_aggregator->stats(w, summary.mean.data(), summary.min.data(), summary.max.data(),
+                            summary.variance.data());
+    }
+    report.window_count = static_cast<uint32_t>(m_aggregator->windowCount());
+    m_report_due = m_ipc_manager.sendWindows(report) == ErrorCode::BUFFER_FULL;
+}
+
+// ComputeMovingAverage: Push reading into the streaming window and read back per-sensor averages
+std::array<double, NUM_SENSORS> DataProcessor::computeMovingAverage(const SensorData& data) {
     std::array<double, NUM_SENSORS> averages{};
-    
-    // Return zero-initialized array if window is empty
-    if (window.empty()) {
-        return averages;
-    }
-    
-    // Compute average for each sensor independently
-    for (size_t sensor = 0; sensor < NUM_SENSORS; ++sensor) {
-        double sum = 0.0;
-        // Sum all readings for current sensor
-        for (const auto& data : window) {
-            sum += data.values[sensor];
-        }
-        // Calculate average by dividing sum by window size
-        averages[sensor] = sum / window.size();
-    }
-    
+
+    // Running sums make this independent of the window length
+    m_moving_average.push(data.values.data());
+    m_moving_average.averages(averages.data());
+
     return averages;
 }
 
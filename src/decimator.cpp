@@ -0,0 +1,234 @@
+#include "decimator.hpp"
+#include "filter_design.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace sensor {
+
+namespace {
+    // Relative width of the Blackman window's transition band: about 5.5 / taps of the
+    // stage input rate
+    constexpr double BLACKMAN_TRANSITION = 5.5;
+
+    // StageFactors: Prime factors packed first-fit, largest first, into stages no larger
+    // than limit; a prime above the limit becomes a stage of its own
+    std::vector<size_t> stageFactors(size_t factor, size_t limit) {
+        std::vector<size_t> primes;
+        for (size_t p = 2; p * p <= factor; ++p) {
+            while (factor % p == 0) {
+                primes.push_back(p);
+                factor /= p;
+            }
+        }
+        if (factor > 1) {
+            primes.push_back(factor);
+        }
+
+        std::vector<size_t> stages;
+        for (auto it = primes.rbegin(); it != primes.rend(); ++it) {
+            auto fit = std::find_if(stages.begin(), stages.end(),
+                                    [&](size_t stage) { return stage * *it <= limit; });
+            if (fit != stages.end()) {
+                *fit *= *it;
+            } else {
+                stages.push_back(*it);
+            }
+        }
+        std::sort(stages.rbegin(), stages.rend());
+        return stages;
+    }
+
+    // Dot: Four independent partial sums so the additions can overlap
+    inline double dot(const double* a, const double* b, size_t n) {
+        double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            s0 += a[i] * b[i];
+            s1 += a[i + 1] * b[i + 1];
+            s2 += a[i + 2] * b[i + 2];
+            s3 += a[i + 3] * b[i + 3];
+        }
+        for (; i < n; ++i) {
+            s0 += a[i] * b[i];
+        }
+        return (s0 + s1) + (s2 + s3);
+    }
+}
+
+// Constructor: One windowed-sinc stage per factor, each placing its stopband edge at its own
+// output Nyquist frequency
+Decimator::Decimator(size_t channels, size_t factor)
+    : m_channels(channels)
+    , m_factor(factor)
+    , m_phase(0)
+    , m_primed(false)
+{
+    if (channels == 0 || factor == 0) {
+        throw std::invalid_argument("Decimator requires at least one channel and a positive factor");
+    }
+
+    for (size_t stage_factor : stageFactors(factor, MAX_STAGE_FACTOR)) {
+        Stage stage;
+        stage.factor = stage_factor;
+        stage.taps = TAPS_PER_PHASE * stage_factor;
+        stage.history.assign(channels * 2 * stage.taps, 0.0);
+        stage.pos = 0;
+        stage.phase = 0;
+
+        // Cutoff half a transition band below the output Nyquist frequency (cycles/sample)
+        const double cutoff = (0.5 - BLACKMAN_TRANSITION / (2.0 * TAPS_PER_PHASE))
+                              / static_cast<double>(stage_factor);
+        const std::vector<double> coeffs = windowedSincLowPass(stage.taps, cutoff);
+        stage.coeffs.assign(coeffs.begin(), coeffs.end());
+        m_stages.push_back(std::move(stage));
+    }
+}
+
+// Push: One sample of every channel, then the shared stage state
+bool Decimator::push(const double* values, double* out) {
+    size_t outputs = 0;
+    for (size_t ch = 0; ch < m_channels; ++ch) {
+        outputs = filterChannel(ch, &values[ch], 1, &out[ch]);
+    }
+    advance(1);
+    return outputs != 0;
+}
+
+// PushBlock: Every channel, then the shared stage state
+void Decimator::pushBlock(const SampleBlock& in, SampleBlock& out) {
+    pushChannels(in, out, 0, m_channels);
+    commitBlock(in, out);
+}
+
+// PushChannels: Channel-outer, so each channel's history stays in cache for the whole block
+void Decimator::pushChannels(const SampleBlock& in, SampleBlock& out, size_t first, size_t last) {
+    const size_t length = in.length();
+    for (size_t ch = first; ch < last; ++ch) {
+        filterChannel(ch, in.column(ch), length, out.column(ch));
+    }
+}
+
+// CommitBlock: Output j completes at input m_factor - 1 - m_phase + j * m_factor of the block
+void Decimator::commitBlock(const SampleBlock& in, SampleBlock& out) {
+    const size_t length = in.length();
+    const size_t outputs = (m_phase + length) / m_factor;
+    const size_t first_input = m_factor - 1 - m_phase;
+
+    out.setLength(outputs);
+    out.setFirstSequence(in.firstSequence());
+    out.stages() = in.stages();
+    for (size_t j = 0; j < outputs; ++j) {
+        out.timestamps()[j] = in.timestamps()[first_input + j * m_factor];
+    }
+    advance(length);
+}
+
+// Reset: Return to the empty state without releasing memory
+void Decimator::reset() {
+    for (Stage& stage : m_stages) {
+        std::fill(stage.history.begin(), stage.history.end(), 0.0);
+        stage.pos = 0;
+        stage.phase = 0;
+    }
+    m_phase = 0;
+    m_primed = false;
+}
+
+// MaxOutputs: A block can start one sample short of an output
+size_t Decimator::maxOutputs(size_t length) const {
+    return (length + m_factor - 1) / m_factor;
+}
+
+// Channels: Returns number of channels filtered
+size_t Decimator::channels() const {
+    return m_channels;
+}
+
+// Factor: Returns input samples per output sample
+size_t Decimator::factor() const {
+    return m_factor;
+}
+
+// StageCount: Returns number of cascaded stages (0 for a factor of 1)
+size_t Decimator::stageCount() const {
+    return m_stages.size();
+}
+
+// StageFactor: Returns the decimation factor of one stage
+size_t Decimator::stageFactor(size_t stage) const {
+    return m_stages[stage].factor;
+}
+
+// StageTaps: Returns the filter length of one stage
+size_t Decimator::stageTaps(size_t stage) const {
+    return m_stages[stage].taps;
+}
+
+// Delay: Each linear-phase stage delays by half its length, in units of its input period
+double Decimator::delay() const {
+    double delay = 0.0;
+    double period = 1.0;
+    for (const Stage& stage : m_stages) {
+        delay += static_cast<double>(stage.taps - 1) / 2.0 * period;
+        period *= static_cast<double>(stage.factor);
+    }
+    return delay;
+}
+
+// FilterChannel: Store each value twice, so the window ending at the newest value is contiguous
+size_t Decimator::filterChannel(size_t channel, const double* in, size_t length, double* out) {
+    // Committed state is shared; this channel advances private copies. Every stage
+    // factor is at least 2, so a cascade has fewer than 64 stages.
+    size_t pos[64];
+    size_t phase[64];
+    const size_t stages = m_stages.size();
+    for (size_t s = 0; s < stages; ++s) {
+        pos[s] = m_stages[s].pos;
+        phase[s] = m_stages[s].phase;
+    }
+
+    // Start from steady state at the first value; unity DC gain keeps every stage at that level
+    if (!m_primed && length > 0) {
+        for (Stage& stage : m_stages) {
+            auto history = stage.history.begin() + static_cast<std::ptrdiff_t>(channel * 2 * stage.taps);
+            std::fill(history, history + static_cast<std::ptrdiff_t>(2 * stage.taps), in[0]);
+        }
+    }
+
+    size_t outputs = 0;
+    for (size_t k = 0; k < length; ++k) {
+        double value = in[k];
+        bool completed = true;
+        for (size_t s = 0; s < stages; ++s) {
+            Stage& stage = m_stages[s];
+            double* history = &stage.history[channel * 2 * stage.taps];
+            history[pos[s]] = value;
+            history[pos[s] + stage.taps] = value;
+            pos[s] = (pos[s] + 1 == stage.taps) ? 0 : pos[s] + 1;
+            if (++phase[s] < stage.factor) {
+                completed = false;
+                break;
+            }
+            phase[s] = 0;
+            value = dot(stage.coeffs.data(), history + pos[s], stage.taps);
+        }
+        if (completed) {
+            out[outputs++] = value;
+        }
+    }
+    return outputs;
+}
+
+// Advance: Each stage sees the outputs of the one before it
+void Decimator::advance(size_t length) {
+    m_primed = m_primed || length > 0;
+    m_phase = (m_phase + length) % m_factor;
+    for (Stage& stage : m_stages) {
+        stage.pos = (stage.pos + length) % stage.taps;
+        const size_t inputs = stage.phase + length;
+        stage.phase = inputs % stage.factor;
+        length = inputs / stage.factor;
+    }
+}
+
+} // namespace sensor
@@ -0,0 +1,144 @@
+#include "fast_random.hpp"
+#include <cmath>
+#include <random>
+
+namespace sensor {
+
+namespace {
+    constexpr size_t ZIGGURAT_LAYERS = 128;
+    constexpr double ZIGGURAT_R = 3.442619855899;           // Start of the tail
+    constexpr double ZIGGURAT_V = 9.91256303526217e-3;      // Area of every layer
+    constexpr double INV_2_52 = 1.0 / 4503599627370496.0;   // 2^-52
+    constexpr double INV_2_53 = 1.0 / 9007199254740992.0;   // 2^-53
+
+    // Layer edges x[i] and the fraction x[i+1]/x[i] of each layer that lies fully under the curve
+    struct ZigguratTables {
+        double x[ZIGGURAT_LAYERS + 1];
+        double ratio[ZIGGURAT_LAYERS];
+
+        ZigguratTables() {
+            const double f = std::exp(-0.5 * ZIGGURAT_R * ZIGGURAT_R);
+            x[0] = ZIGGURAT_V / f;  // Base layer: rectangle plus tail, as one wider rectangle
+            x[1] = ZIGGURAT_R;
+            x[ZIGGURAT_LAYERS] = 0.0;
+            for (size_t i = 2; i < ZIGGURAT_LAYERS; ++i) {
+                x[i] = std::sqrt(-2.0 * std::log(ZIGGURAT_V / x[i - 1]
+                                                 + std::exp(-0.5 * x[i - 1] * x[i - 1])));
+            }
+            for (size_t i = 0; i < ZIGGURAT_LAYERS; ++i) {
+                ratio[i] = x[i + 1] / x[i];
+            }
+        }
+    };
+
+    // Tables: Built once on first use
+    const ZigguratTables& tables() {
+        static const ZigguratTables instance;
+        return instance;
+    }
+
+    // Uniform: (0, 1], safe to take the logarithm of
+    inline double uniformOpen(uint64_t bits) {
+        return static_cast<double>((bits >> 11) + 1) * INV_2_53;
+    }
+
+    // SplitMix64: Seed expander recommended for xoshiro state
+    inline uint64_t splitMix64(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+}
+
+// Constructor: Four splitmix64 outputs, which are never all zero
+Xoshiro256pp::Xoshiro256pp(uint64_t seed) {
+    for (uint64_t& word : m_state) {
+        word = splitMix64(seed);
+    }
+}
+
+// Constructor: Build the shared tables now so the first draw is not slow
+NormalSampler::NormalSampler(uint64_t seed)
+    : m_rng(seed)
+{
+    tables();
+}
+
+// Operator(): Low 7 bits pick the layer, the top 53 bits a signed position within it
+double NormalSampler::operator()() {
+    const ZigguratTables& zig = tables();
+    const uint64_t bits = m_rng();
+    const size_t layer = bits & (ZIGGURAT_LAYERS - 1);
+    const double u = static_cast<double>(static_cast<int64_t>(bits) >> 11) * INV_2_52;
+    if (std::fabs(u) < zig.ratio[layer]) {
+        return u * zig.x[layer];
+    }
+    return sampleSlow(static_cast<int64_t>(bits), layer);
+}
+
+// SampleSlow: Tail from the base layer, accept/reject in the wedge of any other layer
+double NormalSampler::sampleSlow(int64_t bits, size_t layer) {
+    const ZigguratTables& zig = tables();
+    for (;;) {
+        const double u = static_cast<double>(bits >> 11) * INV_2_52;
+        if (std::fabs(u) < zig.ratio[layer]) {
+            return u * zig.x[layer];
+        }
+
+        if (layer == 0) {
+            // Marsaglia's tail method beyond R
+            double x;
+            double y;
+            do {
+                x = std::log(uniformOpen(m_rng())) / ZIGGURAT_R;
+                y = std::log(uniformOpen(m_rng()));
+            } while (-2.0 * y < x * x);
+            return u < 0.0 ? x - ZIGGURAT_R : ZIGGURAT_R - x;
+        }
+
+        // Wedge: accept if a uniform height falls under the density at x
+        const double x = u * zig.x[layer];
+        const double f0 = std::exp(-0.5 * (zig.x[layer] * zig.x[layer] - x * x));
+        const double f1 = std::exp(-0.5 * (zig.x[layer + 1] * zig.x[layer + 1] - x * x));
+        if (f1 + uniformOpen(m_rng()) * (f0 - f1) < 1.0) {
+            return x;
+        }
+
+        // Rejected: draw a fresh layer and position
+        const uint64_t next = m_rng();
+        layer = next & (ZIGGURAT_LAYERS - 1);
+        bits = static_cast<int64_t>(next);
+    }
+}
+
+// Fill: Block of standard normal variates; the rectangle test is inlined in the loop
+void NormalSampler::fill(double* out, size_t n) {
+    const ZigguratTables& zig = tables();
+    for (size_t i = 0; i < n; ++i) {
+        const uint64_t bits = m_rng();
+        const size_t layer = bits & (ZIGGURAT_LAYERS - 1);
+        const double u = static_cast<double>(static_cast<int64_t>(bits) >> 11) * INV_2_52;
+        out[i] = std::fabs(u) < zig.ratio[layer] ? u * zig.x[layer]
+                                                 : sampleSlow(static_cast<int64_t>(bits), layer);
+    }
+}
+
+// Fill: Block of scaled and shifted variates
+void NormalSampler::fill(double* out, size_t n, double mean, double stddev) {
+    fill(out, n);
+    for (size_t i = 0; i < n; ++i) {
+        out[i] = mean + stddev * out[i];
+    }
+}
+
+// RandomSeed: Fixed seed for reproducible runs, otherwise one from the OS
+uint64_t randomSeed(const Config& config) {
+    if (config.random_seed != 0) {
+        return config.random_seed;
+    }
+    std::random_device device;
+    return (static_cast<uint64_t>(device()) << 32) ^ device();
+}
+
+} // namespace sensor
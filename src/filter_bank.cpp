@@ -0,0 +1,453 @@
+#include "filter_bank.hpp"
+#include "stats_kernels.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SENSOR_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace sensor {
+
+namespace {
+    // Number: Whole field as a double
+    double number(const std::string& field) {
+        size_t used = 0;
+        const double value = std::stod(field, &used);
+        if (used != field.size()) {
+            throw std::invalid_argument(field);
+        }
+        return value;
+    }
+
+    // Cutoff: Hz to cycles per sample, below the Nyquist frequency
+    double cutoff(const std::string& field, double sample_rate_hz) {
+        const double relative = number(field) / sample_rate_hz;
+        if (!(relative > 0.0 && relative < 0.5)) {
+            throw std::invalid_argument(field);
+        }
+        return relative;
+    }
+
+    // Lane kernels: every level performs the same multiplies and adds in the same order per
+    // lane, so levels agree to rounding (compilers may fuse multiply-adds). biquad runs one
+    // section over a row in place; fir writes the dot product of the taps with each lane's
+    // history window.
+    struct LaneKernels {
+        void (*biquad)(const Biquad& q, double* row, double* z1, double* z2, size_t lanes);
+        void (*fir)(const double* coeffs, size_t taps, const double* window, double* out, size_t lanes);
+    };
+
+    // ---- Scalar reference ----
+
+    void biquadScalar(const Biquad& q, double* row, double* z1, double* z2, size_t lanes) {
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            const double x = row[lane];
+            const double y = q.b0 * x + z1[lane];
+            z1[lane] = q.b1 * x - q.a1 * y + z2[lane];
+            z2[lane] = q.b2 * x - q.a2 * y;
+            row[lane] = y;
+        }
+    }
+
+    // FirLanesScalar: window is lane-interleaved, stride lanes between taps; tail lanes of the
+    // vector kernels start at an offset, so the stride is passed separately from the count
+    void firLanesScalar(const double* coeffs, size_t taps, const double* window, size_t stride,
+                        double* out, size_t lanes) {
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            double acc = 0.0;
+            for (size_t j = 0; j < taps; ++j) {
+                acc += coeffs[j] * window[j * stride + lane];
+            }
+            out[lane] = acc;
+        }
+    }
+
+    void firScalar(const double* coeffs, size_t taps, const double* window, double* out, size_t lanes) {
+        firLanesScalar(coeffs, taps, window, lanes, out, lanes);
+    }
+
+#ifdef SENSOR_SIMD_X86
+    // ---- SSE2: 2 lanes ----
+
+    void biquadSse2(const Biquad& q, double* row, double* z1, double* z2, size_t lanes) {
+        const __m128d b0 = _mm_set1_pd(q.b0), b1 = _mm_set1_pd(q.b1), b2 = _mm_set1_pd(q.b2);
+        const __m128d a1 = _mm_set1_pd(q.a1), a2 = _mm_set1_pd(q.a2);
+        size_t lane = 0;
+        for (; lane + 2 <= lanes; lane += 2) {
+            const __m128d x = _mm_loadu_pd(row + lane);
+            const __m128d y = _mm_add_pd(_mm_mul_pd(b0, x), _mm_loadu_pd(z1 + lane));
+            _mm_storeu_pd(z1 + lane, _mm_add_pd(_mm_sub_pd(_mm_mul_pd(b1, x), _mm_mul_pd(a1, y)),
+                                                _mm_loadu_pd(z2 + lane)));
+            _mm_storeu_pd(z2 + lane, _mm_sub_pd(_mm_mul_pd(b2, x), _mm_mul_pd(a2, y)));
+            _mm_storeu_pd(row + lane, y);
+        }
+        biquadScalar(q, row + lane, z1 + lane, z2 + lane, lanes - lane);
+    }
+
+    void firSse2(const double* coeffs, size_t taps, const double* window, double* out, size_t lanes) {
+        size_t lane = 0;
+        for (; lane + 2 <= lanes; lane += 2) {
+            __m128d acc = _mm_setzero_pd();
+            for (size_t j = 0; j < taps; ++j) {
+                acc = _mm_add_pd(acc, _mm_mul_pd(_mm_set1_pd(coeffs[j]), _mm_loadu_pd(window + j * lanes + lane)));
+            }
+            _mm_storeu_pd(out + lane, acc);
+        }
+        firLanesScalar(coeffs, taps, window + lane, lanes, out + lane, lanes - lane);
+    }
+
+    // ---- AVX2: 4 lanes ----
+
+    __attribute__((target("avx2")))
+    void biquadAvx2(const Biquad& q, double* row, double* z1, double* z2, size_t lanes) {
+        const __m256d b0 = _mm256_set1_pd(q.b0), b1 = _mm256_set1_pd(q.b1), b2 = _mm256_set1_pd(q.b2);
+        const __m256d a1 = _mm256_set1_pd(q.a1), a2 = _mm256_set1_pd(q.a2);
+        size_t lane = 0;
+        for (; lane + 4 <= lanes; lane += 4) {
+            const __m256d x = _mm256_loadu_pd(row + lane);
+            const __m256d y = _mm256_add_pd(_mm256_mul_pd(b0, x), _mm256_loadu_pd(z1 + lane));
+            _mm256_storeu_pd(z1 + lane, _mm256_add_pd(_mm256_sub_pd(_mm256_mul_pd(b1, x), _mm256_mul_pd(a1, y)),
+                                                      _mm256_loadu_pd(z2 + lane)));
+            _mm256_storeu_pd(z2 + lane, _mm256_sub_pd(_mm256_mul_pd(b2, x), _mm256_mul_pd(a2, y)));
+            _mm256_storeu_pd(row + lane, y);
+        }
+        _mm256_zeroupper(); // The scalar tail is SSE code; avoid transition stalls
+        biquadScalar(q, row + lane, z1 + lane, z2 + lane, lanes - lane);
+    }
+
+    __attribute__((target("avx2")))
+    void firAvx2(const double* coeffs, size_t taps, const double* window, double* out, size_t lanes) {
+        size_t lane = 0;
+        for (; lane + 4 <= lanes; lane += 4) {
+            __m256d acc = _mm256_setzero_pd();
+            for (size_t j = 0; j < taps; ++j) {
+                acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_set1_pd(coeffs[j]),
+                                                       _mm256_loadu_pd(window + j * lanes + lane)));
+            }
+            _mm256_storeu_pd(out + lane, acc);
+        }
+        _mm256_zeroupper(); // The scalar tail is SSE code; avoid transition stalls
+        firLanesScalar(coeffs, taps, window + lane, lanes, out + lane, lanes - lane);
+    }
+
+    // ---- AVX-512F: 8 lanes ----
+
+    __attribute__((target("avx512f")))
+    void biquadAvx512(const Biquad& q, double* row, double* z1, double* z2, size_t lanes) {
+        const __m512d b0 = _mm512_set1_pd(q.b0), b1 = _mm512_set1_pd(q.b1), b2 = _mm512_set1_pd(q.b2);
+        const __m512d a1 = _mm512_set1_pd(q.a1), a2 = _mm512_set1_pd(q.a2);
+        size_t lane = 0;
+        for (; lane + 8 <= lanes; lane += 8) {
+            const __m512d x = _mm512_loadu_pd(row + lane);
+            const __m512d y = _mm512_add_pd(_mm512_mul_pd(b0, x), _mm512_loadu_pd(z1 + lane));
+            _mm512_storeu_pd(z1 + lane, _mm512_add_pd(_mm512_sub_pd(_mm512_mul_pd(b1, x), _mm512_mul_pd(a1, y)),
+                                                      _mm512_loadu_pd(z2 + lane)));
+            _mm512_storeu_pd(z2 + lane, _mm512_sub_pd(_mm512_mul_pd(b2, x), _mm512_mul_pd(a2, y)));
+            _mm512_storeu_pd(row + lane, y);
+        }
+        _mm256_zeroupper(); // The scalar tail is SSE code; avoid transition stalls
+        biquadScalar(q, row + lane, z1 + lane, z2 + lane, lanes - lane);
+    }
+
+    __attribute__((target("avx512f")))
+    void firAvx512(const double* coeffs, size_t taps, const double* window, double* out, size_t lanes) {
+        size_t lane = 0;
+        for (; lane + 8 <= lanes; lane += 8) {
+            __m512d acc = _mm512_setzero_pd();
+            for (size_t j = 0; j < taps; ++j) {
+                acc = _mm512_add_pd(acc, _mm512_mul_pd(_mm512_set1_pd(coeffs[j]),
+                                                       _mm512_loadu_pd(window + j * lanes + lane)));
+            }
+            _mm512_storeu_pd(out + lane, acc);
+        }
+        _mm256_zeroupper(); // The scalar tail is SSE code; avoid transition stalls
+        firLanesScalar(coeffs, taps, window + lane, lanes, out + lane, lanes - lane);
+    }
+#endif
+
+    // LaneKernels: Kernels of a level the statistics kernels support
+    const LaneKernels& laneKernels(SimdLevel level) {
+        static const LaneKernels scalar{biquadScalar, firScalar};
+#ifdef SENSOR_SIMD_X86
+        static const LaneKernels sse2{biquadSse2, firSse2};
+        static const LaneKernels avx2{biquadAvx2, firAvx2};
+        static const LaneKernels avx512{biquadAvx512, firAvx512};
+        switch (level) {
+            case SimdLevel::AVX512: return avx512;
+            case SimdLevel::AVX2:   return avx2;
+            case SimdLevel::SSE2:   return sse2;
+            default:                break;
+        }
+#endif
+        return scalar;
+    }
+}
+
+// ParseFilterSpec: Kind before the first ':', its parameters after
+FilterSpec parseFilterSpec(const std::string& spec, double sample_rate_hz) {
+    FilterSpec filter{FilterKind::FIR, {}, {}, spec};
+    const std::string kind = spec.substr(0, spec.find(':'));
+
+    // Paths may contain ':' themselves, and file errors keep their own message
+    if (kind == "fir-file" && spec.size() > kind.size() + 1) {
+        filter.taps = loadTaps(spec.substr(kind.size() + 1));
+        return filter;
+    }
+
+    try {
+        const std::vector<std::string> fields = splitFields(spec, ':');
+        if (kind == "fir" && fields.size() == 3) {
+            const int taps = std::stoi(fields[1]);
+            if (taps < 1) {
+                throw std::invalid_argument(fields[1]);
+            }
+            filter.taps = windowedSincLowPass(static_cast<size_t>(taps), cutoff(fields[2], sample_rate_hz));
+            return filter;
+        }
+        if (kind == "butterworth" && fields.size() == 3) {
+            filter.kind = FilterKind::BIQUAD;
+            filter.sections = butterworthLowPass(std::stoi(fields[1]), cutoff(fields[2], sample_rate_hz));
+            return filter;
+        }
+        if (kind == "biquad" && fields.size() == 2) {
+            filter.kind = FilterKind::BIQUAD;
+            for (const std::string& section : splitFields(fields[1], '/')) {
+                const std::vector<std::string> c = splitFields(section, ',');
+                if (c.size() != 5) {
+                    throw std::invalid_argument(section);
+                }
+                filter.sections.push_back({number(c[0]), number(c[1]), number(c[2]), number(c[3]), number(c[4])});
+            }
+            if (!filter.sections.empty()) {
+                return filter;
+            }
+        }
+    } catch (const std::logic_error&) {
+        // Reported below with the whole specification
+    }
+    throw std::invalid_argument("Invalid filter specification: " + spec +
+                                " (expected fir:TAPS:HZ, fir-file:PATH, butterworth:ORDER:HZ"
+                                " or biquad:B0,B1,B2,A1,A2[/...])");
+}
+
+// Constructor: Resolve every assignment to a design per channel, then pack lanes design by design
+FilterBank::FilterBank(const ChannelRegistry& channels, const std::vector<std::string>& assignments,
+                       double sample_rate_hz, size_t block)
+    : m_filtered(0)
+    , m_level(statsKernels().level)
+{
+    // Design index per channel, -1 = no filter
+    std::vector<int> design_of(channels.size(), -1);
+    for (const std::string& assignment : assignments) {
+        const size_t eq = assignment.find('=');
+        if (eq == std::string::npos || eq == 0 || eq + 1 == assignment.size()) {
+            throw std::invalid_argument("Filter assignments take the form CHANNEL=SPEC: " + assignment);
+        }
+        const std::string pattern = assignment.substr(0, eq);
+        const std::string spec = assignment.substr(eq + 1);
+
+        // Identical specifications share one design, so their channels share groups
+        int design = -1;
+        if (spec != "none") {
+            auto same = std::find_if(m_designs.begin(), m_designs.end(),
+                                     [&](const FilterSpec& d) { return d.text == spec; });
+            if (same == m_designs.end()) {
+                m_designs.push_back(parseFilterSpec(spec, sample_rate_hz));
+                same = m_designs.end() - 1;
+            }
+            design = static_cast<int>(same - m_designs.begin());
+        }
+
+        const std::vector<size_t> matched = channels.find(pattern);
+        if (matched.empty()) {
+            throw std::invalid_argument("Filter pattern matches no channel: " + pattern);
+        }
+        for (size_t ch : matched) {
+            design_of[ch] = design;
+        }
+    }
+
+    // Convolution walks the history oldest first, so FIR taps are stored reversed
+    for (const FilterSpec& design : m_designs) {
+        m_coeffs.emplace_back(design.taps.rbegin(), design.taps.rend());
+    }
+
+    for (size_t d = 0; d < m_designs.size(); ++d) {
+        std::vector<size_t> lanes;
+        for (size_t ch = 0; ch < channels.size(); ++ch) {
+            if (design_of[ch] == static_cast<int>(d)) {
+                lanes.push_back(ch);
+            }
+        }
+        m_filtered += lanes.size();
+
+        for (size_t first = 0; first < lanes.size(); first += MAX_LANES) {
+            Group group;
+            group.design = d;
+            group.channels.assign(lanes.begin() + static_cast<std::ptrdiff_t>(first),
+                                  lanes.begin() + static_cast<std::ptrdiff_t>(std::min(first + MAX_LANES, lanes.size())));
+            group.lanes = group.channels.size();
+            const size_t slots = (m_designs[d].kind == FilterKind::FIR) ? 2 * m_designs[d].taps.size()
+                                                                        : 2 * m_designs[d].sections.size();
+            group.state.assign(slots * group.lanes, 0.0);
+            group.rows.assign(std::max<size_t>(block, 1) * group.lanes, 0.0);
+            group.pos = 0;
+            group.primed = false;
+            m_groups.push_back(std::move(group));
+        }
+    }
+}
+
+// Push: Stage one row per group, filter it, and copy the results back
+void FilterBank::push(const double* values, double* out) {
+    for (Group& group : m_groups) {
+        for (size_t lane = 0; lane < group.lanes; ++lane) {
+            group.rows[lane] = values[group.channels[lane]];
+        }
+        filter(group, 1);
+        for (size_t lane = 0; lane < group.lanes; ++lane) {
+            out[group.channels[lane]] = group.rows[lane];
+        }
+    }
+}
+
+// PushBlock: Every group in turn
+void FilterBank::pushBlock(const SampleBlock& in, SampleBlock& out) {
+    for (size_t g = 0; g < m_groups.size(); ++g) {
+        pushGroup(in, out, g);
+    }
+}
+
+// PushGroup: Transpose the group's columns into rows, filter, and transpose back
+void FilterBank::pushGroup(const SampleBlock& in, SampleBlock& out, size_t group_index) {
+    Group& group = m_groups[group_index];
+    const size_t length = in.length();
+    const size_t lanes = group.lanes;
+
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        const double* column = in.column(group.channels[lane]);
+        for (size_t k = 0; k < length; ++k) {
+            group.rows[k * lanes + lane] = column[k];
+        }
+    }
+    filter(group, length);
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        double* column = out.column(group.channels[lane]);
+        for (size_t k = 0; k < length; ++k) {
+            column[k] = group.rows[k * lanes + lane];
+        }
+    }
+}
+
+// Report: Designs without channels (overridden by later assignments) are skipped
+void FilterBank::report(std::ostream& os) const {
+    for (size_t d = 0; d < m_designs.size(); ++d) {
+        size_t channels = 0;
+        for (const Group& group : m_groups) {
+            channels += (group.design == d) ? group.lanes : 0;
+        }
+        if (channels > 0) {
+            os << "Filter: " << m_designs[d].text << " on " << channels << " channels\n";
+        }
+    }
+}
+
+// SetSimdLevel: Same clamping as the statistics kernels
+void FilterBank::setSimdLevel(SimdLevel level) {
+    m_level = statsKernels(level).level;
+}
+
+// GroupCount: Returns number of independent lane groups
+size_t FilterBank::groupCount() const {
+    return m_groups.size();
+}
+
+// FilteredChannels: Returns number of channels with a filter
+size_t FilterBank::filteredChannels() const {
+    return m_filtered;
+}
+
+// Filters: Whether a group carries the channel; only asked while setting up
+bool FilterBank::filters(size_t channel) const {
+    for (const Group& group : m_groups) {
+        if (std::find(group.channels.begin(), group.channels.end(), channel) != group.channels.end()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// SimdLevel: Returns the level of the lane kernels
+SimdLevel FilterBank::simdLevel() const {
+    return m_level;
+}
+
+// Filter: Sample-outer, lane-inner, so every inner loop runs over contiguous lanes
+void FilterBank::filter(Group& group, size_t length) {
+    if (length == 0) {
+        return;
+    }
+    if (!group.primed) {
+        prime(group);
+        group.primed = true;
+    }
+
+    const FilterSpec& design = m_designs[group.design];
+    const LaneKernels& kernels = laneKernels(m_level);
+    const size_t lanes = group.lanes;
+    double* state = group.state.data();
+
+    if (design.kind == FilterKind::FIR) {
+        // Mirrored history: the window ending at the newest row is always contiguous
+        const size_t taps = design.taps.size();
+        const double* coeffs = m_coeffs[group.design].data();
+        for (size_t k = 0; k < length; ++k) {
+            double* row = &group.rows[k * lanes];
+            std::copy(row, row + lanes, &state[group.pos * lanes]);
+            std::copy(row, row + lanes, &state[(group.pos + taps) * lanes]);
+            group.pos = (group.pos + 1 == taps) ? 0 : group.pos + 1;
+            kernels.fir(coeffs, taps, &state[group.pos * lanes], row, lanes);
+        }
+        return;
+    }
+
+    // Transposed direct form II: two state values per section and lane
+    const size_t sections = design.sections.size();
+    for (size_t k = 0; k < length; ++k) {
+        double* row = &group.rows[k * lanes];
+        for (size_t s = 0; s < sections; ++s) {
+            kernels.biquad(design.sections[s], row, &state[(2 * s) * lanes], &state[(2 * s + 1) * lanes], lanes);
+        }
+    }
+}
+
+// Prime: State the filter would hold after an infinitely long constant input equal to row 0
+void FilterBank::prime(Group& group) {
+    const FilterSpec& design = m_designs[group.design];
+    const size_t lanes = group.lanes;
+
+    if (design.kind == FilterKind::FIR) {
+        for (size_t slot = 0; slot < 2 * design.taps.size(); ++slot) {
+            std::copy(group.rows.begin(), group.rows.begin() + static_cast<std::ptrdiff_t>(lanes),
+                      group.state.begin() + static_cast<std::ptrdiff_t>(slot * lanes));
+        }
+        return;
+    }
+
+    for (size_t lane = 0; lane < lanes; ++lane) {
+        double x = group.rows[lane];
+        for (size_t s = 0; s < design.sections.size(); ++s) {
+            const Biquad& q = design.sections[s];
+            const double denominator = 1.0 + q.a1 + q.a2;
+            // A pole at DC has no steady state; that section starts from rest
+            const double y = (denominator != 0.0) ? (q.b0 + q.b1 + q.b2) / denominator * x : 0.0;
+            group.state[(2 * s) * lanes + lane] = (denominator != 0.0) ? y - q.b0 * x : 0.0;
+            group.state[(2 * s + 1) * lanes + lane] = (denominator != 0.0) ? q.b2 * x - q.a2 * y : 0.0;
+            x = y;
+        }
+    }
+}
+
+} // namespace sensor
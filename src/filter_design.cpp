@@ -0,0 +1,102 @@
+#include "filter_design.hpp"
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace sensor {
+
+namespace {
+    constexpr double PI = 3.14159265358979323846;
+}
+
+// WindowedSincLowPass: Ideal low-pass impulse response tapered by a Blackman window
+std::vector<double> windowedSincLowPass(size_t taps, double cutoff) {
+    std::vector<double> coeffs(taps);
+    const double centre = static_cast<double>(taps - 1) / 2.0;
+    const double span = static_cast<double>(taps > 1 ? taps - 1 : 1);
+    double gain = 0.0;
+    for (size_t n = 0; n < taps; ++n) {
+        const double t = static_cast<double>(n) - centre;
+        const double sinc = (t == 0.0) ? 2.0 * cutoff
+                                       : std::sin(2.0 * PI * cutoff * t) / (PI * t);
+        const double window = 0.42 - 0.5 * std::cos(2.0 * PI * n / span)
+                              + 0.08 * std::cos(4.0 * PI * n / span);
+        coeffs[n] = sinc * window;
+        gain += coeffs[n];
+    }
+    // Unity gain at DC, so a constant input passes through unchanged
+    for (double& c : coeffs) {
+        c /= gain;
+    }
+    return coeffs;
+}
+
+// ButterworthLowPass: Pole pairs as cookbook low-pass sections, Q_k = 1 / (2 cos(k pi / order))
+std::vector<Biquad> butterworthLowPass(int order, double cutoff) {
+    if (order < 1 || !(cutoff > 0.0 && cutoff < 0.5)) {
+        throw std::invalid_argument("Butterworth filters need an order of at least 1 and a cutoff"
+                                    " below half the sampling rate");
+    }
+
+    std::vector<Biquad> sections;
+    const double w0 = 2.0 * PI * cutoff;
+    const double cosw = std::cos(w0);
+
+    // Even orders: poles at (2k + 1) pi / (2 order); odd orders: k pi / order plus a real pole
+    for (int k = 0; k < order / 2; ++k) {
+        const double angle = (order % 2 == 0) ? (2.0 * k + 1.0) * PI / (2.0 * order)
+                                              : (k + 1.0) * PI / order;
+        const double q = 1.0 / (2.0 * std::cos(angle));
+        const double alpha = std::sin(w0) / (2.0 * q);
+        const double a0 = 1.0 + alpha;
+        sections.push_back({(1.0 - cosw) / 2.0 / a0, (1.0 - cosw) / a0, (1.0 - cosw) / 2.0 / a0,
+                            -2.0 * cosw / a0, (1.0 - alpha) / a0});
+    }
+    if (order % 2 != 0) {
+        const double k = std::tan(PI * cutoff);
+        sections.push_back({k / (1.0 + k), k / (1.0 + k), 0.0, (k - 1.0) / (k + 1.0), 0.0});
+    }
+    return sections;
+}
+
+// LoadTaps: Read every number in the file, failing loudly on anything else
+std::vector<double> loadTaps(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+        throw std::runtime_error("Cannot open taps file: " + path);
+    }
+
+    std::vector<double> taps;
+    std::string line;
+    size_t line_number = 0;
+    while (std::getline(file, line)) {
+        ++line_number;
+        line = line.substr(0, line.find('#'));
+        for (char& c : line) {
+            if (c == ',') {
+                c = ' ';
+            }
+        }
+        std::istringstream stream(line);
+        std::string field;
+        while (stream >> field) {
+            try {
+                size_t used = 0;
+                taps.push_back(std::stod(field, &used));
+                if (used != field.size()) {
+                    throw std::invalid_argument(field);
+                }
+            } catch (const std::logic_error&) {
+                throw std::runtime_error(path + ":" + std::to_string(line_number) +
+                                         ": taps must be numbers");
+            }
+        }
+    }
+    if (taps.empty()) {
+        throw std::runtime_error("Taps file holds no taps: " + path);
+    }
+    return taps;
+}
+
+} // namespace sensor
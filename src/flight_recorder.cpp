@@ -0,0 +1,438 @@
+#include "flight_recorder.hpp"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+
+namespace sensor {
+
+namespace {
+    constexpr uint32_t SEGMENT_MAGIC = 0x46524543;  // "FREC"
+    constexpr uint32_t SEGMENT_VERSION = 1;
+    constexpr mode_t FILE_PERMISSIONS = 0644;       // rw-r--r--
+
+    // SegmentPath: <directory>/<stream>_NNNNNN.seg
+    std::string segmentPath(const std::string& directory, const std::string& stream, uint32_t segment) {
+        char number[16];
+        snprintf(number, sizeof(number), "_%06u.seg", segment);
+        return directory + "/" + stream + number;
+    }
+
+    // IndexPath: <directory>/<stream>.idx
+    std::string indexPath(const std::string& directory, const std::string& stream) {
+        return directory + "/" + stream + ".idx";
+    }
+
+    // ListSegments: Segment numbers of a stream present in directory, ascending
+    std::vector<uint32_t> listSegments(const std::string& directory, const std::string& stream) {
+        std::vector<uint32_t> segments;
+        std::error_code ec;
+        const std::string prefix = stream + "_";
+        for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+            const std::string name = entry.path().filename().string();
+            if (name.size() != prefix.size() + 10 || name.compare(0, prefix.size(), prefix) != 0
+                || name.compare(name.size() - 4, 4, ".seg") != 0) {
+                continue;
+            }
+            const std::string digits = name.substr(prefix.size(), 6);
+            if (std::all_of(digits.begin(), digits.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+                segments.push_back(static_cast<uint32_t>(std::stoul(digits)));
+            }
+        }
+        std::sort(segments.begin(), segments.end());
+        return segments;
+    }
+
+    // WallNanos: Nanoseconds since the epoch of a system_clock time point
+    inline int64_t wallNanos(std::chrono::system_clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+}
+
+// Header at offset 0 of every segment file; records start at sizeof(SegmentHeader)
+struct SegmentHeader {
+    uint32_t magic;                // SEGMENT_MAGIC
+    uint32_t version;              // Layout version
+    uint32_t record_type;          // RecordType of every record
+    uint32_t record_size;          // Bytes per record (guards against layout changes)
+    uint64_t capacity;             // Record slots preallocated
+    std::atomic<uint64_t> count;   // Complete records; stored after each record is copied
+    int64_t first_ns;              // Wall-clock time of the first record
+    int64_t last_ns;               // Wall-clock time of the last record
+    uint64_t reserved[2];          // Pads the header to one cache line
+};
+
+static_assert(sizeof(SegmentHeader) == CACHE_LINE_SIZE, "segment header must fill one cache line");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "record count must be lock-free");
+static_assert(offsetof(SegmentHeader, count) == 24 && offsetof(SegmentHeader, first_ns) == 32
+              && offsetof(SegmentHeader, last_ns) == 40, "FlightReader parses the header at these offsets");
+
+// RecordSize: Records are the in-memory structs, written as raw bytes
+size_t FlightRecorder::recordSize(RecordType type) {
+    return type == RecordType::MQ_MESSAGE ? sizeof(MQMessage) : sizeof(SensorData);
+}
+
+// Constructor: Create the directory and index, then open the segment after any existing ones
+FlightRecorder::FlightRecorder(const std::string& directory, const std::string& stream,
+                               RecordType type, size_t segment_bytes)
+    : m_directory(directory)
+    , m_stream(stream)
+    , m_type(type)
+    , m_record_size(recordSize(type))
+    , m_capacity(0)
+    , m_index_fd(-1)
+    , m_segment_fd(-1)
+    , m_header(nullptr)
+    , m_mapped_bytes(0)
+    , m_records(nullptr)
+    , m_segment(0)
+    , m_count(0)
+    , m_total(0)
+    , m_segments_opened(0)
+    , m_failed(false)
+{
+    if (segment_bytes < sizeof(SegmentHeader) + m_record_size) {
+        throw std::invalid_argument("Flight recorder segment too small for one record");
+    }
+    m_capacity = (segment_bytes - sizeof(SegmentHeader)) / m_record_size;
+
+    std::error_code ec;
+    std::filesystem::create_directories(directory, ec);
+    if (ec) {
+        throw std::runtime_error("Cannot create recording directory " + directory + ": " + ec.message());
+    }
+
+    m_index_fd = ::open(indexPath(directory, stream).c_str(), O_RDWR | O_CREAT | O_CLOEXEC, FILE_PERMISSIONS);
+    if (m_index_fd == -1) {
+        throw std::runtime_error("Cannot open recording index in " + directory + ": " + strerror(errno));
+    }
+
+    const std::vector<uint32_t> existing = listSegments(directory, stream);
+    m_segment = existing.empty() ? 0 : existing.back() + 1;
+
+    if (openSegment() != ErrorCode::SUCCESS) {
+        close(m_index_fd);
+        throw std::runtime_error("Cannot create recording segment in " + directory + ": " + strerror(errno));
+    }
+}
+
+// Destructor: Seal the open segment so its file holds only complete records
+FlightRecorder::~FlightRecorder() {
+    sealSegment();
+    if (m_index_fd != -1) {
+        close(m_index_fd);
+    }
+}
+
+// OpenSegment: Create the file, reserve its blocks up front, map it and write its header
+ErrorCode FlightRecorder::openSegment() {
+    const std::string path = segmentPath(m_directory, m_stream, m_segment);
+    const size_t total = sizeof(SegmentHeader) + m_capacity * m_record_size;
+
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, FILE_PERMISSIONS);
+    if (fd == -1) {
+        return ErrorCode::RECORDER_ERROR;
+    }
+
+    // Allocate the blocks now so appends never fault on a full disk (SIGBUS);
+    // fall back to a sparse file where fallocate is unsupported
+#ifdef __linux__
+    int err = posix_fallocate(fd, 0, static_cast<off_t>(total));
+    if (err != 0 && err != EOPNOTSUPP && err != EINVAL) {
+        close(fd);
+        unlink(path.c_str());
+        errno = err;
+        return ErrorCode::RECORDER_ERROR;
+    }
+#endif
+    if (ftruncate(fd, static_cast<off_t>(total)) == -1) {
+        close(fd);
+        unlink(path.c_str());
+        return ErrorCode::RECORDER_ERROR;
+    }
+
+    void* base = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        unlink(path.c_str());
+        return ErrorCode::RECORDER_ERROR;
+    }
+
+    SegmentHeader* header = new (base) SegmentHeader;
+    header->magic = SEGMENT_MAGIC;
+    header->version = SEGMENT_VERSION;
+    header->record_type = static_cast<uint32_t>(m_type);
+    header->record_size = static_cast<uint32_t>(m_record_size);
+    header->capacity = m_capacity;
+    header->count.store(0, std::memory_order_relaxed);
+    header->first_ns = 0;
+    header->last_ns = 0;
+
+    m_segment_fd = fd;
+    m_header = header;
+    m_mapped_bytes = total;
+    m_records = static_cast<char*>(base) + sizeof(SegmentHeader);
+    m_count = 0;
+    ++m_segments_opened;
+
+    writeIndexEntry(SegmentIndexEntry{m_segment, static_cast<uint32_t>(m_type), 0, 0, 0});
+    return ErrorCode::SUCCESS;
+}
+
+// SealSegment: Flush, unmap, trim the preallocated tail and record the final count in the index
+void FlightRecorder::sealSegment() {
+    if (m_header == nullptr) {
+        return;
+    }
+
+    const SegmentIndexEntry entry{m_segment, static_cast<uint32_t>(m_type), m_count,
+                                  m_header->first_ns, m_header->last_ns};
+    msync(m_header, m_mapped_bytes, MS_ASYNC);
+    munmap(m_header, m_mapped_bytes);
+    if (ftruncate(m_segment_fd, static_cast<off_t>(sizeof(SegmentHeader) + m_count * m_record_size)) == -1) {
+        // The header count still bounds what readers use; the file just keeps its slack
+    }
+    close(m_segment_fd);
+    writeIndexEntry(entry);
+
+    m_header = nullptr;
+    m_records = nullptr;
+    m_mapped_bytes = 0;
+    m_segment_fd = -1;
+}
+
+// WriteIndexEntry: Fixed-size entries at fixed offsets, so rewriting one is a single pwrite
+void FlightRecorder::writeIndexEntry(const SegmentIndexEntry& entry) {
+    const off_t offset = static_cast<off_t>(entry.segment) * static_cast<off_t>(sizeof(entry));
+    if (pwrite(m_index_fd, &entry, sizeof(entry), offset) != static_cast<ssize_t>(sizeof(entry))) {
+        // The index is a summary; readers take counts from the segment headers
+    }
+}
+
+// Append: Raw readings keyed by their wall-clock timestamp
+ErrorCode FlightRecorder::append(const SensorData& data) {
+    return appendRecord(&data, wallNanos(data.timestamp));
+}
+
+// Append: Processed messages keyed by their wall-clock timestamp
+ErrorCode FlightRecorder::append(const MQMessage& msg) {
+    return appendRecord(&msg, wallNanos(msg.timestamp));
+}
+
+// AppendRecord: memcpy into the mapping, then publish the new count; roll over when full
+ErrorCode FlightRecorder::appendRecord(const void* record, int64_t timestamp_ns) {
+    if (m_failed) {
+        return ErrorCode::RECORDER_ERROR;
+    }
+
+    if (m_count == m_capacity) {
+        sealSegment();
+        ++m_segment;
+        if (openSegment() != ErrorCode::SUCCESS) {
+            std::cerr << "Warning: flight recorder stopped, cannot create "
+                      << segmentPath(m_directory, m_stream, m_segment) << ": " << strerror(errno) << "\n";
+            m_failed = true;
+            return ErrorCode::RECORDER_ERROR;
+        }
+    }
+
+    std::memcpy(m_records + m_count * m_record_size, record, m_record_size);
+    if (m_count == 0) {
+        m_header->first_ns = timestamp_ns;
+    }
+    m_header->last_ns = timestamp_ns;
+    ++m_count;
+    ++m_total;
+    m_header->count.store(m_count, std::memory_order_release);
+    return ErrorCode::SUCCESS;
+}
+
+// RecordCount: Returns records appended since construction
+uint64_t FlightRecorder::recordCount() const {
+    return m_total;
+}
+
+// SegmentCount: Returns segments created since construction
+uint32_t FlightRecorder::segmentCount() const {
+    return m_segments_opened;
+}
+
+// Constructor: Read every segment header of the stream to learn counts and time ranges
+FlightReader::FlightReader(const std::string& directory, const std::string& stream, RecordType type)
+    : m_directory(directory)
+    , m_stream(stream)
+    , m_type(type)
+    , m_record_size(FlightRecorder::recordSize(type))
+    , m_current(0)
+    , m_mapping(nullptr)
+    , m_mapped_bytes(0)
+    , m_records(nullptr)
+    , m_segment_count(0)
+    , m_next(0)
+    , m_position(0)
+    , m_total(0)
+{
+    for (uint32_t segment : listSegments(directory, stream)) {
+        const std::string path = segmentPath(directory, stream, segment);
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd == -1) {
+            continue;
+        }
+
+        // Plain fields only: copy the header bytes without touching the atomic
+        unsigned char raw[sizeof(SegmentHeader)];
+        struct stat st;
+        const bool readable = pread(fd, raw, sizeof(raw), 0) == static_cast<ssize_t>(sizeof(raw))
+            && fstat(fd, &st) == 0;
+        close(fd);
+        if (!readable) {
+            continue;
+        }
+
+        uint32_t magic, version, record_type, record_size;
+        uint64_t count;
+        int64_t first_ns, last_ns;
+        std::memcpy(&magic, raw + 0, 4);
+        std::memcpy(&version, raw + 4, 4);
+        std::memcpy(&record_type, raw + 8, 4);
+        std::memcpy(&record_size, raw + 12, 4);
+        std::memcpy(&count, raw + 24, 8);
+        std::memcpy(&first_ns, raw + 32, 8);
+        std::memcpy(&last_ns, raw + 40, 8);
+
+        if (magic != SEGMENT_MAGIC || version != SEGMENT_VERSION
+            || record_type != static_cast<uint32_t>(type) || record_size != m_record_size) {
+            std::cerr << "Warning: skipping incompatible recording segment " << path << "\n";
+            continue;
+        }
+
+        // Never trust the count beyond what the file actually holds
+        const uint64_t stored = static_cast<size_t>(st.st_size) > sizeof(raw)
+            ? (static_cast<size_t>(st.st_size) - sizeof(raw)) / m_record_size : 0;
+        count = std::min(count, stored);
+        if (count == 0) {
+            continue;
+        }
+
+        m_segments.push_back(SegmentIndexEntry{segment, record_type, count, first_ns, last_ns});
+        m_total += count;
+    }
+
+    if (m_segments.empty()) {
+        throw std::runtime_error("No " + stream + " recording found in " + directory);
+    }
+}
+
+// Destructor: Release the current mapping
+FlightReader::~FlightReader() {
+    unmapSegment();
+}
+
+// MapSegment: Map one segment read-only and hint sequential access
+bool FlightReader::mapSegment(size_t which) {
+    const SegmentIndexEntry& entry = m_segments[which];
+    const std::string path = segmentPath(m_directory, m_stream, entry.segment);
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        return false;
+    }
+
+    const size_t total = sizeof(SegmentHeader) + entry.count * m_record_size;
+    void* base = mmap(nullptr, total, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    madvise(base, total, MADV_SEQUENTIAL);
+
+    m_mapping = base;
+    m_mapped_bytes = total;
+    m_records = static_cast<const char*>(base) + sizeof(SegmentHeader);
+    m_segment_count = entry.count;
+    m_next = 0;
+    return true;
+}
+
+// UnmapSegment: Drop the current mapping, if any
+void FlightReader::unmapSegment() {
+    if (m_mapping != nullptr) {
+        munmap(m_mapping, m_mapped_bytes);
+        m_mapping = nullptr;
+        m_records = nullptr;
+        m_mapped_bytes = 0;
+        m_segment_count = 0;
+        m_next = 0;
+    }
+}
+
+// Next: Step through the mapped segment, moving to the next one when it is used up
+const void* FlightReader::next() {
+    while (m_mapping == nullptr || m_next == m_segment_count) {
+        if (m_mapping != nullptr) {
+            unmapSegment();
+            ++m_current;
+        }
+        if (m_current >= m_segments.size()) {
+            return nullptr;
+        }
+        if (!mapSegment(m_current)) {
+            std::cerr << "Warning: cannot map recording segment " << m_segments[m_current].segment << "\n";
+            ++m_current;
+        }
+    }
+
+    const void* record = m_records + m_next * m_record_size;
+    ++m_next;
+    ++m_position;
+    return record;
+}
+
+// NextSensorData: Copy out the next raw reading
+std::optional<SensorData> FlightReader::nextSensorData() {
+    const void* record = m_type == RecordType::SENSOR_DATA ? next() : nullptr;
+    if (record == nullptr) {
+        return std::nullopt;
+    }
+    SensorData data;
+    std::memcpy(&data, record, sizeof(data));
+    return data;
+}
+
+// NextMessage: Copy out the next processed message
+std::optional<MQMessage> FlightReader::nextMessage() {
+    const void* record = m_type == RecordType::MQ_MESSAGE ? next() : nullptr;
+    if (record == nullptr) {
+        return std::nullopt;
+    }
+    MQMessage msg;
+    std::memcpy(&msg, record, sizeof(msg));
+    return msg;
+}
+
+// Position: Returns records returned so far
+uint64_t FlightReader::position() const {
+    return m_position;
+}
+
+// TotalRecords: Returns records in all segments
+uint64_t FlightReader::totalRecords() const {
+    return m_total;
+}
+
+// Segments: Returns the segments in read order
+const std::vector<SegmentIndexEntry>& FlightReader::segments() const {
+    return m_segments;
+}
+
+} // namespace sensor
@@ -0,0 +1,100 @@
+#include "ingest_ring.hpp"
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+
+namespace sensor {
+
+static_assert(std::is_trivially_copyable_v<SensorData>, "readings are copied through shared memory");
+
+// Constructor: Validate the policy before touching shared memory
+IngestRing::IngestRing(OverflowPolicy policy, std::chrono::microseconds block_timeout)
+    : m_policy(policy)
+    , m_block_timeout(block_timeout)
+{
+    if (policy != OverflowPolicy::DROP_NEWEST && policy != OverflowPolicy::BLOCK) {
+        throw std::invalid_argument(std::string("Ingest ring cannot ") + overflowPolicyName(policy)
+                                    + ": only the processing process may remove readings");
+    }
+    m_ring = ShmRing::attach(INGEST_NAME, sizeof(SensorData), INGEST_SLOTS);
+    if (!m_ring) {
+        throw std::runtime_error(std::string("Cannot attach shared-memory ingest ring ") + INGEST_NAME);
+    }
+}
+
+// Push: Write straight into the next slot; BLOCK yields until the consumer frees one
+bool IngestRing::push(const SensorData& item) {
+    if (!m_ring->tryWrite(&item, sizeof(item))) {
+        bool written = false;
+        if (m_policy == OverflowPolicy::BLOCK) {
+            const auto deadline = std::chrono::steady_clock::now() + m_block_timeout;
+            while (!(written = m_ring->tryWrite(&item, sizeof(item)))
+                   && std::chrono::steady_clock::now() < deadline) {
+                std::this_thread::yield();
+            }
+        }
+        if (!written) {
+            m_ring->recordDrop();
+            m_ring->recordDepth(m_ring->capacity());
+            return false;
+        }
+    }
+    // Reading the consumer's position costs a cache miss, so the mark is sampled
+    if ((m_ring->written() & (DEPTH_SAMPLE_INTERVAL - 1)) == 0) {
+        m_ring->recordDepth(m_ring->size());
+    }
+    return true;
+}
+
+// Pop: Copy the reading out of its slot, then hand the slot back
+std::optional<SensorData> IngestRing::pop() {
+    const void* slot = m_ring->front();
+    if (!slot) {
+        return std::nullopt;
+    }
+    SensorData data;
+    std::memcpy(&data, slot, sizeof(data));
+    m_ring->popFront();
+    return data;
+}
+
+// WaitPop: Parks on the ring's futex; the timeout is rounded up to whole milliseconds
+std::optional<SensorData> IngestRing::waitPop(std::chrono::microseconds timeout) {
+    if (auto data = pop()) {
+        return data;
+    }
+    const std::chrono::milliseconds wait((timeout.count() + 999) / 1000);
+    if (!m_ring->waitReadable(wait)) {
+        return std::nullopt;
+    }
+    return pop();
+}
+
+// Empty: Nothing published that the consumer has not taken
+bool IngestRing::empty() const {
+    return m_ring->size() == 0;
+}
+
+// Capacity: Returns the number of slots
+size_t IngestRing::capacity() const {
+    return m_ring->capacity();
+}
+
+// Policy: Returns this process's overflow policy
+OverflowPolicy IngestRing::policy() const {
+    return m_policy;
+}
+
+// Counters: Read from the segment, so both processes report the same stage
+StageCounters IngestRing::counters() const {
+    StageCounters counters;
+    counters.consumed = m_ring->consumed();
+    counters.dropped = m_ring->dropped();
+    counters.produced = m_ring->written() + counters.dropped;
+    counters.high_water = m_ring->highWater();
+    return counters;
+}
+
+} // namespace sensor
@@ -0,0 +1,33 @@
+#include "ingest_source.hpp"
+
+namespace sensor {
+
+// Constructor: Join the ring with the same policy the acquisition side is configured with
+IngestSource::IngestSource(const Config& config)
+    : m_ring(config.sample_overflow, std::chrono::microseconds(config.overflow_block_us))
+{}
+
+// GetLatestData: Take the oldest pending reading without waiting
+std::optional<SensorData> IngestSource::getLatestData() {
+    return m_ring.pop();
+}
+
+// WaitForData: Sleep on the ring's futex until a reading arrives
+std::optional<SensorData> IngestSource::waitForData(std::chrono::microseconds timeout) {
+    return m_ring.waitPop(timeout);
+}
+
+// Report: Pending readings and totals since the segment was created
+void IngestSource::report(std::ostream& os) const {
+    const StageCounters counters = m_ring.counters();
+    os << "Ingest: " << INGEST_NAME << ", " << counters.consumed << " readings taken, "
+       << counters.produced - counters.consumed - counters.dropped << " pending of "
+       << m_ring.capacity() << " slots\n";
+}
+
+// Stages: Same row the acquisition process reports, read from the shared segment
+std::vector<StageReport> IngestSource::stages() const {
+    return {StageReport{"samples", m_ring.policy(), m_ring.capacity(), m_ring.counters()}};
+}
+
+} // namespace sensor
@@ -1,6 +1,10 @@
 #include "ipc_manager.hpp"
+#include <algorithm>
 #include <errno.h>
+#include <fstream>
+#include <poll.h>
 #include <string.h>
+#include <thread>
 
 #ifdef __APPLE__
 // Mock implementations for macOS (IDE only) - real implementation uses POSIX message queues
@@ -15,6 +19,7 @@ struct mq_attr {
 inline mqd_t mq_open(const char*, int, ...) { return -1; }
 inline int mq_send(mqd_t, const char*, size_t, unsigned int) { return -1; }
 inline ssize_t mq_receive(mqd_t, char*, size_t, unsigned int*) { return -1; }
+inline int mq_getattr(mqd_t, struct mq_attr*) { return -1; }
 inline int mq_close(mqd_t) { return 0; }
 inline int mq_unlink(const char*) { return 0; }
 #else
@@ -26,8 +31,19 @@ namespace sensor {
 // Constructor: Initialize member variables to safe defaults
 IPCManager::IPCManager()
     : m_queue(MQ_INVALID)
+    , m_backend(IPCBackend::MQUEUE)
     , m_is_initialized(false)
     , m_is_sender(false)
+    , m_tx_count(0)
+    , m_batch_limit(1)
+    , m_flush_deadline(0)
+    , m_tx_capacity(0)
+    , m_coded_frames(0)
+    , m_raw_bytes(0)
+    , m_coded_bytes(0)
+    , m_rx_data(nullptr)
+    , m_rx_count(0)
+    , m_rx_next(0)
 {}
 
 // Destructor: Clean up message queue resources
@@ -35,18 +51,88 @@ IPCManager::~IPCManager() {
     cleanup();
 }
 
+// BlockFrameBytes: Header, one timestamp per sample, then samples x channels doubles; a
+// compressed frame may need more in the worst case
+size_t IPCManager::blockFrameBytes(size_t channels, size_t samples, bool compressed) {
+    const size_t raw = sizeof(BlockFrameHeader)
+        + samples * sizeof(std::chrono::system_clock::time_point)
+        + channels * samples * sizeof(double);
+    return compressed ? std::max(raw, BlockCodec::maxFrameBytes(channels, samples)) : raw;
+}
+
+// QueueMessageLimit: Read from procfs, where Linux exposes the limit
+size_t IPCManager::queueMessageLimit() {
+    std::ifstream limit("/proc/sys/fs/mqueue/msgsize_max");
+    size_t bytes = 0;
+    return (limit >> bytes) ? bytes : 0;
+}
+
 // Initialize: Set up message queue for either sending or receiving
-ErrorCode IPCManager::initialize(bool is_sender) {
+ErrorCode IPCManager::initialize(bool is_sender, IPCBackend backend, size_t frame_bytes) {
     m_is_sender = is_sender;
+    m_backend = backend;
+
+    // Largest message the sender will produce: a batch frame or a block frame
+    const size_t max_message = std::max(MAX_MSG_SIZE, frame_bytes);
+
+    // Preallocate frame buffers so the send and receive paths never allocate
+    if (is_sender) {
+        m_tx_frame.assign(max_message, 0);
+        m_tx_capacity = max_message;
+        m_alert_frame.assign(MAX_MSG_SIZE, 0);
+    }
+
+    if (backend == IPCBackend::SHM) {
+        // Slots hold a block frame when those were requested, and always one MQMessage, the
+        // smallest slot a receiver accepts
+        const size_t slot_size = std::max(frame_bytes, sizeof(MQMessage));
+        const size_t slots = std::min(SHM_SLOTS, std::max<size_t>(8, SHM_RING_BYTES / slot_size));
+
+        // Sender creates the ring, receiver attaches to it
+        m_shm = is_sender ? ShmRing::create(SHM_NAME, slot_size, slots)
+                          : ShmRing::open(SHM_NAME, sizeof(MQMessage));
+        if (!m_shm) {
+            return ErrorCode::SHM_OPEN_ERROR;
+        }
+        if (is_sender) {
+            m_tx_capacity = std::min(m_tx_capacity, m_shm->slotSize());
+        } else {
+            m_rx_frame.assign(m_shm->slotSize(), 0);
+        }
+        m_is_initialized = true;
+        return ErrorCode::SUCCESS;
+    }
+
+    if (backend == IPCBackend::BROADCAST) {
+        // Same slot sizing as SHM, but a deeper ring: nobody waits for a lagging subscriber
+        const size_t slot_size = std::max(frame_bytes, sizeof(MQMessage));
+        const size_t slots = std::min(BROADCAST_SLOTS, std::max<size_t>(8, SHM_RING_BYTES / slot_size));
+
+        // Sender creates the ring, every receiver claims its own cursor
+        m_broadcast = is_sender ? BroadcastRing::create(BROADCAST_NAME, slot_size, slots)
+                                : BroadcastRing::subscribe(BROADCAST_NAME, sizeof(MQMessage));
+        if (!m_broadcast) {
+            return ErrorCode::SHM_OPEN_ERROR;
+        }
+        if (is_sender) {
+            m_tx_capacity = std::min(m_tx_capacity, m_broadcast->slotSize());
+        } else {
+            m_rx_frame.assign(m_broadcast->slotSize(), 0);
+        }
+        m_is_initialized = true;
+        return ErrorCode::SUCCESS;
+    }
     
     // Configure message queue attributes
     struct mq_attr attr;
     attr.mq_flags = 0;                    // Default flags
     attr.mq_maxmsg = MAX_MESSAGES;        // Maximum messages in queue
-    attr.mq_msgsize = sizeof(MQMessage);  // Size of each message
+    attr.mq_msgsize = static_cast<long>(max_message); // Room for a full batch or block frame
     attr.mq_curmsgs = 0;                  // Current number of messages
 
     if (is_sender) {
+        // Drop any stale queue so it is recreated with the current message size
+        mq_unlink(QUEUE_NAME);
         // Create queue with write-only access
         m_queue = mq_open(QUEUE_NAME, O_WRONLY | O_CREAT | O_NONBLOCK,
                          QUEUE_PERMISSIONS, &attr);
@@ -55,61 +141,669 @@ ErrorCode IPCManager::initialize(bool is_sender) {
         m_queue = mq_open(QUEUE_NAME, O_RDONLY | O_NONBLOCK, QUEUE_PERMISSIONS, nullptr);
     }
 
-    // Check if queue was opened successfully
+    // Check if queue was opened successfully; privileged senders may exceed the limit,
+    // so it only explains a refusal instead of being checked up front
     if (m_queue == MQ_INVALID) {
+        const bool invalid = (errno == EINVAL);
+        const size_t limit = queueMessageLimit();
+        if (is_sender && invalid && limit > 0 && max_message > limit) {
+            return ErrorCode::QUEUE_MSGSIZE_ERROR;
+        }
         return ErrorCode::QUEUE_OPEN_ERROR;
     }
 
+    if (!is_sender) {
+        // Receive buffer must hold the largest message the sender configured
+        struct mq_attr current;
+        const bool have_attr = (mq_getattr(m_queue, &current) == 0);
+        m_rx_frame.assign(have_attr ? static_cast<size_t>(current.mq_msgsize) : MAX_MSG_SIZE, 0);
+    }
+
     m_is_initialized = true;
     return ErrorCode::SUCCESS;
 }
 
-// SendMessage: Send a message to the queue
+// EnableBatching: Configure frame size and flush deadline for the message queue sender
+ErrorCode IPCManager::enableBatching(size_t max_messages, std::chrono::microseconds flush_deadline,
+                                     size_t& limit) {
+    limit = 1;
+    if (!m_is_initialized || !m_is_sender) {
+        return ErrorCode::QUEUE_SEND_ERROR;
+    }
+
+    // The shared-memory rings have no per-message syscall to amortize, but compression
+    // needs many messages per frame on every transport
+    if ((m_backend == IPCBackend::SHM || m_backend == IPCBackend::BROADCAST) && !m_tx_codec) {
+        return ErrorCode::SUCCESS;
+    }
+
+    flush();
+    m_batch_limit = std::min(std::max<size_t>(max_messages, 1),
+                             m_tx_codec ? MAX_COMPRESSED_BATCH : MAX_BATCH);
+    m_flush_deadline = flush_deadline;
+    limit = m_batch_limit;
+    return ErrorCode::SUCCESS;
+}
+
+// EnableCompression: Codecs for both frame kinds; the message codec takes the first
+// NUM_SENSORS precisions, which are the sensors themselves in the fixed pipeline
+ErrorCode IPCManager::enableCompression(const std::vector<double>& precision) {
+    if (!m_is_initialized || !m_is_sender) {
+        return ErrorCode::QUEUE_SEND_ERROR;
+    }
+
+    flush();
+    m_tx_codec = std::make_unique<MessageCodec>(precision);
+    m_tx_blocks = std::make_unique<BlockCodec>(precision);
+
+    // One spare byte pads a frame that would look like an unbatched MQMessage (see flush)
+    if (!m_tx_codec->begin(m_tx_frame.data(), m_tx_capacity - 1)) {
+        m_tx_codec.reset();
+        m_tx_blocks.reset();
+        return ErrorCode::QUEUE_SEND_ERROR;
+    }
+    m_batch_limit = MAX_COMPRESSED_BATCH;
+    return ErrorCode::SUCCESS;
+}
+
+// SendMessage: Send a message to the queue, or append it to the pending batch
 ErrorCode IPCManager::sendMessage(const MQMessage& msg) {
     // Verify manager is initialized and in sender mode
     if (!m_is_initialized || !m_is_sender) {
         return ErrorCode::QUEUE_SEND_ERROR;
     }
 
-    // Attempt to send message to queue
-    if (mq_send(m_queue, reinterpret_cast<const char*>(&msg), 
-                sizeof(MQMessage), 0) == -1) {
+    if (m_backend == IPCBackend::SHM && !m_tx_codec) {
+        // Ring full means the receiver is a full lap behind
+        return m_shm->tryWrite(&msg, sizeof(MQMessage)) ? ErrorCode::SUCCESS
+                                                        : ErrorCode::BUFFER_FULL;
+    }
+    if (m_backend == IPCBackend::BROADCAST && !m_tx_codec) {
+        // Never full: slow subscribers lose the oldest messages instead
+        return m_broadcast->publish(&msg, sizeof(MQMessage)) ? ErrorCode::SUCCESS
+                                                             : ErrorCode::QUEUE_SEND_ERROR;
+    }
+
+    if (m_batch_limit <= 1 && !m_tx_codec) {
+        // Attempt to send message to queue
+        return sendFrame(reinterpret_cast<const char*>(&msg), sizeof(MQMessage));
+    }
+
+    // A full batch left over from a failed flush must go out before we can append
+    if (m_tx_count == m_batch_limit) {
+        ErrorCode result = flush();
+        if (result != ErrorCode::SUCCESS) {
+            return result;
+        }
+    }
+
+    if (m_tx_count == 0) {
+        m_tx_first = std::chrono::steady_clock::now();
+        if (m_tx_codec) {
+            m_tx_codec->begin(m_tx_frame.data(), m_tx_capacity - 1);
+        }
+    }
+    if (m_tx_codec) {
+        // A compressed frame fills up by size rather than count
+        if (!m_tx_codec->append(msg)) {
+            ErrorCode result = flush();
+            if (result != ErrorCode::SUCCESS) {
+                return result;
+            }
+            m_tx_first = std::chrono::steady_clock::now();
+            m_tx_codec->begin(m_tx_frame.data(), m_tx_capacity - 1);
+            m_tx_codec->append(msg);
+        }
+    } else {
+        memcpy(m_tx_frame.data() + sizeof(MQBatchHeader) + m_tx_count * sizeof(MQMessage),
+               &msg, sizeof(MQMessage));
+    }
+    ++m_tx_count;
+
+    ErrorCode result = (m_tx_count == m_batch_limit) ? flush() : flushIfDue();
+    // A full queue only delays the batch; the message itself is kept and retried
+    return result == ErrorCode::BUFFER_FULL ? ErrorCode::SUCCESS : result;
+}
+
+// Flush: Frame the pending messages behind a header and send them with one mq_send
+ErrorCode IPCManager::flush() {
+    if (m_tx_count == 0) {
+        return ErrorCode::SUCCESS;
+    }
+
+    if (m_tx_codec) {
+        // Receivers take a frame of exactly sizeof(MQMessage) for an unbatched message
+        size_t length = m_tx_codec->finish();
+        if (length == sizeof(MQMessage)) {
+            m_tx_frame[length++] = 0;
+        }
+        ErrorCode result = sendFrame(m_tx_frame.data(), length);
+        if (result == ErrorCode::SUCCESS) {
+            ++m_coded_frames;
+            m_raw_bytes += sizeof(MQBatchHeader) + m_tx_count * sizeof(MQMessage);
+            m_coded_bytes += length;
+            m_tx_count = 0;
+        }
+        return result;
+    }
+
+    MQBatchHeader header{BATCH_MAGIC, static_cast<uint32_t>(m_tx_count)};
+    memcpy(m_tx_frame.data(), &header, sizeof(header));
+
+    ErrorCode result = sendFrame(m_tx_frame.data(),
+                                 sizeof(MQBatchHeader) + m_tx_count * sizeof(MQMessage));
+    if (result == ErrorCode::SUCCESS) {
+        m_tx_count = 0;
+    }
+    return result;
+}
+
+// FlushIfDue: Flush once the oldest pending message has waited for the flush deadline
+ErrorCode IPCManager::flushIfDue() {
+    if (m_tx_count == 0) {
+        return ErrorCode::SUCCESS;
+    }
+    if (std::chrono::steady_clock::now() - m_tx_first >= m_flush_deadline) {
+        return flush();
+    }
+    return ErrorCode::SUCCESS;
+}
+
+// FlushDelay: Time left before the pending batch must be flushed (max if nothing pending)
+std::chrono::microseconds IPCManager::flushDelay() const {
+    if (m_tx_count == 0) {
+        return std::chrono::microseconds::max();
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - m_tx_first);
+    return std::max(m_flush_deadline - elapsed, std::chrono::microseconds(0));
+}
+
+// WaitWritable: poll() for POLLOUT on the queue; the SHM consumer never signals, so yield instead
+bool IPCManager::waitWritable(std::chrono::microseconds timeout) {
+    if (!m_is_initialized || !m_is_sender) {
+        return false;
+    }
+
+    if (m_backend == IPCBackend::BROADCAST) {
+        // Publishing never waits for subscribers
+        return true;
+    }
+
+    if (m_backend == IPCBackend::SHM) {
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (m_shm->size() >= m_shm->capacity()) {
+            if (std::chrono::steady_clock::now() >= deadline) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+
+    struct pollfd pfd;
+    pfd.fd = m_queue;
+    pfd.events = POLLOUT;
+    pfd.revents = 0;
+
+    // Round up so a sub-millisecond timeout still waits instead of polling once
+    const int timeout_ms = static_cast<int>((timeout.count() + 999) / 1000);
+    return poll(&pfd, 1, timeout_ms) > 0 && (pfd.revents & POLLOUT);
+}
+
+// SendAlerts: As many alerts per frame as a frame (and a ring slot) holds; a frame is
+// never exactly one MQMessage long, which receivers would take for an unbatched message
+ErrorCode IPCManager::sendAlerts(const AnomalyAlert* alerts, size_t count, size_t& sent) {
+    sent = 0;
+    if (!m_is_initialized || !m_is_sender) {
+        return ErrorCode::QUEUE_SEND_ERROR;
+    }
+
+    const size_t capacity = std::min(m_alert_frame.size(), m_tx_capacity) - 1;
+    const size_t per_frame = (capacity - sizeof(AlertFrameHeader)) / sizeof(AnomalyAlert);
+    while (sent < count) {
+        const size_t n = std::min(count - sent, per_frame);
+        const AlertFrameHeader header{ALERT_MAGIC, static_cast<uint32_t>(n)};
+        memcpy(m_alert_frame.data(), &header, sizeof(header));
+        memcpy(m_alert_frame.data() + sizeof(header), alerts + sent, n * sizeof(AnomalyAlert));
+
+        size_t length = sizeof(header) + n * sizeof(AnomalyAlert);
+        if (length == sizeof(MQMessage)) {
+            m_alert_frame[length++] = 0;
+        }
+        const ErrorCode result = sendFrame(m_alert_frame.data(), length, ALERT_PRIORITY);
+        if (result != ErrorCode::SUCCESS) {
+            return result;
+        }
+        sent += n;
+    }
+    return ErrorCode::SUCCESS;
+}
+
+// TakeAlerts: Hand over the stash, keeping out's storage for the next one
+size_t IPCManager::takeAlerts(std::vector<AnomalyAlert>& out) {
+    out.clear();
+    out.swap(m_rx_alerts);
+    return out.size();
+}
+
+// SendWindows: Flush first so the report follows the messages it covers; a report the
+// transport refuses is dropped, the next one supersedes it anyway
+ErrorCode IPCManager::sendWindows(const WindowReport& report) {
+    if (!m_is_initialized || !m_is_sender || m_tx_capacity < WINDOW_FRAME_BYTES) {
+        return ErrorCode::QUEUE_SEND_ERROR;
+    }
+    const ErrorCode flushed = flush();
+    if (flushed != ErrorCode::SUCCESS) {
+        return flushed;
+    }
+
+    char frame[WINDOW_FRAME_BYTES];
+    const WindowFrameHeader header{WINDOW_MAGIC, 1};
+    memcpy(frame, &header, sizeof(header));
+    memcpy(frame + sizeof(header), &report, sizeof(report));
+    return sendFrame(frame, sizeof(frame));
+}
+
+// TakeWindows: Hand over the stash, keeping out's storage for the next one
+size_t IPCManager::takeWindows(std::vector<WindowReport>& out) {
+    out.clear();
+    out.swap(m_rx_windows);
+    return out.size();
+}
+
+// SendFrame: One ring slot, or a single non-blocking mq_send
+ErrorCode IPCManager::sendFrame(const char* data, size_t len, unsigned priority) {
+    if (m_backend == IPCBackend::SHM) {
+        return m_shm->tryWrite(data, len) ? ErrorCode::SUCCESS : ErrorCode::BUFFER_FULL;
+    }
+    if (m_backend == IPCBackend::BROADCAST) {
+        return m_broadcast->publish(data, len) ? ErrorCode::SUCCESS : ErrorCode::QUEUE_SEND_ERROR;
+    }
+    if (mq_send(m_queue, data, len, priority) == -1) {
         if (errno == EAGAIN) {
             // Queue is full, non-blocking call would block
             return ErrorCode::BUFFER_FULL;
         }
         return ErrorCode::QUEUE_SEND_ERROR;
     }
-
     return ErrorCode::SUCCESS;
 }
 
-// ReceiveMessage: Attempt to receive a message from the queue
+// SendBlock: Serialize header, timestamps and every column into one frame
+ErrorCode IPCManager::sendBlock(const SampleBlock& block) {
+    if (!m_is_initialized || !m_is_sender) {
+        return ErrorCode::QUEUE_SEND_ERROR;
+    }
+
+    const size_t channels = block.channels();
+    const size_t length = block.length();
+    const size_t bytes = blockFrameBytes(channels, length);
+    if (bytes > m_tx_capacity) {
+        return ErrorCode::QUEUE_SEND_ERROR;
+    }
+
+    // The frame buffer is shared with batching; never overwrite unsent messages
+    if (flush() != ErrorCode::SUCCESS) {
+        return ErrorCode::BUFFER_FULL;
+    }
+
+    // Compressed when that is smaller, which it is unless the values are noise
+    if (m_tx_blocks) {
+        // Columns are block.stride() apart, padded past the block's capacity
+        const size_t coded = m_tx_blocks->encode(block.firstSequence(), block.stages(), block.timestamps(),
+                                                 block.column(0), block.stride(), length,
+                                                 m_tx_frame.data(), m_tx_capacity);
+        if (coded != 0 && coded < bytes) {
+            const ErrorCode result = sendFrame(m_tx_frame.data(), coded);
+            if (result == ErrorCode::SUCCESS) {
+                ++m_coded_frames;
+                m_raw_bytes += bytes;
+                m_coded_bytes += coded;
+            }
+            return result;
+        }
+    }
+
+    char* out = m_tx_frame.data();
+    BlockFrameHeader header{BLOCK_MAGIC, static_cast<uint32_t>(channels),
+                            static_cast<uint32_t>(length), 0, block.firstSequence(),
+                            block.stages()};
+    memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    memcpy(out, block.timestamps(), length * sizeof(SampleBlock::TimePoint));
+    out += length * sizeof(SampleBlock::TimePoint);
+    for (size_t ch = 0; ch < channels; ++ch) {
+        memcpy(out, block.column(ch), length * sizeof(double));
+        out += length * sizeof(double);
+    }
+
+    const ErrorCode result = sendFrame(m_tx_frame.data(), bytes);
+    if (result == ErrorCode::SUCCESS && m_tx_blocks) {
+        ++m_coded_frames;
+        m_raw_bytes += bytes;
+        m_coded_bytes += bytes;
+    }
+    return result;
+}
+
+// ReceiveBlock: Fetch one frame and expose it as column views into the receive buffer
+std::optional<BlockView> IPCManager::receiveBlock() {
+    const size_t length = fetchRaw();
+    if (BlockCodec::isFrame(m_rx_frame.data(), length)) {
+        // Compressed: unpack into m_rx_block, which then backs the view
+        if (!m_rx_block_codec.decode(m_rx_frame.data(), length, m_rx_block)) {
+            return std::nullopt;
+        }
+        BlockView view;
+        view.first_msg_id = m_rx_block.first_msg_id;
+        view.channels = m_rx_block.channels;
+        view.length = m_rx_block.length;
+        view.stages = m_rx_block.stages;
+        view.timestamps = m_rx_block.timestamps.data();
+        view.values = m_rx_block.values.data();
+        return view;
+    }
+    if (length < sizeof(BlockFrameHeader)) {
+        return std::nullopt;
+    }
+
+    BlockFrameHeader header;
+    memcpy(&header, m_rx_frame.data(), sizeof(header));
+    if (header.magic != BLOCK_MAGIC || length != blockFrameBytes(header.channels, header.length)) {
+        // Not a block frame: drop it rather than hand out garbage
+        return std::nullopt;
+    }
+
+    const char* payload = m_rx_frame.data() + sizeof(header);
+    BlockView view;
+    view.first_msg_id = header.first_msg_id;
+    view.channels = header.channels;
+    view.length = header.length;
+    view.stages = header.stages;
+    view.timestamps = reinterpret_cast<const std::chrono::system_clock::time_point*>(payload);
+    view.values = reinterpret_cast<const double*>(
+        payload + header.length * sizeof(std::chrono::system_clock::time_point));
+    return view;
+}
+
+// ReceiveBlock: Blocking variant, returns empty optional on timeout
+std::optional<BlockView> IPCManager::receiveBlock(std::chrono::milliseconds timeout) {
+    if (auto block = receiveBlock()) {
+        return block;
+    }
+    if (!waitReadable(timeout)) {
+        return std::nullopt;
+    }
+    return receiveBlock();
+}
+
+// ReceiveMessage: Hand out the next message, fetching a new frame when the current one is used up
 std::optional<MQMessage> IPCManager::receiveMessage() {
+    if (m_rx_next == m_rx_count && !fetchFrame()) {
+        return std::nullopt;
+    }
+    return m_rx_data[m_rx_next++];
+}
+
+// ReceiveMessage: Try a non-blocking receive, otherwise wait until the transport is readable
+std::optional<MQMessage> IPCManager::receiveMessage(std::chrono::milliseconds timeout) {
+    // Fast path: one syscall (none for SHM) when a message is already waiting
+    if (auto msg = receiveMessage()) {
+        return msg;
+    }
+    if (!waitReadable(timeout)) {
+        return std::nullopt;
+    }
+    return receiveMessage();
+}
+
+// ReceiveBatch: Return every message of the current or next frame as one span
+MessageSpan IPCManager::receiveBatch() {
+    if (m_rx_next == m_rx_count && !fetchFrame()) {
+        return MessageSpan{};
+    }
+    return takePending();
+}
+
+// ReceiveBatch: Blocking variant, returns an empty span on timeout
+MessageSpan IPCManager::receiveBatch(std::chrono::milliseconds timeout) {
+    MessageSpan batch = receiveBatch();
+    if (!batch.empty() || !waitReadable(timeout)) {
+        return batch;
+    }
+    return receiveBatch();
+}
+
+// TakePending: Mark the rest of the receive frame consumed and return it
+MessageSpan IPCManager::takePending() {
+    MessageSpan batch{m_rx_data + m_rx_next, m_rx_count - m_rx_next};
+    m_rx_next = m_rx_count;
+    return batch;
+}
+
+// FetchRaw: Alert frames may arrive between any two others (or first, by priority), and
+// window reports between any two message frames, so both are unpacked here and never
+// reach the message and block decoders
+size_t IPCManager::fetchRaw() {
+    for (;;) {
+        const size_t length = fetchSlot();
+        AlertFrameHeader header{};
+        if (length == 0 || length == sizeof(MQMessage) || length < sizeof(header)) {
+            return length;
+        }
+        memcpy(&header, m_rx_frame.data(), sizeof(header));
+        const char* payload = m_rx_frame.data() + sizeof(header);
+        if (header.magic == ALERT_MAGIC) {
+            const size_t expected = sizeof(header) + header.count * sizeof(AnomalyAlert);
+            if (length != expected && length != expected + 1) {
+                return length;
+            }
+            const size_t first = m_rx_alerts.size();
+            m_rx_alerts.resize(first + header.count);
+            memcpy(m_rx_alerts.data() + first, payload, header.count * sizeof(AnomalyAlert));
+        } else if (header.magic == WINDOW_MAGIC) {
+            if (length != sizeof(WindowFrameHeader) + header.count * sizeof(WindowReport)) {
+                return length;
+            }
+            const size_t first = m_rx_windows.size();
+            m_rx_windows.resize(first + header.count);
+            memcpy(m_rx_windows.data() + first, payload, header.count * sizeof(WindowReport));
+        } else {
+            return length;
+        }
+    }
+}
+
+// FetchSlot: Receive one queue message or shared-memory slot into the receive buffer
+size_t IPCManager::fetchSlot() {
     // Verify manager is initialized and in receiver mode
     if (!m_is_initialized || m_is_sender) {
-        return std::nullopt;
+        return 0;
     }
 
-    // Attempt to receive message from queue
-    MQMessage msg;
-    ssize_t bytes_read = mq_receive(m_queue, reinterpret_cast<char*>(&msg),
-                                  sizeof(MQMessage), nullptr);
+    if (m_backend == IPCBackend::SHM) {
+        // Copy straight out of the shared slot, then hand the slot back
+        const void* slot = m_shm->front();
+        if (!slot) {
+            return 0;
+        }
+        const size_t length = std::min(m_shm->frontLength(), m_rx_frame.size());
+        memcpy(m_rx_frame.data(), slot, length);
+        m_shm->popFront();
+        return length;
+    }
+    if (m_backend == IPCBackend::BROADCAST) {
+        // Copies and validates in one step; overwritten messages are skipped and counted
+        return m_broadcast->read(m_rx_frame.data(), m_rx_frame.size());
+    }
 
+    // Attempt to receive message from queue
+    ssize_t bytes_read = mq_receive(m_queue, m_rx_frame.data(), m_rx_frame.size(), nullptr);
     if (bytes_read == -1) {
-        if (errno == EAGAIN) {
-            // No message available, non-blocking call would block
-            return std::nullopt;
+        // EAGAIN: no message available, non-blocking call would block
+        return 0;
+    }
+    return static_cast<size_t>(bytes_read);
+}
+
+// FetchFrame: Receive one queue message or shared-memory slot and decode it
+bool IPCManager::fetchFrame() {
+    const size_t length = fetchRaw();
+    if (length == 0) {
+        return false;
+    }
+
+    // Unbatched senders put exactly one MQMessage in each queue message
+    if (length == sizeof(MQMessage)) {
+        m_rx_data = reinterpret_cast<const MQMessage*>(m_rx_frame.data());
+        m_rx_count = 1;
+        m_rx_next = 0;
+        return true;
+    }
+
+    // Compressed batches are unpacked into m_rx_messages
+    if (MessageCodec::isFrame(m_rx_frame.data(), length)) {
+        if (!m_rx_codec.decode(m_rx_frame.data(), length, m_rx_messages)) {
+            m_rx_count = m_rx_next = 0;
+            return false;
         }
-        return std::nullopt;
+        m_rx_data = m_rx_messages.data();
+        m_rx_count = m_rx_messages.size();
+        m_rx_next = 0;
+        return true;
+    }
+
+    // Otherwise expect a batch header followed by exactly header.count messages
+    MQBatchHeader header{};
+    if (length >= sizeof(header)) {
+        memcpy(&header, m_rx_frame.data(), sizeof(header));
+    }
+    if (header.magic != BATCH_MAGIC ||
+        length != sizeof(MQBatchHeader) + header.count * sizeof(MQMessage)) {
+        // Malformed frame: drop it rather than hand out garbage
+        m_rx_count = m_rx_next = 0;
+        return false;
+    }
+
+    m_rx_data = reinterpret_cast<const MQMessage*>(m_rx_frame.data() + sizeof(MQBatchHeader));
+    m_rx_count = header.count;
+    m_rx_next = 0;
+    return true;
+}
+
+// WaitReadable: Park until the transport signals data or timeout expires
+bool IPCManager::waitReadable(std::chrono::milliseconds timeout) {
+    if (!m_is_initialized || m_is_sender) {
+        return false;
     }
 
-    return msg;
+    if (m_backend == IPCBackend::SHM) {
+        // Parks on the ring's futex; no syscall if a message shows up first
+        return m_shm->waitReadable(timeout);
+    }
+    if (m_backend == IPCBackend::BROADCAST) {
+        return m_broadcast->waitReadable(timeout);
+    }
+
+    // On Linux an mqd_t is a file descriptor, so poll() wakes exactly when a message arrives
+    struct pollfd pfd;
+    pfd.fd = m_queue;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    int ready = poll(&pfd, 1, static_cast<int>(timeout.count()));
+    // Timeout, signal or error: caller re-checks its running flag
+    return ready > 0 && (pfd.revents & POLLIN);
+}
+
+// LostMessages: Returns messages this subscriber skipped because the producer lapped it
+uint64_t IPCManager::lostMessages() const {
+    if (!m_is_initialized || m_is_sender || m_backend != IPCBackend::BROADCAST) {
+        return 0;
+    }
+    return m_broadcast->lost();
 }
 
-// Cleanup: Close and unlink message queue
+// QueueDepth: mq_getattr for the message queue, ring positions for the shared-memory backends
+size_t IPCManager::queueDepth() const {
+    if (!m_is_initialized) {
+        return 0;
+    }
+    if (m_backend == IPCBackend::SHM) {
+        return m_shm->size();
+    }
+    if (m_backend == IPCBackend::BROADCAST) {
+        if (!m_is_sender) {
+            return 0;
+        }
+        uint64_t deepest = 0;
+        for (const BroadcastRing::SubscriberStats& sub : m_broadcast->subscribers()) {
+            deepest = std::max(deepest, sub.lag);
+        }
+        return static_cast<size_t>(deepest);
+    }
+    struct mq_attr attr;
+    return mq_getattr(m_queue, &attr) == 0 ? static_cast<size_t>(attr.mq_curmsgs) : 0;
+}
+
+// QueueCapacity: The queue's own limit, which may differ from MAX_MESSAGES for an existing queue
+size_t IPCManager::queueCapacity() const {
+    if (!m_is_initialized) {
+        return 0;
+    }
+    if (m_backend == IPCBackend::SHM) {
+        return m_shm->capacity();
+    }
+    if (m_backend == IPCBackend::BROADCAST) {
+        return m_broadcast->capacity();
+    }
+    struct mq_attr attr;
+    return mq_getattr(m_queue, &attr) == 0 ? static_cast<size_t>(attr.mq_maxmsg) : 0;
+}
+
+// Report: Compression ratio, then one line per attached subscriber, as seen from the
+// producer's side of the ring
+void IPCManager::report(std::ostream& os) const {
+    if (!m_is_initialized || !m_is_sender) {
+        return;
+    }
+    if (m_tx_codec && m_coded_bytes > 0) {
+        os << "Compression: " << m_coded_frames << " frames, " << m_raw_bytes << " bytes sent as "
+           << m_coded_bytes << " ("
+           << static_cast<double>(m_raw_bytes) / static_cast<double>(m_coded_bytes) << "x)\n";
+    }
+    if (m_backend != IPCBackend::BROADCAST) {
+        return;
+    }
+    const auto subscribers = m_broadcast->subscribers();
+    os << "Broadcast: " << subscribers.size() << " subscribers, " << m_broadcast->capacity()
+       << " slots, " << m_broadcast->slowEvents() << " slow events\n";
+    for (const BroadcastRing::SubscriberStats& sub : subscribers) {
+        os << "  #" << sub.id << " pid " << sub.pid << ": " << sub.received << " received, "
+           << sub.lost << " lost, lag " << sub.lag << (sub.slow ? " (slow)" : "") << "\n";
+    }
+}
+
+// Cleanup: Flush any pending batch, then close and unlink message queue
 void IPCManager::cleanup() {
+    if (m_is_initialized && m_backend == IPCBackend::SHM) {
+        // Unmaps, and unlinks the segment if this is the sender
+        m_shm.reset();
+        m_is_initialized = false;
+        return;
+    }
+    if (m_is_initialized && m_backend == IPCBackend::BROADCAST) {
+        // Frees the subscriber entry, or unlinks the segment if this is the sender
+        m_broadcast.reset();
+        m_is_initialized = false;
+        return;
+    }
     if (m_is_initialized) {
+        if (m_is_sender) {
+            // Best effort: a full queue at shutdown loses the final partial batch
+            flush();
+        }
         // Close the queue handle
         mq_close(m_queue);
         if (m_is_sender) {
@@ -120,4 +814,4 @@ void IPCManager::cleanup() {
     }
 }
 
-} // namespace sensor 
\ No newline at end of file
+} // namespace sensor
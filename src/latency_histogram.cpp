@@ -0,0 +1,152 @@
+#include "latency_histogram.hpp"
+#include <algorithm>
+#include <iomanip>
+
+namespace sensor {
+
+namespace {
+    // HighestBit: Index of the most significant set bit (value must be non-zero)
+    inline unsigned highestBit(uint64_t value) {
+        return 63u - static_cast<unsigned>(__builtin_clzll(value));
+    }
+}
+
+// Constructor: Zero every counter (std::atomic default construction leaves them indeterminate)
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+// BucketIndex: Values below 2*SUB_BUCKETS map one-to-one; above that each power of two
+// [2^k, 2^(k+1)) is split into SUB_BUCKETS equal buckets of width 2^(k - SUB_BUCKET_BITS)
+size_t LatencyHistogram::bucketIndex(uint64_t value) {
+    if (value < 2 * SUB_BUCKETS) {
+        return static_cast<size_t>(value);
+    }
+    const unsigned shift = highestBit(value) - SUB_BUCKET_BITS;
+    return shift * SUB_BUCKETS + static_cast<size_t>(value >> shift);
+}
+
+// BucketUpperBound: Inverse of bucketIndex, the largest value in the bucket
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < 2 * SUB_BUCKETS) {
+        return index;
+    }
+    const unsigned shift = static_cast<unsigned>(index / SUB_BUCKETS) - 1;
+    const uint64_t sub = index - shift * SUB_BUCKETS;
+    // Wraps to UINT64_MAX for the very last bucket, which is the right answer
+    return ((sub + 1) << shift) - 1;
+}
+
+// Record: Relaxed increments only; readers tolerate a record being half-applied
+void LatencyHistogram::record(uint64_t ns) {
+    m_buckets[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(ns, std::memory_order_relaxed);
+
+    // New maxima are rare once the histogram has warmed up, so this loop almost never runs
+    uint64_t max = m_max.load(std::memory_order_relaxed);
+    while (ns > max && !m_max.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+    }
+}
+
+// Summarize: Copy the buckets once, then walk them for each percentile
+LatencyHistogram::Summary LatencyHistogram::summarize() const {
+    std::array<uint64_t, BUCKETS> counts;
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKETS; ++i) {
+        counts[i] = m_buckets[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+
+    Summary summary;
+    summary.count = total;
+    summary.max = m_max.load(std::memory_order_relaxed);
+    if (total == 0) {
+        return summary;
+    }
+    summary.mean = static_cast<double>(m_sum.load(std::memory_order_relaxed))
+                 / static_cast<double>(total);
+
+    // Smallest bucket whose cumulative count reaches the rank, reported as its upper bound
+    auto valueAt = [&](double quantile) {
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(quantile * static_cast<double>(total) + 0.5));
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                return std::min(bucketUpperBound(i), summary.max);
+            }
+        }
+        return summary.max;
+    };
+    summary.p50 = valueAt(0.50);
+    summary.p99 = valueAt(0.99);
+    summary.p999 = valueAt(0.999);
+    return summary;
+}
+
+// Reset: Zero every counter
+void LatencyHistogram::reset() {
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+// Record: Convert a pair of stage stamps into a duration on the hop's histogram
+void LatencyStats::record(LatencyHop hop, uint64_t from_ns, uint64_t to_ns) {
+    if (from_ns == 0 || to_ns < from_ns) {
+        return;
+    }
+    m_histograms[static_cast<size_t>(hop)].record(to_ns - from_ns);
+}
+
+// Histogram: Returns the histogram of one hop
+const LatencyHistogram& LatencyStats::histogram(LatencyHop hop) const {
+    return m_histograms[static_cast<size_t>(hop)];
+}
+
+// Report: One table row per hop, durations in microseconds
+void LatencyStats::report(std::ostream& os) const {
+    const auto flags = os.flags();
+    const auto precision = os.precision();
+
+    os << "\nLatency (us)            count      mean       p50       p99     p99.9       max\n";
+    os << std::fixed << std::setprecision(1);
+    for (size_t i = 0; i < m_histograms.size(); ++i) {
+        const LatencyHistogram::Summary s = m_histograms[i].summarize();
+        os << std::left << std::setw(20) << hopName(static_cast<LatencyHop>(i)) << std::right
+           << std::setw(9) << s.count
+           << std::setw(10) << s.mean / 1e3
+           << std::setw(10) << static_cast<double>(s.p50) / 1e3
+           << std::setw(10) << static_cast<double>(s.p99) / 1e3
+           << std::setw(10) << static_cast<double>(s.p999) / 1e3
+           << std::setw(10) << static_cast<double>(s.max) / 1e3 << "\n";
+    }
+    os.flush();
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+// Reset: Clear every hop
+void LatencyStats::reset() {
+    for (auto& histogram : m_histograms) {
+        histogram.reset();
+    }
+}
+
+// HopName: Display name of a hop
+const char* LatencyStats::hopName(LatencyHop hop) {
+    switch (hop) {
+        case LatencyHop::QUEUE:      return "generated->popped";
+        case LatencyHop::PROCESS:    return "popped->sent";
+        case LatencyHop::IPC:        return "sent->received";
+        case LatencyHop::OUTPUT:     return "received->printed";
+        case LatencyHop::END_TO_END: return "generated->printed";
+        case LatencyHop::ALERT:      return "generated->alerted";
+        default:                     return "unknown";
+    }
+}
+
+} // namespace sensor
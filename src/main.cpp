@@ -1,11 +1,22 @@
 // Header includes for core system components
 #include "sensor_simulator.hpp"
+#include "replay_source.hpp"
+#include "ingest_source.hpp"
 #include "data_processor.hpp"
 #include "output_handler.hpp"
+#include "channel_registry.hpp"
+#include "latency_histogram.hpp"
+#include "stage_counters.hpp"
+#include "metrics_exporter.hpp"
+#include "time_series_store.hpp"
 
 // System header includes
 #include <csignal>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
 
 // Using declaration for the sensor namespace
 using namespace sensor;
@@ -14,45 +25,544 @@ namespace {
     // Global atomic flag for graceful shutdown
     std::atomic<bool> g_running{true};
 
-    // Signal handler function for handling Ctrl+C (SIGINT)
+    // Set by SIGUSR1 to print the latency report without stopping
+    std::atomic<bool> g_report_latency{false};
+
+    // Signal handler function for handling Ctrl+C (SIGINT) and SIGTERM
     void signalHandler(int) {
         g_running = false;
     }
+
+    // Signal handler function for on-demand latency reports (SIGUSR1)
+    void reportHandler(int) {
+        g_report_latency = true;
+    }
+
+    // Parse "SIM,PROC,OUT" CPU numbers for --pin; -1 or an omitted entry leaves that thread unpinned
+    void parsePinning(const std::string& list, Config& config) {
+        ThreadPolicy* threads[] = {&config.simulator_thread, &config.processor_thread,
+                                   &config.output_thread};
+        size_t start = 0;
+        for (ThreadPolicy* thread : threads) {
+            const size_t comma = list.find(',', start);
+            const std::string item = list.substr(start, comma - start);
+            if (!item.empty()) {
+                thread->cpu = std::stoi(item);
+            }
+            if (comma == std::string::npos) {
+                break;
+            }
+            start = comma + 1;
+        }
+    }
+
+    // Parse "MS,MS,..." aggregation window lengths; "none" disables aggregation
+    std::vector<int> parseWindows(const std::string& list) {
+        std::vector<int> windows;
+        if (list == "none") {
+            return windows;
+        }
+        size_t start = 0;
+        for (;;) {
+            const size_t comma = list.find(',', start);
+            windows.push_back(std::stoi(list.substr(start, comma - start)));
+            if (comma == std::string::npos) {
+                return windows;
+            }
+            start = comma + 1;
+        }
+    }
+
+    // Parse "STAGE=POLICY,..." for --overflow; stages are samples, ipc and output
+    void parseOverflow(const std::string& list, Config& config) {
+        size_t start = 0;
+        for (;;) {
+            const size_t comma = list.find(',', start);
+            const std::string item = list.substr(start, comma - start);
+            const size_t equals = item.find('=');
+            if (equals == std::string::npos) {
+                throw std::invalid_argument("Expected STAGE=POLICY in --overflow: " + item);
+            }
+            const std::string stage = item.substr(0, equals);
+            const OverflowPolicy policy = parseOverflowPolicy(item.substr(equals + 1));
+            if (stage == "samples") {
+                config.sample_overflow = policy;
+            } else if (stage == "ipc") {
+                config.ipc_overflow = policy;
+            } else if (stage == "output") {
+                config.output_overflow = policy;
+            } else {
+                throw std::invalid_argument("Unknown pipeline stage: " + stage);
+            }
+            if (comma == std::string::npos) {
+                return;
+            }
+            start = comma + 1;
+        }
+    }
+
+    // Stage accounting of every component that is running in this process
+    std::vector<StageReport> collectStages(const SampleSource* source, const DataProcessor* processor,
+                                           const OutputHandler* output) {
+        std::vector<StageReport> stages;
+        if (source) {
+            stages = source->stages();
+        }
+        if (processor) {
+            const std::vector<StageReport> ipc = processor->stages();
+            stages.insert(stages.end(), ipc.begin(), ipc.end());
+        }
+        if (output) {
+            const std::vector<StageReport> out = output->stages();
+            stages.insert(stages.end(), out.begin(), out.end());
+        }
+        return stages;
+    }
+
+    // Print the stage table of every component that is running in this process
+    void printStages(std::ostream& os, const SampleSource* source, const DataProcessor* processor,
+                      const OutputHandler* output) {
+        reportStages(os, collectStages(source, processor, output));
+    }
+
+    // Metrics exporter over the running components, or null when no endpoint is configured;
+    // the socket also answers history queries when the processor keeps a store
+    std::unique_ptr<MetricsExporter> makeExporter(const Config& config, const SampleSource* source,
+                                                  const DataProcessor* processor, const OutputHandler* output) {
+        if (config.metrics_socket.empty() && config.metrics_file.empty()) {
+            return nullptr;
+        }
+        MetricsExporter::SeriesHandler series;
+        if (processor && processor->store()) {
+            const TimeSeriesStore* store = processor->store();
+            const std::shared_ptr<const ChannelRegistry> channels = config.channel_registry
+                ? config.channel_registry : std::make_shared<const ChannelRegistry>(ChannelRegistry::builtin());
+            series = [store, channels](const std::string& params) { return seriesCsv(*store, *channels, params); };
+        }
+        const std::shared_ptr<const LatencyStats> latency = config.latency_stats;
+        return std::make_unique<MetricsExporter>(config, [source, processor, output, latency]() {
+            MetricsSnapshot snapshot;
+            snapshot.stages = collectStages(source, processor, output);
+            if (source) {
+                snapshot.loops = source->loops();
+            }
+            if (processor) {
+                const std::vector<LoopReport> loops = processor->loops();
+                snapshot.loops.insert(snapshot.loops.end(), loops.begin(), loops.end());
+                snapshot.has_transport = true;
+                snapshot.transport_depth = processor->transportDepth();
+                snapshot.transport_capacity = processor->transportCapacity();
+            }
+            if (output) {
+                const std::vector<LoopReport> loops = output->loops();
+                snapshot.loops.insert(snapshot.loops.end(), loops.begin(), loops.end());
+            }
+            snapshot.latency = latency;
+            return snapshot;
+        }, std::move(series));
+    }
+
+    // Apply command-line options on top of the default configuration
+    void parseArguments(int argc, char* argv[], Config& config) {
+        bool subscribe = false;
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            if (arg == "--ipc" && i + 1 < argc) {
+                // Select transport between DataProcessor and OutputHandler
+                const std::string backend = argv[++i];
+                if (backend == "mqueue") {
+                    config.ipc_backend = IPCBackend::MQUEUE;
+                } else if (backend == "shm") {
+                    config.ipc_backend = IPCBackend::SHM;
+                } else if (backend == "broadcast") {
+                    config.ipc_backend = IPCBackend::BROADCAST;
+                } else {
+                    throw std::invalid_argument("Unknown IPC backend: " + backend);
+                }
+            } else if (arg == "--role" && i + 1 < argc) {
+                // Run one pipeline stage per process instead of all three
+                const std::string role = argv[++i];
+                if (role == "all") {
+                    config.role = PipelineRole::ALL;
+                } else if (role == "acquire") {
+                    config.role = PipelineRole::ACQUIRE;
+                } else if (role == "process") {
+                    config.role = PipelineRole::PROCESS;
+                } else if (role == "output") {
+                    config.role = PipelineRole::OUTPUT;
+                } else {
+                    throw std::invalid_argument("Unknown role: " + role);
+                }
+            } else if (arg == "--subscribe") {
+                // Extra output stage attached to another process's broadcast ring
+                config.role = PipelineRole::OUTPUT;
+                subscribe = true;
+            } else if (arg == "--buffer" && i + 1 < argc) {
+                // Simulator -> processor buffer implementation
+                const std::string type = argv[++i];
+                if (type == "spsc") {
+                    config.buffer_type = BufferType::SPSC;
+                } else if (type == "mutex") {
+                    config.buffer_type = BufferType::MUTEX;
+                } else {
+                    throw std::invalid_argument("Unknown buffer type: " + type);
+                }
+            } else if (arg == "--overflow" && i + 1 < argc) {
+                // Per-stage overflow policies, e.g. samples=block,ipc=drop-oldest
+                parseOverflow(argv[++i], config);
+            } else if (arg == "--block-us" && i + 1 < argc) {
+                // Longest wait of a BLOCK stage before it drops the item
+                config.overflow_block_us = std::stoi(argv[++i]);
+                if (config.overflow_block_us < 0) {
+                    throw std::invalid_argument("--block-us must not be negative");
+                }
+            } else if (arg == "--ipc-backlog" && i + 1 < argc) {
+                // Messages held while the transport is full
+                const int backlog = std::stoi(argv[++i]);
+                if (backlog <= 0) {
+                    throw std::invalid_argument("--ipc-backlog must be positive");
+                }
+                config.ipc_backlog = static_cast<size_t>(backlog);
+            } else if (arg == "--batch" && i + 1 < argc) {
+                // Messages coalesced per queue send (1 disables batching)
+                config.ipc_batch_size = std::stoi(argv[++i]);
+                if (config.ipc_batch_size < 1) {
+                    throw std::invalid_argument("--batch must be at least 1");
+                }
+            } else if (arg == "--flush-us" && i + 1 < argc) {
+                // Longest time a message may wait in a partial batch
+                config.ipc_flush_us = std::stoi(argv[++i]);
+                if (config.ipc_flush_us < 0) {
+                    throw std::invalid_argument("--flush-us must not be negative");
+                }
+            } else if (arg == "--compress") {
+                // Compressed IPC frames and binary output
+                config.compress = true;
+            } else if (arg == "--precision" && i + 1 < argc) {
+                // Quantization step of compressed values, repeatable (e.g. "Pressure=0.01")
+                config.precision.push_back(argv[++i]);
+            } else if (arg == "--channels" && i + 1 < argc) {
+                // Registry mode with channels loaded from a name,unit,mean,stddev file
+                config.channel_registry = std::make_shared<const ChannelRegistry>(
+                    ChannelRegistry::fromFile(argv[++i]));
+            } else if (arg == "--synthetic-channels" && i + 1 < argc) {
+                // Registry mode with N generated channels for load testing
+                config.channel_registry = std::make_shared<const ChannelRegistry>(
+                    ChannelRegistry::synthetic(std::stoul(argv[++i])));
+            } else if (arg == "--block-size" && i + 1 < argc) {
+                // Samples per SampleBlock in registry mode
+                config.block_size = std::stoi(argv[++i]);
+            } else if (arg == "--filter" && i + 1 < argc) {
+                // CHANNEL=SPEC: FIR or biquad filter instead of the moving average (repeatable)
+                config.filters.push_back(argv[++i]);
+            } else if (arg == "--detect" && i + 1 < argc) {
+                // [CHANNEL=]SPEC: anomaly check of the raw readings, alerts on stderr (repeatable)
+                config.detectors.push_back(argv[++i]);
+            } else if (arg == "--output-rate-hz" && i + 1 < argc) {
+                // Decimate the processed stream to this many messages per second
+                config.output_rate_hz = std::stod(argv[++i]);
+                if (config.output_rate_hz <= 0.0) {
+                    throw std::invalid_argument("--output-rate-hz must be positive");
+                }
+            } else if (arg == "--workers" && i + 1 < argc) {
+                // Threads sharing the registry mode channel math
+                config.processing_threads = std::stoi(argv[++i]);
+                if (config.processing_threads < 1) {
+                    throw std::invalid_argument("--workers must be at least 1");
+                }
+            } else if (arg == "--windows" && i + 1 < argc) {
+                // Statistics windows in milliseconds, e.g. 1000,10000,60000
+                config.aggregate_windows_ms = parseWindows(argv[++i]);
+            } else if (arg == "--windows-every" && i + 1 < argc) {
+                // Milliseconds between window reports (0 = the shortest window)
+                config.windows_every_ms = std::stoi(argv[++i]);
+                if (config.windows_every_ms < 0) {
+                    throw std::invalid_argument("--windows-every must not be negative");
+                }
+            } else if (arg == "--rate-hz" && i + 1 < argc) {
+                // Sampling rate with nanosecond-resolution period (e.g. 20000 for 20 kHz)
+                const double hz = std::stod(argv[++i]);
+                if (hz <= 0.0) {
+                    throw std::invalid_argument("--rate-hz must be positive");
+                }
+                config.sampling_period_ns = static_cast<int64_t>(1e9 / hz + 0.5);
+            } else if (arg == "--spin-us" && i + 1 < argc) {
+                // Busy-wait the last US microseconds before each sampling deadline
+                config.timer_spin_us = std::stoi(argv[++i]);
+            } else if (arg == "--rt-priority" && i + 1 < argc) {
+                // SCHED_FIFO priority for every pipeline thread (needs CAP_SYS_NICE)
+                const int priority = std::stoi(argv[++i]);
+                config.simulator_thread.rt_priority = priority;
+                config.processor_thread.rt_priority = priority;
+                config.output_thread.rt_priority = priority;
+            } else if (arg == "--pin" && i + 1 < argc) {
+                // CPUs for the simulator, processor and output threads
+                parsePinning(argv[++i], config);
+            } else if (arg == "--format" && i + 1 < argc) {
+                // Layout of the processed data written to stdout
+                const std::string format = argv[++i];
+                if (format == "pretty") {
+                    config.output_format = OutputFormat::PRETTY;
+                } else if (format == "compact") {
+                    config.output_format = OutputFormat::COMPACT;
+                } else if (format == "csv") {
+                    config.output_format = OutputFormat::CSV;
+                } else if (format == "binary") {
+                    config.output_format = OutputFormat::BINARY;
+                } else {
+                    throw std::invalid_argument("Unknown output format: " + format);
+                }
+            } else if (arg == "--rng" && i + 1 < argc) {
+                // Generator behind the simulated readings
+                const std::string engine = argv[++i];
+                if (engine == "std") {
+                    config.random_engine = RandomEngine::STD;
+                } else if (engine == "fast") {
+                    config.random_engine = RandomEngine::FAST;
+                } else {
+                    throw std::invalid_argument("Unknown random engine: " + engine);
+                }
+            } else if (arg == "--seed" && i + 1 < argc) {
+                // Fixed seed so runs produce the same readings
+                config.random_seed = std::stoull(argv[++i]);
+            } else if (arg == "--store" && i + 1 < argc) {
+                // Keep SECONDS of raw readings in memory, rolled up to 1 s/1 min/1 h beyond that
+                config.store_seconds = std::stod(argv[++i]);
+                if (config.store_seconds <= 0.0) {
+                    throw std::invalid_argument("--store must be positive");
+                }
+            } else if (arg == "--record" && i + 1 < argc) {
+                // Record every raw reading into memory-mapped segments in DIR
+                config.record_dir = argv[++i];
+            } else if (arg == "--record-messages") {
+                // Also record every processed message (needs --record)
+                config.record_messages = true;
+            } else if (arg == "--replay" && i + 1 < argc) {
+                // Feed the pipeline from a recording instead of the simulator
+                config.replay_dir = argv[++i];
+            } else if (arg == "--replay-speed" && i + 1 < argc) {
+                // Replay pacing: 1 = as recorded, N = N times faster, 0 = as fast as possible
+                config.replay_speed = std::stod(argv[++i]);
+                if (config.replay_speed < 0.0) {
+                    throw std::invalid_argument("--replay-speed must not be negative");
+                }
+            } else if (arg == "--metrics-socket" && i + 1 < argc) {
+                // Serve Prometheus text metrics on a Unix domain socket
+                config.metrics_socket = argv[++i];
+            } else if (arg == "--metrics-file" && i + 1 < argc) {
+                // Rewrite a Prometheus textfile every metrics interval
+                config.metrics_file = argv[++i];
+            } else if (arg == "--metrics-interval-ms" && i + 1 < argc) {
+                // Rate window and file rewrite period
+                config.metrics_interval_ms = std::stoi(argv[++i]);
+                if (config.metrics_interval_ms <= 0) {
+                    throw std::invalid_argument("--metrics-interval-ms must be positive");
+                }
+            } else if (arg == "--no-latency") {
+                // Skip stage latency recording entirely
+                config.latency_stats.reset();
+            } else {
+                throw std::invalid_argument("Unknown option: " + arg +
+                                            "\nUsage: sensor_processor [--ipc mqueue|shm|broadcast]"
+                                            " [--role all|acquire|process|output] [--subscribe]"
+                                            " [--buffer spsc|mutex] [--overflow STAGE=POLICY,...]"
+                                            " [--block-us US] [--ipc-backlog N]"
+                                            " [--batch N] [--flush-us US]"
+                                            " [--compress [--precision CHANNEL=STEP ...]]"
+                                            " [--channels FILE | --synthetic-channels N]"
+                                            " [--block-size N] [--workers N] [--no-latency]"
+                                            " [--rate-hz HZ] [--spin-us US] [--output-rate-hz HZ]"
+                                            " [--filter CHANNEL=SPEC ...] [--detect [CHANNEL=]SPEC ...]"
+                                            " [--rt-priority N] [--pin SIM,PROC,OUT]"
+                                            " [--windows MS,MS,...|none] [--windows-every MS]"
+                                            " [--rng std|fast] [--seed N]"
+                                            " [--format pretty|compact|csv|binary] [--store SECONDS]"
+                                            " [--record DIR [--record-messages]]"
+                                            " [--replay DIR [--replay-speed X]]"
+                                            " [--metrics-socket PATH] [--metrics-file PATH]"
+                                            " [--metrics-interval-ms MS]");
+            }
+        }
+
+        // Recordings hold fixed-layout SensorData and MQMessage records only
+        if (config.channel_registry && (!config.record_dir.empty() || !config.replay_dir.empty())) {
+            throw std::invalid_argument("--record and --replay are not supported with registry channels");
+        }
+        if (config.processing_threads > 1 && !config.channel_registry) {
+            throw std::invalid_argument("--workers requires --channels or --synthetic-channels");
+        }
+        if (config.record_messages && config.record_dir.empty()) {
+            throw std::invalid_argument("--record-messages requires --record DIR");
+        }
+        if (!config.precision.empty() && !config.compress) {
+            throw std::invalid_argument("--precision requires --compress");
+        }
+        if (subscribe && config.ipc_backend != IPCBackend::BROADCAST) {
+            throw std::invalid_argument("--subscribe requires --ipc broadcast");
+        }
+
+        // Separate stages exchange fixed-layout SensorData through the ingest ring
+        const PipelineRole role = config.role;
+        if (config.channel_registry && (role == PipelineRole::ACQUIRE || role == PipelineRole::PROCESS)) {
+            throw std::invalid_argument("Acquisition and processing roles do not support registry channels");
+        }
+        if (!config.replay_dir.empty() && role != PipelineRole::ALL) {
+            throw std::invalid_argument("--replay runs the whole pipeline in one process");
+        }
+        if (!config.record_dir.empty()
+            && (role == PipelineRole::OUTPUT || (role == PipelineRole::PROCESS && !config.record_messages))) {
+            throw std::invalid_argument("--record needs raw readings (--role all|acquire) or --record-messages"
+                                        " (--role process)");
+        }
+        if (config.record_messages && role == PipelineRole::ACQUIRE) {
+            throw std::invalid_argument("--record-messages needs the processing stage");
+        }
+        if (role == PipelineRole::ACQUIRE) {
+            config.buffer_type = BufferType::SHM;
+        }
+    }
+
+    // Output role: the processing stage creates the transport, so wait for it to appear
+    std::unique_ptr<OutputHandler> attachOutput(const Config& config, std::ostream& status) {
+        bool announced = false;
+        while (g_running) {
+            try {
+                return std::make_unique<OutputHandler>(config);
+            } catch (const std::runtime_error&) {
+                if (!announced) {
+                    status << "Waiting for the processing stage...\n";
+                    announced = true;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(config.wait_timeout_ms));
+            }
+        }
+        return nullptr;
+    }
+
+    // Startup line naming the stages this process runs
+    const char* startMessage(PipelineRole role) {
+        switch (role) {
+            case PipelineRole::ACQUIRE: return "Starting acquisition stage, publishing to the ingest ring...\n";
+            case PipelineRole::PROCESS: return "Starting processing stage, reading the ingest ring...\n";
+            case PipelineRole::OUTPUT:  return "Starting output stage...\n";
+            case PipelineRole::ALL:     break;
+        }
+        return "Starting sensor data processing system...\n";
+    }
 }
 
 int main(int argc, char* argv[]) {
     try {
-        // Register signal handler for graceful shutdown on Ctrl+C
+        // Register signal handler for graceful shutdown on Ctrl+C, or SIGTERM from a supervisor
         std::signal(SIGINT, signalHandler);
+        std::signal(SIGTERM, signalHandler);
+        std::signal(SIGUSR1, reportHandler);
         
         // System configuration initialization
         Config config;
         config.sampling_rate_ms = 100;  // Set sampling rate to 10Hz (100ms intervals)
         config.moving_avg_window = 10;  // Configure 1-second moving average window (10 samples at 10Hz)
+        config.latency_stats = std::make_shared<LatencyStats>(); // Cheap enough to leave on
+        parseArguments(argc, argv, config);
+        if (config.role == PipelineRole::ACQUIRE) {
+            // Readings are only stamped here; every hop is measured further downstream
+            config.latency_stats.reset();
+        }
+
+        // Machine-readable formats own stdout; status and reports go to stderr instead
+        std::ostream& status = config.output_format == OutputFormat::PRETTY ? std::cout : std::cerr;
         
-        // Initialize core system components
-        SensorSimulator simulator(config);
-        DataProcessor processor(config, simulator);
-        OutputHandler output(config);
+        // Initialize the components of this process's role; readings come from a recording
+        // when replaying, or from the ingest ring when acquisition runs in another process
+        const PipelineRole role = config.role;
+        std::unique_ptr<SampleSource> source;
+        std::unique_ptr<DataProcessor> processor;
+        std::unique_ptr<OutputHandler> output;
+        if (role == PipelineRole::PROCESS) {
+            source = std::make_unique<IngestSource>(config);
+        } else if (role != PipelineRole::OUTPUT && !config.replay_dir.empty()) {
+            source = std::make_unique<ReplaySource>(config);
+        } else if (role != PipelineRole::OUTPUT) {
+            source = std::make_unique<SensorSimulator>(config);
+        }
+        if (role == PipelineRole::ALL || role == PipelineRole::PROCESS) {
+            processor = std::make_unique<DataProcessor>(config, *source);
+        }
+        if (role == PipelineRole::ALL) {
+            output = std::make_unique<OutputHandler>(config);
+        } else if (role == PipelineRole::OUTPUT) {
+            output = attachOutput(config, status);
+            if (!output) {
+                return 0;
+            }
+        }
+        std::unique_ptr<MetricsExporter> metrics = makeExporter(config, source.get(), processor.get(),
+                                                                output.get());
         
         // System startup notification
-        std::cout << "Starting sensor data processing system...\n";
+        status << startMessage(role);
 
         // Start all system components in sequence
-        simulator.start();
-        processor.start();
-        output.start();
+        if (source) {
+            source->start();
+        }
+        if (processor) {
+            processor->start();
+        }
+        if (output) {
+            output->start();
+        }
+        if (metrics) {
+            metrics->start();
+        }
         
-        // Main program loop - runs until shutdown signal is received
-        while (g_running) {
+        // Main program loop - runs until shutdown signal is received or a replay ends
+        while (g_running && !(source && source->finished())) {
             std::this_thread::sleep_for(std::chrono::seconds(1));
+
+            // kill -USR1 <pid> prints the latency report so far, on stderr to keep stdout clean
+            if (g_report_latency.exchange(false)) {
+                if (source) {
+                    source->report(std::cerr);
+                }
+                if (processor) {
+                    processor->report(std::cerr);
+                }
+                printStages(std::cerr, source.get(), processor.get(), output.get());
+                if (config.latency_stats) {
+                    config.latency_stats->report(std::cerr);
+                }
+            }
         }
         
         // Graceful shutdown sequence
-        std::cout << "\nShutting down...\n";
-        output.stop();
-        processor.stop();
-        simulator.stop();
+        status << "\nShutting down...\n";
+        // Upstream first, so the output stage can print what is still in flight
+        if (source) {
+            source->stop();
+        }
+        if (processor) {
+            processor->stop();
+        }
+        if (output) {
+            output->stop();
+        }
+        if (metrics) {
+            // Last rewrite of the metrics file holds the final counts
+            metrics->stop();
+        }
+
+        // Final source and latency reports once every stage has stopped recording
+        if (source) {
+            source->report(status);
+        }
+        if (processor) {
+            processor->report(status);
+        }
+        printStages(status, source.get(), processor.get(), output.get());
+        if (config.latency_stats) {
+            config.latency_stats->report(status);
+        }
         
         return 0;
     } catch (const std::exception& e) {
@@ -60,4 +570,4 @@ int main(int argc, char* argv[]) {
         std::cerr << "Error: " << e.what() << std::endl;
         return 1;
     }
-} 
\ No newline at end of file
+}
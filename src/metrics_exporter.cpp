@@ -0,0 +1,362 @@
+#include "metrics_exporter.hpp"
+#include "latency_histogram.hpp"
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace sensor {
+
+namespace {
+    // How long a client may take to send its request before it gets plain text
+    constexpr int REQUEST_WAIT_MS = 50;
+
+    // Longest a slow client may hold up the exporter thread per write
+    constexpr struct timeval SEND_TIMEOUT = {1, 0};
+
+    // Request path answered by the series handler
+    constexpr std::string_view SERIES_PATH = "/series";
+
+    // Quantile labels of the latency summaries, in Summary order (p50, p99, p99.9)
+    constexpr const char* QUANTILES[] = {"0.5", "0.99", "0.999"};
+
+    // AppendNumber: Shortest round-trip text of a value
+    template<typename T>
+    void appendNumber(std::string& out, T value) {
+        char digits[32];
+        const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, result.ptr);
+    }
+
+    // AppendFamily: HELP and TYPE lines that start every metric family
+    void appendFamily(std::string& out, const char* name, const char* type, const char* help) {
+        out += "# HELP ";
+        out += name;
+        out += ' ';
+        out += help;
+        out += "\n# TYPE ";
+        out += name;
+        out += ' ';
+        out += type;
+        out += '\n';
+    }
+
+    // AppendSample: name{label="value",...} number
+    template<typename T>
+    void appendSample(std::string& out, const char* name,
+                      std::initializer_list<std::pair<const char*, std::string>> labels, T value) {
+        out += name;
+        if (labels.size() > 0) {
+            char separator = '{';
+            for (const auto& label : labels) {
+                out += separator;
+                out += label.first;
+                out += "=\"";
+                out += label.second;
+                out += '"';
+                separator = ',';
+            }
+            out += '}';
+        }
+        out += ' ';
+        appendNumber(out, value);
+        out += '\n';
+    }
+
+    // SendAll: Write the whole buffer unless the client goes away or stalls
+    bool sendAll(int fd, const char* data, size_t len) {
+        while (len > 0) {
+            const ssize_t sent = send(fd, data, len, MSG_NOSIGNAL);
+            if (sent < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data += sent;
+            len -= static_cast<size_t>(sent);
+        }
+        return true;
+    }
+}
+
+// Constructor: Bind the listening socket now so a bad path fails at startup
+MetricsExporter::MetricsExporter(const Config& config, Collector collector, SeriesHandler series)
+    : m_collector(std::move(collector))
+    , m_series(std::move(series))
+    , m_socket_path(config.metrics_socket)
+    , m_file_path(config.metrics_file)
+    , m_interval(std::max(config.metrics_interval_ms, 1))
+    , m_poll(std::max(config.wait_timeout_ms, 1))
+    , m_listen_fd(-1)
+    , m_running(false)
+{
+    if (m_socket_path.empty()) {
+        return;
+    }
+
+    struct sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (m_socket_path.size() >= sizeof(addr.sun_path)) {
+        throw std::invalid_argument("Metrics socket path too long: " + m_socket_path);
+    }
+    std::copy(m_socket_path.begin(), m_socket_path.end(), addr.sun_path);
+
+    // A socket left behind by a killed run is replaced; any other file is not
+    struct stat existing;
+    if (lstat(m_socket_path.c_str(), &existing) == 0) {
+        if (!S_ISSOCK(existing.st_mode)) {
+            throw std::runtime_error("Metrics socket path exists and is not a socket: " + m_socket_path);
+        }
+        unlink(m_socket_path.c_str());
+    }
+
+    m_listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (m_listen_fd < 0
+        || bind(m_listen_fd, reinterpret_cast<const struct sockaddr*>(&addr), sizeof(addr)) != 0
+        || listen(m_listen_fd, 8) != 0) {
+        const std::string error = strerror(errno);
+        if (m_listen_fd >= 0) {
+            close(m_listen_fd);
+        }
+        throw std::runtime_error("Cannot listen on metrics socket " + m_socket_path + ": " + error);
+    }
+}
+
+// Destructor: Stop the thread, then close and remove the socket
+MetricsExporter::~MetricsExporter() {
+    stop();
+    if (m_listen_fd >= 0) {
+        close(m_listen_fd);
+        unlink(m_socket_path.c_str());
+    }
+}
+
+// Start: Launch the exporter thread if not already running
+void MetricsExporter::start() {
+    if (!m_running) {
+        m_running = true;
+        m_thread = std::thread(&MetricsExporter::exportLoop, this);
+    }
+}
+
+// Stop: Join the thread and leave the final counts in the file
+void MetricsExporter::stop() {
+    if (m_running) {
+        m_running = false;
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+        if (!m_file_path.empty()) {
+            const MetricsSnapshot snapshot = m_collector();
+            updateRates(snapshot, std::chrono::steady_clock::now());
+            writeFile(render(snapshot));
+        }
+    }
+}
+
+// ExportLoop: Poll the socket until the next interval boundary, then refresh rates and the file
+void MetricsExporter::exportLoop() {
+    // Baseline counts, so the first interval already has a rate
+    updateRates(m_collector(), std::chrono::steady_clock::now());
+    auto next_tick = m_last_tick + m_interval;
+
+    while (m_running) {
+        const auto now = std::chrono::steady_clock::now();
+        if (now >= next_tick) {
+            const MetricsSnapshot snapshot = m_collector();
+            updateRates(snapshot, now);
+            if (!m_file_path.empty()) {
+                writeFile(render(snapshot));
+            }
+            next_tick += m_interval;
+            if (next_tick <= now) {
+                next_tick = now + m_interval;
+            }
+            continue;
+        }
+
+        const auto wait = std::min(std::chrono::duration_cast<std::chrono::milliseconds>(next_tick - now)
+                                   + std::chrono::milliseconds(1), m_poll);
+        if (m_listen_fd < 0) {
+            std::this_thread::sleep_for(wait);
+            continue;
+        }
+
+        struct pollfd pfd = {m_listen_fd, POLLIN, 0};
+        if (poll(&pfd, 1, static_cast<int>(wait.count())) > 0 && (pfd.revents & POLLIN)) {
+            const int client = accept4(m_listen_fd, nullptr, nullptr, SOCK_CLOEXEC);
+            if (client >= 0) {
+                serveClient(client);
+                close(client);
+            }
+        }
+    }
+}
+
+// UpdateRates: Produced-count delta per stage over the time since the previous tick
+void MetricsExporter::updateRates(const MetricsSnapshot& snapshot, std::chrono::steady_clock::time_point now) {
+    const double seconds = std::chrono::duration<double>(now - m_last_tick).count();
+    std::vector<StageRate> rates;
+    for (const StageReport& stage : snapshot.stages) {
+        const uint64_t produced = stage.counters.produced;
+        double per_second = 0.0;
+        for (const StageRate& previous : m_rates) {
+            if (previous.stage == stage.name && produced >= previous.produced && seconds > 0.0) {
+                per_second = static_cast<double>(produced - previous.produced) / seconds;
+            }
+        }
+        rates.push_back(StageRate{stage.name, produced, per_second});
+    }
+    m_rates = std::move(rates);
+    m_last_tick = now;
+}
+
+// ServeClient: HTTP response for a GET, plain exposition text for anything else
+void MetricsExporter::serveClient(int fd) {
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &SEND_TIMEOUT, sizeof(SEND_TIMEOUT));
+
+    // Clients such as socat send nothing; curl sends its request straight away
+    bool http = false;
+    std::string target;
+    struct pollfd pfd = {fd, POLLIN, 0};
+    if (poll(&pfd, 1, REQUEST_WAIT_MS) > 0 && (pfd.revents & POLLIN)) {
+        char request[1024];
+        const ssize_t received = recv(fd, request, sizeof(request), 0);
+        http = received >= 4 && std::string(request, 4) == "GET ";
+        if (http) {
+            const std::string line(request, static_cast<size_t>(received));
+            target = line.substr(4, line.find_first_of(" \r\n", 4) - 4);
+        }
+    }
+
+    // History queries are CSV; a malformed one gets the reason back
+    std::string status = "200 OK";
+    std::string type = "text/plain; version=0.0.4";
+    std::string body;
+    if (http && m_series && target.compare(0, SERIES_PATH.size(), SERIES_PATH) == 0
+        && (target.size() == SERIES_PATH.size() || target[SERIES_PATH.size()] == '?')) {
+        const size_t query = target.find('?');
+        type = "text/csv";
+        try {
+            body = m_series(query == std::string::npos ? std::string() : target.substr(query + 1));
+        } catch (const std::invalid_argument& error) {
+            status = "400 Bad Request";
+            type = "text/plain";
+            body = std::string(error.what()) + "\n";
+        }
+    } else {
+        body = render(m_collector());
+    }
+    if (http) {
+        std::string header = "HTTP/1.0 " + status + "\r\nContent-Type: " + type + "\r\nContent-Length: ";
+        appendNumber(header, body.size());
+        header += "\r\nConnection: close\r\n\r\n";
+        if (!sendAll(fd, header.data(), header.size())) {
+            return;
+        }
+    }
+    sendAll(fd, body.data(), body.size());
+}
+
+// WriteFile: Readers never see a partially written file
+void MetricsExporter::writeFile(const std::string& text) {
+    const std::string temp = m_file_path + ".tmp";
+    std::FILE* file = std::fopen(temp.c_str(), "w");
+    if (!file) {
+        return;
+    }
+    const bool written = std::fwrite(text.data(), 1, text.size(), file) == text.size();
+    if (std::fclose(file) != 0 || !written || std::rename(temp.c_str(), m_file_path.c_str()) != 0) {
+        std::remove(temp.c_str());
+    }
+}
+
+// Render: One family at a time, as the text format requires
+std::string MetricsExporter::render(const MetricsSnapshot& snapshot) const {
+    std::string out;
+    out.reserve(4096);
+
+    appendFamily(out, "sensor_stage_info", "gauge", "Overflow policy of each pipeline stage");
+    for (const StageReport& stage : snapshot.stages) {
+        appendSample(out, "sensor_stage_info", {{"stage", stage.name}, {"policy", overflowPolicyName(stage.policy)}}, 1);
+    }
+    appendFamily(out, "sensor_stage_produced_total", "counter", "Items offered to the stage");
+    for (const StageReport& stage : snapshot.stages) {
+        appendSample(out, "sensor_stage_produced_total", {{"stage", stage.name}}, stage.counters.produced);
+    }
+    appendFamily(out, "sensor_stage_consumed_total", "counter", "Items taken out by the next stage");
+    for (const StageReport& stage : snapshot.stages) {
+        appendSample(out, "sensor_stage_consumed_total", {{"stage", stage.name}}, stage.counters.consumed);
+    }
+    appendFamily(out, "sensor_stage_dropped_total", "counter", "Items discarded by the overflow policy");
+    for (const StageReport& stage : snapshot.stages) {
+        appendSample(out, "sensor_stage_dropped_total", {{"stage", stage.name}}, stage.counters.dropped);
+    }
+    appendFamily(out, "sensor_stage_depth", "gauge", "Items currently queued in the stage");
+    for (const StageReport& stage : snapshot.stages) {
+        // Counters are read one by one, so a concurrent pop can make this briefly negative
+        const uint64_t out_of_stage = stage.counters.consumed + stage.counters.dropped;
+        const uint64_t depth = stage.counters.produced > out_of_stage ? stage.counters.produced - out_of_stage : 0;
+        appendSample(out, "sensor_stage_depth", {{"stage", stage.name}}, depth);
+    }
+    appendFamily(out, "sensor_stage_high_water", "gauge", "Deepest occupancy observed");
+    for (const StageReport& stage : snapshot.stages) {
+        appendSample(out, "sensor_stage_high_water", {{"stage", stage.name}}, stage.counters.high_water);
+    }
+    appendFamily(out, "sensor_stage_capacity", "gauge", "Items (output: chunks) the stage can hold");
+    for (const StageReport& stage : snapshot.stages) {
+        appendSample(out, "sensor_stage_capacity", {{"stage", stage.name}}, stage.capacity);
+    }
+    appendFamily(out, "sensor_stage_rate", "gauge", "Items per second offered to the stage over the last interval");
+    for (const StageRate& rate : m_rates) {
+        appendSample(out, "sensor_stage_rate", {{"stage", rate.stage}}, rate.per_second);
+    }
+
+    appendFamily(out, "sensor_loop_iterations_total", "counter", "Passes through a pipeline thread's main loop");
+    for (const LoopReport& loop : snapshot.loops) {
+        appendSample(out, "sensor_loop_iterations_total", {{"thread", loop.thread}}, loop.iterations);
+    }
+    appendFamily(out, "sensor_loop_idle_wakeups_total", "counter", "Loop passes that found no work");
+    for (const LoopReport& loop : snapshot.loops) {
+        appendSample(out, "sensor_loop_idle_wakeups_total", {{"thread", loop.thread}}, loop.idle_wakeups);
+    }
+
+    if (snapshot.has_transport) {
+        appendFamily(out, "sensor_transport_depth", "gauge", "Frames waiting in the IPC transport");
+        appendSample(out, "sensor_transport_depth", {}, snapshot.transport_depth);
+        appendFamily(out, "sensor_transport_capacity", "gauge", "Frames the IPC transport can hold");
+        appendSample(out, "sensor_transport_capacity", {}, snapshot.transport_capacity);
+    }
+
+    if (snapshot.latency) {
+        appendFamily(out, "sensor_latency_seconds", "summary", "Stage-to-stage latency of readings");
+        for (size_t i = 0; i < static_cast<size_t>(LatencyHop::COUNT); ++i) {
+            const LatencyHop hop = static_cast<LatencyHop>(i);
+            const LatencyHistogram::Summary summary = snapshot.latency->histogram(hop).summarize();
+            const std::string name = LatencyStats::hopName(hop);
+            const uint64_t values[] = {summary.p50, summary.p99, summary.p999};
+            for (size_t q = 0; q < std::size(QUANTILES); ++q) {
+                appendSample(out, "sensor_latency_seconds", {{"hop", name}, {"quantile", QUANTILES[q]}},
+                             static_cast<double>(values[q]) / 1e9);
+            }
+            appendSample(out, "sensor_latency_seconds_sum", {{"hop", name}},
+                         summary.mean * static_cast<double>(summary.count) / 1e9);
+            appendSample(out, "sensor_latency_seconds_count", {{"hop", name}}, summary.count);
+        }
+    }
+
+    return out;
+}
+
+} // namespace sensor
@@ -0,0 +1,189 @@
+#include "moving_average.hpp"
+#include "stats_kernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace sensor {
+
+namespace {
+    // NeumaierAdd: Add value to sum while capturing the lost low-order bits in comp
+    inline void neumaierAdd(double& sum, double& comp, double value) {
+        const double t = sum + value;
+        if (std::fabs(sum) >= std::fabs(value)) {
+            comp += (sum - t) + value;
+        } else {
+            comp += (value - t) + sum;
+        }
+        sum = t;
+    }
+}
+
+// Constructor: Validate dimensions and preallocate history and running sums
+MovingAverage::MovingAverage(size_t channels, size_t window)
+    : m_channels(channels)
+    , m_window(window)
+    , m_history(channels * window, 0.0)
+    , m_sums(channels, 0.0)
+    , m_comps(channels, 0.0)
+    , m_skipped(channels, 0)
+    , m_pos(0)
+    , m_count(0)
+    , m_since_renormalize(0)
+{
+    if (channels == 0 || window == 0) {
+        throw std::invalid_argument("MovingAverage requires at least one channel and window slot");
+    }
+}
+
+// Push: Add newest value and subtract the evicted one for every channel
+void MovingAverage::push(const double* values) {
+    const bool evicting = (m_count == m_window);
+
+    for (size_t ch = 0; ch < m_channels; ++ch) {
+        if (m_skipped[ch]) {
+            continue;
+        }
+        double& slot = m_history[ch * m_window + m_pos];
+        if (evicting) {
+            neumaierAdd(m_sums[ch], m_comps[ch], -slot);
+        }
+        neumaierAdd(m_sums[ch], m_comps[ch], values[ch]);
+        slot = values[ch];
+    }
+
+    m_pos = (m_pos + 1 == m_window) ? 0 : m_pos + 1;
+    if (!evicting) {
+        ++m_count;
+    }
+
+    if (renormalizeDue(1)) {
+        renormalize(0, m_channels);
+        m_since_renormalize = 0;
+    } else {
+        ++m_since_renormalize;
+    }
+}
+
+// PushBlock: Every channel, then the shared window bookkeeping
+void MovingAverage::pushBlock(const SampleBlock& in, SampleBlock& out) {
+    pushChannels(in, out, 0, m_channels);
+    commitBlock(in, out);
+}
+
+// PushChannels: Channel-outer, sample-inner so input, history and output columns are walked linearly
+void MovingAverage::pushChannels(const SampleBlock& in, SampleBlock& out, size_t first, size_t last) {
+    const size_t length = in.length();
+
+    for (size_t ch = first; ch < last; ++ch) {
+        if (m_skipped[ch]) {
+            continue;
+        }
+        const double* values = in.column(ch);
+        double* averages = out.column(ch);
+        double* history = &m_history[ch * m_window];
+        double sum = m_sums[ch];
+        double comp = m_comps[ch];
+        size_t pos = m_pos;
+        size_t count = m_count;
+
+        for (size_t k = 0; k < length; ++k) {
+            if (count == m_window) {
+                neumaierAdd(sum, comp, -history[pos]);
+            } else {
+                ++count;
+            }
+            neumaierAdd(sum, comp, values[k]);
+            history[pos] = values[k];
+            pos = (pos + 1 == m_window) ? 0 : pos + 1;
+            averages[k] = (sum + comp) / static_cast<double>(count);
+        }
+
+        m_sums[ch] = sum;
+        m_comps[ch] = comp;
+    }
+
+    // Each range re-sums its own channels while their history is still in cache
+    if (renormalizeDue(length)) {
+        renormalize(first, last);
+    }
+}
+
+// SkipChannel: Pushes stop maintaining the channel's history and average
+void MovingAverage::skipChannel(size_t channel) {
+    if (channel >= m_channels) {
+        throw std::out_of_range("MovingAverage channel out of range");
+    }
+    m_skipped[channel] = 1;
+}
+
+// CommitBlock: Every channel advanced by the same number of samples
+void MovingAverage::commitBlock(const SampleBlock& in, SampleBlock& out) {
+    const size_t length = in.length();
+
+    m_pos = (m_pos + length) % m_window;
+    m_count = std::min(m_count + length, m_window);
+    out.setLength(length);
+    out.setFirstSequence(in.firstSequence());
+    out.stages() = in.stages();
+    std::copy(in.timestamps(), in.timestamps() + length, out.timestamps());
+
+    // pushChannels() already re-summed every channel if the period ended with this block
+    m_since_renormalize = renormalizeDue(length) ? 0 : m_since_renormalize + length;
+}
+
+// Averages: Divide compensated running sums by the number of samples in the window
+void MovingAverage::averages(double* out) const {
+    if (m_count == 0) {
+        std::fill(out, out + m_channels, 0.0);
+        return;
+    }
+    // Vectorized across channels; bit-identical to the scalar division
+    statsKernels().mean(m_sums.data(), m_comps.data(), static_cast<double>(m_count),
+                        out, m_channels);
+}
+
+// Reset: Return to the empty state without releasing memory
+void MovingAverage::reset() {
+    std::fill(m_history.begin(), m_history.end(), 0.0);
+    std::fill(m_sums.begin(), m_sums.end(), 0.0);
+    std::fill(m_comps.begin(), m_comps.end(), 0.0);
+    m_pos = 0;
+    m_count = 0;
+    m_since_renormalize = 0;
+}
+
+// Renormalize: Rebuild each running sum from the values actually in the window
+void MovingAverage::renormalize(size_t first, size_t last) {
+    const StatsKernels& kernels = statsKernels();
+    for (size_t ch = first; ch < last; ++ch) {
+        if (m_skipped[ch]) {
+            continue;
+        }
+        // Unfilled slots are zero, so summing the whole column is exact either way
+        m_sums[ch] = kernels.sum(&m_history[ch * m_window], m_window);
+        m_comps[ch] = 0.0;
+    }
+}
+
+// RenormalizeDue: Amortized O(1): one O(window) re-sum every RENORMALIZE_PASSES * window pushes
+bool MovingAverage::renormalizeDue(size_t length) const {
+    return m_since_renormalize + length >= RENORMALIZE_PASSES * m_window;
+}
+
+// Channels: Returns number of channels tracked
+size_t MovingAverage::channels() const {
+    return m_channels;
+}
+
+// Window: Returns maximum number of samples averaged
+size_t MovingAverage::window() const {
+    return m_window;
+}
+
+// Count: Returns number of samples currently in the window
+size_t MovingAverage::count() const {
+    return m_count;
+}
+
+} // namespace sensor
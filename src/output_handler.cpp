@@ -1,18 +1,163 @@
 #include "output_handler.hpp"
-#include <iomanip>
+#include "channel_registry.hpp"
+#include "latency_histogram.hpp"
+#include "realtime.hpp"
+#include <unistd.h>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <ctime>
 #include <iostream>
+#include <iterator>
 
 namespace sensor {
 
-// Constructor: Initialize output handler with config and set up IPC
+namespace {
+    // Output chunks handed to the writer thread (see OutputWriter)
+    constexpr size_t OUTPUT_CHUNK_BYTES = 64 * 1024;
+    constexpr size_t OUTPUT_CHUNKS = 16;
+
+    // Compressed message frames: size, and the longest a message waits in an open frame
+    constexpr size_t COMPRESSED_FRAME_BYTES = 16 * 1024;
+    constexpr std::chrono::seconds COMPRESSED_FRAME_AGE(1);
+
+    // Bound on one formatted number, including padding
+    constexpr size_t NUMBER_BYTES = 40;
+
+    // Statistic names used in CSV column headers, in WindowSummary order
+    constexpr const char* WINDOW_STATS[] = {"mean", "min", "max", "var"};
+
+    // AppendText: Copy text verbatim
+    inline char* appendText(char* out, std::string_view text) {
+        std::memcpy(out, text.data(), text.size());
+        return out + text.size();
+    }
+
+    // AppendPadded: Text left-aligned in a field of width bytes (as std::left << std::setw)
+    inline char* appendPadded(char* out, std::string_view text, size_t width) {
+        out = appendText(out, text);
+        if (text.size() < width) {
+            std::memset(out, ' ', width - text.size());
+            out += width - text.size();
+        }
+        return out;
+    }
+
+    // AppendFixed: Two decimals right-aligned in width bytes (as std::fixed << std::setw);
+    // magnitudes too large for the field fall back to scientific notation
+    inline char* appendFixed(char* out, double value, size_t width) {
+        char digits[NUMBER_BYTES];
+        auto result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::fixed, 2);
+        if (result.ec != std::errc()) {
+            result = std::to_chars(digits, digits + sizeof(digits), value, std::chars_format::scientific, 6);
+        }
+        const size_t length = static_cast<size_t>(result.ptr - digits);
+        if (length < width) {
+            std::memset(out, ' ', width - length);
+            out += width - length;
+        }
+        return appendText(out, std::string_view(digits, length));
+    }
+
+    // AppendShortest: Shortest text that parses back to exactly the same double
+    inline char* appendShortest(char* out, double value) {
+        return std::to_chars(out, out + NUMBER_BYTES, value).ptr;
+    }
+
+    // AppendUnsigned: Decimal integer
+    inline char* appendUnsigned(char* out, uint64_t value) {
+        return std::to_chars(out, out + NUMBER_BYTES, value).ptr;
+    }
+
+    // AppendInteger: Signed decimal integer
+    inline char* appendInteger(char* out, int64_t value) {
+        return std::to_chars(out, out + NUMBER_BYTES, value).ptr;
+    }
+
+    // EpochNanos: Wall-clock time as nanoseconds since the epoch
+    inline int64_t epochNanos(std::chrono::system_clock::time_point time) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+    }
+
+    // Binary output record header used in registry mode; followed by one double per channel
+    struct BinarySampleHeader {
+        uint64_t msg_id;        // Message id of the sample
+        int64_t timestamp_ns;   // Wall-clock time, ns since the epoch
+        uint32_t channels;      // Doubles that follow
+        uint32_t reserved;      // Zero
+    };
+
+    // FieldName: Channel name usable as a compact key or CSV column (spaces become '_')
+    std::string fieldName(std::string_view name) {
+        std::string field(name);
+        std::replace(field.begin(), field.end(), ' ', '_');
+        std::replace(field.begin(), field.end(), ',', '_');
+        return field;
+    }
+}
+
+// Constructor: Initialize output handler with config, set up IPC and size the output chunks
 OutputHandler::OutputHandler(const Config& config)
     : m_config(config)
     , m_running(false)
+    , m_name_width(16)
+    , m_record_bytes(0)
+    , m_cached_second(-1)
+    , m_cached_prefix{}
 {
     // Initialize IPC manager in receiver mode
-    if (m_ipc_manager.initialize(false) != ErrorCode::SUCCESS) {
+    if (m_ipc_manager.initialize(false, m_config.ipc_backend) != ErrorCode::SUCCESS) {
         throw std::runtime_error("Failed to initialize IPC manager");
     }
+
+    // Keys for compact and CSV output; widest name and unit bound the record size
+    size_t unit_width = 0;
+    if (const auto& registry = m_config.channel_registry) {
+        for (size_t i = 0; i < registry->size(); ++i) {
+            m_field_names.push_back(fieldName((*registry)[i].name));
+            m_name_width = std::max(m_name_width, (*registry)[i].name.size() + 1);
+            unit_width = std::max(unit_width, (*registry)[i].unit.size());
+        }
+    } else {
+        for (const SensorMetadata& sensor : SENSORS) {
+            m_field_names.push_back(fieldName(sensor.name));
+            m_name_width = std::max(m_name_width, sensor.name.size() + 1);
+            unit_width = std::max(unit_width, sensor.unit.size());
+        }
+    }
+
+    // Worst case of every format: one line per channel holding up to five numbers, per
+    // window in fixed mode or per block sample in registry mode (compact and CSV)
+    const size_t per_channel = m_name_width + unit_width + 5 * (NUMBER_BYTES + 8) + 16;
+    const size_t sections = m_config.channel_registry
+        ? static_cast<size_t>(std::max(m_config.block_size, 1)) + 1
+        : MAX_AGGREGATE_WINDOWS + 1;
+    m_record_bytes = 256 + sections * (128 + m_field_names.size() * per_channel);
+
+    // CSV message rows leave the window columns to the window report rows
+    if (!m_config.channel_registry) {
+        const size_t columns = 1 + std::size(WINDOW_STATS) * NUM_SENSORS;
+        m_csv_window_gap.assign(m_config.aggregate_windows_ms.size() * columns, ',');
+    }
+
+    // Compressed binary output; a block frame must fit in one record
+    if (m_config.compress && m_config.output_format == OutputFormat::BINARY) {
+        const ChannelRegistry channels = m_config.channel_registry ? *m_config.channel_registry
+                                                                   : ChannelRegistry::builtin();
+        m_precision = parsePrecision(channels, m_config.precision);
+        if (m_config.channel_registry) {
+            m_block_codec = std::make_unique<BlockCodec>(m_precision);
+            m_record_bytes = std::max(m_record_bytes, BlockCodec::maxFrameBytes(
+                m_precision.size(), static_cast<size_t>(std::max(m_config.block_size, 1))));
+        } else {
+            m_message_codec = std::make_unique<MessageCodec>(m_precision);
+            m_frame.assign(COMPRESSED_FRAME_BYTES, 0);
+            m_message_codec->begin(m_frame.data(), m_frame.size());
+        }
+    }
+    m_writer = std::make_unique<OutputWriter>(STDOUT_FILENO, std::max(OUTPUT_CHUNK_BYTES, 2 * m_record_bytes),
+                                              OUTPUT_CHUNKS, m_config.output_overflow,
+                                              std::chrono::microseconds(m_config.overflow_block_us));
 }
 
 // Destructor: Ensure output thread is stopped
@@ -24,11 +169,15 @@ OutputHandler::~OutputHandler() {
 void OutputHandler::start() {
     if (!m_running) {
         m_running = true;
+        m_writer->start();
+        if (m_config.output_format == OutputFormat::CSV) {
+            writeCsvHeader();
+        }
         m_thread = std::thread(&OutputHandler::outputLoop, this);
     }
 }
 
-// Stop: Terminate output thread and wait for it to finish
+// Stop: Terminate output thread, then let the writer flush what it formatted
 void OutputHandler::stop() {
     if (m_running) {
         m_running = false;
@@ -36,39 +185,440 @@ void OutputHandler::stop() {
         if (m_thread.joinable()) {
             m_thread.join();
         }
+        m_writer->stop();
+        if (const uint64_t dropped = m_writer->droppedRecords()) {
+            std::cerr << "Warning: output could not keep up, " << dropped << " records dropped\n";
+        }
+        if (const uint64_t lost = m_ipc_manager.lostMessages()) {
+            std::cerr << "Warning: subscriber fell behind the broadcast ring, " << lost
+                      << " messages lost\n";
+        }
     }
 }
 
+// Stages: Formatted records waiting for the writer thread
+std::vector<StageReport> OutputHandler::stages() const {
+    return {StageReport{"output", m_config.output_overflow, OUTPUT_CHUNKS, m_writer->counters()}};
+}
+
+// Loops: Passes of the output loop, and those that received nothing
+std::vector<LoopReport> OutputHandler::loops() const {
+    return {LoopReport{"output", m_loop.iterations.load(std::memory_order_relaxed),
+                       m_loop.idle_wakeups.load(std::memory_order_relaxed)}};
+}
+
 // OutputLoop: Main loop that receives and displays processed sensor data
 void OutputHandler::outputLoop() {
+    applyThreadPolicy(m_config.output_thread, "output");
+    const bool event_driven = (m_config.wakeup_mode == WakeupMode::EVENT);
+    const std::chrono::milliseconds timeout(m_config.wait_timeout_ms);
+
     while (m_running) {
-        // Check for new messages from the processor
-        if (auto msg = m_ipc_manager.receiveMessage()) {
-            printSensorData(*msg);
+        bumpCounter(m_loop.iterations);
+        if (!printNext(event_driven, timeout)) {
+            bumpCounter(m_loop.idle_wakeups);
+        }
+
+        // A compressed frame goes out when full or once its first message has waited long enough
+        if (m_message_codec && m_message_codec->count() > 0
+            && std::chrono::steady_clock::now() - m_frame_first >= COMPRESSED_FRAME_AGE) {
+            flushCompressed();
+        }
+
+        // Hand formatted output to the writer unless it is still busy with the last batch
+        m_writer->release();
+
+        if (!event_driven) {
+            // Sleep for half the sampling interval to ensure responsive output
+            std::this_thread::sleep_for(samplingPeriod(m_config) / 2);
+        }
+    }
+
+    // Upstream stages stop first, so print whatever they sent before shutdown
+    while (printNext(false, timeout)) {
+    }
+    flushCompressed();
+}
+
+// PrintNext: Receive one frame (waiting up to timeout if blocking) and print its contents
+bool OutputHandler::printNext(bool blocking, std::chrono::milliseconds timeout) {
+    if (m_config.channel_registry) {
+        // Registry mode: one structure-of-arrays frame per block
+        auto block = blocking ? m_ipc_manager.receiveBlock(timeout)
+                              : m_ipc_manager.receiveBlock();
+        printAlerts();
+        if (!block) {
+            return false;
+        }
+        const uint64_t received_ns = monotonicNanos();
+        printBlock(*block);
+        recordLatency(block->stages, received_ns);
+        return true;
+    }
+
+    // Block on the queue until a frame arrives, or just check in polling mode
+    MessageSpan batch = blocking ? m_ipc_manager.receiveBatch(timeout)
+                                 : m_ipc_manager.receiveBatch();
+    printAlerts();
+    printWindows();
+    const uint64_t received_ns = monotonicNanos();
+    for (const MQMessage& msg : batch) {
+        printSensorData(msg);
+        recordLatency(msg.stages, received_ns);
+    }
+    return !batch.empty();
+}
+
+// PrintAlerts: Straight to stderr rather than through the writer, so an alert is never
+// queued behind formatted output and never mixed into machine-readable stdout
+void OutputHandler::printAlerts() {
+    if (m_ipc_manager.takeAlerts(m_alerts) == 0) {
+        return;
+    }
+    m_alert_text.resize(m_alerts.size() * (m_name_width + 6 * NUMBER_BYTES + 64));
+    char* out = m_alert_text.data();
+    for (const AnomalyAlert& alert : m_alerts) {
+        // ALERT 2024-01-01 12:00:00.100 #42 Temperature zscore value=38.21 score=6.61 limit=6.00
+        out = appendTimestamp(appendText(out, "ALERT "), alert.timestamp, true);
+        out = appendText(appendUnsigned(appendText(out, " #"), alert.sample), " ");
+        if (alert.channel < m_field_names.size()) {
+            out = appendText(out, m_field_names[alert.channel]);
+        } else {
+            out = appendUnsigned(appendText(out, "channel"), alert.channel);
+        }
+        out = appendText(appendText(out, " "), anomalyKindName(alert.kind));
+        out = appendFixed(appendText(out, " value="), alert.value, 0);
+        out = appendFixed(appendText(out, " score="), alert.score, 0);
+        out = appendFixed(appendText(out, " limit="), alert.threshold, 0);
+        out = appendText(out, "\n");
+    }
+    const size_t length = static_cast<size_t>(out - m_alert_text.data());
+    // Best effort: a failed write to stderr has nowhere else to be reported
+    [[maybe_unused]] const ssize_t written = ::write(STDERR_FILENO, m_alert_text.data(), length);
+
+    if (LatencyStats* stats = m_config.latency_stats.get()) {
+        const uint64_t alerted_ns = monotonicNanos();
+        for (const AnomalyAlert& alert : m_alerts) {
+            stats->record(LatencyHop::ALERT, alert.generated_ns, alerted_ns);
         }
-        
-        // Sleep for half the sampling interval to ensure responsive output
-        std::this_thread::sleep_for(std::chrono::milliseconds(m_config.sampling_rate_ms / 2));
     }
 }
 
-// PrintSensorData: Format and display processed sensor data with timestamp
+// PrintWindows: Window reports received with the last frame, ahead of the messages that
+// follow them. Binary output carries MQMessage records only, so the reports are dropped there.
+void OutputHandler::printWindows() {
+    if (m_ipc_manager.takeWindows(m_windows) == 0 || m_config.output_format == OutputFormat::BINARY) {
+        return;
+    }
+    for (const WindowReport& report : m_windows) {
+        char* const begin = m_writer->reserve(m_record_bytes);
+        if (!begin) {
+            return;
+        }
+        char* out = begin;
+        const uint32_t windows = std::min<uint32_t>(report.window_count, MAX_AGGREGATE_WINDOWS);
+
+        switch (m_config.output_format) {
+        case OutputFormat::PRETTY:
+            out = appendText(out, "\n[");
+            out = appendTimestamp(out, report.timestamp, false);
+            out = appendText(out, "] Windows\n");
+            for (uint32_t w = 0; w < windows; ++w) {
+                const WindowSummary& window = report.windows[w];
+                out = appendWindow(appendText(out, "Window "), window.window_ms);
+                out = appendText(appendUnsigned(appendText(out, " ("), window.samples), " samples)\n");
+                for (size_t i = 0; i < NUM_SENSORS; ++i) {
+                    out = appendPadded(out, SENSORS[i].name, 16);
+                    out = appendFixed(appendText(out, "Mean: "), window.mean[i], 8);
+                    out = appendFixed(appendText(out, "  Min: "), window.min[i], 8);
+                    out = appendFixed(appendText(out, "  Max: "), window.max[i], 8);
+                    out = appendFixed(appendText(out, "  Var: "), window.variance[i], 8);
+                    out = appendText(appendText(appendText(out, " "), SENSORS[i].unit), "\n");
+                }
+            }
+            out = appendText(out, "\n");
+            break;
+
+        case OutputFormat::COMPACT:
+            // 2024-01-01 12:00:00.100 windows | 1s n=10 Temperature=25.0/23.1/27.2/1.98 ...
+            out = appendText(appendTimestamp(out, report.timestamp, true), " windows");
+            for (uint32_t w = 0; w < windows; ++w) {
+                const WindowSummary& window = report.windows[w];
+                out = appendWindow(appendText(out, " | "), window.window_ms);
+                out = appendUnsigned(appendText(out, " n="), window.samples);
+                for (size_t i = 0; i < NUM_SENSORS; ++i) {
+                    out = appendText(appendText(appendText(out, " "), m_field_names[i]), "=");
+                    out = appendFixed(out, window.mean[i], 0);
+                    out = appendFixed(appendText(out, "/"), window.min[i], 0);
+                    out = appendFixed(appendText(out, "/"), window.max[i], 0);
+                    out = appendFixed(appendText(out, "/"), window.variance[i], 0);
+                }
+            }
+            out = appendText(out, "\n");
+            break;
+
+        case OutputFormat::CSV:
+            // Same columns as the message rows, with msg_id and the averages left empty
+            out = appendInteger(out, epochNanos(report.timestamp));
+            out = appendText(out, ",");
+            for (size_t i = 0; i < NUM_SENSORS; ++i) {
+                out = appendText(out, ",");
+            }
+            for (uint32_t w = 0; w < windows; ++w) {
+                const WindowSummary& window = report.windows[w];
+                out = appendUnsigned(appendText(out, ","), window.samples);
+                for (const auto* stat : {&window.mean, &window.min, &window.max, &window.variance}) {
+                    for (size_t i = 0; i < NUM_SENSORS; ++i) {
+                        out = appendShortest(appendText(out, ","), (*stat)[i]);
+                    }
+                }
+            }
+            out = appendText(out, "\n");
+            break;
+
+        case OutputFormat::BINARY:
+            break;
+        }
+
+        m_writer->commit(static_cast<size_t>(out - begin));
+    }
+}
+
+// RecordLatency: Transport, output and end-to-end hops of a reading that was just formatted
+void OutputHandler::recordLatency(const StageTimes& stages, uint64_t received_ns) {
+    if (LatencyStats* stats = m_config.latency_stats.get()) {
+        const uint64_t printed_ns = monotonicNanos();
+        stats->record(LatencyHop::IPC, stages.sent_ns, received_ns);
+        stats->record(LatencyHop::OUTPUT, received_ns, printed_ns);
+        stats->record(LatencyHop::END_TO_END, stages.generated_ns, printed_ns);
+    }
+}
+
+// FormatWindow: Window length as whole seconds where possible, e.g. "10s" or "250ms"
+std::string OutputHandler::formatWindow(uint32_t window_ms) {
+    return window_ms % 1000 == 0 ? std::to_string(window_ms / 1000) + "s"
+                                 : std::to_string(window_ms) + "ms";
+}
+
+// AppendWindow: Same labels as formatWindow, without allocating
+char* OutputHandler::appendWindow(char* out, uint32_t window_ms) {
+    if (window_ms % 1000 == 0) {
+        return appendText(appendUnsigned(out, window_ms / 1000), "s");
+    }
+    return appendText(appendUnsigned(out, window_ms), "ms");
+}
+
+// AppendTimestamp: Local "YYYY-MM-DD HH:MM:SS", with localtime_r/strftime run once per second
+char* OutputHandler::appendTimestamp(char* out, std::chrono::system_clock::time_point time, bool millis) {
+    const int64_t ns = epochNanos(time);
+    const int64_t second = ns >= 0 ? ns / 1000000000 : (ns - 999999999) / 1000000000;
+    if (second != m_cached_second) {
+        const std::time_t seconds = static_cast<std::time_t>(second);
+        std::tm local{};
+        localtime_r(&seconds, &local);
+        if (std::strftime(m_cached_prefix, sizeof(m_cached_prefix), "%F %T", &local) == 0) {
+            m_cached_prefix[0] = '\0';
+        }
+        m_cached_second = second;
+    }
+    out = appendText(out, m_cached_prefix);
+    if (millis) {
+        const int64_t ms = (ns - second * 1000000000) / 1000000;
+        *out++ = '.';
+        *out++ = static_cast<char>('0' + ms / 100);
+        *out++ = static_cast<char>('0' + ms / 10 % 10);
+        *out++ = static_cast<char>('0' + ms % 10);
+    }
+    return out;
+}
+
+// PrintSensorData: Format one processed message into the writer's buffer in the configured format
 void OutputHandler::printSensorData(const MQMessage& msg) {
-    // Convert timestamp to local time and format it
-    auto time = std::chrono::system_clock::to_time_t(msg.timestamp);
-    std::cout << "\n[" << std::put_time(std::localtime(&time), "%F %T") 
-              << "] Message ID: " << msg.msg_id << "\n";
-    
-    // Set up floating-point output format
-    std::cout << std::fixed << std::setprecision(2);
+    if (m_message_codec) {
+        appendCompressed(msg);
+        return;
+    }
+    char* const begin = m_writer->reserve(m_record_bytes);
+    if (!begin) {
+        return;
+    }
+    char* out = begin;
+
+    switch (m_config.output_format) {
+    case OutputFormat::PRETTY:
+        out = appendText(out, "\n[");
+        out = appendTimestamp(out, msg.timestamp, false);
+        out = appendText(out, "] Message ID: ");
+        out = appendText(appendUnsigned(out, msg.msg_id), "\n");
+        for (size_t i = 0; i < NUM_SENSORS; ++i) {
+            out = appendPadded(out, SENSORS[i].name, 16);
+            out = appendFixed(appendText(out, "Avg: "), msg.avg_values[i], 8);
+            out = appendText(appendText(appendText(out, " "), SENSORS[i].unit), "\n");
+        }
+        out = appendText(out, "\n");
+        break;
+
+    case OutputFormat::COMPACT:
+        // 2024-01-01 12:00:00.100 #42 Temperature=25.01 ...
+        out = appendTimestamp(out, msg.timestamp, true);
+        out = appendUnsigned(appendText(out, " #"), msg.msg_id);
+        for (size_t i = 0; i < NUM_SENSORS; ++i) {
+            out = appendText(appendText(appendText(out, " "), m_field_names[i]), "=");
+            out = appendFixed(out, msg.avg_values[i], 0);
+        }
+        out = appendText(out, "\n");
+        break;
+
+    case OutputFormat::CSV:
+        // Columns as announced by writeCsvHeader(); values round-trip exactly
+        out = appendInteger(out, epochNanos(msg.timestamp));
+        out = appendUnsigned(appendText(out, ","), msg.msg_id);
+        for (size_t i = 0; i < NUM_SENSORS; ++i) {
+            out = appendShortest(appendText(out, ","), msg.avg_values[i]);
+        }
+        out = appendText(out, m_csv_window_gap.c_str());
+        out = appendText(out, "\n");
+        break;
+
+    case OutputFormat::BINARY:
+        // Raw MQMessage, the same record layout as the flight recorder's "messages" stream
+        std::memcpy(out, &msg, sizeof(msg));
+        out += sizeof(msg);
+        break;
+    }
+
+    m_writer->commit(static_cast<size_t>(out - begin));
+}
+
+// PrintBlock: Latest sample of a block in pretty mode, every sample in the machine formats
+void OutputHandler::printBlock(const BlockView& block) {
+    if (block.length == 0) {
+        return;
+    }
+    char* const begin = m_writer->reserve(m_record_bytes);
+    if (!begin) {
+        return;
+    }
+    char* out = begin;
+    const ChannelRegistry& registry = *m_config.channel_registry;
+
+    // Frames from a sender with a different registry are printed as far as they match
+    const size_t channels = std::min(block.channels, registry.size());
+
+    switch (m_config.output_format) {
+    case OutputFormat::PRETTY: {
+        const size_t last = block.length - 1;
+        out = appendText(out, "\n[");
+        out = appendTimestamp(out, block.timestamps[last], false);
+        out = appendText(out, "] Message ID: ");
+        out = appendText(appendUnsigned(out, block.first_msg_id + last), "\n");
+        for (size_t i = 0; i < channels; ++i) {
+            out = appendPadded(out, registry[i].name, m_name_width);
+            out = appendFixed(appendText(out, "Avg: "), block.column(i)[last], 8);
+            out = appendText(appendText(appendText(out, " "), registry[i].unit), "\n");
+        }
+        out = appendText(out, "\n");
+        break;
+    }
+
+    case OutputFormat::COMPACT:
+        for (size_t s = 0; s < block.length; ++s) {
+            out = appendTimestamp(out, block.timestamps[s], true);
+            out = appendUnsigned(appendText(out, " #"), block.first_msg_id + s);
+            for (size_t i = 0; i < channels; ++i) {
+                out = appendText(appendText(appendText(out, " "), m_field_names[i]), "=");
+                out = appendFixed(out, block.column(i)[s], 0);
+            }
+            out = appendText(out, "\n");
+        }
+        break;
+
+    case OutputFormat::CSV:
+        for (size_t s = 0; s < block.length; ++s) {
+            out = appendInteger(out, epochNanos(block.timestamps[s]));
+            out = appendUnsigned(appendText(out, ","), block.first_msg_id + s);
+            for (size_t i = 0; i < channels; ++i) {
+                out = appendShortest(appendText(out, ","), block.column(i)[s]);
+            }
+            out = appendText(out, "\n");
+        }
+        break;
+
+    case OutputFormat::BINARY:
+        if (m_block_codec) {
+            // One compressed frame of the channels this registry knows
+            if (m_block_codec->channels() != channels) {
+                m_precision.resize(channels, 0.0);
+                m_block_codec = std::make_unique<BlockCodec>(m_precision);
+            }
+            out += m_block_codec->encode(block.first_msg_id, block.stages, block.timestamps, block.values,
+                                         block.length, block.length, out, m_record_bytes);
+            break;
+        }
+        for (size_t s = 0; s < block.length; ++s) {
+            const BinarySampleHeader header{block.first_msg_id + s, epochNanos(block.timestamps[s]),
+                                            static_cast<uint32_t>(channels), 0};
+            std::memcpy(out, &header, sizeof(header));
+            out += sizeof(header);
+            for (size_t i = 0; i < channels; ++i) {
+                std::memcpy(out, &block.column(i)[s], sizeof(double));
+                out += sizeof(double);
+            }
+        }
+        break;
+    }
+
+    m_writer->commit(static_cast<size_t>(out - begin));
+}
+
+// AppendCompressed: A full frame is written out and a new one started with the message
+void OutputHandler::appendCompressed(const MQMessage& msg) {
+    if (m_message_codec->count() == 0) {
+        m_frame_first = std::chrono::steady_clock::now();
+    }
+    if (!m_message_codec->append(msg)) {
+        flushCompressed();
+        m_frame_first = std::chrono::steady_clock::now();
+        m_message_codec->append(msg);
+    }
+}
+
+// FlushCompressed: Copy the frame into an output chunk (dropped with the chunk if none is free)
+void OutputHandler::flushCompressed() {
+    if (!m_message_codec || m_message_codec->count() == 0) {
+        return;
+    }
+    const size_t length = m_message_codec->finish();
+    if (char* out = m_writer->reserve(length)) {
+        std::memcpy(out, m_frame.data(), length);
+        m_writer->commit(length);
+    }
+    m_message_codec->begin(m_frame.data(), m_frame.size());
+}
+
+// WriteCsvHeader: Column names matching the rows printSensorData/printBlock write
+void OutputHandler::writeCsvHeader() {
+    std::string header = "timestamp_ns,msg_id";
+    for (const std::string& name : m_field_names) {
+        header += "," + name;
+    }
+    if (!m_config.channel_registry) {
+        for (int window_ms : m_config.aggregate_windows_ms) {
+            const std::string suffix = "_" + formatWindow(static_cast<uint32_t>(window_ms));
+            header += ",samples" + suffix;
+            for (const char* stat : WINDOW_STATS) {
+                for (const std::string& name : m_field_names) {
+                    header += "," + name + "_" + stat + suffix;
+                }
+            }
+        }
+    }
+    header += "\n";
 
-    // Display average values for each sensor with proper formatting
-    for (size_t i = 0; i < NUM_SENSORS; ++i) {
-        std::cout << std::left << std::setw(16) << SENSORS[i].name 
-                  << "Avg: " << std::right << std::setw(8) << msg.avg_values[i] 
-                  << " " << SENSORS[i].unit << "\n";
+    if (char* out = m_writer->reserve(header.size())) {
+        std::memcpy(out, header.data(), header.size());
+        m_writer->commit(header.size());
     }
-    std::cout << std::endl;
 }
 
-} // namespace sensor 
\ No newline at end of file
+} // namespace sensor
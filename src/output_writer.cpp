@@ -0,0 +1,236 @@
+#include "output_writer.hpp"
+#include <errno.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+namespace sensor {
+
+namespace {
+    // How long the writer sleeps between checks for shutdown
+    constexpr std::chrono::milliseconds WRITER_POLL(100);
+}
+
+// Constructor: Allocate every chunk up front; all start on the free ring
+OutputWriter::OutputWriter(int fd, size_t chunk_bytes, size_t chunk_count, OverflowPolicy policy,
+                           std::chrono::microseconds block_timeout)
+    : m_fd(fd)
+    , m_chunk_bytes(chunk_bytes)
+    , m_chunks(chunk_count)
+    , m_filled(chunk_count)
+    , m_free(chunk_count)
+    , m_current(-1)
+    , m_policy(policy)
+    , m_block_timeout(block_timeout)
+    , m_running(false)
+    , m_busy(false)
+    , m_records(0)
+    , m_dropped(0)
+    , m_written(0)
+    , m_high_water(0)
+    , m_write_calls(0)
+    , m_bytes(0)
+{
+    if (policy != OverflowPolicy::DROP_NEWEST && policy != OverflowPolicy::BLOCK) {
+        throw std::invalid_argument(std::string("Output stage cannot ") + overflowPolicyName(policy)
+                                    + ": formatted records are only dropped or waited for");
+    }
+    for (size_t i = 0; i < chunk_count; ++i) {
+        m_chunks[i].data = std::make_unique<char[]>(chunk_bytes);
+        m_free.push(static_cast<uint32_t>(i));
+    }
+}
+
+// Destructor: Make sure committed output is not lost
+OutputWriter::~OutputWriter() {
+    stop();
+}
+
+// Start: Launch the writer thread if not already running
+void OutputWriter::start() {
+    if (!m_running) {
+        std::cout.flush();
+        m_running = true;
+        m_thread = std::thread(&OutputWriter::writerLoop, this);
+    }
+}
+
+// Stop: Queue the partial chunk, then let the writer drain the ring before it exits
+void OutputWriter::stop() {
+    if (m_running) {
+        flush();
+        m_running = false;
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+    }
+}
+
+// Reserve: Continue the current chunk if the record fits, otherwise move to a free one
+char* OutputWriter::reserve(size_t max_bytes) {
+    bumpCounter(m_records);
+    if (max_bytes > m_chunk_bytes) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    if (m_current >= 0 && m_chunk_bytes - m_chunks[m_current].used < max_bytes) {
+        publish();
+    }
+    if (m_current < 0) {
+        auto chunk = m_free.pop();
+        if (!chunk && m_policy == OverflowPolicy::BLOCK) {
+            // The writer pushes each chunk back to the free ring as soon as it is written
+            chunk = m_free.waitPop(m_block_timeout);
+        }
+        if (!chunk) {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        m_current = *chunk;
+        m_chunks[m_current].used = 0;
+        m_chunks[m_current].records = 0;
+    }
+    Chunk& chunk = m_chunks[m_current];
+    return chunk.data.get() + chunk.used;
+}
+
+// Commit: Advance past the bytes the caller formatted
+void OutputWriter::commit(size_t bytes) {
+    m_chunks[m_current].used += bytes;
+    ++m_chunks[m_current].records;
+}
+
+// Release: While the writer is busy, keep filling the chunk so the next writev() is larger
+void OutputWriter::release() {
+    if (!m_busy.load(std::memory_order_acquire) && m_filled.empty()) {
+        flush();
+    }
+}
+
+// Flush: Queue the current chunk if it holds anything
+void OutputWriter::flush() {
+    if (m_current >= 0 && m_chunks[m_current].used > 0) {
+        publish();
+    }
+}
+
+// Publish: The ring never overflows because it has room for every chunk
+void OutputWriter::publish() {
+    m_filled.push(static_cast<uint32_t>(m_current));
+    m_current = -1;
+
+    // Chunks neither free nor being filled are queued or being written
+    const size_t queued = m_chunks.size() - m_free.size();
+    if (queued > m_high_water.load(std::memory_order_relaxed)) {
+        m_high_water.store(queued, std::memory_order_relaxed);
+    }
+}
+
+// WriterLoop: One writev() per wakeup over everything queued, retried until fully written
+void OutputWriter::writerLoop() {
+    uint32_t gathered[MAX_GATHER];
+    struct iovec iov[MAX_GATHER];
+
+    for (;;) {
+        auto first = m_filled.waitPop(WRITER_POLL);
+        if (!first) {
+            // stop() queues its last chunk before clearing m_running
+            if (!m_running && m_filled.empty()) {
+                break;
+            }
+            continue;
+        }
+
+        m_busy.store(true, std::memory_order_release);
+        size_t count = 0;
+        gathered[count++] = *first;
+        while (count < MAX_GATHER) {
+            auto next = m_filled.pop();
+            if (!next) {
+                break;
+            }
+            gathered[count++] = *next;
+        }
+
+        size_t total = 0;
+        for (size_t i = 0; i < count; ++i) {
+            iov[i].iov_base = m_chunks[gathered[i]].data.get();
+            iov[i].iov_len = m_chunks[gathered[i]].used;
+            total += iov[i].iov_len;
+        }
+
+        size_t records = 0;
+        for (size_t i = 0; i < count; ++i) {
+            records += m_chunks[gathered[i]].records;
+        }
+
+        // Short writes are resumed where they stopped; errors abandon the batch
+        struct iovec* pending = iov;
+        int remaining = static_cast<int>(count);
+        size_t written_total = 0;
+        while (remaining > 0) {
+            const ssize_t written = writev(m_fd, pending, remaining);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            m_write_calls.fetch_add(1, std::memory_order_relaxed);
+            written_total += static_cast<size_t>(written);
+            size_t advance = static_cast<size_t>(written);
+            while (remaining > 0 && advance >= pending->iov_len) {
+                advance -= pending->iov_len;
+                ++pending;
+                --remaining;
+            }
+            if (remaining > 0) {
+                pending->iov_base = static_cast<char*>(pending->iov_base) + advance;
+                pending->iov_len -= advance;
+            }
+        }
+        m_bytes.fetch_add(std::min(written_total, total), std::memory_order_relaxed);
+        if (remaining == 0) {
+            bumpCounter(m_written, records);
+        } else {
+            // An abandoned batch is lost output: count its records as dropped
+            m_dropped.fetch_add(records, std::memory_order_relaxed);
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            m_free.push(gathered[i]);
+        }
+        m_busy.store(false, std::memory_order_release);
+    }
+}
+
+// DroppedRecords: Returns records dropped for lack of a free chunk
+uint64_t OutputWriter::droppedRecords() const {
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+// WriteCalls: Returns writev() calls made
+uint64_t OutputWriter::writeCalls() const {
+    return m_write_calls.load(std::memory_order_relaxed);
+}
+
+// BytesWritten: Returns bytes written
+uint64_t OutputWriter::bytesWritten() const {
+    return m_bytes.load(std::memory_order_relaxed);
+}
+
+// Counters: Records offered, written and dropped; approximate while running
+StageCounters OutputWriter::counters() const {
+    StageCounters counters;
+    counters.produced = m_records.load(std::memory_order_relaxed);
+    counters.consumed = m_written.load(std::memory_order_relaxed);
+    counters.dropped = m_dropped.load(std::memory_order_relaxed);
+    counters.high_water = m_high_water.load(std::memory_order_relaxed);
+    return counters;
+}
+
+} // namespace sensor
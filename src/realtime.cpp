@@ -0,0 +1,178 @@
+#include "realtime.hpp"
+#include <errno.h>
+#include <algorithm>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace sensor {
+
+namespace {
+    // CpuRelax: Tell the core we are spinning (frees resources for a hyperthread sibling)
+    inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+        _mm_pause();
+#elif defined(__aarch64__)
+        asm volatile("yield");
+#endif
+    }
+}
+
+// ApplyThreadPolicy: Best effort; a missing privilege downgrades to a warning
+ErrorCode applyThreadPolicy(const ThreadPolicy& policy, const char* thread_name) {
+    ErrorCode result = ErrorCode::SUCCESS;
+
+#ifdef __linux__
+    if (policy.cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(policy.cpu, &cpus);
+        const int err = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (err != 0) {
+            std::cerr << "Warning: cannot pin " << thread_name << " thread to CPU " << policy.cpu
+                      << ": " << strerror(err) << "\n";
+            result = ErrorCode::THREAD_POLICY_ERROR;
+        }
+    }
+
+    if (policy.rt_priority > 0) {
+        sched_param param{};
+        param.sched_priority = policy.rt_priority;
+        const int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (err != 0) {
+            std::cerr << "Warning: cannot set SCHED_FIFO priority " << policy.rt_priority
+                      << " on " << thread_name << " thread: " << strerror(err) << "\n";
+            result = ErrorCode::THREAD_POLICY_ERROR;
+        }
+    }
+#else
+    // No affinity API and no portable real-time scheduling here
+    if (policy.cpu >= 0 || policy.rt_priority > 0) {
+        std::cerr << "Warning: thread policy for " << thread_name
+                  << " thread is not supported on this platform\n";
+        result = ErrorCode::THREAD_POLICY_ERROR;
+    }
+#endif
+
+    return result;
+}
+
+// Constructor: Deadlines start one period after construction until restart() is called
+DeadlineTimer::DeadlineTimer(std::chrono::nanoseconds period, std::chrono::nanoseconds spin)
+    : m_period_ns(static_cast<uint64_t>(std::max<int64_t>(period.count(), 1)))
+    , m_spin_ns(static_cast<uint64_t>(std::max<int64_t>(spin.count(), 0)))
+    , m_next_ns(0)
+    , m_ticks(0)
+    , m_overruns(0)
+    , m_skipped(0)
+{
+    restart();
+}
+
+// Restart: Re-anchor the schedule on the current time
+void DeadlineTimer::restart() {
+    m_next_ns = monotonicNanos() + m_period_ns;
+}
+
+// Wait: Absolute sleep to the deadline, then advance it by exactly one period
+bool DeadlineTimer::wait() {
+    bool on_time = true;
+    uint64_t now = monotonicNanos();
+
+    if (now > m_next_ns) {
+        // Work overran the deadline: fire immediately, dropping any periods missed entirely
+        on_time = false;
+        m_overruns.fetch_add(1, std::memory_order_relaxed);
+        const uint64_t missed = (now - m_next_ns) / m_period_ns;
+        if (missed > 0) {
+            m_skipped.fetch_add(missed, std::memory_order_relaxed);
+            m_next_ns += missed * m_period_ns;
+        }
+    } else {
+        // Sleep until shortly before the deadline, then spin the rest of the way
+        if (m_next_ns - now > m_spin_ns) {
+            sleepUntil(m_next_ns - m_spin_ns);
+        }
+        while ((now = monotonicNanos()) < m_next_ns) {
+            cpuRelax();
+        }
+    }
+
+    m_jitter.record(now - m_next_ns);
+    m_ticks.fetch_add(1, std::memory_order_relaxed);
+    m_next_ns += m_period_ns;
+    return on_time;
+}
+
+// SleepUntil: Absolute sleep on the same clock monotonicNanos() reads
+void DeadlineTimer::sleepUntil(uint64_t target_ns) {
+#ifdef __linux__
+    // steady_clock is CLOCK_MONOTONIC, so the two timelines agree
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(target_ns / 1000000000);
+    ts.tv_nsec = static_cast<long>(target_ns % 1000000000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+#else
+    std::this_thread::sleep_until(std::chrono::steady_clock::time_point(
+        std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::nanoseconds(target_ns))));
+#endif
+}
+
+// Report: One-line summary of counters and wakeup jitter in microseconds
+void DeadlineTimer::report(std::ostream& os) const {
+    const auto flags = os.flags();
+    const auto precision = os.precision();
+
+    const LatencyHistogram::Summary s = m_jitter.summarize();
+    os << std::fixed << std::setprecision(1)
+       << "Sampling timer: period " << static_cast<double>(m_period_ns) / 1e3 << " us, "
+       << ticks() << " ticks, " << overruns() << " overruns, " << skipped() << " skipped; "
+       << "jitter (us) p50 " << static_cast<double>(s.p50) / 1e3
+       << " p99 " << static_cast<double>(s.p99) / 1e3
+       << " p99.9 " << static_cast<double>(s.p999) / 1e3
+       << " max " << static_cast<double>(s.max) / 1e3 << "\n";
+    os.flush();
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+// Ticks: Returns deadlines reached
+uint64_t DeadlineTimer::ticks() const {
+    return m_ticks.load(std::memory_order_relaxed);
+}
+
+// Overruns: Returns waits that started after their deadline
+uint64_t DeadlineTimer::overruns() const {
+    return m_overruns.load(std::memory_order_relaxed);
+}
+
+// Skipped: Returns periods dropped while catching up
+uint64_t DeadlineTimer::skipped() const {
+    return m_skipped.load(std::memory_order_relaxed);
+}
+
+// Period: Returns the configured period
+std::chrono::nanoseconds DeadlineTimer::period() const {
+    return std::chrono::nanoseconds(m_period_ns);
+}
+
+// Jitter: Returns the wakeup lateness histogram
+const LatencyHistogram& DeadlineTimer::jitter() const {
+    return m_jitter;
+}
+
+} // namespace sensor
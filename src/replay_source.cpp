@@ -0,0 +1,105 @@
+#include "replay_source.hpp"
+#include "realtime.hpp"
+#include <chrono>
+#include <iomanip>
+
+namespace sensor {
+
+// Constructor: Open the recording up front so a bad directory fails before any thread starts
+ReplaySource::ReplaySource(const Config& config)
+    : m_config(config)
+    , m_reader(config.replay_dir, "samples", RecordType::SENSOR_DATA)
+    , m_buffer(REPLAY_BUFFER_SIZE)
+    , m_running(false)
+    , m_exhausted(false)
+    , m_replayed(0)
+{}
+
+// Destructor: Ensure the replay thread is stopped
+ReplaySource::~ReplaySource() {
+    stop();
+}
+
+// Start: Begin replaying in a separate thread if not already running
+void ReplaySource::start() {
+    if (!m_running) {
+        m_running = true;
+        m_thread = std::thread(&ReplaySource::replayLoop, this);
+    }
+}
+
+// Stop: Terminate the replay thread and wait for it to finish
+void ReplaySource::stop() {
+    if (m_running) {
+        m_running = false;
+    }
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+// GetLatestData: Take the oldest replayed reading without waiting
+std::optional<SensorData> ReplaySource::getLatestData() {
+    return m_buffer.pop();
+}
+
+// WaitForData: Sleep until the replay thread pushes a reading or the timeout expires
+std::optional<SensorData> ReplaySource::waitForData(std::chrono::microseconds timeout) {
+    return m_buffer.waitPop(timeout);
+}
+
+// Finished: Everything read from the recording has also left the buffer
+bool ReplaySource::finished() const {
+    return m_exhausted.load(std::memory_order_acquire) && m_buffer.empty();
+}
+
+// Report: Records replayed out of the recording total
+void ReplaySource::report(std::ostream& os) const {
+    os << "Replay: " << m_replayed.load(std::memory_order_relaxed) << "/" << m_reader.totalRecords()
+       << " readings from " << m_config.replay_dir << " in " << m_reader.segments().size()
+       << " segments at " << std::fixed << std::setprecision(1) << m_config.replay_speed << "x"
+       << (m_exhausted.load(std::memory_order_relaxed) ? " (complete)" : "") << "\n";
+}
+
+// ReplayLoop: Reading i is due at start + (t_i - t_0) / speed on the monotonic clock
+void ReplaySource::replayLoop() {
+    applyThreadPolicy(m_config.simulator_thread, "replay");
+
+    using std::chrono::steady_clock;
+    const double speed = m_config.replay_speed;
+    const steady_clock::time_point start = steady_clock::now();
+    std::chrono::system_clock::time_point first{};
+    bool have_first = false;
+
+    while (m_running) {
+        std::optional<SensorData> data = m_reader.nextSensorData();
+        if (!data) {
+            break;
+        }
+
+        if (!have_first) {
+            first = data->timestamp;
+            have_first = true;
+        }
+        if (speed > 0.0) {
+            const auto offset = std::chrono::duration<double, std::nano>(data->timestamp - first) / speed;
+            std::this_thread::sleep_until(start + std::chrono::duration_cast<steady_clock::duration>(offset));
+        }
+
+        // Stamp the hand-off so latency histograms measure this run, not the recording
+        data->generated_ns = monotonicNanos();
+
+        // Backpressure instead of dropping: replay is only useful if it is complete
+        while (!m_buffer.push(*data)) {
+            if (!m_running) {
+                return;
+            }
+            std::this_thread::yield();
+        }
+        m_replayed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    m_exhausted.store(true, std::memory_order_release);
+}
+
+} // namespace sensor
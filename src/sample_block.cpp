@@ -0,0 +1,86 @@
+#include "sample_block.hpp"
+
+namespace sensor {
+
+namespace {
+    // Doubles per cache line; column starts are padded to this multiple
+    constexpr size_t DOUBLES_PER_LINE = CACHE_LINE_SIZE / sizeof(double);
+}
+
+// Constructor: Pad each column to whole cache lines so columns never share a line
+SampleBlock::SampleBlock(size_t channels, size_t capacity)
+    : m_channels(channels)
+    , m_capacity(capacity)
+    , m_stride(roundUp(capacity, DOUBLES_PER_LINE))
+    , m_values(channels * m_stride, 0.0)
+    , m_timestamps(capacity)
+    , m_length(0)
+    , m_first_sequence(0)
+{}
+
+// Column: Start of one channel's samples
+double* SampleBlock::column(size_t channel) {
+    return m_values.data() + channel * m_stride;
+}
+
+// Column: Start of one channel's samples (read-only)
+const double* SampleBlock::column(size_t channel) const {
+    return m_values.data() + channel * m_stride;
+}
+
+// Timestamps: Per-sample timestamps
+SampleBlock::TimePoint* SampleBlock::timestamps() {
+    return m_timestamps.data();
+}
+
+// Timestamps: Per-sample timestamps (read-only)
+const SampleBlock::TimePoint* SampleBlock::timestamps() const {
+    return m_timestamps.data();
+}
+
+// Length: Returns number of valid samples
+size_t SampleBlock::length() const {
+    return m_length;
+}
+
+// SetLength: Mark the first length samples of every column valid
+void SampleBlock::setLength(size_t length) {
+    m_length = length;
+}
+
+// FirstSequence: Returns sequence number of sample 0
+uint64_t SampleBlock::firstSequence() const {
+    return m_first_sequence;
+}
+
+// SetFirstSequence: Set sequence number of sample 0
+void SampleBlock::setFirstSequence(uint64_t sequence) {
+    m_first_sequence = sequence;
+}
+
+// Stages: Stage stamps of the newest sample
+StageTimes& SampleBlock::stages() {
+    return m_stages;
+}
+
+// Stages: Read-only stage stamps of the newest sample
+const StageTimes& SampleBlock::stages() const {
+    return m_stages;
+}
+
+// Channels: Returns number of columns
+size_t SampleBlock::channels() const {
+    return m_channels;
+}
+
+// Capacity: Returns samples per column
+size_t SampleBlock::capacity() const {
+    return m_capacity;
+}
+
+// Stride: Returns doubles between column starts
+size_t SampleBlock::stride() const {
+    return m_stride;
+}
+
+} // namespace sensor
@@ -1,20 +1,81 @@
 #include "sensor_simulator.hpp"
+#include "channel_registry.hpp"
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
 
 namespace sensor {
 
+namespace {
+    // SeededEngine: mt19937 seeded from both halves of a 64-bit seed, so seeds differing only above bit 31 diverge
+    std::mt19937 seededEngine(uint64_t seed) {
+        std::seed_seq sequence{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)};
+        return std::mt19937(sequence);
+    }
+}
+
 // Constructor: Initialize simulator with configuration and set up random number generators
 SensorSimulator::SensorSimulator(const Config& config)
     : m_config(config)
-    , m_buffer(BUFFER_SIZE)
+    , m_buffer(makeBuffer(config))
     , m_running(false)
-    , m_rng(std::random_device{}())
+    , m_timer(samplingPeriod(config), std::chrono::microseconds(config.timer_spin_us))
+    , m_rng(seededEngine(randomSeed(config)))
+    , m_noise_pos(0)
+    , m_filling_block(nullptr)
+    , m_sample_sequence(0)
+    , m_block_produced(0)
+    , m_block_dropped(0)
+    , m_block_consumed(0)
 {
     // Initialize normal distributions for each sensor using metadata
     for (size_t i = 0; i < NUM_SENSORS; ++i) {
         m_distributions[i] = std::normal_distribution<double>(
             SENSORS[i].mean, SENSORS[i].stddev);
     }
+
+    // Fast engine: about 4096 variates per refill, rounded to whole samples
+    if (m_config.random_engine == RandomEngine::FAST) {
+        const size_t channels = m_config.channel_registry ? std::max<size_t>(m_config.channel_registry->size(), 1)
+                                                          : NUM_SENSORS;
+        m_normal = std::make_unique<NormalSampler>(randomSeed(m_config));
+        m_noise.resize(roundUp(NOISE_BLOCK, channels));
+        m_noise_pos = m_noise.size();
+    }
+
+    // Fixed path only: registry blocks have no fixed record layout
+    if (!m_config.record_dir.empty() && !m_config.channel_registry) {
+        m_recorder = std::make_unique<FlightRecorder>(m_config.record_dir, "samples",
+                                                      RecordType::SENSOR_DATA,
+                                                      m_config.record_segment_bytes);
+    }
+
+    if (const auto& registry = m_config.channel_registry) {
+        // Filled blocks are never taken back from the consumer, so nothing queued can be evicted
+        if (m_config.sample_overflow != OverflowPolicy::DROP_NEWEST
+            && m_config.sample_overflow != OverflowPolicy::BLOCK) {
+            throw std::invalid_argument(std::string("Registry sample stage cannot ")
+                                        + overflowPolicyName(m_config.sample_overflow));
+        }
+
+        // One distribution per registry channel, in column order
+        m_channel_distributions.reserve(registry->size());
+        for (size_t i = 0; i < registry->size(); ++i) {
+            m_channel_distributions.emplace_back((*registry)[i].mean, (*registry)[i].stddev);
+        }
+
+        // Pool holds about BUFFER_SIZE samples, and at least double buffering
+        const size_t block_size = static_cast<size_t>(std::max(m_config.block_size, 1));
+        const size_t pool_size = std::max<size_t>(2, BUFFER_SIZE / block_size);
+        m_ready_blocks = std::make_unique<SpscRingBuffer<SampleBlock*>>(pool_size);
+        m_free_blocks = std::make_unique<SpscRingBuffer<SampleBlock*>>(pool_size);
+        for (size_t i = 0; i < pool_size; ++i) {
+            m_block_pool.push_back(std::make_unique<SampleBlock>(registry->size(), block_size));
+            m_free_blocks->push(m_block_pool.back().get());
+        }
+    }
 }
 
 // Destructor: Ensure simulation thread is stopped
@@ -42,35 +103,129 @@ void SensorSimulator::stop() {
     }
 }
 
+// MakeBuffer: Construct the configured buffer in place (variant alternatives are not movable)
+SensorSimulator::SampleBuffer SensorSimulator::makeBuffer(const Config& config) {
+    const std::chrono::microseconds block_timeout(config.overflow_block_us);
+    if (config.buffer_type == BufferType::SPSC) {
+        return SampleBuffer(std::in_place_index<1>, BUFFER_SIZE, config.sample_overflow, block_timeout);
+    }
+    if (config.buffer_type == BufferType::SHM) {
+        return SampleBuffer(std::in_place_index<2>, config.sample_overflow, block_timeout);
+    }
+    return SampleBuffer(std::in_place_index<0>, BUFFER_SIZE, config.sample_overflow, block_timeout);
+}
+
 // GetLatestData: Retrieve and remove the most recent sensor reading
 std::optional<SensorData> SensorSimulator::getLatestData() {
-    return m_buffer.pop();
+    return std::visit([](auto& buffer) { return buffer.pop(); }, m_buffer);
+}
+
+// WaitForData: Sleep on the buffer until the simulation thread pushes a reading
+std::optional<SensorData> SensorSimulator::waitForData(std::chrono::microseconds timeout) {
+    return std::visit([timeout](auto& buffer) { return buffer.waitPop(timeout); }, m_buffer);
+}
+
+// Report: Sampling timer counters and jitter
+void SensorSimulator::report(std::ostream& os) const {
+    m_timer.report(os);
+}
+
+// Stages: Sample buffer counters; registry mode counts samples through the block pool
+std::vector<StageReport> SensorSimulator::stages() const {
+    if (m_config.channel_registry) {
+        StageCounters counters;
+        counters.produced = m_block_produced.load(std::memory_order_relaxed);
+        counters.consumed = m_block_consumed.load(std::memory_order_relaxed);
+        counters.dropped = m_block_dropped.load(std::memory_order_relaxed);
+        counters.high_water = m_ready_blocks->counters().high_water * m_block_pool.front()->capacity();
+        return {StageReport{"samples", m_config.sample_overflow,
+                            m_block_pool.size() * m_block_pool.front()->capacity(), counters}};
+    }
+    return std::visit([this](const auto& buffer) {
+        return std::vector<StageReport>{
+            StageReport{"samples", buffer.policy(), buffer.capacity(), buffer.counters()}};
+    }, m_buffer);
+}
+
+// Loops: The timer already counts every pass; the loop always has a sample to generate
+std::vector<LoopReport> SensorSimulator::loops() const {
+    return {LoopReport{"simulator", m_timer.ticks(), 0}};
+}
+
+// Timer: Returns the sampling deadline timer
+const DeadlineTimer& SensorSimulator::timer() const {
+    return m_timer;
+}
+
+// GetLatestBlock: Take the oldest filled block without waiting
+SampleBlock* SensorSimulator::getLatestBlock() {
+    auto block = m_ready_blocks->pop();
+    if (!block) {
+        return nullptr;
+    }
+    bumpCounter(m_block_consumed, (*block)->length());
+    return *block;
+}
+
+// WaitForBlock: Sleep on the ready ring until the simulation thread publishes a block
+SampleBlock* SensorSimulator::waitForBlock(std::chrono::microseconds timeout) {
+    auto block = m_ready_blocks->waitPop(timeout);
+    if (!block) {
+        return nullptr;
+    }
+    bumpCounter(m_block_consumed, (*block)->length());
+    return *block;
+}
+
+// ReleaseBlock: Return a consumed block to the free ring
+void SensorSimulator::releaseBlock(SampleBlock* block) {
+    m_free_blocks->push(block);
 }
 
 // SimulationLoop: Main loop that generates sensor data at specified intervals
 void SensorSimulator::simulationLoop() {
+    applyThreadPolicy(m_config.simulator_thread, "simulator");
+    m_timer.restart();
+
+    if (m_config.channel_registry) {
+        blockSimulationLoop();
+        return;
+    }
+
     // More specific declarations are preferred over using namespace
     using std::chrono::system_clock;
-    using std::chrono::milliseconds;
     
     while (m_running) {
         // Create new sensor data with current values and timestamp
         SensorData data{
             generateSensorValues(),
-            system_clock::now()
+            system_clock::now(),
+            monotonicNanos()
         };
         
-        // Store data in circular buffer
-        m_buffer.push(data);
+        // Keep every reading for later replay; a write failure stops recording, not sampling
+        if (m_recorder) {
+            m_recorder->append(data);
+        }
+
+        // Store data in the configured buffer; Config::sample_overflow decides what a full buffer loses
+        std::visit([&data](auto& buffer) { buffer.push(data); }, m_buffer);
         
-        // Wait for next sampling interval
-        std::this_thread::sleep_for(milliseconds(m_config.sampling_rate_ms));
+        // Wait for the next absolute deadline; time spent above does not add drift
+        m_timer.wait();
     }
 }
 
 // GenerateSensorValues: Create simulated readings for all sensors
 std::array<double, NUM_SENSORS> SensorSimulator::generateSensorValues() {
     std::array<double, NUM_SENSORS> values;
+    if (m_normal) {
+        const double* noise = nextNoise(NUM_SENSORS);
+        for (size_t i = 0; i < NUM_SENSORS; ++i) {
+            values[i] = SENSORS[i].mean + SENSORS[i].stddev * noise[i];
+        }
+        return values;
+    }
     // Generate random values using normal distribution for each sensor
     for (size_t i = 0; i < NUM_SENSORS; ++i) {
         values[i] = m_distributions[i](m_rng);
@@ -78,4 +233,72 @@ std::array<double, NUM_SENSORS> SensorSimulator::generateSensorValues() {
     return values;
 }
 
-} // namespace sensor 
\ No newline at end of file
+// BlockSimulationLoop: Fill blocks sample by sample and publish each one when full
+void SensorSimulator::blockSimulationLoop() {
+    // Block being filled survives stop()/start(); only the consumer pushes to the free ring
+    SampleBlock*& block = m_filling_block;
+
+    while (m_running) {
+        if (!block) {
+            // Take an empty block; if the consumer holds them all, this sample is dropped
+            // (BLOCK waits a bounded time for the consumer to release one first)
+            auto free_block = m_free_blocks->pop();
+            if (!free_block && m_config.sample_overflow == OverflowPolicy::BLOCK) {
+                free_block = m_free_blocks->waitPop(std::chrono::microseconds(m_config.overflow_block_us));
+            }
+            if (free_block) {
+                block = *free_block;
+                block->setLength(0);
+                block->setFirstSequence(m_sample_sequence);
+            }
+        }
+
+        bumpCounter(m_block_produced);
+        if (!block) {
+            bumpCounter(m_block_dropped);
+        } else {
+            generateBlockSample(*block);
+            if (block->length() == block->capacity()) {
+                m_ready_blocks->push(block);
+                block = nullptr;
+            }
+        }
+        ++m_sample_sequence;
+
+        // Wait for the next absolute deadline
+        m_timer.wait();
+    }
+
+}
+
+// GenerateBlockSample: Write one value into every channel column at the next free index
+void SensorSimulator::generateBlockSample(SampleBlock& block) {
+    const size_t index = block.length();
+    if (m_normal) {
+        const double* noise = nextNoise(m_channel_distributions.size());
+        for (size_t ch = 0; ch < m_channel_distributions.size(); ++ch) {
+            block.column(ch)[index] = m_channel_distributions[ch].mean()
+                                      + m_channel_distributions[ch].stddev() * noise[ch];
+        }
+    } else {
+        for (size_t ch = 0; ch < m_channel_distributions.size(); ++ch) {
+            block.column(ch)[index] = m_channel_distributions[ch](m_rng);
+        }
+    }
+    block.timestamps()[index] = std::chrono::system_clock::now();
+    block.stages() = StageTimes{monotonicNanos(), 0, 0};
+    block.setLength(index + 1);
+}
+
+// NextNoise: Hand out the next slice of the noise block, drawing a new block when used up
+const double* SensorSimulator::nextNoise(size_t count) {
+    if (m_noise_pos + count > m_noise.size()) {
+        m_normal->fill(m_noise.data(), m_noise.size());
+        m_noise_pos = 0;
+    }
+    const double* noise = m_noise.data() + m_noise_pos;
+    m_noise_pos += count;
+    return noise;
+}
+
+} // namespace sensor
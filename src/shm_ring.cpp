@@ -0,0 +1,388 @@
+#include "shm_ring.hpp"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
+#include <new>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
+namespace sensor {
+
+namespace {
+    constexpr uint32_t SHM_MAGIC = 0x53485231;   // "SHR1"
+    constexpr uint32_t SHM_VERSION = 3;
+    constexpr mode_t SHM_PERMISSIONS = 0660;     // rw-rw----
+
+    // attach(): retries while another process is creating or removing the segment,
+    // after which whatever holds the name is treated as stale and replaced
+    constexpr int ATTACH_ATTEMPTS = 100;
+    constexpr std::chrono::milliseconds ATTACH_RETRY(1);
+
+    // A published slot (seq p + 1) must differ from a free one of the next lap (p + capacity)
+    constexpr size_t MIN_CAPACITY = 2;
+}
+
+// Control block placed at the start of the mapping; producer and consumer fields
+// live on separate cache lines so the two processes do not false-share
+struct ShmRing::Header {
+    std::atomic<uint32_t> magic;   // SHM_MAGIC once the creator finished initializing
+    uint32_t version;              // Layout version
+    uint64_t slot_size;            // Maximum payload bytes per slot
+    uint64_t capacity;             // Number of slots (power of two)
+    uint64_t stride;               // Bytes between consecutive slots
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> write_pos;  // Next position to publish
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> read_pos;   // Next position to consume
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint32_t> wake_seq;   // Futex word bumped on wakeups
+    std::atomic<uint32_t> parked;                              // 1 while the consumer sleeps on wake_seq
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> dropped;    // Writes the producer abandoned
+    std::atomic<uint64_t> high_water;                          // Deepest occupancy recorded
+    std::atomic<uint32_t> attached;                            // attach() holders; 0 = being removed
+};
+
+// Per-slot header; the payload follows immediately
+struct ShmRing::SlotHeader {
+    std::atomic<uint64_t> seq;  // pos + 1 when published, pos + capacity when free again
+    uint64_t length;            // Payload bytes written by the producer
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free, "futex word must be lock-free");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "slot sequence must be lock-free");
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be 32 bits");
+
+// Create: Replace any stale segment, size it, and initialize header and slot sequences
+std::unique_ptr<ShmRing> ShmRing::create(const std::string& name, size_t slot_size, size_t slots) {
+    // A segment left behind by a crashed producer may have a different layout
+    shm_unlink(name.c_str());
+
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, SHM_PERMISSIONS);
+    if (fd == -1) {
+        return nullptr;
+    }
+    return initialize(name, fd, slot_size, slots, Ownership::CREATOR);
+}
+
+// Attach: Whoever comes first creates the segment, everyone else joins it
+std::unique_ptr<ShmRing> ShmRing::attach(const std::string& name, size_t slot_size, size_t slots) {
+    for (int attempt = 0; attempt < ATTACH_ATTEMPTS; ++attempt) {
+        const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, SHM_PERMISSIONS);
+        if (fd != -1) {
+            return initialize(name, fd, slot_size, slots, Ownership::SHARED);
+        }
+        if (errno != EEXIST) {
+            return nullptr;
+        }
+
+        // Fails while the creator is still initializing or the last holder is removing it
+        std::unique_ptr<ShmRing> ring = open(name, slot_size);
+        if (ring && ring->join()) {
+            ring->m_ownership = Ownership::SHARED;
+            return ring;
+        }
+        std::this_thread::sleep_for(ATTACH_RETRY);
+    }
+
+    // Never became usable: left behind by a crash or by a build with another layout
+    shm_unlink(name.c_str());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, SHM_PERMISSIONS);
+    if (fd == -1) {
+        return nullptr;
+    }
+    return initialize(name, fd, slot_size, slots, Ownership::SHARED);
+}
+
+// Initialize: Takes ownership of fd; removes the name again if the segment cannot be set up
+std::unique_ptr<ShmRing> ShmRing::initialize(const std::string& name, int fd, size_t slot_size,
+                                             size_t slots, Ownership ownership) {
+    const size_t capacity = roundUpPow2(std::max(slots, MIN_CAPACITY));
+    const size_t stride = roundUp(sizeof(SlotHeader) + slot_size, CACHE_LINE_SIZE);
+    const size_t total = sizeof(Header) + stride * capacity;
+
+    if (ftruncate(fd, static_cast<off_t>(total)) == -1) {
+        close(fd);
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    void* base = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);  // Mapping keeps the segment alive
+    if (base == MAP_FAILED) {
+        shm_unlink(name.c_str());
+        return nullptr;
+    }
+
+    // Construct the control block and slot headers in the zero-filled segment
+    Header* header = new (base) Header;
+    header->version = SHM_VERSION;
+    header->slot_size = slot_size;
+    header->capacity = capacity;
+    header->stride = stride;
+    header->write_pos.store(0, std::memory_order_relaxed);
+    header->read_pos.store(0, std::memory_order_relaxed);
+    header->wake_seq.store(0, std::memory_order_relaxed);
+    header->parked.store(0, std::memory_order_relaxed);
+    header->dropped.store(0, std::memory_order_relaxed);
+    header->high_water.store(0, std::memory_order_relaxed);
+    header->attached.store(ownership == Ownership::SHARED ? 1 : 0, std::memory_order_relaxed);
+
+    char* slot_base = static_cast<char*>(base) + sizeof(Header);
+    for (size_t i = 0; i < capacity; ++i) {
+        SlotHeader* slot = new (slot_base + i * stride) SlotHeader;
+        slot->seq.store(i, std::memory_order_relaxed);
+        slot->length = 0;
+    }
+
+    // Publish the layout last so an early open() never sees a half-built ring
+    header->magic.store(SHM_MAGIC, std::memory_order_release);
+
+    return std::unique_ptr<ShmRing>(new ShmRing(name, base, total, ownership));
+}
+
+// Open: Map an existing segment and validate that its layout matches what we expect
+std::unique_ptr<ShmRing> ShmRing::open(const std::string& name, size_t slot_size) {
+    int fd = shm_open(name.c_str(), O_RDWR, SHM_PERMISSIONS);
+    if (fd == -1) {
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+        close(fd);
+        return nullptr;
+    }
+
+    const size_t total = static_cast<size_t>(st.st_size);
+    void* base = mmap(nullptr, total, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        return nullptr;
+    }
+
+    const Header* header = static_cast<const Header*>(base);
+    const bool valid = header->magic.load(std::memory_order_acquire) == SHM_MAGIC
+        && header->version == SHM_VERSION
+        && header->slot_size >= slot_size
+        && header->capacity >= MIN_CAPACITY
+        && sizeof(Header) + header->stride * header->capacity <= total;
+    if (!valid) {
+        munmap(base, total);
+        return nullptr;
+    }
+
+    // open() is the consumer's entry point: a consumer killed while parked left the flag set,
+    // which would make every push enter the kernel to wake nobody
+    static_cast<Header*>(base)->parked.store(0, std::memory_order_relaxed);
+
+    return std::unique_ptr<ShmRing>(new ShmRing(name, base, total, Ownership::OPENER));
+}
+
+// Join: A count of zero is final, so a segment being removed is never revived
+bool ShmRing::join() {
+    uint32_t count = m_header->attached.load(std::memory_order_acquire);
+    while (count != 0) {
+        if (m_header->attached.compare_exchange_weak(count, count + 1, std::memory_order_acq_rel)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Constructor: Adopt an initialized mapping
+ShmRing::ShmRing(const std::string& name, void* base, size_t mapped_size, Ownership ownership)
+    : m_name(name)
+    , m_base(base)
+    , m_mapped_size(mapped_size)
+    , m_ownership(ownership)
+    , m_header(static_cast<Header*>(base))
+    , m_slots(static_cast<char*>(base) + sizeof(Header))
+    , m_stride(m_header->stride)
+{}
+
+// Destructor: Unmap, and let the creator (or the last attached process) remove the name
+ShmRing::~ShmRing() {
+    const bool last = m_ownership == Ownership::CREATOR
+        || (m_ownership == Ownership::SHARED
+            && m_header->attached.fetch_sub(1, std::memory_order_acq_rel) == 1);
+    munmap(m_base, m_mapped_size);
+    if (last) {
+        shm_unlink(m_name.c_str());
+    }
+}
+
+// SlotAt: Masked position to slot address
+ShmRing::SlotHeader* ShmRing::slotAt(uint64_t pos) const {
+    return reinterpret_cast<SlotHeader*>(m_slots + (pos & (m_header->capacity - 1)) * m_stride);
+}
+
+// TryWrite: Fill the next slot in place and publish it with its sequence number
+bool ShmRing::tryWrite(const void* data, size_t len) {
+    if (len > m_header->slot_size) {
+        return false;
+    }
+
+    const uint64_t pos = m_header->write_pos.load(std::memory_order_relaxed);
+    SlotHeader* slot = slotAt(pos);
+
+    // Slot still holds an unconsumed message from one lap ago: ring is full
+    if (slot->seq.load(std::memory_order_acquire) != pos) {
+        return false;
+    }
+
+    memcpy(reinterpret_cast<char*>(slot) + sizeof(SlotHeader), data, len);
+    slot->length = len;
+    slot->seq.store(pos + 1, std::memory_order_release);
+    m_header->write_pos.store(pos + 1, std::memory_order_release);
+
+    wakeConsumer();
+    return true;
+}
+
+// Front: Oldest published payload, read directly from the mapping
+const void* ShmRing::front() const {
+    const uint64_t pos = m_header->read_pos.load(std::memory_order_relaxed);
+    const SlotHeader* slot = slotAt(pos);
+    if (slot->seq.load(std::memory_order_acquire) != pos + 1) {
+        return nullptr;
+    }
+    return reinterpret_cast<const char*>(slot) + sizeof(SlotHeader);
+}
+
+// FrontLength: Payload size of the slot returned by front()
+size_t ShmRing::frontLength() const {
+    return slotAt(m_header->read_pos.load(std::memory_order_relaxed))->length;
+}
+
+// PopFront: Mark the slot free for the producer's next lap
+void ShmRing::popFront() {
+    const uint64_t pos = m_header->read_pos.load(std::memory_order_relaxed);
+    slotAt(pos)->seq.store(pos + m_header->capacity, std::memory_order_release);
+    m_header->read_pos.store(pos + 1, std::memory_order_release);
+}
+
+// WakeConsumer: Pairs with waitReadable(); only enters the kernel if a consumer is parked
+void ShmRing::wakeConsumer() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_header->parked.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+    m_header->wake_seq.fetch_add(1, std::memory_order_release);
+#ifdef __linux__
+    // Shared (non-private) futex so a consumer in another process is woken
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_header->wake_seq), FUTEX_WAKE, 1,
+            nullptr, nullptr, 0);
+#endif
+}
+
+// WaitReadable: Spin-free wait on the futex word until the producer publishes or timeout.
+// There is one consumer, so parked is a flag it stores rather than a count: whichever
+// consumer parks next overwrites a flag left by one that died asleep
+bool ShmRing::waitReadable(std::chrono::milliseconds timeout) {
+    if (front()) {
+        return true;
+    }
+
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;) {
+        const uint32_t seen = m_header->wake_seq.load(std::memory_order_acquire);
+        m_header->parked.store(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // Re-check after announcing ourselves so a concurrent publish cannot be missed
+        if (front()) {
+            m_header->parked.store(0, std::memory_order_relaxed);
+            return true;
+        }
+
+        const auto remaining = deadline - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::steady_clock::duration::zero()) {
+            m_header->parked.store(0, std::memory_order_relaxed);
+            return false;
+        }
+
+#ifdef __linux__
+        // Returns immediately if wake_seq already moved past the value we saw
+        const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining).count();
+        struct timespec ts;
+        ts.tv_sec = static_cast<time_t>(ns / 1000000000);
+        ts.tv_nsec = static_cast<long>(ns % 1000000000);
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&m_header->wake_seq), FUTEX_WAIT, seen,
+                &ts, nullptr, 0);
+#else
+        // No cross-process futex: fall back to short sleeps
+        (void)seen;
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+#endif
+        m_header->parked.store(0, std::memory_order_relaxed);
+
+        if (front()) {
+            return true;
+        }
+    }
+}
+
+// SlotSize: Returns maximum payload bytes per slot
+size_t ShmRing::slotSize() const {
+    return m_header->slot_size;
+}
+
+// Capacity: Returns number of slots
+size_t ShmRing::capacity() const {
+    return m_header->capacity;
+}
+
+// Size: Returns published but unconsumed slots
+size_t ShmRing::size() const {
+    const uint64_t read = m_header->read_pos.load(std::memory_order_acquire);
+    const uint64_t write = m_header->write_pos.load(std::memory_order_acquire);
+    return write - read;
+}
+
+// Written: Shared write position
+uint64_t ShmRing::written() const {
+    return m_header->write_pos.load(std::memory_order_acquire);
+}
+
+// Consumed: Shared read position
+uint64_t ShmRing::consumed() const {
+    return m_header->read_pos.load(std::memory_order_acquire);
+}
+
+// Dropped: Returns abandoned writes
+uint64_t ShmRing::dropped() const {
+    return m_header->dropped.load(std::memory_order_relaxed);
+}
+
+// HighWater: Returns the deepest recorded occupancy
+size_t ShmRing::highWater() const {
+    return static_cast<size_t>(m_header->high_water.load(std::memory_order_relaxed));
+}
+
+// ConsumerParked: Whether a push would enter the kernel to wake the consumer
+bool ShmRing::consumerParked() const {
+    return m_header->parked.load(std::memory_order_relaxed) != 0;
+}
+
+// RecordDrop: Single producer, so a plain load and store suffice
+void ShmRing::recordDrop() {
+    m_header->dropped.store(m_header->dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+// RecordDepth: Only the producer raises the mark
+void ShmRing::recordDepth(size_t depth) {
+    if (depth > m_header->high_water.load(std::memory_order_relaxed)) {
+        m_header->high_water.store(depth, std::memory_order_relaxed);
+    }
+}
+
+} // namespace sensor
@@ -0,0 +1,51 @@
+#include "stage_counters.hpp"
+#include <iomanip>
+#include <stdexcept>
+
+namespace sensor {
+
+// OverflowPolicyName: Command-line spelling of each policy
+const char* overflowPolicyName(OverflowPolicy policy) {
+    switch (policy) {
+        case OverflowPolicy::DROP_OLDEST: return "drop-oldest";
+        case OverflowPolicy::DROP_NEWEST: return "drop-newest";
+        case OverflowPolicy::BLOCK:       return "block";
+        case OverflowPolicy::COALESCE:    return "coalesce";
+    }
+    return "unknown";
+}
+
+// ParseOverflowPolicy: Inverse of overflowPolicyName
+OverflowPolicy parseOverflowPolicy(const std::string& name) {
+    for (OverflowPolicy policy : {OverflowPolicy::DROP_OLDEST, OverflowPolicy::DROP_NEWEST,
+                                  OverflowPolicy::BLOCK, OverflowPolicy::COALESCE}) {
+        if (name == overflowPolicyName(policy)) {
+            return policy;
+        }
+    }
+    throw std::invalid_argument("Unknown overflow policy: " + name);
+}
+
+// ReportStages: Same table layout as the latency report
+void reportStages(std::ostream& os, const std::vector<StageReport>& stages) {
+    if (stages.empty()) {
+        return;
+    }
+    const auto flags = os.flags();
+
+    os << "\nStage      policy        capacity    produced    consumed     dropped  high-water\n";
+    for (const StageReport& stage : stages) {
+        os << std::left << std::setw(11) << stage.name
+           << std::setw(12) << overflowPolicyName(stage.policy) << std::right
+           << std::setw(10) << stage.capacity
+           << std::setw(12) << stage.counters.produced
+           << std::setw(12) << stage.counters.consumed
+           << std::setw(12) << stage.counters.dropped
+           << std::setw(12) << stage.counters.high_water << "\n";
+    }
+    os.flush();
+
+    os.flags(flags);
+}
+
+} // namespace sensor
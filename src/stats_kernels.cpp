@@ -0,0 +1,270 @@
+#include "stats_kernels.hpp"
+#include <cmath>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define SENSOR_SIMD_X86 1
+#include <immintrin.h>
+#endif
+
+namespace sensor {
+
+namespace {
+    // NeumaierAdd: Add value to sum while capturing the lost low-order bits in comp
+    inline void neumaierAdd(double& sum, double& comp, double value) {
+        const double t = sum + value;
+        if (std::fabs(sum) >= std::fabs(value)) {
+            comp += (sum - t) + value;
+        } else {
+            comp += (value - t) + sum;
+        }
+        sum = t;
+    }
+
+    // Term: A value as summed by sum() (SQUARES false) or sumSquares() (its squared deviation)
+    template <bool SQUARES>
+    inline double term(double x, double mean) {
+        if (SQUARES) {
+            const double d = x - mean;
+            return d * d;
+        }
+        return x;
+    }
+
+    // CombineLanes: Fold per-lane sums and compensations, then the scalar tail, in a fixed order
+    template <bool SQUARES>
+    inline double combineLanes(const double* sums, const double* comps, size_t lanes,
+                               const double* tail, size_t tail_n, double mean) {
+        double sum = 0.0;
+        double comp = 0.0;
+        for (size_t i = 0; i < lanes; ++i) {
+            neumaierAdd(sum, comp, sums[i]);
+        }
+        for (size_t i = 0; i < lanes; ++i) {
+            neumaierAdd(sum, comp, comps[i]);
+        }
+        for (size_t i = 0; i < tail_n; ++i) {
+            neumaierAdd(sum, comp, term<SQUARES>(tail[i], mean));
+        }
+        return sum + comp;
+    }
+
+    // ---- Scalar reference ----
+
+    template <bool SQUARES>
+    double neumaierScalar(const double* values, size_t n, double mean) {
+        double sum = 0.0;
+        double comp = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            neumaierAdd(sum, comp, term<SQUARES>(values[i], mean));
+        }
+        return sum + comp;
+    }
+
+    double sumScalar(const double* values, size_t n) { return neumaierScalar<false>(values, n, 0.0); }
+
+    double sumSquaresScalar(const double* values, size_t n, double mean) {
+        return neumaierScalar<true>(values, n, mean);
+    }
+
+    void meanScalar(const double* sums, const double* comps, double count, double* out, size_t n) {
+        for (size_t i = 0; i < n; ++i) {
+            out[i] = (sums[i] + comps[i]) / count;
+        }
+    }
+
+#ifdef SENSOR_SIMD_X86
+    // ---- SSE2: 2 lanes, no blendv, so select with and/andnot ----
+
+    template <bool SQUARES>
+    double neumaierSse2(const double* values, size_t n, double mean) {
+        const __m128d sign = _mm_set1_pd(-0.0);
+        const __m128d centre = _mm_set1_pd(mean);
+        __m128d sum = _mm_setzero_pd();
+        __m128d comp = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            __m128d x = _mm_loadu_pd(values + i);
+            if (SQUARES) {
+                const __m128d d = _mm_sub_pd(x, centre);
+                x = _mm_mul_pd(d, d);
+            }
+            const __m128d t = _mm_add_pd(sum, x);
+            const __m128d sum_larger = _mm_cmpge_pd(_mm_andnot_pd(sign, sum), _mm_andnot_pd(sign, x));
+            const __m128d if_sum = _mm_add_pd(_mm_sub_pd(sum, t), x);
+            const __m128d if_x = _mm_add_pd(_mm_sub_pd(x, t), sum);
+            comp = _mm_add_pd(comp, _mm_or_pd(_mm_and_pd(sum_larger, if_sum),
+                                              _mm_andnot_pd(sum_larger, if_x)));
+            sum = t;
+        }
+        alignas(16) double sums[2];
+        alignas(16) double comps[2];
+        _mm_store_pd(sums, sum);
+        _mm_store_pd(comps, comp);
+        return combineLanes<SQUARES>(sums, comps, 2, values + i, n - i, mean);
+    }
+
+    double sumSse2(const double* values, size_t n) { return neumaierSse2<false>(values, n, 0.0); }
+
+    double sumSquaresSse2(const double* values, size_t n, double mean) {
+        return neumaierSse2<true>(values, n, mean);
+    }
+
+    void meanSse2(const double* sums, const double* comps, double count, double* out, size_t n) {
+        const __m128d divisor = _mm_set1_pd(count);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2) {
+            const __m128d total = _mm_add_pd(_mm_loadu_pd(sums + i), _mm_loadu_pd(comps + i));
+            _mm_storeu_pd(out + i, _mm_div_pd(total, divisor));
+        }
+        meanScalar(sums + i, comps + i, count, out + i, n - i);
+    }
+
+    // ---- AVX2: 4 lanes ----
+
+    template <bool SQUARES>
+    __attribute__((target("avx2")))
+    double neumaierAvx2(const double* values, size_t n, double mean) {
+        const __m256d sign = _mm256_set1_pd(-0.0);
+        const __m256d centre = _mm256_set1_pd(mean);
+        __m256d sum = _mm256_setzero_pd();
+        __m256d comp = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256d x = _mm256_loadu_pd(values + i);
+            if (SQUARES) {
+                const __m256d d = _mm256_sub_pd(x, centre);
+                x = _mm256_mul_pd(d, d);
+            }
+            const __m256d t = _mm256_add_pd(sum, x);
+            const __m256d sum_larger = _mm256_cmp_pd(_mm256_andnot_pd(sign, sum),
+                                                     _mm256_andnot_pd(sign, x), _CMP_GE_OQ);
+            const __m256d if_sum = _mm256_add_pd(_mm256_sub_pd(sum, t), x);
+            const __m256d if_x = _mm256_add_pd(_mm256_sub_pd(x, t), sum);
+            comp = _mm256_add_pd(comp, _mm256_blendv_pd(if_x, if_sum, sum_larger));
+            sum = t;
+        }
+        alignas(32) double sums[4];
+        alignas(32) double comps[4];
+        _mm256_store_pd(sums, sum);
+        _mm256_store_pd(comps, comp);
+        return combineLanes<SQUARES>(sums, comps, 4, values + i, n - i, mean);
+    }
+
+    __attribute__((target("avx2")))
+    double sumAvx2(const double* values, size_t n) { return neumaierAvx2<false>(values, n, 0.0); }
+
+    __attribute__((target("avx2")))
+    double sumSquaresAvx2(const double* values, size_t n, double mean) {
+        return neumaierAvx2<true>(values, n, mean);
+    }
+
+    __attribute__((target("avx2")))
+    void meanAvx2(const double* sums, const double* comps, double count, double* out, size_t n) {
+        const __m256d divisor = _mm256_set1_pd(count);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            const __m256d total = _mm256_add_pd(_mm256_loadu_pd(sums + i), _mm256_loadu_pd(comps + i));
+            _mm256_storeu_pd(out + i, _mm256_div_pd(total, divisor));
+        }
+        meanScalar(sums + i, comps + i, count, out + i, n - i);
+    }
+
+    // ---- AVX-512F: 8 lanes with mask registers ----
+
+    template <bool SQUARES>
+    __attribute__((target("avx512f")))
+    double neumaierAvx512(const double* values, size_t n, double mean) {
+        const __m512d centre = _mm512_set1_pd(mean);
+        __m512d sum = _mm512_setzero_pd();
+        __m512d comp = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            __m512d x = _mm512_loadu_pd(values + i);
+            if (SQUARES) {
+                const __m512d d = _mm512_sub_pd(x, centre);
+                x = _mm512_mul_pd(d, d);
+            }
+            const __m512d t = _mm512_add_pd(sum, x);
+            const __mmask8 sum_larger = _mm512_cmp_pd_mask(_mm512_abs_pd(sum), _mm512_abs_pd(x),
+                                                           _CMP_GE_OQ);
+            const __m512d if_sum = _mm512_add_pd(_mm512_sub_pd(sum, t), x);
+            const __m512d if_x = _mm512_add_pd(_mm512_sub_pd(x, t), sum);
+            comp = _mm512_add_pd(comp, _mm512_mask_blend_pd(sum_larger, if_x, if_sum));
+            sum = t;
+        }
+        alignas(64) double sums[8];
+        alignas(64) double comps[8];
+        _mm512_store_pd(sums, sum);
+        _mm512_store_pd(comps, comp);
+        return combineLanes<SQUARES>(sums, comps, 8, values + i, n - i, mean);
+    }
+
+    __attribute__((target("avx512f")))
+    double sumAvx512(const double* values, size_t n) { return neumaierAvx512<false>(values, n, 0.0); }
+
+    __attribute__((target("avx512f")))
+    double sumSquaresAvx512(const double* values, size_t n, double mean) {
+        return neumaierAvx512<true>(values, n, mean);
+    }
+
+    __attribute__((target("avx512f")))
+    void meanAvx512(const double* sums, const double* comps, double count, double* out, size_t n) {
+        const __m512d divisor = _mm512_set1_pd(count);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            const __m512d total = _mm512_add_pd(_mm512_loadu_pd(sums + i), _mm512_loadu_pd(comps + i));
+            _mm512_storeu_pd(out + i, _mm512_div_pd(total, divisor));
+        }
+        meanScalar(sums + i, comps + i, count, out + i, n - i);
+    }
+#endif
+
+    // Kernel tables, one per level
+    const StatsKernels SCALAR_KERNELS{SimdLevel::SCALAR, "scalar", sumScalar, sumSquaresScalar, meanScalar};
+#ifdef SENSOR_SIMD_X86
+    const StatsKernels SSE2_KERNELS{SimdLevel::SSE2, "sse2", sumSse2, sumSquaresSse2, meanSse2};
+    const StatsKernels AVX2_KERNELS{SimdLevel::AVX2, "avx2", sumAvx2, sumSquaresAvx2, meanAvx2};
+    const StatsKernels AVX512_KERNELS{SimdLevel::AVX512, "avx512", sumAvx512, sumSquaresAvx512, meanAvx512};
+#endif
+}
+
+// DetectSimdLevel: Query CPUID (and OS register support) through the compiler builtins
+SimdLevel detectSimdLevel() {
+#ifdef SENSOR_SIMD_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse2")) {
+        return SimdLevel::SSE2;
+    }
+#endif
+    return SimdLevel::SCALAR;
+}
+
+// StatsKernels: Requested level, clamped to what this CPU can run
+const StatsKernels& statsKernels(SimdLevel level) {
+    const SimdLevel supported = detectSimdLevel();
+    if (static_cast<int>(level) > static_cast<int>(supported)) {
+        level = supported;
+    }
+    switch (level) {
+#ifdef SENSOR_SIMD_X86
+        case SimdLevel::AVX512: return AVX512_KERNELS;
+        case SimdLevel::AVX2:   return AVX2_KERNELS;
+        case SimdLevel::SSE2:   return SSE2_KERNELS;
+#endif
+        default:                return SCALAR_KERNELS;
+    }
+}
+
+// StatsKernels: Dispatch once; later calls are a static load
+const StatsKernels& statsKernels() {
+    static const StatsKernels& best = statsKernels(detectSimdLevel());
+    return best;
+}
+
+} // namespace sensor
@@ -0,0 +1,632 @@
+#include "telemetry_codec.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+namespace sensor {
+
+namespace {
+    // Largest |value / precision| quantized; beyond it doubles lose integer precision
+    constexpr double QUANTIZE_LIMIT = 4503599627370496.0; // 2^52
+
+    // Marks a quantized field sent as its raw bit pattern (NaN, infinity or out of range).
+    // Quantized differences stay below 2^53 in magnitude, so they never collide with it.
+    constexpr int64_t RAW_ESCAPE = std::numeric_limits<int64_t>::min();
+
+    // Worst-case bits of one field: 68-bit signed integer; XOR header, lengths and a full
+    // 64-bit window; escape plus raw bits
+    constexpr size_t INTEGER_BITS = 68;
+    constexpr size_t LOSSLESS_BITS = 2 + 5 + 6 + 64;
+    constexpr size_t QUANTIZED_BITS = 68 + 64;
+
+    // Worst-case bits of one precision table run: length, flag and precision
+    constexpr size_t TABLE_RUN_BITS = 68 + 1 + 64;
+
+    // ToBigEndian: Byte order of the encoded stream, independent of the host
+    inline uint64_t toBigEndian(uint64_t word) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return word;
+#else
+        return __builtin_bswap64(word);
+#endif
+    }
+
+    // SignExtend: Interpret the low bits bits of value as two's complement
+    inline int64_t signExtend(uint64_t value, unsigned bits) {
+        return static_cast<int64_t>(value << (64 - bits)) >> (64 - bits);
+    }
+
+    // DoubleBits / BitsDouble: Bit pattern of a double and back
+    inline uint64_t doubleBits(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+    inline double bitsDouble(uint64_t bits) {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // EpochCount: Timestamp in the clock's own ticks, so it round-trips exactly
+    inline uint64_t epochCount(std::chrono::system_clock::time_point time) {
+        return static_cast<uint64_t>(time.time_since_epoch().count());
+    }
+    inline std::chrono::system_clock::time_point fromEpochCount(uint64_t count) {
+        return std::chrono::system_clock::time_point(
+            std::chrono::system_clock::duration(static_cast<std::chrono::system_clock::rep>(count)));
+    }
+}
+
+// Reset: Start an empty bit stream at out
+void BitWriter::reset(unsigned char* out, size_t capacity) {
+    m_out = out;
+    m_capacity = capacity;
+    m_bytes = 0;
+    m_acc = 0;
+    m_fill = 0;
+}
+
+// Write: Shift bits into the accumulator, storing it big-endian whenever 64 bits are pending
+void BitWriter::write(uint64_t bits, unsigned count) {
+    const unsigned room = 64 - m_fill;
+    if (count < room) {
+        m_acc = (m_acc << count) | bits;
+        m_fill += count;
+        return;
+    }
+
+    // Top part completes the word, the rest starts the next one
+    const unsigned rest = count - room;
+    const uint64_t word = (room == 64 ? 0 : m_acc << room) | (bits >> rest);
+    const uint64_t stored = toBigEndian(word);
+    std::memcpy(m_out + m_bytes, &stored, sizeof(stored));
+    m_bytes += sizeof(stored);
+    m_acc = rest ? bits & ((uint64_t{1} << rest) - 1) : 0;
+    m_fill = rest;
+}
+
+// Finish: Store the pending bits without consuming them, so later writes overwrite the tail
+size_t BitWriter::finish() {
+    size_t used = m_bytes;
+    if (m_fill > 0) {
+        const uint64_t word = m_acc << (64 - m_fill);
+        for (unsigned shift = 56; used < m_bytes + (m_fill + 7) / 8; shift -= 8) {
+            m_out[used++] = static_cast<unsigned char>(word >> shift);
+        }
+    }
+    return used;
+}
+
+// BitCount: Returns bits written since reset
+size_t BitWriter::bitCount() const {
+    return m_bytes * 8 + m_fill;
+}
+
+// Capacity: Returns bytes available at the destination
+size_t BitWriter::capacity() const {
+    return m_capacity;
+}
+
+// Reset: Start reading at the first bit of data
+void BitReader::reset(const unsigned char* data, size_t size) {
+    m_data = data;
+    m_size = size;
+    m_pos = 0;
+    m_overrun = false;
+}
+
+// Read: Fields wider than 32 bits are read in two halves
+uint64_t BitReader::read(unsigned count) {
+    if (count > 32) {
+        const uint64_t high = readShort(count - 32);
+        return (high << 32) | readShort(32);
+    }
+    return readShort(count);
+}
+
+// ReadShort: Load the eight bytes around the position, zero padded near the end
+uint64_t BitReader::readShort(unsigned count) {
+    const size_t byte = m_pos >> 3;
+    const unsigned offset = static_cast<unsigned>(m_pos & 7);
+    uint64_t word = 0;
+    if (byte + sizeof(word) <= m_size) {
+        std::memcpy(&word, m_data + byte, sizeof(word));
+        word = toBigEndian(word);
+    } else {
+        for (size_t i = 0; i < sizeof(word); ++i) {
+            word = (word << 8) | (byte + i < m_size ? m_data[byte + i] : 0);
+        }
+    }
+    if (m_pos + count > m_size * 8) {
+        m_overrun = true;
+    }
+    m_pos += count;
+    return (word << offset) >> (64 - count);
+}
+
+// Overrun: Returns whether a read went past the end
+bool BitReader::overrun() const {
+    return m_overrun;
+}
+
+// Constructor: Worst-case record size from the field layout
+TelemetryEncoder::TelemetryEncoder(size_t integers, std::vector<double> precision)
+    : m_precision(std::move(precision))
+    , m_integers(integers)
+    , m_values(m_precision.size())
+    , m_records(0)
+{
+    size_t bits = integers * INTEGER_BITS;
+    size_t runs = 0;
+    for (size_t i = 0; i < m_precision.size(); ++i) {
+        double& step = m_precision[i];
+        if (!(step > 0.0) || !std::isfinite(step)) {
+            step = 0.0;
+        }
+        bits += step > 0.0 ? QUANTIZED_BITS : LOSSLESS_BITS;
+        runs += (i == 0 || step != m_precision[i - 1]) ? 1 : 0;
+    }
+    m_record_bytes = (bits + 7) / 8;
+    m_table_bytes = (runs * TABLE_RUN_BITS + 7) / 8;
+}
+
+// Begin: Zero the field state and write the precision table as runs of equal precision
+bool TelemetryEncoder::begin(unsigned char* out, size_t capacity) {
+    m_bits.reset(out, capacity);
+    m_records = 0;
+    std::fill(m_integers.begin(), m_integers.end(), IntegerState{0, 0});
+    std::fill(m_values.begin(), m_values.end(), ValueState{0, 64, 0});
+    if (capacity < m_table_bytes + m_record_bytes) {
+        return false;
+    }
+
+    for (size_t first = 0; first < m_precision.size();) {
+        size_t last = first + 1;
+        while (last < m_precision.size() && m_precision[last] == m_precision[first]) {
+            ++last;
+        }
+        writeSigned(static_cast<int64_t>(last - first));
+        if (m_precision[first] > 0.0) {
+            m_bits.write(1, 1);
+            m_bits.write(doubleBits(m_precision[first]), 64);
+        } else {
+            m_bits.write(0, 1);
+        }
+        first = last;
+    }
+    return true;
+}
+
+// Append: Delta-of-delta integers, then XOR or quantized-difference doubles
+bool TelemetryEncoder::append(const uint64_t* integers, const double* values, size_t stride) {
+    if ((m_bits.bitCount() + 7) / 8 + m_record_bytes > m_bits.capacity()) {
+        return false;
+    }
+
+    // Regular ids and timestamps have a constant difference: one bit each
+    for (size_t i = 0; i < m_integers.size(); ++i) {
+        IntegerState& state = m_integers[i];
+        const uint64_t delta = integers[i] - state.prev;
+        writeSigned(static_cast<int64_t>(delta - state.delta));
+        state.prev = integers[i];
+        state.delta = delta;
+    }
+
+    for (size_t i = 0; i < m_values.size(); ++i) {
+        ValueState& state = m_values[i];
+        const double value = values[i * stride];
+        const double step = m_precision[i];
+
+        if (step > 0.0) {
+            // Quantized: difference of integer multiples of the precision
+            const double scaled = value / step;
+            if (std::isfinite(scaled) && std::fabs(scaled) < QUANTIZE_LIMIT) {
+                const int64_t q = std::llround(scaled);
+                writeSigned(q - static_cast<int64_t>(state.prev));
+                state.prev = static_cast<uint64_t>(q);
+            } else {
+                writeSigned(RAW_ESCAPE);
+                m_bits.write(doubleBits(value), 64);
+            }
+            continue;
+        }
+
+        // Lossless: '0' same value, '10' XOR fits the previous window, '11' new window
+        const uint64_t bits = doubleBits(value);
+        const uint64_t x = bits ^ state.prev;
+        state.prev = bits;
+        if (x == 0) {
+            m_bits.write(0, 1);
+            continue;
+        }
+        const unsigned lead = std::min(static_cast<unsigned>(__builtin_clzll(x)), 31u);
+        const unsigned trail = static_cast<unsigned>(__builtin_ctzll(x));
+        if (state.lead != 64 && lead >= state.lead && trail >= state.trail) {
+            m_bits.write(2, 2);
+            m_bits.write(x >> state.trail, 64 - state.lead - state.trail);
+        } else {
+            // A 64-bit window is stored as length 0
+            const unsigned significant = 64 - lead - trail;
+            m_bits.write((uint64_t{3} << 11) | (lead << 6) | (significant & 63), 13);
+            m_bits.write(x >> trail, significant);
+            state.lead = lead;
+            state.trail = trail;
+        }
+    }
+    ++m_records;
+    return true;
+}
+
+// Finish: Bytes of the frame, tail byte included
+size_t TelemetryEncoder::finish() {
+    return m_bits.finish();
+}
+
+// Records: Returns records appended since begin()
+size_t TelemetryEncoder::records() const {
+    return m_records;
+}
+
+// MaxRecordBytes: Returns the worst-case size of one record
+size_t TelemetryEncoder::maxRecordBytes() const {
+    return m_record_bytes;
+}
+
+// MaxTableBytes: Every run of equal precision at its worst
+size_t TelemetryEncoder::maxTableBytes() const {
+    return m_table_bytes;
+}
+
+// WriteSigned: '0' for zero, then 8, 16, 32 or 64 bits of two's complement behind a prefix
+void TelemetryEncoder::writeSigned(int64_t value) {
+    const uint64_t bits = static_cast<uint64_t>(value);
+    if (value == 0) {
+        m_bits.write(0, 1);
+    } else if (value >= -(int64_t{1} << 7) && value < (int64_t{1} << 7)) {
+        m_bits.write((uint64_t{0x2} << 8) | (bits & 0xff), 10);
+    } else if (value >= -(int64_t{1} << 15) && value < (int64_t{1} << 15)) {
+        m_bits.write((uint64_t{0x6} << 16) | (bits & 0xffff), 19);
+    } else if (value >= -(int64_t{1} << 31) && value < (int64_t{1} << 31)) {
+        m_bits.write((uint64_t{0xe} << 32) | (bits & 0xffffffff), 36);
+    } else {
+        m_bits.write(0xf, 4);
+        m_bits.write(bits, 64);
+    }
+}
+
+// Constructor: Field state sized once, reused for every frame
+TelemetryDecoder::TelemetryDecoder(size_t integers, size_t values)
+    : m_precision(values, 0.0)
+    , m_divisor(values, 0.0)
+    , m_prev(integers)
+    , m_delta(integers)
+    , m_bits_prev(values)
+    , m_lead(values)
+    , m_trail(values)
+{}
+
+// Begin: Zero the field state and read the precision table
+bool TelemetryDecoder::begin(const unsigned char* data, size_t size) {
+    m_bits.reset(data, size);
+    std::fill(m_prev.begin(), m_prev.end(), 0);
+    std::fill(m_delta.begin(), m_delta.end(), 0);
+    std::fill(m_bits_prev.begin(), m_bits_prev.end(), 0);
+    std::fill(m_lead.begin(), m_lead.end(), 64u);
+    std::fill(m_trail.begin(), m_trail.end(), 0u);
+
+    for (size_t first = 0; first < m_precision.size();) {
+        const int64_t run = readSigned();
+        if (run <= 0 || static_cast<uint64_t>(run) > m_precision.size() - first || m_bits.overrun()) {
+            return false;
+        }
+        const double step = m_bits.read(1) ? bitsDouble(m_bits.read(64)) : 0.0;
+        if (!(step >= 0.0)) {
+            return false;
+        }
+        // Steps like 0.01 divide by their whole reciprocal, so values print as written
+        const double inverse = step > 0.0 ? std::round(1.0 / step) : 0.0;
+        const double divisor = (inverse >= 1.0 && std::fabs(inverse * step - 1.0) < 1e-12) ? inverse : 0.0;
+        std::fill_n(m_precision.begin() + static_cast<std::ptrdiff_t>(first), run, step);
+        std::fill_n(m_divisor.begin() + static_cast<std::ptrdiff_t>(first), run, divisor);
+        first += static_cast<size_t>(run);
+    }
+    return !m_bits.overrun();
+}
+
+// Next: Inverse of TelemetryEncoder::append
+bool TelemetryDecoder::next(uint64_t* integers, double* values, size_t stride) {
+    for (size_t i = 0; i < m_prev.size(); ++i) {
+        m_delta[i] += static_cast<uint64_t>(readSigned());
+        m_prev[i] += m_delta[i];
+        integers[i] = m_prev[i];
+    }
+
+    for (size_t i = 0; i < m_precision.size(); ++i) {
+        const double step = m_precision[i];
+        if (step > 0.0) {
+            const int64_t diff = readSigned();
+            if (diff == RAW_ESCAPE) {
+                values[i * stride] = bitsDouble(m_bits.read(64));
+            } else {
+                m_bits_prev[i] += static_cast<uint64_t>(diff);
+                const double q = static_cast<double>(static_cast<int64_t>(m_bits_prev[i]));
+                values[i * stride] = m_divisor[i] > 0.0 ? q / m_divisor[i] : q * step;
+            }
+            continue;
+        }
+
+        if (m_bits.read(1) != 0) {
+            uint64_t x;
+            if (m_bits.read(1) == 0) {
+                if (m_lead[i] == 64) {
+                    return false;
+                }
+                x = m_bits.read(64 - m_lead[i] - m_trail[i]) << m_trail[i];
+            } else {
+                const unsigned lead = static_cast<unsigned>(m_bits.read(5));
+                unsigned significant = static_cast<unsigned>(m_bits.read(6));
+                significant = significant ? significant : 64;
+                if (lead + significant > 64) {
+                    return false;
+                }
+                m_lead[i] = lead;
+                m_trail[i] = 64 - lead - significant;
+                x = m_bits.read(significant) << m_trail[i];
+            }
+            m_bits_prev[i] ^= x;
+        }
+        values[i * stride] = bitsDouble(m_bits_prev[i]);
+    }
+    return !m_bits.overrun();
+}
+
+// Integers: Returns integer fields per record
+size_t TelemetryDecoder::integers() const {
+    return m_prev.size();
+}
+
+// Values: Returns double fields per record
+size_t TelemetryDecoder::values() const {
+    return m_precision.size();
+}
+
+// MaxRecords: Bounds counts read from untrusted frame headers before anything is sized by them
+size_t TelemetryDecoder::maxRecords(size_t bytes) const {
+    return bytes * 8 / std::max<size_t>(m_prev.size() + m_precision.size(), 1);
+}
+
+// ReadSigned: Prefix selects the width, then sign-extend
+int64_t TelemetryDecoder::readSigned() {
+    if (m_bits.read(1) == 0) {
+        return 0;
+    }
+    if (m_bits.read(1) == 0) {
+        return signExtend(m_bits.read(8), 8);
+    }
+    if (m_bits.read(1) == 0) {
+        return signExtend(m_bits.read(16), 16);
+    }
+    if (m_bits.read(1) == 0) {
+        return signExtend(m_bits.read(32), 32);
+    }
+    return static_cast<int64_t>(m_bits.read(64));
+}
+
+namespace {
+    // MessagePrecision: One precision per sensor average, lossless where none is given
+    std::vector<double> messagePrecision(const std::vector<double>& per_sensor) {
+        std::vector<double> precision(per_sensor.begin(),
+                                      per_sensor.begin() + std::min(per_sensor.size(), NUM_SENSORS));
+        precision.resize(NUM_SENSORS, 0.0);
+        return precision;
+    }
+}
+
+// Constructor: Field layout of an MQMessage
+MessageCodec::MessageCodec(const std::vector<double>& precision)
+    : m_encoder(INTEGERS, messagePrecision(precision))
+    , m_decoder(INTEGERS, VALUES)
+    , m_frame(nullptr)
+    , m_integers{}
+    , m_values{}
+{}
+
+// Begin: Encoded fields start behind the frame header
+bool MessageCodec::begin(char* out, size_t capacity) {
+    m_frame = out;
+    if (capacity < sizeof(CompressedBatchHeader)) {
+        return false;
+    }
+    return m_encoder.begin(reinterpret_cast<unsigned char*>(out) + sizeof(CompressedBatchHeader),
+                           capacity - sizeof(CompressedBatchHeader));
+}
+
+// Append: Flatten the message into codec fields
+bool MessageCodec::append(const MQMessage& msg) {
+    m_integers[0] = msg.msg_id;
+    m_integers[1] = epochCount(msg.timestamp);
+    m_integers[2] = msg.stages.generated_ns;
+    // Later stamps as offsets: small, and zero when a stage did not stamp
+    m_integers[3] = msg.stages.popped_ns - msg.stages.generated_ns;
+    m_integers[4] = msg.stages.sent_ns - msg.stages.popped_ns;
+    std::copy(msg.avg_values.begin(), msg.avg_values.end(), m_values);
+    return m_encoder.append(m_integers, m_values);
+}
+
+// Finish: Header in front of the encoded bytes
+size_t MessageCodec::finish() {
+    const size_t bytes = m_encoder.finish();
+    const CompressedBatchHeader header{MAGIC, static_cast<uint32_t>(m_encoder.records()),
+                                       static_cast<uint32_t>(bytes), 0};
+    std::memcpy(m_frame, &header, sizeof(header));
+    return sizeof(header) + bytes;
+}
+
+// Count: Returns messages appended since begin()
+size_t MessageCodec::count() const {
+    return m_encoder.records();
+}
+
+// Decode: Inverse of append() for every message of the frame
+bool MessageCodec::decode(const char* frame, size_t length, std::vector<MQMessage>& out) {
+    if (!isFrame(frame, length)) {
+        return false;
+    }
+    CompressedBatchHeader header;
+    std::memcpy(&header, frame, sizeof(header));
+    if (header.bytes > length - sizeof(header) || header.count > m_decoder.maxRecords(header.bytes)
+        || !m_decoder.begin(reinterpret_cast<const unsigned char*>(frame) + sizeof(header), header.bytes)) {
+        return false;
+    }
+
+    out.resize(header.count);
+    for (MQMessage& msg : out) {
+        if (!m_decoder.next(m_integers, m_values)) {
+            return false;
+        }
+        msg.msg_id = m_integers[0];
+        msg.timestamp = fromEpochCount(m_integers[1]);
+        msg.stages.generated_ns = m_integers[2];
+        msg.stages.popped_ns = m_integers[2] + m_integers[3];
+        msg.stages.sent_ns = msg.stages.popped_ns + m_integers[4];
+        std::copy(m_values, m_values + NUM_SENSORS, msg.avg_values.begin());
+    }
+    return true;
+}
+
+// IsFrame: Magic and a header that fits
+bool MessageCodec::isFrame(const char* data, size_t length) {
+    uint32_t magic = 0;
+    if (length >= sizeof(CompressedBatchHeader)) {
+        std::memcpy(&magic, data, sizeof(magic));
+    }
+    return magic == MAGIC;
+}
+
+// Constructor: One value field per channel behind the timestamp
+BlockCodec::BlockCodec(const std::vector<double>& precision)
+    : m_channels(precision.size())
+    , m_encoder(1, precision)
+    , m_decoder(1, precision.size())
+{}
+
+// Encode: One record per sample, read across the columns with a stride of length
+size_t BlockCodec::encode(uint64_t first_msg_id, const StageTimes& stages,
+                          const std::chrono::system_clock::time_point* timestamps, const double* values,
+                          size_t stride, size_t length, char* out, size_t capacity) {
+    if (capacity < sizeof(CompressedBlockHeader)
+        || !m_encoder.begin(reinterpret_cast<unsigned char*>(out) + sizeof(CompressedBlockHeader),
+                            capacity - sizeof(CompressedBlockHeader))) {
+        return 0;
+    }
+    for (size_t s = 0; s < length; ++s) {
+        const uint64_t timestamp = epochCount(timestamps[s]);
+        if (!m_encoder.append(&timestamp, values + s, stride)) {
+            return 0;
+        }
+    }
+
+    const size_t bytes = m_encoder.finish();
+    const CompressedBlockHeader header{MAGIC, static_cast<uint32_t>(m_channels), static_cast<uint32_t>(length),
+                                       static_cast<uint32_t>(bytes), first_msg_id, stages};
+    std::memcpy(out, &header, sizeof(header));
+    return sizeof(header) + bytes;
+}
+
+// Decode: Samples straight into their column positions
+bool BlockCodec::decode(const char* frame, size_t length, DecodedBlock& block) {
+    if (!isFrame(frame, length)) {
+        return false;
+    }
+    CompressedBlockHeader header;
+    std::memcpy(&header, frame, sizeof(header));
+    // Every channel of every record takes at least one bit, so the encoded size bounds both
+    // counts before the decoder and the block are sized by them
+    if (header.bytes > length - sizeof(header) || header.channels > size_t{header.bytes} * 8) {
+        return false;
+    }
+    if (m_decoder.values() != header.channels) {
+        m_decoder = TelemetryDecoder(1, header.channels);
+    }
+    if (header.length > m_decoder.maxRecords(header.bytes)
+        || !m_decoder.begin(reinterpret_cast<const unsigned char*>(frame) + sizeof(header), header.bytes)) {
+        return false;
+    }
+
+    block.first_msg_id = header.first_msg_id;
+    block.channels = header.channels;
+    block.length = header.length;
+    block.stages = header.stages;
+    block.timestamps.resize(header.length);
+    block.values.resize(static_cast<size_t>(header.channels) * header.length);
+    for (size_t s = 0; s < header.length; ++s) {
+        uint64_t timestamp = 0;
+        if (!m_decoder.next(&timestamp, block.values.data() + s, header.length)) {
+            return false;
+        }
+        block.timestamps[s] = fromEpochCount(timestamp);
+    }
+    return true;
+}
+
+// Channels: Returns channels the encoder was built for
+size_t BlockCodec::channels() const {
+    return m_channels;
+}
+
+// MaxFrameBytes: Header, a table run per channel and every field at its worst
+size_t BlockCodec::maxFrameBytes(size_t channels, size_t length) {
+    const size_t record_bits = INTEGER_BITS + channels * QUANTIZED_BITS;
+    return sizeof(CompressedBlockHeader) + (channels * TABLE_RUN_BITS + 7) / 8
+           + length * ((record_bits + 7) / 8);
+}
+
+// IsFrame: Magic and a header that fits
+bool BlockCodec::isFrame(const char* data, size_t length) {
+    uint32_t magic = 0;
+    if (length >= sizeof(CompressedBlockHeader)) {
+        std::memcpy(&magic, data, sizeof(magic));
+    }
+    return magic == MAGIC;
+}
+
+// ParsePrecision: Apply the assignments in order over a lossless default
+std::vector<double> parsePrecision(const ChannelRegistry& channels,
+                                   const std::vector<std::string>& assignments) {
+    std::vector<double> precision(channels.size(), 0.0);
+    for (const std::string& assignment : assignments) {
+        const size_t eq = assignment.find('=');
+        if (eq == std::string::npos || eq == 0 || eq + 1 == assignment.size()) {
+            throw std::invalid_argument("Precision assignments take the form CHANNEL=STEP: " + assignment);
+        }
+        const std::string pattern = assignment.substr(0, eq);
+        const std::string text = assignment.substr(eq + 1);
+
+        double step = 0.0;
+        if (text != "lossless") {
+            size_t used = 0;
+            try {
+                step = std::stod(text, &used);
+            } catch (const std::logic_error&) {
+                used = 0;
+            }
+            if (used != text.size() || !(step > 0.0) || !std::isfinite(step)) {
+                throw std::invalid_argument("Precision must be a positive number or \"lossless\": " + assignment);
+            }
+        }
+
+        const std::vector<size_t> matched = channels.find(pattern);
+        if (matched.empty()) {
+            throw std::invalid_argument("Precision pattern matches no channel: " + pattern);
+        }
+        for (size_t ch : matched) {
+            precision[ch] = step;
+        }
+    }
+    return precision;
+}
+
+} // namespace sensor
@@ -0,0 +1,644 @@
+#include "time_series_store.hpp"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
+namespace sensor {
+
+namespace {
+    // Levels a query can read: the raw ring, then every rollup tier
+    constexpr size_t LEVELS = 1 + TimeSeriesStore::TIER_COUNT;
+
+    // Copies retried after the writer overwrote part of what was read, before giving up
+    // on those buckets
+    constexpr int COPY_ATTEMPTS = 4;
+
+    // AlignDown: Start of the width-wide bucket holding t, also for times before the epoch
+    inline int64_t alignDown(int64_t t, int64_t width) {
+        const int64_t remainder = t % width;
+        return remainder < 0 ? t - remainder - width : t - remainder;
+    }
+
+    // AlignUp: First multiple of width at or after t
+    inline int64_t alignUp(int64_t t, int64_t width) {
+        const int64_t down = alignDown(t, width);
+        return down == t ? t : down + width;
+    }
+
+    // Oldest: First slot index still held by a ring that has been filled count times
+    inline uint64_t oldest(uint64_t count, size_t capacity) {
+        return count > capacity ? count - capacity : 0;
+    }
+
+    // TierName: "1 s", "1 min" or "1 h" style width of a rollup tier
+    std::string tierName(int64_t width_ns) {
+        constexpr int64_t SECOND = 1000000000LL;
+        if (width_ns % (3600 * SECOND) == 0) {
+            return std::to_string(width_ns / (3600 * SECOND)) + " h";
+        }
+        if (width_ns % (60 * SECOND) == 0) {
+            return std::to_string(width_ns / (60 * SECOND)) + " min";
+        }
+        return std::to_string(width_ns / SECOND) + " s";
+    }
+
+    // Advance: Fold one sample time into the open bucket starts and counts of every tier.
+    // Each tier whose bucket the time leaves is closed, closed(tier, start, count) called
+    // for it, and its counts merged into the tier above. Returns the number of tiers closed.
+    template<typename Closed>
+    size_t advance(int64_t t, int64_t* start, uint64_t* count, Closed closed) {
+        constexpr size_t TIERS = TimeSeriesStore::TIER_COUNT;
+        size_t closes = 0;
+        while (closes < TIERS && count[closes] > 0
+               && alignDown(t, TimeSeriesStore::TIERS[closes].width_ns) != start[closes]) {
+            closed(closes, start[closes], count[closes]);
+            if (closes + 1 < TIERS) {
+                if (count[closes + 1] == 0) {
+                    start[closes + 1] = alignDown(start[closes], TimeSeriesStore::TIERS[closes + 1].width_ns);
+                }
+                count[closes + 1] += count[closes];
+            }
+            count[closes] = 0;
+            ++closes;
+        }
+        if (count[0] == 0) {
+            start[0] = alignDown(t, TimeSeriesStore::TIERS[0].width_ns);
+        }
+        ++count[0];
+        return closes;
+    }
+
+    // AppendNumber: Shortest round-trip text of a value, then a separator
+    template<typename T>
+    void appendNumber(std::string& out, T value, char separator) {
+        char digits[32];
+        const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+        out.append(digits, result.ptr);
+        out += separator;
+    }
+
+    // ParseSeconds: Decimal seconds of a query parameter
+    double parseSeconds(const std::string& name, const std::string& text) {
+        size_t used = 0;
+        double seconds = 0.0;
+        try {
+            seconds = std::stod(text, &used);
+        } catch (const std::exception&) {
+            used = 0;
+        }
+        if (used == 0 || used != text.size() || !std::isfinite(seconds)) {
+            throw std::invalid_argument("Malformed " + name + ": " + text);
+        }
+        return seconds;
+    }
+
+    // PercentDecode: URL query component with '+' as a space
+    std::string percentDecode(const std::string& text) {
+        std::string out;
+        for (size_t i = 0; i < text.size(); ++i) {
+            if (text[i] == '+') {
+                out += ' ';
+            } else if (text[i] == '%' && i + 2 < text.size() && std::isxdigit(static_cast<unsigned char>(text[i + 1]))
+                       && std::isxdigit(static_cast<unsigned char>(text[i + 2]))) {
+                out += static_cast<char>(std::stoi(text.substr(i + 1, 2), nullptr, 16));
+                i += 2;
+            } else {
+                out += text[i];
+            }
+        }
+        return out;
+    }
+}
+
+// Constructor: Every ring and open bucket at full size, so ingestion never allocates
+TimeSeriesStore::TimeSeriesStore(size_t channels, size_t raw_samples, size_t block)
+    : m_channels(channels)
+    , m_tiers(new Ring[TIER_COUNT])
+    , m_times(std::max<size_t>(block, 1))
+    , m_pending{}
+    , m_newest(std::numeric_limits<int64_t>::min())
+{
+    if (channels == 0 || raw_samples == 0) {
+        throw std::invalid_argument("TimeSeriesStore requires at least one channel and one raw sample");
+    }
+
+    m_raw.width = 0;
+    m_raw.capacity = raw_samples;
+    m_raw.start.assign(raw_samples, 0);
+    m_raw.min.assign(channels * raw_samples, 0.0);
+    m_raw.claim.store(0, std::memory_order_relaxed);
+    m_raw.head.store(0, std::memory_order_relaxed);
+
+    for (size_t t = 0; t < TIER_COUNT; ++t) {
+        Ring& ring = m_tiers[t];
+        ring.width = TIERS[t].width_ns;
+        ring.capacity = TIERS[t].buckets;
+        ring.start.assign(ring.capacity, 0);
+        ring.count.assign(ring.capacity, 0);
+        ring.min.assign(channels * ring.capacity, 0.0);
+        ring.max.assign(channels * ring.capacity, 0.0);
+        ring.sum.assign(channels * ring.capacity, 0.0);
+        ring.claim.store(0, std::memory_order_relaxed);
+        ring.head.store(0, std::memory_order_relaxed);
+
+        OpenBucket open;
+        open.start = 0;
+        open.count = 0;
+        open.min.assign(channels, std::numeric_limits<double>::infinity());
+        open.max.assign(channels, -std::numeric_limits<double>::infinity());
+        open.sum.assign(channels, 0.0);
+        m_open.push_back(std::move(open));
+    }
+    m_boundaries.reserve(m_times.size());
+}
+
+// Push: A block of one sample, values laid out one per channel
+void TimeSeriesStore::push(TimePoint time, const double* values) {
+    begin(&time, 1);
+    for (size_t ch = 0; ch < m_channels; ++ch) {
+        pushChannel(ch, &values[ch], 1);
+    }
+    commit();
+}
+
+// PushBlock: All three phases on the calling thread
+void TimeSeriesStore::pushBlock(const SampleBlock& block) {
+    beginBlock(block);
+    pushChannels(block, 0, m_channels);
+    commitBlock(block);
+}
+
+// BeginBlock: Shared per-sample work, before any channel is written
+void TimeSeriesStore::beginBlock(const SampleBlock& block) {
+    begin(block.timestamps(), block.length());
+}
+
+// PushChannels: Columns are contiguous, so each channel is one linear pass
+void TimeSeriesStore::pushChannels(const SampleBlock& block, size_t first, size_t last) {
+    const size_t length = block.length();
+    for (size_t ch = first; ch < last; ++ch) {
+        pushChannel(ch, block.column(ch), length);
+    }
+}
+
+// CommitBlock: Make the block visible to queries
+void TimeSeriesStore::commitBlock(const SampleBlock&) {
+    commit();
+}
+
+// Begin: Announce every slot the block will overwrite before writing any of them, then fill
+// in the fields shared by all channels
+void TimeSeriesStore::begin(const TimePoint* times, size_t length) {
+    if (m_times.size() < length) {
+        m_times.resize(length);
+    }
+    for (size_t k = 0; k < length; ++k) {
+        const int64_t t = std::chrono::duration_cast<std::chrono::nanoseconds>(times[k].time_since_epoch()).count();
+        m_newest = std::max(m_newest, t);
+        m_times[k] = m_newest;
+    }
+
+    // First pass on copies of the open buckets: where buckets close and how many per tier
+    int64_t start[TIER_COUNT];
+    uint64_t count[TIER_COUNT];
+    for (size_t t = 0; t < TIER_COUNT; ++t) {
+        start[t] = m_open[t].start;
+        count[t] = m_open[t].count;
+        m_pending[t] = 0;
+    }
+    m_boundaries.clear();
+    for (size_t k = 0; k < length; ++k) {
+        const size_t closes = advance(m_times[k], start, count,
+                                      [this](size_t tier, int64_t, uint64_t) { ++m_pending[tier]; });
+        if (closes > 0) {
+            m_boundaries.push_back(Boundary{k, closes});
+        }
+    }
+
+    // Readers that copy any of these slots from now on will discard them
+    const uint64_t raw_head = m_raw.head.load(std::memory_order_relaxed);
+    m_raw.claim.store(raw_head + length, std::memory_order_relaxed);
+    for (size_t t = 0; t < TIER_COUNT; ++t) {
+        if (m_pending[t] > 0) {
+            Ring& ring = m_tiers[t];
+            ring.claim.store(ring.head.load(std::memory_order_relaxed) + m_pending[t], std::memory_order_relaxed);
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // Raw sample times; only the last capacity of an oversized block survive
+    const size_t skip = length > m_raw.capacity ? length - m_raw.capacity : 0;
+    for (size_t k = skip; k < length; ++k) {
+        m_raw.start[(raw_head + k) % m_raw.capacity] = m_times[k];
+    }
+
+    // Second pass for real: start and count of every bucket that closes
+    uint64_t written[TIER_COUNT];
+    int64_t open_start[TIER_COUNT];
+    uint64_t open_count[TIER_COUNT];
+    for (size_t t = 0; t < TIER_COUNT; ++t) {
+        written[t] = m_tiers[t].head.load(std::memory_order_relaxed);
+        open_start[t] = m_open[t].start;
+        open_count[t] = m_open[t].count;
+    }
+    for (size_t k = 0; k < length; ++k) {
+        advance(m_times[k], open_start, open_count, [&](size_t tier, int64_t bucket_start, uint64_t samples) {
+            Ring& ring = m_tiers[tier];
+            const size_t slot = written[tier]++ % ring.capacity;
+            ring.start[slot] = bucket_start;
+            ring.count[slot] = samples;
+        });
+    }
+    for (size_t t = 0; t < TIER_COUNT; ++t) {
+        m_open[t].start = open_start[t];
+        m_open[t].count = open_count[t];
+    }
+}
+
+// PushChannel: Copy the column into the raw ring, then fold it into the open 1 s bucket,
+// closing buckets at the boundaries begin() found; only this channel's values are touched
+void TimeSeriesStore::pushChannel(size_t channel, const double* column, size_t length) {
+    const size_t capacity = m_raw.capacity;
+    const size_t skip = length > capacity ? length - capacity : 0;
+    uint64_t index = m_raw.head.load(std::memory_order_relaxed) + skip;
+    double* raw = &m_raw.min[channel * capacity];
+    for (size_t k = skip; k < length;) {
+        const size_t slot = index % capacity;
+        const size_t run = std::min(length - k, capacity - slot);
+        std::copy(column + k, column + k + run, raw + slot);
+        k += run;
+        index += run;
+    }
+
+    uint64_t written[TIER_COUNT];
+    for (size_t t = 0; t < TIER_COUNT; ++t) {
+        written[t] = m_tiers[t].head.load(std::memory_order_relaxed);
+    }
+
+    OpenBucket& second = m_open[0];
+    double lo = second.min[channel];
+    double hi = second.max[channel];
+    double total = second.sum[channel];
+    size_t k = 0;
+    for (const Boundary& boundary : m_boundaries) {
+        for (; k < boundary.sample; ++k) {
+            const double value = column[k];
+            lo = value < lo ? value : lo;
+            hi = value > hi ? value : hi;
+            total += value;
+        }
+
+        // Close tiers bottom up, each merged into the one above before that one closes
+        double bucket_min = lo;
+        double bucket_max = hi;
+        double bucket_sum = total;
+        for (size_t t = 0; t < boundary.closes; ++t) {
+            if (t > 0) {
+                OpenBucket& open = m_open[t];
+                bucket_min = open.min[channel];
+                bucket_max = open.max[channel];
+                bucket_sum = open.sum[channel];
+                open.min[channel] = std::numeric_limits<double>::infinity();
+                open.max[channel] = -std::numeric_limits<double>::infinity();
+                open.sum[channel] = 0.0;
+            }
+            Ring& ring = m_tiers[t];
+            const size_t slot = channel * ring.capacity + written[t]++ % ring.capacity;
+            ring.min[slot] = bucket_min;
+            ring.max[slot] = bucket_max;
+            ring.sum[slot] = bucket_sum;
+            if (t + 1 < TIER_COUNT) {
+                OpenBucket& above = m_open[t + 1];
+                above.min[channel] = std::min(above.min[channel], bucket_min);
+                above.max[channel] = std::max(above.max[channel], bucket_max);
+                above.sum[channel] += bucket_sum;
+            }
+        }
+        lo = std::numeric_limits<double>::infinity();
+        hi = -std::numeric_limits<double>::infinity();
+        total = 0.0;
+    }
+    for (; k < length; ++k) {
+        const double value = column[k];
+        lo = value < lo ? value : lo;
+        hi = value > hi ? value : hi;
+        total += value;
+    }
+    second.min[channel] = lo;
+    second.max[channel] = hi;
+    second.sum[channel] = total;
+}
+
+// Commit: Release every announced slot to readers
+void TimeSeriesStore::commit() {
+    m_raw.head.store(m_raw.claim.load(std::memory_order_relaxed), std::memory_order_release);
+    for (size_t t = 0; t < TIER_COUNT; ++t) {
+        Ring& ring = m_tiers[t];
+        ring.head.store(ring.claim.load(std::memory_order_relaxed), std::memory_order_release);
+    }
+}
+
+// Query: Walk the range oldest first, taking each stretch from the best level that holds it,
+// and merge what comes back into resolution-wide points
+size_t TimeSeriesStore::query(size_t channel, int64_t from_ns, int64_t to_ns, int64_t resolution_ns,
+                              std::vector<SeriesPoint>& out) const {
+    out.clear();
+    if (channel >= m_channels || from_ns >= to_ns) {
+        return 0;
+    }
+
+    // Preferred level: the coarsest no wider than the resolution
+    bool has[LEVELS];
+    int64_t oldest_ns[LEVELS];
+    int64_t end_ns[LEVELS];
+    size_t preferred = 0;
+    for (size_t l = 0; l < LEVELS; ++l) {
+        has[l] = span(level(l), oldest_ns[l], end_ns[l]);
+        // A ring never overwritten still holds all its level ever had: nothing is older
+        if (has[l] && level(l).claim.load(std::memory_order_relaxed) <= level(l).capacity) {
+            oldest_ns[l] = std::numeric_limits<int64_t>::min();
+        }
+        if (l > 0 && resolution_ns >= level(l).width) {
+            preferred = l;
+        }
+    }
+
+    std::vector<Bucket> buckets;
+    int64_t cursor = from_ns;
+    while (cursor < to_ns) {
+        size_t use = LEVELS;
+        int64_t until = to_ns;
+        if (has[preferred] && cursor >= oldest_ns[preferred] && cursor < end_ns[preferred]) {
+            use = preferred;
+            until = end_ns[preferred];
+        } else if (!has[preferred] || cursor >= end_ns[preferred]) {
+            // Newer than the preferred level holds yet: the coarsest finer level with data
+            for (size_t l = preferred; l-- > 0;) {
+                if (has[l] && end_ns[l] > cursor && (use == LEVELS || oldest_ns[l] <= cursor)) {
+                    use = l;
+                    if (oldest_ns[l] <= cursor) {
+                        break;
+                    }
+                }
+            }
+            if (use != LEVELS) {
+                until = end_ns[use];
+            }
+        } else {
+            // Aged out of the preferred level: the finest coarser level that holds cursor
+            for (size_t l = preferred + 1; l < LEVELS; ++l) {
+                if (has[l] && oldest_ns[l] <= cursor && end_ns[l] > cursor) {
+                    use = l;
+                    break;
+                }
+            }
+            if (use == LEVELS) {
+                // Nothing that old is held anywhere: skip to the oldest data after cursor
+                int64_t next = oldest_ns[preferred];
+                for (size_t l = preferred + 1; l < LEVELS; ++l) {
+                    if (has[l] && oldest_ns[l] > cursor) {
+                        next = std::min(next, oldest_ns[l]);
+                    }
+                }
+                cursor = next;
+                continue;
+            }
+            // Hand over to a finer level at the first coarse boundary it fully covers
+            until = end_ns[use];
+            for (size_t l = preferred; l < use; ++l) {
+                if (has[l] && oldest_ns[l] > cursor) {
+                    until = std::min(until, alignUp(oldest_ns[l], level(use).width));
+                }
+            }
+        }
+        if (use == LEVELS) {
+            break;
+        }
+        until = std::min(until, to_ns);
+
+        buckets.clear();
+        copy(level(use), channel, cursor, until, buckets);
+        const int64_t width = level(use).width;
+        for (const Bucket& bucket : buckets) {
+            if (resolution_ns > 0 && width <= resolution_ns) {
+                const int64_t start = alignDown(bucket.start, resolution_ns);
+                if (!out.empty() && out.back().start_ns == start && out.back().duration_ns == resolution_ns) {
+                    SeriesPoint& point = out.back();
+                    point.count += bucket.count;
+                    point.min = std::min(point.min, bucket.min);
+                    point.max = std::max(point.max, bucket.max);
+                    point.mean += bucket.sum;
+                    continue;
+                }
+                out.push_back(SeriesPoint{start, resolution_ns, bucket.count, bucket.min, bucket.max, bucket.sum});
+            } else {
+                out.push_back(SeriesPoint{bucket.start, width, bucket.count, bucket.min, bucket.max, bucket.sum});
+            }
+        }
+        cursor = until;
+    }
+
+    // Points carry sums until every bucket has been merged
+    for (SeriesPoint& point : out) {
+        point.mean /= static_cast<double>(point.count);
+    }
+    return out.size();
+}
+
+// Span: Slots the writer has announced are skipped; retried if it announced more meanwhile
+bool TimeSeriesStore::span(const Ring& ring, int64_t& oldest_start, int64_t& end) const {
+    for (;;) {
+        const uint64_t head = ring.head.load(std::memory_order_acquire);
+        if (head == 0) {
+            return false;
+        }
+        const uint64_t tail = std::max(oldest(head, ring.capacity),
+                                       oldest(ring.claim.load(std::memory_order_relaxed), ring.capacity));
+        if (tail >= head) {
+            continue;
+        }
+        const int64_t first = ring.start[tail % ring.capacity];
+        const int64_t last = ring.start[(head - 1) % ring.capacity];
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (tail >= oldest(ring.claim.load(std::memory_order_relaxed), ring.capacity)) {
+            oldest_start = first;
+            end = last + std::max<int64_t>(ring.width, 1);
+            return true;
+        }
+    }
+}
+
+// Copy: Binary search the slot times for from_ns, copy forward to to_ns, then check which
+// slots the writer announced in the meantime. A slot overwritten during the search only ever
+// reads as newer, which moves the search towards older slots, so dropping the overwritten
+// prefix leaves exactly the buckets that were valid throughout; only a copy that stopped
+// early on an overwritten slot is repeated.
+void TimeSeriesStore::copy(const Ring& ring, size_t channel, int64_t from_ns, int64_t to_ns,
+                           std::vector<Bucket>& out) const {
+    const size_t capacity = ring.capacity;
+    const bool raw = ring.width == 0;
+    const size_t base = out.size();
+    for (int attempt = 1; ; ++attempt) {
+        out.resize(base);
+        const uint64_t head = ring.head.load(std::memory_order_acquire);
+        uint64_t lo = std::min(head, std::max(oldest(head, capacity),
+                                              oldest(ring.claim.load(std::memory_order_relaxed), capacity)));
+        uint64_t hi = head;
+        while (lo < hi) {
+            const uint64_t mid = lo + (hi - lo) / 2;
+            if (ring.start[mid % capacity] < from_ns) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+
+        const uint64_t first = lo;
+        uint64_t index = first;
+        for (; index < head; ++index) {
+            const size_t slot = index % capacity;
+            const int64_t start = ring.start[slot];
+            if (start >= to_ns) {
+                break;
+            }
+            const size_t value = channel * capacity + slot;
+            if (raw) {
+                const double sample = ring.min[value];
+                out.push_back(Bucket{start, 1, sample, sample, sample});
+            } else {
+                out.push_back(Bucket{start, ring.count[slot], ring.min[value], ring.max[value], ring.sum[value]});
+            }
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t valid = oldest(ring.claim.load(std::memory_order_relaxed), capacity);
+        if (first >= valid) {
+            return;
+        }
+        if (index >= valid || attempt == COPY_ATTEMPTS) {
+            const size_t stale = static_cast<size_t>(std::min<uint64_t>(valid - first, out.size() - base));
+            out.erase(out.begin() + static_cast<std::ptrdiff_t>(base),
+                      out.begin() + static_cast<std::ptrdiff_t>(base + stale));
+            return;
+        }
+    }
+}
+
+// Level: Raw ring first, then the tiers in TIERS order
+const TimeSeriesStore::Ring& TimeSeriesStore::level(size_t index) const {
+    return index == 0 ? m_raw : m_tiers[index - 1];
+}
+
+// Report: Allocation, then how much each level currently holds
+void TimeSeriesStore::report(std::ostream& os) const {
+    os << "Store: " << std::fixed << std::setprecision(1) << static_cast<double>(memoryBytes()) / (1 << 20)
+       << " MB for " << m_channels << " channels; raw " << m_raw.capacity << " samples";
+    int64_t oldest_ns = 0;
+    int64_t end_ns = 0;
+    if (span(m_raw, oldest_ns, end_ns)) {
+        os << " (" << static_cast<double>(end_ns - 1 - oldest_ns) / 1e9 << " s held)";
+    }
+    for (size_t t = 0; t < TIER_COUNT; ++t) {
+        const Ring& ring = m_tiers[t];
+        const uint64_t head = ring.head.load(std::memory_order_acquire);
+        os << ", " << tierName(ring.width) << " x " << ring.capacity << " ("
+           << std::min<uint64_t>(head, ring.capacity) << " held)";
+    }
+    os << std::defaultfloat << "\n";
+}
+
+// Channels: Returns number of values per sample
+size_t TimeSeriesStore::channels() const {
+    return m_channels;
+}
+
+// RawCapacity: Returns number of raw samples kept
+size_t TimeSeriesStore::rawCapacity() const {
+    return m_raw.capacity;
+}
+
+// MemoryBytes: Ring storage plus the open buckets
+size_t TimeSeriesStore::memoryBytes() const {
+    size_t bytes = m_raw.start.size() * sizeof(int64_t) + m_raw.min.size() * sizeof(double);
+    for (size_t t = 0; t < TIER_COUNT; ++t) {
+        const Ring& ring = m_tiers[t];
+        bytes += ring.start.size() * sizeof(int64_t) + ring.count.size() * sizeof(uint64_t)
+                 + (ring.min.size() + ring.max.size() + ring.sum.size()) * sizeof(double);
+        bytes += 3 * m_channels * sizeof(double);
+    }
+    return bytes;
+}
+
+// SeriesCsv: Parse the parameters, run one query and print a header row plus one row per point
+std::string seriesCsv(const TimeSeriesStore& store, const ChannelRegistry& channels,
+                      const std::string& params) {
+    std::string name;
+    double from = -60.0;
+    double to = 0.0;
+    double step = 0.0;
+    size_t pos = 0;
+    while (pos < params.size()) {
+        size_t next = params.find('&', pos);
+        if (next == std::string::npos) {
+            next = params.size();
+        }
+        const std::string pair = params.substr(pos, next - pos);
+        const size_t equals = pair.find('=');
+        const std::string key = pair.substr(0, equals);
+        const std::string value = equals == std::string::npos ? std::string() : percentDecode(pair.substr(equals + 1));
+        if (key == "channel") {
+            name = value;
+        } else if (key == "from") {
+            from = parseSeconds(key, value);
+        } else if (key == "to") {
+            to = parseSeconds(key, value);
+        } else if (key == "step") {
+            step = parseSeconds(key, value);
+            if (step < 0.0) {
+                throw std::invalid_argument("step must not be negative");
+            }
+        } else if (!key.empty()) {
+            throw std::invalid_argument("Unknown parameter: " + key);
+        }
+        pos = next + 1;
+    }
+
+    size_t channel = channels.size();
+    for (size_t ch = 0; ch < channels.size(); ++ch) {
+        if (channels[ch].name == name) {
+            channel = ch;
+            break;
+        }
+    }
+    if (channel == channels.size()) {
+        throw std::invalid_argument("Unknown channel: " + name);
+    }
+
+    // Zero and negative times count back from now
+    const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    const auto toNanos = [now](double seconds) {
+        const int64_t ns = std::llround(seconds * 1e9);
+        return seconds <= 0.0 ? now + ns : ns;
+    };
+
+    std::vector<SeriesPoint> points;
+    store.query(channel, toNanos(from), toNanos(to), std::llround(step * 1e9), points);
+
+    std::string csv = "start_ns,duration_ns,count,min,max,mean\n";
+    for (const SeriesPoint& point : points) {
+        appendNumber(csv, point.start_ns, ',');
+        appendNumber(csv, point.duration_ns, ',');
+        appendNumber(csv, point.count, ',');
+        appendNumber(csv, point.min, ',');
+        appendNumber(csv, point.max, ',');
+        appendNumber(csv, point.mean, '\n');
+    }
+    return csv;
+}
+
+} // namespace sensor
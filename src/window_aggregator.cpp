@@ -0,0 +1,207 @@
+#include "window_aggregator.hpp"
+#include "stats_kernels.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace sensor {
+
+// Constructor: Validate dimensions, then lay out the shared history and every deque ring
+WindowAggregator::WindowAggregator(size_t channels, const std::vector<size_t>& windows)
+    : m_channels(channels)
+    , m_history_capacity(0)
+    , m_history_mask(0)
+    , m_position(0)
+{
+    if (channels == 0 || windows.empty()) {
+        throw std::invalid_argument("WindowAggregator requires at least one channel and window");
+    }
+
+    size_t longest = 0;
+    size_t deque_slots = 0;
+    m_windows.resize(windows.size());
+    for (size_t w = 0; w < windows.size(); ++w) {
+        if (windows[w] == 0 || windows[w] >= (size_t{1} << 31)) {
+            throw std::invalid_argument("WindowAggregator windows must hold 1 to 2^31 - 1 samples");
+        }
+        Window& window = m_windows[w];
+        window.length = windows[w];
+        // push() expires before it appends, so a deque holds at most length positions
+        const size_t ring = roundUpPow2(window.length);
+        window.deque_mask = ring - 1;
+        window.states.resize(channels);
+        for (ChannelState& state : window.states) {
+            state.min.offset = deque_slots;
+            state.max.offset = deque_slots + ring;
+            deque_slots += 2 * ring;
+        }
+        longest = std::max(longest, window.length);
+    }
+
+    m_history_capacity = roundUpPow2(longest);
+    m_history_mask = m_history_capacity - 1;
+    m_history.assign(channels * m_history_capacity, 0.0);
+    m_deque_storage.assign(deque_slots, 0);
+}
+
+// ValueAt: History lookup; valid for the last m_history_capacity positions
+double WindowAggregator::valueAt(size_t channel, uint64_t position) const {
+    return m_history[channel * m_history_capacity + (position & m_history_mask)];
+}
+
+// Push: Evict, store, then fold the new value into every window of every channel
+void WindowAggregator::push(const double* values) {
+    const uint64_t position = m_position;
+
+    for (size_t ch = 0; ch < m_channels; ++ch) {
+        const double x = values[ch];
+
+        for (Window& window : m_windows) {
+            ChannelState& state = window.states[ch];
+            const size_t length = window.length;
+
+            // Sliding Welford: remove the evicted sample before the history slot is reused
+            size_t n = window.count;
+            if (n == length) {
+                const double y = valueAt(ch, position - length);
+                if (n == 1) {
+                    state.mean = 0.0;
+                    state.m2 = 0.0;
+                } else {
+                    const double old_mean = state.mean;
+                    const double old_m2 = state.m2;
+                    state.mean -= (y - old_mean) / static_cast<double>(n - 1);
+                    state.m2 = std::max(0.0, old_m2 - (y - old_mean) * (y - state.mean));
+                    if (old_m2 > CANCELLATION_RATIO * state.m2) {
+                        window.cancelled = true;
+                    }
+                }
+                --n;
+            }
+            const double delta = x - state.mean;
+            state.mean += delta / static_cast<double>(n + 1);
+            state.m2 += delta * (x - state.mean);
+        }
+
+        m_history[ch * m_history_capacity + (position & m_history_mask)] = x;
+
+        for (Window& window : m_windows) {
+            ChannelState& state = window.states[ch];
+            uint32_t* ring = m_deque_storage.data();
+            const uint64_t mask = window.deque_mask;
+            const uint32_t now = static_cast<uint32_t>(position);
+
+            // Max deque: expire positions from the front first, so the ring never holds more
+            // than length entries, then drop smaller-or-equal values from the back
+            MonotonicDeque& max = state.max;
+            while (max.head != max.tail
+                   && static_cast<uint32_t>(now - ring[max.offset + (max.head & mask)]) >= window.length) {
+                ++max.head;
+            }
+            while (max.tail != max.head && valueAt(ch, ring[max.offset + ((max.tail - 1) & mask)]) <= x) {
+                --max.tail;
+            }
+            ring[max.offset + (max.tail++ & mask)] = now;
+
+            // Min deque: mirror image
+            MonotonicDeque& min = state.min;
+            while (min.head != min.tail
+                   && static_cast<uint32_t>(now - ring[min.offset + (min.head & mask)]) >= window.length) {
+                ++min.head;
+            }
+            while (min.tail != min.head && valueAt(ch, ring[min.offset + ((min.tail - 1) & mask)]) >= x) {
+                --min.tail;
+            }
+            ring[min.offset + (min.tail++ & mask)] = now;
+        }
+    }
+
+    ++m_position;
+    for (Window& window : m_windows) {
+        window.count = std::min(window.count + 1, window.length);
+
+        // Amortized O(1): one O(window) recomputation every RENORMALIZE_PASSES * window pushes,
+        // or every window length while evictions keep cancelling
+        ++window.since_renormalize;
+        if (window.since_renormalize >= RENORMALIZE_PASSES * window.length
+            || (window.cancelled && window.since_renormalize >= window.length)) {
+            renormalize(window);
+        }
+    }
+}
+
+// Stats: Read every channel's moments and deque fronts for one window
+void WindowAggregator::stats(size_t window, double* mean, double* min, double* max,
+                             double* variance) const {
+    const Window& w = m_windows.at(window);
+    const uint32_t* ring = m_deque_storage.data();
+
+    for (size_t ch = 0; ch < m_channels; ++ch) {
+        const ChannelState& state = w.states[ch];
+        if (w.count == 0) {
+            mean[ch] = min[ch] = max[ch] = variance[ch] = 0.0;
+            continue;
+        }
+        mean[ch] = state.mean;
+        variance[ch] = w.count > 1 ? state.m2 / static_cast<double>(w.count - 1) : 0.0;
+        min[ch] = valueAt(ch, ring[state.min.offset + (state.min.head & w.deque_mask)]);
+        max[ch] = valueAt(ch, ring[state.max.offset + (state.max.head & w.deque_mask)]);
+    }
+}
+
+// Renormalize: Two-pass mean and squared deviations over the samples actually in the
+// window, which lie in one or two contiguous runs of each history column
+void WindowAggregator::renormalize(Window& window) {
+    const StatsKernels& kernels = statsKernels();
+    const size_t start = static_cast<size_t>((m_position - window.count) & m_history_mask);
+    const size_t head = std::min(window.count, m_history_capacity - start);
+    const size_t wrapped = window.count - head;
+    for (size_t ch = 0; ch < m_channels; ++ch) {
+        const double* column = m_history.data() + ch * m_history_capacity;
+        const double sum = kernels.sum(column + start, head) + kernels.sum(column, wrapped);
+        const double mean = sum / static_cast<double>(window.count);
+        window.states[ch].mean = mean;
+        window.states[ch].m2 = kernels.sumSquares(column + start, head, mean)
+                             + kernels.sumSquares(column, wrapped, mean);
+    }
+    window.since_renormalize = 0;
+    window.cancelled = false;
+}
+
+// Reset: Return every window to the empty state without releasing memory
+void WindowAggregator::reset() {
+    for (Window& window : m_windows) {
+        window.count = 0;
+        window.since_renormalize = 0;
+        window.cancelled = false;
+        for (ChannelState& state : window.states) {
+            state.mean = 0.0;
+            state.m2 = 0.0;
+            state.min.head = state.min.tail = 0;
+            state.max.head = state.max.tail = 0;
+        }
+    }
+    std::fill(m_history.begin(), m_history.end(), 0.0);
+    m_position = 0;
+}
+
+// Channels: Returns number of channels tracked
+size_t WindowAggregator::channels() const {
+    return m_channels;
+}
+
+// WindowCount: Returns number of windows
+size_t WindowAggregator::windowCount() const {
+    return m_windows.size();
+}
+
+// WindowLength: Returns maximum samples in one window
+size_t WindowAggregator::windowLength(size_t window) const {
+    return m_windows.at(window).length;
+}
+
+// Count: Returns samples currently in one window
+size_t WindowAggregator::count(size_t window) const {
+    return m_windows.at(window).count;
+}
+
+} // namespace sensor
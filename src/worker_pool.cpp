@@ -0,0 +1,161 @@
+#include "worker_pool.hpp"
+#include "realtime.hpp"
+#include <stdexcept>
+
+namespace sensor {
+
+namespace {
+    // PackRange: Shards [begin, end) as one word that a single CAS can update
+    inline uint64_t packRange(uint64_t begin, uint64_t end) {
+        return begin | (end << 32);
+    }
+}
+
+// Constructor: One range slot per thread, and every thread but the caller's started asleep
+WorkerPool::WorkerPool(size_t threads, const ThreadPolicy& policy)
+    : m_queues(threads)
+    , m_task(nullptr)
+    , m_pending(0)
+    , m_steals(0)
+    , m_generation(0)
+    , m_stop(false)
+{
+    if (threads == 0) {
+        throw std::invalid_argument("WorkerPool requires at least one thread");
+    }
+
+    // Priority only: the processor thread's CPU belongs to worker 0 alone
+    const ThreadPolicy worker_policy{policy.rt_priority, -1};
+    m_workers.reserve(threads - 1);
+    for (size_t i = 1; i < threads; ++i) {
+        m_workers.emplace_back(&WorkerPool::workerLoop, this, i, worker_policy);
+    }
+}
+
+// Destructor: Wake every worker with the stop flag set and wait for them
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& worker : m_workers) {
+        worker.join();
+    }
+}
+
+// Run: Deal contiguous ranges, wake the workers, work as thread 0 and wait for the stragglers
+void WorkerPool::run(size_t shards, const Task& task) {
+    if (shards == 0) {
+        return;
+    }
+    if (m_workers.empty()) {
+        for (size_t shard = 0; shard < shards; ++shard) {
+            task(shard);
+        }
+        return;
+    }
+
+    // The previous run has fully finished, so no thread is touching the ranges or the task
+    m_task.store(&task, std::memory_order_relaxed);
+    m_pending.store(shards, std::memory_order_relaxed);
+    const size_t threads = m_queues.size();
+    for (size_t i = 0; i < threads; ++i) {
+        m_queues[i].range.store(packRange(shards * i / threads, shards * (i + 1) / threads),
+                                std::memory_order_release);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    drain(0);
+
+    // Shards stolen from this thread may still be running elsewhere
+    while (m_pending.load(std::memory_order_acquire) != 0) {
+        std::this_thread::yield();
+    }
+}
+
+// Threads: Returns the number of threads sharing each run
+size_t WorkerPool::threads() const {
+    return m_queues.size();
+}
+
+// Steals: Returns shards run outside the range they were dealt to
+uint64_t WorkerPool::steals() const {
+    return m_steals.load(std::memory_order_relaxed);
+}
+
+// WorkerLoop: Each generation is one run(); a worker that wakes late simply finds nothing left
+void WorkerPool::workerLoop(size_t index, ThreadPolicy policy) {
+    applyThreadPolicy(policy, "worker");
+
+    uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop) {
+                return;
+            }
+            seen = m_generation;
+        }
+        drain(index);
+    }
+}
+
+// Drain: Own shards front to back first, then steal until every range is empty
+void WorkerPool::drain(size_t index) {
+    size_t shard;
+    while (popFront(index, shard) || steal(index, shard)) {
+        // Claiming a shard acquired the ranges published after the task pointer
+        (*m_task.load(std::memory_order_relaxed))(shard);
+        m_pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+}
+
+// PopFront: Advance begin; fails once the range is empty, stolen down to nothing included
+bool WorkerPool::popFront(size_t index, size_t& shard) {
+    std::atomic<uint64_t>& range = m_queues[index].range;
+    uint64_t current = range.load(std::memory_order_acquire);
+    while (true) {
+        const uint64_t begin = current & 0xFFFFFFFFu;
+        const uint64_t end = current >> 32;
+        if (begin >= end) {
+            return false;
+        }
+        if (range.compare_exchange_weak(current, packRange(begin + 1, end),
+                                        std::memory_order_acquire, std::memory_order_acquire)) {
+            shard = static_cast<size_t>(begin);
+            return true;
+        }
+    }
+}
+
+// Steal: Take from the back of the next non-empty range, away from where its owner is working
+bool WorkerPool::steal(size_t thief, size_t& shard) {
+    const size_t threads = m_queues.size();
+    for (size_t offset = 1; offset < threads; ++offset) {
+        std::atomic<uint64_t>& range = m_queues[(thief + offset) % threads].range;
+        uint64_t current = range.load(std::memory_order_acquire);
+        while (true) {
+            const uint64_t begin = current & 0xFFFFFFFFu;
+            const uint64_t end = current >> 32;
+            if (begin >= end) {
+                break;
+            }
+            if (range.compare_exchange_weak(current, packRange(begin, end - 1),
+                                            std::memory_order_acquire, std::memory_order_acquire)) {
+                shard = static_cast<size_t>(end - 1);
+                m_steals.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+} // namespace sensor
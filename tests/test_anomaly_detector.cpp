@@ -0,0 +1,267 @@
+// AnomalyDetector thresholds, re-arming and the CUSUM clamp on readings placed at exact
+// z-scores of the built-in channels, and the block path against the reading path.
+
+#include "test_framework.hpp"
+#include "anomaly_detector.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace sensor;
+
+namespace {
+    constexpr size_t TEMPERATURE = 0;  // Mean 25, stddev 2
+    constexpr size_t GYROSCOPE = 5;    // Mean 0, stddev 1
+
+    // Feeds one channel readings in declared stddevs, every other channel its mean
+    class Feed {
+    public:
+        explicit Feed(const std::vector<std::string>& assignments)
+            : m_channels(ChannelRegistry::builtin())
+            , m_detector(m_channels, assignments)
+        {}
+
+        // Push one reading at z-score z on channel; returns the alerts it raised
+        std::vector<AnomalyAlert> push(size_t channel, double z) {
+            double values[NUM_SENSORS];
+            for (size_t ch = 0; ch < NUM_SENSORS; ++ch) {
+                values[ch] = m_channels[ch].mean;
+            }
+            values[channel] += z * m_channels[channel].stddev;
+            std::vector<AnomalyAlert> alerts;
+            m_detector.push(AnomalyDetector::TimePoint{}, 0, values, alerts);
+            return alerts;
+        }
+
+        // Push count readings at z; returns the sample numbers of the alerts they raised
+        std::vector<uint64_t> pushMany(size_t channel, double z, size_t count) {
+            std::vector<uint64_t> samples;
+            for (size_t i = 0; i < count; ++i) {
+                for (const AnomalyAlert& alert : push(channel, z)) {
+                    samples.push_back(alert.sample);
+                }
+            }
+            return samples;
+        }
+
+        AnomalyDetector& detector() { return m_detector; }
+
+    private:
+        ChannelRegistry m_channels;
+        AnomalyDetector m_detector;
+    };
+
+    // Checks one alert field by field
+    void checkAlert(const AnomalyAlert& alert, uint64_t sample, size_t channel, AnomalyKind kind,
+                    double score, double threshold) {
+        CHECK_EQ(alert.sample, sample);
+        CHECK_EQ(alert.channel, static_cast<uint32_t>(channel));
+        CHECK(alert.kind == kind);
+        CHECK_NEAR(alert.score, score, 1e-9);
+        CHECK_NEAR(alert.threshold, threshold, 1e-12);
+    }
+}
+
+TEST_CASE(detector_zscore_fires_past_its_threshold_and_rearms_inside) {
+    Feed feed({"Temperature=zscore:3"});
+    CHECK(feed.push(TEMPERATURE, 2.9).empty());
+    CHECK(feed.push(TEMPERATURE, 3.0).empty());  // The threshold itself is inside
+
+    std::vector<AnomalyAlert> alerts = feed.push(TEMPERATURE, 3.5);
+    CHECK_EQ(alerts.size(), size_t{1});
+    checkAlert(alerts[0], 2, TEMPERATURE, AnomalyKind::ZSCORE, 3.5, 3.0);
+    CHECK_NEAR(alerts[0].value, 25.0 + 3.5 * 2.0, 1e-12);
+
+    // Edge-triggered: still outside raises nothing, back inside re-arms
+    CHECK(feed.push(TEMPERATURE, 4.0).empty());
+    CHECK(feed.push(TEMPERATURE, -5.0).empty());
+    CHECK(feed.push(TEMPERATURE, 0.0).empty());
+    alerts = feed.push(TEMPERATURE, -3.5);
+    CHECK_EQ(alerts.size(), size_t{1});
+    checkAlert(alerts[0], 6, TEMPERATURE, AnomalyKind::ZSCORE, -3.5, 3.0);
+
+    // Only the assigned channel is checked
+    CHECK(feed.push(GYROSCOPE, 100.0).empty());
+    CHECK_EQ(feed.detector().alerts(AnomalyKind::ZSCORE), uint64_t{2});
+    CHECK_EQ(feed.detector().checkedChannels(), size_t{1});
+    CHECK_EQ(feed.detector().samples(), uint64_t{8});
+}
+
+TEST_CASE(detector_defaults_for_zscore_and_rate_of_change) {
+    Feed feed({"Temperature=zscore", "Gyroscope=roc"});
+    CHECK(feed.push(TEMPERATURE, 5.9).empty());
+    CHECK(feed.push(TEMPERATURE, 0.0).empty());
+    std::vector<AnomalyAlert> alerts = feed.push(TEMPERATURE, -6.1);
+    CHECK_EQ(alerts.size(), size_t{1});
+    checkAlert(alerts[0], 2, TEMPERATURE, AnomalyKind::ZSCORE, -6.1, 6.0);
+
+    // Gyroscope sat at its mean so far; steps up to 8 are inside
+    CHECK(feed.push(GYROSCOPE, 7.5).empty());
+    CHECK(feed.push(GYROSCOPE, -0.5).empty());
+    alerts = feed.push(GYROSCOPE, -9.0);
+    CHECK_EQ(alerts.size(), size_t{1});
+    checkAlert(alerts[0], 5, GYROSCOPE, AnomalyKind::RATE, -8.5, 8.0);
+
+    // A step back inside re-arms; a second large step fires again
+    CHECK(feed.push(GYROSCOPE, -8.0).empty());
+    alerts = feed.push(GYROSCOPE, 1.0);
+    CHECK_EQ(alerts.size(), size_t{1});
+    checkAlert(alerts[0], 7, GYROSCOPE, AnomalyKind::RATE, 9.0, 8.0);
+
+    // The very first reading has nothing to be compared with
+    Feed fresh({"Gyroscope=roc"});
+    CHECK(fresh.push(GYROSCOPE, 20.0).empty());
+    CHECK_EQ(fresh.push(GYROSCOPE, 0.0).size(), size_t{1});
+}
+
+TEST_CASE(detector_ewma_catches_a_shift_and_rearms_once_it_decays) {
+    // Defaults: lambda 0.1, limit 4 sigma of the EWMA, 4 * sqrt(0.1 / 1.9) ~ 0.918
+    const double limit = 4.0 * std::sqrt(0.1 / 1.9);
+    Feed feed({"Temperature=ewma"});
+
+    // After n readings of a 1 stddev shift the EWMA is 1 - 0.9^n
+    uint64_t expected = 0;
+    while (1.0 - std::pow(0.9, static_cast<double>(expected + 1)) <= limit) {
+        ++expected;
+    }
+    CHECK_EQ(expected, uint64_t{23});
+    std::vector<uint64_t> samples = feed.pushMany(TEMPERATURE, 1.0, 40);
+    CHECK_EQ(samples.size(), size_t{1});
+    CHECK_EQ(samples[0], expected);
+
+    // Back at the mean the EWMA falls inside at once; the opposite shift is caught again,
+    // at most a reading later for the little EWMA left over
+    CHECK(feed.pushMany(TEMPERATURE, 0.0, 40).empty());
+    samples = feed.pushMany(TEMPERATURE, -1.0, 40);
+    CHECK_EQ(samples.size(), size_t{1});
+    CHECK(samples[0] >= 80 + expected && samples[0] <= 81 + expected);
+
+    // A custom weight of 1 turns the EWMA into the z-score itself, limit L
+    Feed sharp({"Temperature=ewma:1:3"});
+    CHECK(sharp.push(TEMPERATURE, 2.9).empty());
+    const std::vector<AnomalyAlert> alerts = sharp.push(TEMPERATURE, 3.1);
+    CHECK_EQ(alerts.size(), size_t{1});
+    checkAlert(alerts[0], 1, TEMPERATURE, AnomalyKind::EWMA, 3.1, 3.0);
+    CHECK_EQ(sharp.detector().alerts(AnomalyKind::EWMA), uint64_t{1});
+}
+
+TEST_CASE(detector_cusum_is_clamped_so_a_long_fault_rearms_quickly) {
+    // Defaults: slack 0.5, interval 10; a 1 stddev shift adds 0.5 per reading
+    Feed feed({"Temperature=cusum"});
+    std::vector<uint64_t> samples = feed.pushMany(TEMPERATURE, 1.0, 1000);
+    CHECK_EQ(samples.size(), size_t{1});
+    CHECK_EQ(samples[0], uint64_t{20});  // 21 * 0.5 = 10.5 > 10
+
+    // Clamped at 20 rather than 500, so 20 readings at the mean bring it back to 10 (inside)
+    CHECK(feed.pushMany(TEMPERATURE, 0.0, 20).empty());
+    std::vector<AnomalyAlert> alerts = feed.push(TEMPERATURE, 1.0);
+    CHECK_EQ(alerts.size(), size_t{1});
+    checkAlert(alerts[0], 1020, TEMPERATURE, AnomalyKind::CUSUM, 10.5, 10.0);
+
+    // The lower sum reports a negative score
+    Feed low({"Temperature=cusum:1:4"});
+    samples = low.pushMany(TEMPERATURE, -3.0, 2);
+    CHECK_EQ(samples.size(), size_t{0});  // 2 + 2 = 4 is inside
+    alerts = low.push(TEMPERATURE, -3.0);
+    CHECK_EQ(alerts.size(), size_t{1});
+    checkAlert(alerts[0], 2, TEMPERATURE, AnomalyKind::CUSUM, -6.0, 4.0);
+}
+
+TEST_CASE(detector_ignores_non_finite_readings_and_rejects_bad_specs) {
+    Feed feed({"all"});
+    CHECK_EQ(feed.detector().checkedChannels(), NUM_SENSORS);
+    CHECK(feed.push(TEMPERATURE, std::numeric_limits<double>::quiet_NaN()).empty());
+    CHECK(feed.push(TEMPERATURE, std::numeric_limits<double>::infinity()).empty());
+    CHECK(feed.push(TEMPERATURE, 0.0).empty());
+    for (size_t k = 0; k < static_cast<size_t>(AnomalyKind::COUNT); ++k) {
+        CHECK_EQ(feed.detector().alerts(static_cast<AnomalyKind>(k)), uint64_t{0});
+    }
+
+    // "none" removes earlier checks
+    Feed removed({"all", "Temperature=none"});
+    CHECK_EQ(removed.detector().checkedChannels(), NUM_SENSORS - 1);
+    CHECK(removed.push(TEMPERATURE, 100.0).empty());
+
+    const ChannelRegistry channels = ChannelRegistry::builtin();
+    for (const char* bad : {"zscore:-1", "zscore:0", "zscore:abc", "zscore:1:2", "ewma:1.5",
+                            "cusum:1:2:3", "median", "Nope=zscore", "=zscore", "Temperature="}) {
+        bool thrown = false;
+        try {
+            AnomalyDetector detector(channels, {bad});
+        } catch (const std::invalid_argument&) {
+            thrown = true;
+        }
+        CHECK(thrown);
+    }
+}
+
+TEST_CASE(detector_blocks_raise_the_alerts_of_single_readings) {
+    const ChannelRegistry channels = ChannelRegistry::builtin();
+    const std::vector<std::string> assignments{"all", "Pressure=zscore:2", "Humidity=cusum:0.2:3"};
+    AnomalyDetector readings(channels, assignments);
+    AnomalyDetector blocks(channels, assignments);
+
+    // Noise with occasional spikes and shifts, so every check fires now and then
+    constexpr size_t BLOCK = 37;
+    constexpr size_t BLOCKS = 60;
+    std::mt19937_64 rng(24);
+    std::normal_distribution<double> noise(0.0, 1.0);
+    std::vector<AnomalyAlert> expected;
+    std::vector<AnomalyAlert> actual;
+    SampleBlock block(NUM_SENSORS, BLOCK);
+    for (size_t b = 0; b < BLOCKS; ++b) {
+        for (size_t s = 0; s < BLOCK; ++s) {
+            const size_t i = b * BLOCK + s;
+            const double shift = (i / 300) % 2 ? 1.5 : 0.0;
+            double values[NUM_SENSORS];
+            for (size_t ch = 0; ch < NUM_SENSORS; ++ch) {
+                const double spike = i % 97 == ch ? 12.0 : 0.0;
+                values[ch] = channels[ch].mean + (noise(rng) + shift + spike) * channels[ch].stddev;
+                block.column(ch)[s] = values[ch];
+            }
+            block.timestamps()[s] = AnomalyDetector::TimePoint{};
+            readings.push(AnomalyDetector::TimePoint{}, 0, values, expected);
+        }
+        block.setLength(BLOCK);
+        // Two shards, as DataProcessor runs them on its pool
+        blocks.pushChannels(block, 0, 2, actual);
+        blocks.pushChannels(block, 2, NUM_SENSORS, actual);
+        blocks.commitBlock(block);
+    }
+
+    // Blocks report channel by channel; compare per channel in reading order
+    CHECK_EQ(actual.size(), expected.size());
+    for (size_t ch = 0; ch < NUM_SENSORS; ++ch) {
+        std::vector<const AnomalyAlert*> a;
+        std::vector<const AnomalyAlert*> e;
+        for (const AnomalyAlert& alert : actual) {
+            if (alert.channel == ch) {
+                a.push_back(&alert);
+            }
+        }
+        for (const AnomalyAlert& alert : expected) {
+            if (alert.channel == ch) {
+                e.push_back(&alert);
+            }
+        }
+        std::stable_sort(a.begin(), a.end(),
+                         [](const AnomalyAlert* x, const AnomalyAlert* y) { return x->sample < y->sample; });
+        CHECK_EQ(a.size(), e.size());
+        for (size_t i = 0; i < a.size(); ++i) {
+            CHECK_EQ(a[i]->sample, e[i]->sample);
+            CHECK(a[i]->kind == e[i]->kind);
+            CHECK_EQ(a[i]->value, e[i]->value);
+            CHECK_EQ(a[i]->score, e[i]->score);
+        }
+    }
+    for (size_t k = 0; k < static_cast<size_t>(AnomalyKind::COUNT); ++k) {
+        const AnomalyKind kind = static_cast<AnomalyKind>(k);
+        CHECK(readings.alerts(kind) > 0);
+        CHECK_EQ(blocks.alerts(kind), readings.alerts(kind));
+    }
+    CHECK_EQ(blocks.samples(), readings.samples());
+}
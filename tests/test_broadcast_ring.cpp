@@ -0,0 +1,131 @@
+// BroadcastRing lap accounting in a single process: a lapped subscriber's received and
+// lost counts add up to every publish, plus reclaim of a subscriber whose process exited.
+
+#include "test_framework.hpp"
+#include "broadcast_ring.hpp"
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace sensor;
+
+namespace {
+    // Segment name private to this test process
+    std::string ringName() {
+        return "/sensor_test_broadcast_" + std::to_string(getpid());
+    }
+
+    // Publish count consecutive positions starting at next
+    void publishRange(BroadcastRing& producer, uint64_t& next, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            CHECK(producer.publish(&next, sizeof(next)));
+            ++next;
+        }
+    }
+}
+
+TEST_CASE(broadcast_lapped_subscriber_counts_every_message) {
+    auto producer = BroadcastRing::create(ringName(), sizeof(uint64_t), 8);
+    CHECK(producer != nullptr);
+    CHECK_EQ(producer->capacity(), size_t{8});
+    auto subscriber = BroadcastRing::subscribe(ringName(), sizeof(uint64_t));
+    CHECK(subscriber != nullptr);
+
+    // Bursts from nothing to several laps, drained partly or fully in between
+    std::mt19937_64 rng(15);
+    uint64_t written = 0;
+    uint64_t received = 0;
+    uint64_t expected = 0;  // Oldest position the subscriber can still get
+    for (int step = 0; step < 300; ++step) {
+        publishRange(*producer, written, rng() % 40);
+        if (written - expected > producer->capacity()) {
+            expected = written - producer->capacity();
+        }
+        const size_t reads = step % 5 == 0 ? 2 * producer->capacity() : rng() % 10;
+        for (size_t r = 0; r < reads; ++r) {
+            uint64_t value = 0;
+            const size_t length = subscriber->read(&value, sizeof(value));
+            if (length == 0) {
+                CHECK_EQ(expected, written);
+                break;
+            }
+            // In order, and after a lap resumes at the oldest message still intact
+            CHECK_EQ(length, sizeof(value));
+            CHECK_EQ(value, expected);
+            ++expected;
+            ++received;
+        }
+        // Losses are counted when the subscriber next reads
+        if (reads > 0) {
+            CHECK_EQ(received + subscriber->lost(), expected);
+        }
+    }
+
+    uint64_t value = 0;
+    while (subscriber->read(&value, sizeof(value)) != 0) {
+        ++received;
+    }
+    CHECK(subscriber->lost() > 0);
+    CHECK_EQ(received + subscriber->lost(), written);
+
+    // The producer's view of the same entry agrees
+    const std::vector<BroadcastRing::SubscriberStats> stats = producer->subscribers();
+    CHECK_EQ(stats.size(), size_t{1});
+    CHECK_EQ(stats[0].pid, static_cast<int>(getpid()));
+    CHECK_EQ(stats[0].received, received);
+    CHECK_EQ(stats[0].lost, subscriber->lost());
+    CHECK_EQ(stats[0].lag, uint64_t{0});
+    CHECK(producer->slowEvents() > 0);
+}
+
+TEST_CASE(broadcast_dead_subscriber_entry_is_reclaimed) {
+    const std::string name = ringName();  // Taken before fork(), the child has another pid
+    auto producer = BroadcastRing::create(name, sizeof(uint64_t), 8);
+    CHECK(producer != nullptr);
+
+    // Child claims an entry and exits without unsubscribing
+    const pid_t child = fork();
+    if (child == 0) {
+        auto subscriber = BroadcastRing::subscribe(name, sizeof(uint64_t));
+        _exit(subscriber ? 0 : 1);
+    }
+    CHECK(child > 0);
+    int status = 0;
+    CHECK_EQ(waitpid(child, &status, 0), child);
+    CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+
+    // Live subscribers fill the rest of the table
+    std::vector<std::unique_ptr<BroadcastRing>> live;
+    for (size_t i = 1; i < BroadcastRing::MAX_SUBSCRIBERS; ++i) {
+        live.push_back(BroadcastRing::subscribe(name, sizeof(uint64_t)));
+        CHECK(live.back() != nullptr);
+    }
+    CHECK(BroadcastRing::subscribe(name, sizeof(uint64_t)) == nullptr);
+    std::vector<BroadcastRing::SubscriberStats> stats = producer->subscribers();
+    CHECK_EQ(stats.size(), BroadcastRing::MAX_SUBSCRIBERS);
+    CHECK_EQ(stats[0].pid, static_cast<int>(child));
+
+    // Everyone falls more than a lap behind; only the dead process loses its entry, at
+    // the producer's next scan of the table
+    uint64_t next = 0;
+    publishRange(*producer, next, 64);
+    stats = producer->subscribers();
+    CHECK_EQ(stats.size(), BroadcastRing::MAX_SUBSCRIBERS - 1);
+    for (const BroadcastRing::SubscriberStats& s : stats) {
+        CHECK_EQ(s.pid, static_cast<int>(getpid()));
+        CHECK_EQ(s.lag, uint64_t{64});
+    }
+
+    // The freed entry can be claimed again, starting at the newest message
+    auto replacement = BroadcastRing::subscribe(name, sizeof(uint64_t));
+    CHECK(replacement != nullptr);
+    uint64_t value = 0;
+    CHECK_EQ(replacement->read(&value, sizeof(value)), size_t{0});
+    publishRange(*producer, next, 1);
+    CHECK_EQ(replacement->read(&value, sizeof(value)), sizeof(value));
+    CHECK_EQ(value, uint64_t{64});
+    CHECK_EQ(replacement->lost(), uint64_t{0});
+}
@@ -0,0 +1,117 @@
+// Producer/consumer stress tests for the sample buffers: every item must arrive exactly
+// once, in order and intact, whichever side wins each race.
+
+#include "test_framework.hpp"
+#include "circular_buffer.hpp"
+#include "spsc_ring_buffer.hpp"
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+
+using namespace sensor;
+
+namespace {
+    constexpr uint64_t STRESS_ITEMS = 300000;
+
+    // Item whose every field encodes its sequence number, so a torn copy shows
+    SensorData makeItem(uint64_t sequence) {
+        SensorData item;
+        item.values.fill(static_cast<double>(sequence));
+        item.timestamp = std::chrono::system_clock::time_point(std::chrono::nanoseconds(sequence));
+        item.generated_ns = sequence;
+        return item;
+    }
+
+    // Producer pushes 0..count-1, retrying rejected pushes; the consumer alternates
+    // pop() and waitPop() so both the fast path and parking race with the producer.
+    // Fails on the first lost, duplicated, reordered or torn item. A reporter reads the
+    // counters meanwhile, as the metrics exporter does, and checks they never go backwards.
+    template<typename Buffer>
+    void stress(Buffer& buffer, uint64_t count) {
+        std::atomic<bool> stop{false};
+        std::atomic<bool> counters_ok{true};
+        std::thread reporter([&buffer, &stop, &counters_ok]() {
+            StageCounters last;
+            while (!stop.load(std::memory_order_relaxed)) {
+                const StageCounters now = buffer.counters();
+                if (now.produced < last.produced || now.consumed < last.consumed
+                    || now.dropped < last.dropped || now.high_water < last.high_water
+                    || now.high_water > buffer.capacity()) {
+                    counters_ok.store(false, std::memory_order_relaxed);
+                }
+                last = now;
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+        });
+        std::thread producer([&buffer, &stop, count]() {
+            for (uint64_t i = 0; i < count && !stop.load(std::memory_order_relaxed); ++i) {
+                const SensorData item = makeItem(i);
+                while (!buffer.push(item) && !stop.load(std::memory_order_relaxed)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+
+        uint64_t expected = 0;
+        uint64_t attempts = 0;
+        std::string error;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(60);
+        while (expected < count && error.empty() && std::chrono::steady_clock::now() < deadline) {
+            // Alternate per attempt, not per item, so an empty pop() is followed by a park
+            auto item = (attempts++ & 1) ? buffer.pop() : buffer.waitPop(std::chrono::microseconds(1000));
+            if (!item) {
+                continue;
+            }
+            const double sequence = item->values[0];
+            for (double v : item->values) {
+                if (v != sequence) {
+                    error = "torn item at " + std::to_string(expected);
+                }
+            }
+            if (item->generated_ns != static_cast<uint64_t>(sequence)
+                || item->timestamp.time_since_epoch() != std::chrono::nanoseconds(item->generated_ns)) {
+                error = "torn item at " + std::to_string(expected);
+            } else if (sequence < static_cast<double>(expected)) {
+                error = (sequence + 1 == static_cast<double>(expected) ? "duplicated" : "reordered")
+                        + std::string(" item ") + std::to_string(item->generated_ns);
+            } else if (sequence > static_cast<double>(expected)) {
+                error = "lost items " + std::to_string(expected) + " to " + std::to_string(item->generated_ns - 1);
+            }
+            ++expected;
+        }
+        stop.store(true, std::memory_order_relaxed);
+        producer.join();
+        reporter.join();
+
+        if (!error.empty()) {
+            sensor::test::fail(__FILE__, __LINE__, error);
+        }
+        CHECK_EQ(expected, count);
+        CHECK(!buffer.pop().has_value());
+        const StageCounters counters = buffer.counters();
+        CHECK_EQ(counters.consumed, count);
+        CHECK_EQ(counters.produced, counters.consumed + counters.dropped);
+        CHECK(counters_ok.load());
+    }
+}
+
+TEST_CASE(spsc_drop_newest_delivers_every_item_in_order) {
+    SpscRingBuffer<SensorData> buffer(16, OverflowPolicy::DROP_NEWEST);
+    stress(buffer, STRESS_ITEMS);
+}
+
+TEST_CASE(spsc_block_delivers_every_item_in_order) {
+    SpscRingBuffer<SensorData> buffer(4, OverflowPolicy::BLOCK, std::chrono::microseconds(100));
+    stress(buffer, STRESS_ITEMS);
+}
+
+TEST_CASE(mutex_block_delivers_every_item_in_order) {
+    CircularBuffer<SensorData> buffer(16, OverflowPolicy::BLOCK, std::chrono::microseconds(100));
+    stress(buffer, STRESS_ITEMS);
+}
+
+TEST_CASE(mutex_drop_newest_delivers_every_item_in_order) {
+    CircularBuffer<SensorData> buffer(3, OverflowPolicy::DROP_NEWEST);
+    stress(buffer, STRESS_ITEMS);
+}
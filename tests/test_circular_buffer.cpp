@@ -0,0 +1,149 @@
+// CircularBuffer batch functions against their per-item counterparts under every overflow
+// policy, and the zero-copy views against getWindow().
+
+#include "test_framework.hpp"
+#include "circular_buffer.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace sensor;
+
+namespace {
+    // Both buffers must hold the same items and report the same counters
+    void checkSame(const CircularBuffer<uint64_t>& batch, const CircularBuffer<uint64_t>& single) {
+        CHECK_EQ(batch.size(), single.size());
+        CHECK_EQ(batch.full(), single.full());
+        const std::vector<uint64_t> expected = single.getWindow(single.capacity());
+        const std::vector<uint64_t> actual = batch.getWindow(batch.capacity());
+        CHECK(actual == expected);
+        const StageCounters a = batch.counters();
+        const StageCounters e = single.counters();
+        CHECK_EQ(a.produced, e.produced);
+        CHECK_EQ(a.consumed, e.consumed);
+        CHECK_EQ(a.dropped, e.dropped);
+        CHECK_EQ(a.high_water, e.high_water);
+    }
+
+    // Random runs of pushes and pops, batched on one buffer and item by item on the other.
+    // Nothing waits: a BLOCK push into a full buffer times out at once, as a stuck consumer
+    // would make it.
+    void compareBatches(OverflowPolicy policy, size_t capacity, uint64_t seed) {
+        CircularBuffer<uint64_t> batch(capacity, policy);
+        CircularBuffer<uint64_t> single(capacity, policy);
+        std::mt19937_64 rng(seed);
+        std::uniform_int_distribution<size_t> length(0, 2 * capacity + 1);
+        uint64_t next = 0;
+        std::vector<uint64_t> items;
+        std::vector<uint64_t> popped;
+
+        for (int step = 0; step < 400; ++step) {
+            const size_t count = length(rng);
+            if (rng() % 3 != 0) {
+                items.clear();
+                for (size_t i = 0; i < count; ++i) {
+                    items.push_back(next++);
+                }
+                size_t accepted = 0;
+                for (uint64_t item : items) {
+                    accepted += single.push(item);
+                }
+                CHECK_EQ(batch.pushBatch(items.data(), items.size()), accepted);
+            } else {
+                popped.assign(count, 0);
+                const size_t expected = std::min(count, single.size());
+                const size_t taken = batch.popBatch(popped.data(), count);
+                CHECK_EQ(taken, expected);
+                for (size_t i = 0; i < taken; ++i) {
+                    const std::optional<uint64_t> item = single.pop();
+                    CHECK(item.has_value());
+                    CHECK_EQ(popped[i], *item);
+                }
+            }
+            checkSame(batch, single);
+        }
+    }
+}
+
+TEST_CASE(circular_push_batch_matches_single_pushes_under_every_policy) {
+    for (OverflowPolicy policy : {OverflowPolicy::DROP_OLDEST, OverflowPolicy::DROP_NEWEST,
+                                  OverflowPolicy::BLOCK, OverflowPolicy::COALESCE}) {
+        for (size_t capacity : {1, 2, 3, 8, 13}) {
+            compareBatches(policy, capacity, 25 + capacity);
+        }
+    }
+}
+
+TEST_CASE(circular_push_batch_counts_what_each_policy_loses) {
+    const uint64_t items[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+
+    CircularBuffer<uint64_t> oldest(4, OverflowPolicy::DROP_OLDEST);
+    CHECK_EQ(oldest.pushBatch(items, 10), size_t{10});
+    CHECK(oldest.getWindow(4) == (std::vector<uint64_t>{6, 7, 8, 9}));
+
+    CircularBuffer<uint64_t> newest(4, OverflowPolicy::DROP_NEWEST);
+    CHECK_EQ(newest.pushBatch(items, 10), size_t{4});
+    CHECK(newest.getWindow(4) == (std::vector<uint64_t>{0, 1, 2, 3}));
+
+    CircularBuffer<uint64_t> block(4, OverflowPolicy::BLOCK);
+    CHECK_EQ(block.pushBatch(items, 10), size_t{4});
+    CHECK(block.getWindow(4) == (std::vector<uint64_t>{0, 1, 2, 3}));
+
+    // The last item supersedes the newest queued one
+    CircularBuffer<uint64_t> coalesce(4, OverflowPolicy::COALESCE);
+    CHECK_EQ(coalesce.pushBatch(items, 10), size_t{10});
+    CHECK(coalesce.getWindow(4) == (std::vector<uint64_t>{0, 1, 2, 9}));
+
+    for (const CircularBuffer<uint64_t>* buffer : {&oldest, &newest, &block, &coalesce}) {
+        const StageCounters counters = buffer->counters();
+        CHECK_EQ(counters.produced, uint64_t{10});
+        CHECK_EQ(counters.consumed, uint64_t{0});
+        CHECK_EQ(counters.dropped, uint64_t{6});
+        CHECK_EQ(counters.high_water, size_t{4});
+    }
+}
+
+TEST_CASE(circular_views_show_items_in_place_until_overwritten) {
+    CircularBuffer<uint64_t> buffer(5, OverflowPolicy::DROP_OLDEST);
+    CHECK(buffer.window(3).empty());
+    for (uint64_t i = 0; i < 8; ++i) {
+        buffer.push(i);
+    }
+
+    // Items 3..7, wrapped around the end of the storage
+    for (size_t length : {0, 1, 3, 5, 9}) {
+        const auto view = buffer.window(length);
+        const std::vector<uint64_t> expected = buffer.getWindow(length);
+        CHECK_EQ(view.size(), expected.size());
+        for (size_t i = 0; i < view.size(); ++i) {
+            CHECK_EQ(view[i], expected[i]);
+        }
+        CHECK(view.first.size + view.second.size == view.size());
+    }
+    const auto oldest = buffer.front(2);
+    CHECK_EQ(oldest.size(), size_t{2});
+    CHECK_EQ(oldest[0], uint64_t{3});
+    CHECK_EQ(oldest[1], uint64_t{4});
+    CHECK(buffer.valid(oldest));
+
+    // Consuming leaves the items in place; the next write into a freed slot invalidates
+    CHECK_EQ(buffer.consume(1), size_t{1});
+    CHECK(buffer.valid(oldest));
+    buffer.push(8);
+    CHECK(!buffer.valid(oldest));
+    CHECK_EQ(buffer.front(1)[0], uint64_t{4});
+    CHECK_EQ(buffer.consume(10), size_t{5});
+    CHECK(buffer.empty());
+    CHECK_EQ(buffer.counters().consumed, uint64_t{6});
+
+    // COALESCE rewrites the newest item in place
+    CircularBuffer<uint64_t> coalesce(2, OverflowPolicy::COALESCE);
+    coalesce.push(1);
+    coalesce.push(2);
+    const auto older = coalesce.front(1);
+    const auto newer = coalesce.window(1);
+    coalesce.push(3);
+    CHECK(coalesce.valid(older));
+    CHECK(!coalesce.valid(newer));
+    CHECK_EQ(coalesce.window(1)[0], uint64_t{3});
+}
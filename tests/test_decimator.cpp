@@ -0,0 +1,191 @@
+// Decimator gain at DC and beyond the output Nyquist frequency, and the per-sample, block
+// and sharded paths against each other.
+
+#include "test_framework.hpp"
+#include "decimator.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace sensor;
+
+namespace {
+    constexpr double PI = 3.14159265358979323846;
+
+    // Outputs and the timestamps of the inputs that completed them, one row per channel
+    struct Outputs {
+        std::vector<std::vector<double>> values;
+        std::vector<SampleBlock::TimePoint> timestamps;
+    };
+
+    // Input timestamp of sample k
+    SampleBlock::TimePoint stamp(size_t k) {
+        return SampleBlock::TimePoint(std::chrono::microseconds(1700000000000000 + 50 * k + k % 3));
+    }
+
+    // Random walk plus noise, different on every channel
+    std::vector<std::vector<double>> makeSignal(size_t channels, size_t samples) {
+        std::mt19937_64 rng(17);
+        std::normal_distribution<double> noise(0.0, 1.0);
+        std::vector<std::vector<double>> signal(channels, std::vector<double>(samples));
+        for (size_t ch = 0; ch < channels; ++ch) {
+            double level = 10.0 * static_cast<double>(ch);
+            for (size_t k = 0; k < samples; ++k) {
+                level += 0.1 * noise(rng);
+                signal[ch][k] = level + noise(rng);
+            }
+        }
+        return signal;
+    }
+
+    // One sample at a time through push()
+    Outputs runPerSample(size_t factor, const std::vector<std::vector<double>>& signal) {
+        const size_t channels = signal.size();
+        Decimator decimator(channels, factor);
+        Outputs result{std::vector<std::vector<double>>(channels), {}};
+        std::vector<double> values(channels);
+        std::vector<double> out(channels);
+        for (size_t k = 0; k < signal[0].size(); ++k) {
+            for (size_t ch = 0; ch < channels; ++ch) {
+                values[ch] = signal[ch][k];
+            }
+            if (decimator.push(values.data(), out.data())) {
+                for (size_t ch = 0; ch < channels; ++ch) {
+                    result.values[ch].push_back(out[ch]);
+                }
+                result.timestamps.push_back(stamp(k));
+            }
+        }
+        return result;
+    }
+
+    // Blocks of irregular lengths through pushBlock(), or through pushChannels() on shards
+    // of channels followed by commitBlock()
+    Outputs runBlocks(size_t factor, const std::vector<std::vector<double>>& signal, bool sharded) {
+        const size_t channels = signal.size();
+        constexpr size_t CAPACITY = 97;
+        Decimator decimator(channels, factor);
+        SampleBlock in(channels, CAPACITY);
+        SampleBlock out(channels, decimator.maxOutputs(CAPACITY));
+        Outputs result{std::vector<std::vector<double>>(channels), {}};
+        std::mt19937_64 rng(factor);
+        size_t k = 0;
+        while (k < signal[0].size()) {
+            const size_t length = std::min<size_t>(rng() % (CAPACITY + 1), signal[0].size() - k);
+            in.setLength(length);
+            in.setFirstSequence(k);
+            for (size_t ch = 0; ch < channels; ++ch) {
+                std::copy_n(signal[ch].begin() + static_cast<std::ptrdiff_t>(k), length, in.column(ch));
+            }
+            for (size_t i = 0; i < length; ++i) {
+                in.timestamps()[i] = stamp(k + i);
+            }
+
+            if (sharded) {
+                // Uneven shards, filtered last to first
+                decimator.pushChannels(in, out, 2, channels);
+                decimator.pushChannels(in, out, 0, 2);
+                decimator.commitBlock(in, out);
+            } else {
+                decimator.pushBlock(in, out);
+            }
+            CHECK(out.length() <= decimator.maxOutputs(length));
+            CHECK_EQ(out.firstSequence(), uint64_t{k});
+            for (size_t j = 0; j < out.length(); ++j) {
+                for (size_t ch = 0; ch < channels; ++ch) {
+                    result.values[ch].push_back(out.column(ch)[j]);
+                }
+                result.timestamps.push_back(out.timestamps()[j]);
+            }
+            k += length;
+        }
+        return result;
+    }
+
+    // Same outputs bit for bit, and the same timestamps
+    void checkSame(const Outputs& actual, const Outputs& expected) {
+        CHECK_EQ(actual.timestamps.size(), expected.timestamps.size());
+        CHECK(actual.timestamps == expected.timestamps);
+        for (size_t ch = 0; ch < expected.values.size(); ++ch) {
+            CHECK_EQ(actual.values[ch].size(), expected.values[ch].size());
+            CHECK(std::memcmp(actual.values[ch].data(), expected.values[ch].data(),
+                              expected.values[ch].size() * sizeof(double)) == 0);
+        }
+    }
+
+    // Largest output magnitude of a unit sine at cycles per input sample, once the
+    // filters have settled
+    double toneAmplitude(size_t factor, double cycles) {
+        Decimator decimator(1, factor);
+        const size_t settle = static_cast<size_t>(4.0 * decimator.delay()) + 1;
+        const size_t samples = settle + 200 * factor;
+        double peak = 0.0;
+        double out = 0.0;
+        for (size_t k = 0; k < samples; ++k) {
+            const double value = std::sin(2.0 * PI * cycles * static_cast<double>(k));
+            if (decimator.push(&value, &out) && k >= settle) {
+                peak = std::max(peak, std::fabs(out));
+            }
+        }
+        return peak;
+    }
+}
+
+TEST_CASE(decimator_passes_dc_at_unity_gain) {
+    for (size_t factor : {1, 7, 10, 1000}) {
+        // Primed at the first value, a constant stays constant from the first output
+        const double levels[] = {-273.15, 0.0, 101.325, 1e6};
+        Decimator decimator(4, factor);
+        double out[4];
+        size_t outputs = 0;
+        for (size_t k = 0; k < 20 * factor; ++k) {
+            if (decimator.push(levels, out)) {
+                ++outputs;
+                for (size_t ch = 0; ch < 4; ++ch) {
+                    CHECK_NEAR(out[ch], levels[ch], 1e-12 * (1.0 + std::fabs(levels[ch])));
+                }
+            }
+        }
+        CHECK_EQ(outputs, size_t{20});
+
+        // After a step the output settles at the new level
+        const double low = 0.0;
+        const double high = 5.0;
+        double last = 0.0;
+        Decimator single(1, factor);
+        single.push(&low, &last);
+        const size_t settle = static_cast<size_t>(2.0 * single.delay()) + 2 * factor;
+        for (size_t k = 0; k < settle; ++k) {
+            single.push(&high, &last);
+        }
+        CHECK_NEAR(last, high, 1e-9);
+    }
+}
+
+TEST_CASE(decimator_attenuates_tones_above_output_nyquist) {
+    // Blackman-windowed sinc stages: at least 60 dB down from the output Nyquist frequency
+    // on (about 80 dB measured), while a tone at a fifth of it keeps 95% of its amplitude
+    for (size_t factor : {7, 10, 1000}) {
+        const double nyquist = 0.5 / static_cast<double>(factor);
+        for (double above : {1.0, 1.2, 1.5, 3.0, 7.0}) {
+            const double cycles = std::min(above * nyquist, 0.49);
+            CHECK(toneAmplitude(factor, cycles) < 1e-3);
+        }
+        const double passed = toneAmplitude(factor, 0.2 * nyquist);
+        CHECK(passed > 0.95 && passed < 1.01);
+    }
+}
+
+TEST_CASE(decimator_paths_give_identical_outputs_and_timestamps) {
+    constexpr size_t CHANNELS = 5;
+    for (size_t factor : {1, 7, 10, 1000}) {
+        const auto signal = makeSignal(CHANNELS, std::max<size_t>(3000, 25 * factor + factor / 2));
+        const Outputs single = runPerSample(factor, signal);
+        CHECK_EQ(single.timestamps.size(), signal[0].size() / factor);
+        checkSame(runBlocks(factor, signal, false), single);
+        checkSame(runBlocks(factor, signal, true), single);
+    }
+}
@@ -0,0 +1,131 @@
+// xoshiro256++ against the reference algorithm, ziggurat normals for reproducibility and
+// shape, and the simulator's noise block across its refills.
+
+#include "test_framework.hpp"
+#include "fast_random.hpp"
+#include "sensor_simulator.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace sensor;
+
+namespace {
+    // Normals drawn for the moment and tail checks
+    constexpr size_t DRAWS = 1000000;
+
+    // Fraction of a standard normal beyond |z| > x
+    double twoSidedTail(double x) {
+        return std::erfc(x / std::sqrt(2.0));
+    }
+}
+
+TEST_CASE(xoshiro_matches_reference_outputs) {
+    // First outputs of the reference xoshiro256++ seeded through splitmix64
+    Xoshiro256pp zero(0);
+    for (uint64_t expected : {0x53175d61490b23dfull, 0x61da6f3dc380d507ull, 0x5c0fdf91ec9a7bfcull,
+                              0x02eebf8c3bbe5e1aull, 0x7eca04ebaf4a5eeaull}) {
+        CHECK_EQ(zero(), expected);
+    }
+    Xoshiro256pp answer(42);
+    for (uint64_t expected : {0xd0764d4f4476689full, 0x519e4174576f3791ull, 0xfbe07cfb0c24ed8cull,
+                              0xb37d9f600cd835b8ull, 0xcb231c3874846a73ull}) {
+        CHECK_EQ(answer(), expected);
+    }
+}
+
+TEST_CASE(normal_sampler_same_seed_same_stream) {
+    // One draw at a time and fill() in uneven blocks produce the same sequence
+    NormalSampler single(1234);
+    NormalSampler blocks(1234);
+    NormalSampler other(1235);
+    std::vector<double> expected(100000);
+    for (double& z : expected) {
+        z = single();
+    }
+    std::vector<double> actual(expected.size());
+    for (size_t done = 0, n = 1; done < actual.size(); done += n, n = n * 3 % 1009 + 1) {
+        n = std::min(n, actual.size() - done);
+        blocks.fill(actual.data() + done, n);
+    }
+    CHECK(std::memcmp(actual.data(), expected.data(), expected.size() * sizeof(double)) == 0);
+
+    size_t equal = 0;
+    for (double z : expected) {
+        equal += (other() == z);
+    }
+    CHECK(equal < 10);
+
+    // The scaled fill is mean + stddev * z of the same draws
+    NormalSampler scaled(1234);
+    std::vector<double> shifted(1000);
+    scaled.fill(shifted.data(), shifted.size(), 25.0, 2.0);
+    for (size_t i = 0; i < shifted.size(); ++i) {
+        CHECK_EQ(shifted[i], 25.0 + 2.0 * expected[i]);
+    }
+}
+
+TEST_CASE(normal_sampler_moments_and_tails) {
+    // Fixed seed; every tolerance is five standard errors of the estimate
+    NormalSampler sampler(20240601);
+    std::vector<double> z(DRAWS);
+    sampler.fill(z.data(), z.size());
+    const double n = static_cast<double>(DRAWS);
+
+    double sum = 0.0;
+    for (double v : z) {
+        sum += v;
+    }
+    const double mean = sum / n;
+    double m2 = 0.0;
+    double m4 = 0.0;
+    for (double v : z) {
+        const double d = (v - mean) * (v - mean);
+        m2 += d;
+        m4 += d * d;
+    }
+    const double variance = m2 / (n - 1.0);
+    CHECK_NEAR(mean, 0.0, 5.0 / std::sqrt(n));
+    CHECK_NEAR(variance, 1.0, 5.0 * std::sqrt(2.0 / n));
+    CHECK_NEAR(m4 / n, 3.0, 5.0 * std::sqrt(96.0 / n));
+
+    // Mass beyond the ziggurat's first layer edge (3.4426) and the tail it samples separately
+    for (double x : {1.0, 2.0, 3.0, 3.442619855899, 4.0, 4.5}) {
+        size_t beyond = 0;
+        size_t positive = 0;
+        for (double v : z) {
+            if (std::fabs(v) > x) {
+                ++beyond;
+                positive += (v > 0.0);
+            }
+        }
+        const double p = twoSidedTail(x);
+        CHECK_NEAR(static_cast<double>(beyond) / n, p, 5.0 * std::sqrt(p * (1.0 - p) / n) + 1.0 / n);
+        // Both tails are drawn: half of the mass on each side
+        if (beyond > 100) {
+            CHECK_NEAR(static_cast<double>(positive) / static_cast<double>(beyond), 0.5,
+                       5.0 * 0.5 / std::sqrt(static_cast<double>(beyond)));
+        }
+    }
+}
+
+TEST_CASE(simulator_noise_block_refills_without_repeats_or_gaps) {
+    // The fast engine hands out the sampler's stream in refills of about 4096 variates: the
+    // readings across several refills must be exactly that stream, in order
+    Config config;
+    config.random_engine = RandomEngine::FAST;
+    config.random_seed = 77;
+    SensorSimulator simulator(config);
+    NormalSampler reference(77);
+
+    const size_t readings = 3 * 4096 / NUM_SENSORS + 7;
+    for (size_t r = 0; r < readings; ++r) {
+        const std::array<double, NUM_SENSORS> values = simulator.generateSensorValues();
+        for (size_t i = 0; i < NUM_SENSORS; ++i) {
+            const double expected = SENSORS[i].mean + SENSORS[i].stddev * reference();
+            CHECK_EQ(values[i], expected);
+        }
+    }
+}
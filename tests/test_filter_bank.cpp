@@ -0,0 +1,251 @@
+// FilterBank lane kernels at every SIMD level against scalar, the Butterworth design's
+// response, FIR mirroring against a direct convolution, and primed (flat) starts.
+
+#include "test_framework.hpp"
+#include "filter_bank.hpp"
+#include <unistd.h>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace sensor;
+
+namespace {
+    constexpr double PI = 3.14159265358979323846;
+    constexpr double RATE_HZ = 1000.0;
+    constexpr size_t BLOCK = 64;
+
+    // Blocks of random length and content through pushBlock(); one output row per sample
+    std::vector<std::vector<double>> runBlocks(FilterBank& bank, size_t channels, size_t samples, uint64_t seed) {
+        std::mt19937_64 rng(seed);
+        std::normal_distribution<double> noise(0.0, 1.0);
+        SampleBlock in(channels, BLOCK);
+        SampleBlock out(channels, BLOCK);
+        std::vector<std::vector<double>> rows;
+        size_t done = 0;
+        while (done < samples) {
+            const size_t length = std::min<size_t>(rng() % (BLOCK + 1), samples - done);
+            in.setLength(length);
+            for (size_t ch = 0; ch < channels; ++ch) {
+                for (size_t k = 0; k < length; ++k) {
+                    in.column(ch)[k] = 10.0 * static_cast<double>(ch % 7) + noise(rng);
+                }
+            }
+            bank.pushBlock(in, out);
+            for (size_t k = 0; k < length; ++k) {
+                std::vector<double> row(channels);
+                for (size_t ch = 0; ch < channels; ++ch) {
+                    row[ch] = bank.filters(ch) ? out.column(ch)[k] : 0.0;
+                }
+                rows.push_back(std::move(row));
+            }
+            done += length;
+        }
+        return rows;
+    }
+
+    // Complex response of a biquad cascade at cycles per sample
+    std::complex<double> response(const std::vector<Biquad>& sections, double cycles) {
+        const std::complex<double> z1 = std::polar(1.0, -2.0 * PI * cycles);
+        const std::complex<double> z2 = z1 * z1;
+        std::complex<double> h = 1.0;
+        for (const Biquad& q : sections) {
+            h *= (q.b0 + q.b1 * z1 + q.b2 * z2) / (1.0 + q.a1 * z1 + q.a2 * z2);
+        }
+        return h;
+    }
+
+    // Taps file in the temporary directory, removed when the test ends
+    struct TapsFile {
+        std::string path;
+        explicit TapsFile(const std::vector<double>& taps)
+            : path("/tmp/sensor_test_taps_" + std::to_string(::getpid()) + ".txt") {
+            std::ofstream file(path);
+            file.precision(17);
+            file << "# h[0] first\n";
+            for (double tap : taps) {
+                file << tap << ",\n";
+            }
+        }
+        ~TapsFile() { std::remove(path.c_str()); }
+    };
+}
+
+TEST_CASE(filter_lane_kernels_agree_across_simd_levels) {
+    // Lane counts around every vector width, and more than one 64-lane group
+    const std::vector<std::vector<std::string>> designs = {
+        {"*=fir:33:100"},
+        {"*=butterworth:6:80"},
+        {"*=butterworth:5:120", "Temperature*=fir:17:50", "Pressure*=none",
+         "Humidity*=biquad:0.2,0.4,0.2,-0.5,0.3/0.5,0.5,0,-0.1,0"},
+    };
+    for (size_t channels : {1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 64, 70, 131}) {
+        const ChannelRegistry registry = ChannelRegistry::synthetic(channels);
+        for (const std::vector<std::string>& assignments : designs) {
+            if (assignments.size() > 1 && channels < 3) {
+                continue;  // Patterns must match a channel
+            }
+            FilterBank scalar(registry, assignments, RATE_HZ, BLOCK);
+            scalar.setSimdLevel(SimdLevel::SCALAR);
+            CHECK(scalar.simdLevel() == SimdLevel::SCALAR);
+            const auto expected = runBlocks(scalar, channels, 300, channels);
+
+            for (SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+                FilterBank bank(registry, assignments, RATE_HZ, BLOCK);
+                bank.setSimdLevel(level);
+                if (bank.simdLevel() != level) {
+                    continue;  // Not supported here
+                }
+                const auto actual = runBlocks(bank, channels, 300, channels);
+                CHECK_EQ(actual.size(), expected.size());
+                // Same operations in the same order per lane; only fused multiply-adds could
+                // make them differ, by rounding
+                for (size_t k = 0; k < expected.size(); ++k) {
+                    for (size_t ch = 0; ch < channels; ++ch) {
+                        CHECK_NEAR(actual[k][ch], expected[k][ch], 1e-12 * (1.0 + std::fabs(expected[k][ch])));
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE(filter_butterworth_has_its_cutoff_and_order) {
+    for (int order = 1; order <= 8; ++order) {
+        for (double cutoff : {0.01, 0.1, 0.25, 0.4}) {
+            const std::vector<Biquad> sections = butterworthLowPass(order, cutoff);
+            CHECK_EQ(sections.size(), static_cast<size_t>((order + 1) / 2));
+
+            // Unity at DC, -3 dB at the cutoff, and the prewarped Butterworth magnitude
+            // |H|^2 = 1 / (1 + (tan(pi f) / tan(pi fc))^(2 order)) elsewhere
+            CHECK_NEAR(std::abs(response(sections, 0.0)), 1.0, 1e-12);
+            CHECK_NEAR(std::abs(response(sections, cutoff)), std::sqrt(0.5), 1e-9);
+            for (double f : {0.5 * cutoff, 0.9 * cutoff, 1.5 * cutoff, 0.49}) {
+                if (f >= 0.5) {
+                    continue;
+                }
+                const double ratio = std::tan(PI * f) / std::tan(PI * cutoff);
+                const double expected = 1.0 / std::sqrt(1.0 + std::pow(ratio, 2.0 * order));
+                CHECK_NEAR(std::abs(response(sections, f)), expected, 1e-9);
+            }
+
+            // Every pole inside the unit circle; an odd order ends with one real pole
+            for (const Biquad& q : sections) {
+                const std::complex<double> disc = std::sqrt(std::complex<double>(q.a1 * q.a1 - 4.0 * q.a2));
+                CHECK(std::abs((-q.a1 + disc) / 2.0) < 1.0);
+                CHECK(std::abs((-q.a1 - disc) / 2.0) < 1.0);
+            }
+            if (order % 2 != 0) {
+                const Biquad& real = sections.back();
+                CHECK_EQ(real.b2, 0.0);
+                CHECK_EQ(real.a2, 0.0);
+                CHECK(std::fabs(real.a1) < 1.0);
+                CHECK_EQ(real.b0, real.b1);
+            }
+        }
+    }
+}
+
+TEST_CASE(filter_fir_matches_direct_convolution) {
+    // Asymmetric taps, so a reversed or shifted window shows up
+    std::vector<double> taps;
+    for (size_t j = 0; j < 23; ++j) {
+        taps.push_back(std::sin(0.7 * static_cast<double>(j) + 0.3) / static_cast<double>(j + 2));
+    }
+    const TapsFile file(taps);
+    const ChannelRegistry registry = ChannelRegistry::synthetic(11);
+    std::mt19937_64 rng(9);
+    std::normal_distribution<double> noise(0.0, 1.0);
+
+    for (bool blocks : {false, true}) {
+        FilterBank bank(registry, {"*=fir-file:" + file.path}, RATE_HZ, BLOCK);
+        CHECK_EQ(bank.filteredChannels(), size_t{11});
+        const size_t samples = 500;
+        std::vector<std::vector<double>> x(11, std::vector<double>(samples));
+        for (auto& column : x) {
+            for (double& v : column) {
+                v = noise(rng);
+            }
+        }
+
+        std::vector<std::vector<double>> y(11, std::vector<double>(samples));
+        if (blocks) {
+            SampleBlock in(11, BLOCK);
+            SampleBlock out(11, BLOCK);
+            for (size_t first = 0; first < samples; first += BLOCK) {
+                const size_t length = std::min(BLOCK, samples - first);
+                in.setLength(length);
+                for (size_t ch = 0; ch < 11; ++ch) {
+                    std::copy_n(x[ch].begin() + static_cast<std::ptrdiff_t>(first), length, in.column(ch));
+                }
+                bank.pushBlock(in, out);
+                for (size_t ch = 0; ch < 11; ++ch) {
+                    std::copy_n(out.column(ch), length, y[ch].begin() + static_cast<std::ptrdiff_t>(first));
+                }
+            }
+        } else {
+            std::vector<double> values(11);
+            std::vector<double> out(11);
+            for (size_t k = 0; k < samples; ++k) {
+                for (size_t ch = 0; ch < 11; ++ch) {
+                    values[ch] = x[ch][k];
+                }
+                bank.push(values.data(), out.data());
+                for (size_t ch = 0; ch < 11; ++ch) {
+                    y[ch][k] = out[ch];
+                }
+            }
+        }
+
+        // y[n] = sum h[j] x[n - j], with the primed history holding x[0] before the start
+        for (size_t ch = 0; ch < 11; ++ch) {
+            for (size_t n = 0; n < samples; ++n) {
+                double expected = 0.0;
+                for (size_t j = 0; j < taps.size(); ++j) {
+                    expected += taps[j] * (n >= j ? x[ch][n - j] : x[ch][0]);
+                }
+                CHECK_NEAR(y[ch][n], expected, 1e-12);
+            }
+        }
+    }
+}
+
+TEST_CASE(filter_prime_starts_flat) {
+    // A constant input is at steady state from the first sample: FIR and Butterworth pass
+    // it at unity gain, the explicit biquad at its DC gain of 4
+    const ChannelRegistry registry = ChannelRegistry::synthetic(10);
+    const std::vector<std::string> assignments = {
+        "*=butterworth:7:20", "Temperature*=fir:41:30", "Pressure*=biquad:1,0.5,0.5,-0.5,0"};
+    std::vector<double> levels(10);
+    for (size_t ch = 0; ch < levels.size(); ++ch) {
+        levels[ch] = 1000.0 * static_cast<double>(ch) - 3000.0;
+    }
+
+    FilterBank per_sample(registry, assignments, RATE_HZ, BLOCK);
+    FilterBank per_block(registry, assignments, RATE_HZ, BLOCK);
+    SampleBlock in(10, BLOCK);
+    SampleBlock out(10, BLOCK);
+    in.setLength(BLOCK);
+    for (size_t ch = 0; ch < 10; ++ch) {
+        std::fill_n(in.column(ch), BLOCK, levels[ch]);
+    }
+    std::vector<double> row(10);
+    for (int pass = 0; pass < 4; ++pass) {
+        per_block.pushBlock(in, out);
+        for (size_t k = 0; k < BLOCK; ++k) {
+            per_sample.push(levels.data(), row.data());
+            for (size_t ch = 0; ch < 10; ++ch) {
+                const std::string& name = registry[ch].name;
+                const double gain = name.rfind("Pressure", 0) == 0 ? 4.0 : 1.0;
+                const double expected = gain * levels[ch];
+                CHECK_NEAR(row[ch], expected, 1e-9 * (1.0 + std::fabs(expected)));
+                CHECK_NEAR(out.column(ch)[k], expected, 1e-9 * (1.0 + std::fabs(expected)));
+            }
+        }
+    }
+}
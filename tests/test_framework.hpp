@@ -0,0 +1,86 @@
+// Minimal self-registering test harness, so the suite builds with nothing but the
+// compiler and make. A test is a function declared with TEST_CASE; CHECK and CHECK_NEAR
+// throw on the first failed expectation, which ends that test and fails the run.
+#pragma once
+
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace sensor::test {
+
+// One registered test
+struct TestCase {
+    const char* name;   // Function name, used by --filter
+    void (*run)();      // Test body
+};
+
+// Thrown by a failed expectation
+struct TestFailure : std::runtime_error {
+    using std::runtime_error::runtime_error;
+};
+
+// Every test of the binary, in registration order
+inline std::vector<TestCase>& registry() {
+    static std::vector<TestCase> tests;
+    return tests;
+}
+
+// Adds a test to the registry during static initialization
+struct Registrar {
+    Registrar(const char* name, void (*run)()) {
+        registry().push_back(TestCase{name, run});
+    }
+};
+
+// Fail: Throw a TestFailure naming the expectation and where it was written
+inline void fail(const char* file, int line, const std::string& message) {
+    std::ostringstream os;
+    os << file << ":" << line << ": " << message;
+    throw TestFailure(os.str());
+}
+
+} // namespace sensor::test
+
+// Declare and register a test function
+#define TEST_CASE(name)                                                              \
+    static void name();                                                              \
+    static const ::sensor::test::Registrar name##_registrar(#name, name);            \
+    static void name()
+
+// Fail the test unless condition holds
+#define CHECK(condition)                                                             \
+    do {                                                                             \
+        if (!(condition)) {                                                          \
+            ::sensor::test::fail(__FILE__, __LINE__, "CHECK(" #condition ") failed"); \
+        }                                                                            \
+    } while (0)
+
+// Fail the test unless actual == expected, printing both
+#define CHECK_EQ(actual, expected)                                                   \
+    do {                                                                             \
+        const auto& check_actual_ = (actual);                                        \
+        const auto& check_expected_ = (expected);                                    \
+        if (!(check_actual_ == check_expected_)) {                                   \
+            std::ostringstream check_os_;                                            \
+            check_os_ << "CHECK_EQ(" #actual ", " #expected ") failed: "             \
+                      << check_actual_ << " != " << check_expected_;                 \
+            ::sensor::test::fail(__FILE__, __LINE__, check_os_.str());               \
+        }                                                                            \
+    } while (0)
+
+// Fail the test unless |actual - expected| <= tolerance
+#define CHECK_NEAR(actual, expected, tolerance)                                      \
+    do {                                                                             \
+        const double check_actual_ = (actual);                                       \
+        const double check_expected_ = (expected);                                   \
+        if (!(std::fabs(check_actual_ - check_expected_) <= (tolerance))) {          \
+            std::ostringstream check_os_;                                            \
+            check_os_.precision(17);                                                 \
+            check_os_ << "CHECK_NEAR(" #actual ", " #expected ") failed: "           \
+                      << check_actual_ << " vs " << check_expected_;                 \
+            ::sensor::test::fail(__FILE__, __LINE__, check_os_.str());               \
+        }                                                                            \
+    } while (0)
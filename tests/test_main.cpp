@@ -0,0 +1,42 @@
+// Runs every registered test, or those whose name contains the --filter text.
+// Build and run with `make test`; exits non-zero if any test fails.
+
+#include "test_framework.hpp"
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <iostream>
+#include <string>
+
+int main(int argc, char* argv[]) {
+    std::string filter;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            std::cerr << "Usage: sensor_tests [--filter TEXT]\n";
+            return 2;
+        }
+    }
+
+    int run = 0;
+    int failed = 0;
+    for (const auto& test : sensor::test::registry()) {
+        if (!filter.empty() && std::string(test.name).find(filter) == std::string::npos) {
+            continue;
+        }
+        ++run;
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            test.run();
+            const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start).count();
+            std::cerr << "PASS " << test.name << " (" << ms << " ms)\n";
+        } catch (const std::exception& e) {
+            ++failed;
+            std::cerr << "FAIL " << test.name << ": " << e.what() << "\n";
+        }
+    }
+    std::cerr << run - failed << " of " << run << " tests passed\n";
+    return failed == 0 ? 0 : 1;
+}
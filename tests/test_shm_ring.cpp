@@ -0,0 +1,119 @@
+// ShmRing slot sequencing in a single process: laps, fullness and capacity limits,
+// plus recovery from a consumer killed while parked.
+
+#include "test_framework.hpp"
+#include "shm_ring.hpp"
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace sensor;
+
+namespace {
+    // Segment name private to this test process
+    std::string ringName() {
+        return "/sensor_test_ring_" + std::to_string(getpid());
+    }
+
+    // Pop one payload, which must be the single uint64_t value
+    void expectFront(ShmRing& ring, uint64_t value) {
+        CHECK(ring.front() != nullptr);
+        CHECK_EQ(ring.frontLength(), sizeof(value));
+        uint64_t read = 0;
+        std::memcpy(&read, ring.front(), sizeof(read));
+        CHECK_EQ(read, value);
+        ring.popFront();
+    }
+}
+
+TEST_CASE(shm_ring_single_slot_request_rounds_up_to_two) {
+    auto ring = ShmRing::create(ringName(), sizeof(uint64_t), 1);
+    CHECK(ring != nullptr);
+    CHECK_EQ(ring->capacity(), size_t{2});
+
+    // Several laps, each filling the ring: a published slot must never look free
+    uint64_t next = 0;
+    for (int lap = 0; lap < 8; ++lap) {
+        for (uint64_t i = 0; i < 2; ++i) {
+            const uint64_t value = next + i;
+            CHECK(ring->tryWrite(&value, sizeof(value)));
+        }
+        const uint64_t extra = 99;
+        CHECK(!ring->tryWrite(&extra, sizeof(extra)));
+        expectFront(*ring, next);
+        expectFront(*ring, next + 1);
+        CHECK(ring->front() == nullptr);
+        next += 2;
+    }
+    CHECK_EQ(ring->written(), next);
+    CHECK_EQ(ring->consumed(), next);
+}
+
+TEST_CASE(shm_ring_interleaved_write_and_read_keeps_order) {
+    auto ring = ShmRing::create(ringName(), sizeof(uint64_t), 4);
+    CHECK(ring != nullptr);
+    uint64_t written = 0;
+    uint64_t read = 0;
+    for (int step = 0; step < 1000; ++step) {
+        // Two writes then one read, draining whenever the ring is full
+        for (int i = 0; i < 2; ++i) {
+            if (!ring->tryWrite(&written, sizeof(written))) {
+                while (ring->front() != nullptr) {
+                    expectFront(*ring, read++);
+                }
+                CHECK(ring->tryWrite(&written, sizeof(written)));
+            }
+            ++written;
+        }
+        expectFront(*ring, read++);
+    }
+    while (ring->front() != nullptr) {
+        expectFront(*ring, read++);
+    }
+    CHECK_EQ(read, written);
+}
+
+TEST_CASE(shm_ring_consumer_killed_while_parked_is_recovered) {
+    const std::string name = ringName();  // Taken before fork(), the child has another pid
+    auto producer = ShmRing::create(name, sizeof(uint64_t), 4);
+    CHECK(producer != nullptr);
+
+    // Child consumer parks on the empty ring and is killed there
+    const pid_t child = fork();
+    if (child == 0) {
+        auto consumer = ShmRing::open(name, sizeof(uint64_t));
+        if (consumer) {
+            consumer->waitReadable(std::chrono::milliseconds(10000));
+        }
+        _exit(0);
+    }
+    CHECK(child > 0);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!producer->consumerParked() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    CHECK(producer->consumerParked());
+    kill(child, SIGKILL);
+    waitpid(child, nullptr, 0);
+    CHECK(producer->consumerParked());
+
+    // The replacement consumer clears the flag, so pushes stop issuing futex wakes
+    auto consumer = ShmRing::open(name, sizeof(uint64_t));
+    CHECK(consumer != nullptr);
+    CHECK(!producer->consumerParked());
+
+    // Parking and being woken still work for the new consumer
+    std::thread writer([&producer]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        const uint64_t value = 7;
+        producer->tryWrite(&value, sizeof(value));
+    });
+    CHECK(consumer->waitReadable(std::chrono::milliseconds(5000)));
+    writer.join();
+    expectFront(*consumer, 7);
+    CHECK(!producer->consumerParked());
+}
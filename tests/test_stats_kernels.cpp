@@ -0,0 +1,209 @@
+// Every statistics kernel level the host supports against the scalar reference: sums and
+// sums of squared deviations on readings, cancelling and special values, and means.
+
+#include "test_framework.hpp"
+#include "stats_kernels.hpp"
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace sensor;
+
+namespace {
+    constexpr double UNIT_ROUNDOFF = 0x1p-53;
+
+    // Vector levels this CPU can run (statsKernels() clamps the others)
+    std::vector<const StatsKernels*> vectorLevels() {
+        std::vector<const StatsKernels*> levels;
+        for (SimdLevel level : {SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+            const StatsKernels& kernels = statsKernels(level);
+            if (kernels.level == level) {
+                levels.push_back(&kernels);
+            }
+        }
+        return levels;
+    }
+
+    // Lengths around every lane count and unroll boundary, then a few long ones
+    std::vector<size_t> awkwardLengths() {
+        std::vector<size_t> lengths;
+        for (size_t n = 0; n <= 70; ++n) {
+            lengths.push_back(n);
+        }
+        for (size_t n : {127, 128, 129, 255, 1000, 1023, 1025, 4097}) {
+            lengths.push_back(n);
+        }
+        return lengths;
+    }
+
+    // Distance in representable doubles between two finite values of the same sign
+    uint64_t ulps(double a, double b) {
+        int64_t ia = 0;
+        int64_t ib = 0;
+        std::memcpy(&ia, &a, sizeof(a));
+        std::memcpy(&ib, &b, sizeof(b));
+        return ia > ib ? static_cast<uint64_t>(ia - ib) : static_cast<uint64_t>(ib - ia);
+    }
+
+    // Sum every vector level over values (or their squared deviations from mean, when
+    // squares is set) and compare with scalar: both NaN, or within the compensated-summation
+    // bound, and within max_ulps when that is given
+    void checkReduction(const std::vector<double>& values, uint64_t max_ulps, bool squares, double mean) {
+        auto reduce = [&](const StatsKernels& kernels) {
+            return squares ? kernels.sumSquares(values.data(), values.size(), mean)
+                           : kernels.sum(values.data(), values.size());
+        };
+        const double reference = reduce(statsKernels(SimdLevel::SCALAR));
+        double magnitude = 0.0;
+        for (double v : values) {
+            magnitude += squares ? (v - mean) * (v - mean) : std::fabs(v);
+        }
+        const double n = static_cast<double>(values.size());
+        const double bound = 4.0 * UNIT_ROUNDOFF * std::fabs(reference)
+                           + 4.0 * n * UNIT_ROUNDOFF * UNIT_ROUNDOFF * magnitude
+                           + n * std::numeric_limits<double>::denorm_min();
+        for (const StatsKernels* kernels : vectorLevels()) {
+            const double total = reduce(*kernels);
+            if (std::isnan(reference)) {
+                CHECK(std::isnan(total));
+                continue;
+            }
+            CHECK_NEAR(total, reference, bound);
+            if (max_ulps != UINT64_MAX && total != reference) {
+                CHECK(std::signbit(total) == std::signbit(reference));
+                CHECK(ulps(total, reference) <= max_ulps);
+            }
+        }
+    }
+
+    // Both reductions: the plain sum, and squared deviations about the values' mean
+    void checkSum(const std::vector<double>& values, uint64_t max_ulps) {
+        checkReduction(values, max_ulps, false, 0.0);
+        double mean = 0.0;
+        for (double v : values) {
+            mean += v;
+        }
+        mean = values.empty() ? 0.0 : mean / static_cast<double>(values.size());
+        checkReduction(values, max_ulps, true, mean);
+    }
+}
+
+TEST_CASE(stats_sum_matches_scalar_on_readings) {
+    // Well-conditioned data, like a channel column: at most 2 ULP apart (0 measured)
+    std::mt19937_64 rng(7);
+    std::normal_distribution<double> reading(1013.25, 25.0);
+    for (size_t n : awkwardLengths()) {
+        for (int rep = 0; rep < 10; ++rep) {
+            std::vector<double> values(n);
+            for (double& v : values) {
+                v = reading(rng);
+            }
+            checkSum(values, 2);
+        }
+    }
+}
+
+TEST_CASE(stats_sum_matches_scalar_under_cancellation) {
+    // Magnitudes over 36 decades that mostly cancel: ULPs are meaningless near zero, the
+    // error bound is not
+    std::mt19937_64 rng(11);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    std::uniform_int_distribution<int> exponent(-60, 60);
+    for (size_t n : awkwardLengths()) {
+        for (int rep = 0; rep < 10; ++rep) {
+            std::vector<double> values(n);
+            for (double& v : values) {
+                v = std::ldexp(unit(rng), exponent(rng));
+            }
+            for (size_t i = 0; i < n / 2; ++i) {
+                values[n - 1 - i] = -values[i] * (1.0 + 1e-15 * unit(rng));
+            }
+            checkSum(values, UINT64_MAX);
+        }
+    }
+}
+
+TEST_CASE(stats_sum_matches_scalar_on_special_values) {
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    const double tiny = std::numeric_limits<double>::denorm_min();
+    for (size_t n : awkwardLengths()) {
+        std::vector<double> zeros(n);
+        for (size_t i = 0; i < n; ++i) {
+            zeros[i] = (i & 1) ? -0.0 : 0.0;
+        }
+        checkSum(zeros, 0);
+
+        std::vector<double> subnormal(n);
+        for (size_t i = 0; i < n; ++i) {
+            subnormal[i] = tiny * static_cast<double>(i % 5) * ((i & 2) ? -1.0 : 1.0);
+        }
+        checkSum(subnormal, UINT64_MAX);
+
+        // One special value at every position, including the scalar tail
+        for (size_t at = 0; at < n; at += 3) {
+            for (double special : {inf, -inf, nan}) {
+                std::vector<double> values(n, 1.5);
+                values[at] = special;
+                checkSum(values, UINT64_MAX);
+            }
+        }
+    }
+}
+
+TEST_CASE(stats_sum_squares_is_the_exact_second_moment) {
+    // Small integers make every squared deviation and partial sum exact
+    for (size_t n : awkwardLengths()) {
+        std::vector<double> values(n);
+        double expected = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            values[i] = static_cast<double>(i % 7);
+            expected += (values[i] - 3.0) * (values[i] - 3.0);
+        }
+        for (SimdLevel level : {SimdLevel::SCALAR, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512}) {
+            CHECK_EQ(statsKernels(level).sumSquares(values.data(), n, 3.0), expected);
+        }
+    }
+
+    // Offset readings whose naive sum of squares would cancel: the deviations stay exact
+    std::vector<double> offset(1000);
+    for (size_t i = 0; i < offset.size(); ++i) {
+        offset[i] = 1e9 + ((i & 1) ? 0.5 : -0.5);
+    }
+    for (const StatsKernels* kernels : vectorLevels()) {
+        CHECK_EQ(kernels->sumSquares(offset.data(), offset.size(), 1e9), 250.0);
+    }
+}
+
+TEST_CASE(stats_mean_is_bit_identical_to_scalar) {
+    std::mt19937_64 rng(3);
+    std::uniform_real_distribution<double> unit(-1.0, 1.0);
+    const StatsKernels& scalar = statsKernels(SimdLevel::SCALAR);
+    for (size_t n : awkwardLengths()) {
+        std::vector<double> sums(n);
+        std::vector<double> comps(n);
+        for (size_t i = 0; i < n; ++i) {
+            sums[i] = unit(rng) * 1e6;
+            comps[i] = unit(rng) * 1e-10;
+        }
+        for (double count : {1.0, 3.0, 7.0, 1000.0}) {
+            std::vector<double> expected(n);
+            scalar.mean(sums.data(), comps.data(), count, expected.data(), n);
+            for (const StatsKernels* kernels : vectorLevels()) {
+                std::vector<double> out(n, -1.0);
+                kernels->mean(sums.data(), comps.data(), count, out.data(), n);
+                CHECK(std::memcmp(out.data(), expected.data(), n * sizeof(double)) == 0);
+            }
+        }
+    }
+}
+
+TEST_CASE(stats_kernels_dispatch_to_a_supported_level) {
+    const SimdLevel best = detectSimdLevel();
+    CHECK(statsKernels().level == best);
+    CHECK(statsKernels(SimdLevel::SCALAR).level == SimdLevel::SCALAR);
+    CHECK(static_cast<int>(statsKernels(SimdLevel::AVX512).level) <= static_cast<int>(best));
+}
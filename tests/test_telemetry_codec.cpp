@@ -0,0 +1,369 @@
+// Telemetry codec round trips: special values and every field encoding, message frames
+// split where append() runs out of room, block frames of several shapes (directly and
+// through IPCManager), window reports in order with the messages, and frame headers whose
+// counts the encoded bytes cannot hold.
+
+#include "test_framework.hpp"
+#include "ipc_manager.hpp"
+#include "sample_block.hpp"
+#include "telemetry_codec.hpp"
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using namespace sensor;
+
+namespace {
+    constexpr double STEP = 0.01;
+    constexpr double QUANTIZE_LIMIT = 4503599627370496.0; // 2^52, as in the codec
+
+    uint64_t bitsOf(double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return bits;
+    }
+
+    double fromBits(uint64_t bits) {
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    // Lossless fields must come back bit for bit, NaN payloads and signed zeros included
+    void expectSameBits(double decoded, double original) {
+        CHECK_EQ(bitsOf(decoded), bitsOf(original));
+    }
+
+    // Quantized fields round to the step; what cannot be quantized travels raw
+    void expectQuantized(double decoded, double original, double step) {
+        const double scaled = original / step;
+        if (!std::isfinite(scaled) || std::fabs(scaled) >= QUANTIZE_LIMIT) {
+            expectSameBits(decoded, original);
+        } else {
+            CHECK_NEAR(decoded, original, step * 0.5 + std::fabs(original) * 4e-16);
+        }
+    }
+
+    // Values exercising every lossless and quantized path; consecutive entries 5-8 XOR to
+    // full 64-bit windows, 9-10 to a one-bit window
+    std::vector<double> specialValues() {
+        return {
+            0.0, -0.0, 25.3485, 25.3485,
+            std::numeric_limits<double>::quiet_NaN(),
+            fromBits(0x8000000000000001ull),  // XOR with the NaN above spans all 64 bits
+            fromBits(0x0000000000000000ull),  // Same 64-bit window again ('10' path)
+            fromBits(0xffffffffffffffffull),  // All-ones NaN
+            fromBits(0x7ff0000000000001ull),  // Signalling NaN payload
+            1.0, std::nextafter(1.0, 2.0),
+            std::numeric_limits<double>::infinity(),
+            -std::numeric_limits<double>::infinity(),
+            std::numeric_limits<double>::denorm_min(),
+            std::numeric_limits<double>::max(),
+            -std::numeric_limits<double>::max(),
+            STEP * QUANTIZE_LIMIT * 1.5,       // Beyond 2^52 steps: raw escape
+            -STEP * QUANTIZE_LIMIT * 1.5,
+            STEP * (QUANTIZE_LIMIT - 1024.0),  // Just inside: 64-bit quantized difference
+            -STEP * (QUANTIZE_LIMIT - 1024.0),
+            4e13, -4e13, 101.3, 101.31, 101.29,
+        };
+    }
+
+    // Message whose fields are all distinct, some of them special values
+    MQMessage makeMessage(uint64_t index) {
+        const std::vector<double> special = specialValues();
+        MQMessage msg{};
+        msg.msg_id = 1000 + index * index;  // Irregular ids: non-zero delta of delta
+        msg.timestamp = std::chrono::system_clock::time_point(std::chrono::microseconds(1700000000000000 + 997 * index));
+        msg.stages.generated_ns = 5000000000ull + 100000 * index;
+        msg.stages.popped_ns = msg.stages.generated_ns + 1234 + index;
+        msg.stages.sent_ns = msg.stages.popped_ns + 77;
+        size_t k = index;
+        for (size_t s = 0; s < NUM_SENSORS; ++s) {
+            msg.avg_values[s] = special[k++ % special.size()];
+        }
+        return msg;
+    }
+
+    // Precision 0 compares bits; otherwise the averages are quantized
+    void expectSameMessage(const MQMessage& decoded, const MQMessage& original, double step) {
+        auto expect = [step](double d, double o) {
+            if (step > 0.0) {
+                expectQuantized(d, o, step);
+            } else {
+                expectSameBits(d, o);
+            }
+        };
+        CHECK_EQ(decoded.msg_id, original.msg_id);
+        CHECK(decoded.timestamp == original.timestamp);
+        CHECK_EQ(decoded.stages.generated_ns, original.stages.generated_ns);
+        CHECK_EQ(decoded.stages.popped_ns, original.stages.popped_ns);
+        CHECK_EQ(decoded.stages.sent_ns, original.stages.sent_ns);
+        for (size_t s = 0; s < NUM_SENSORS; ++s) {
+            expect(decoded.avg_values[s], original.avg_values[s]);
+        }
+    }
+
+    // Pack count messages into frames of capacity bytes, starting a new frame whenever
+    // append() refuses, and check every frame decodes to the messages it took
+    size_t splitRoundTrip(double step, size_t count, size_t capacity) {
+        MessageCodec codec(std::vector<double>(NUM_SENSORS, step));
+        MessageCodec decoder;
+        std::vector<char> frame(capacity);
+        std::vector<MQMessage> decoded;
+        size_t frames = 0;
+        size_t next = 0;
+        while (next < count) {
+            CHECK(codec.begin(frame.data(), frame.size()));
+            const size_t first = next;
+            while (next < count && codec.append(makeMessage(next))) {
+                ++next;
+            }
+            CHECK(next > first);  // A fresh frame always takes the refused message
+            const size_t bytes = codec.finish();
+            CHECK(bytes <= capacity);
+            CHECK(decoder.decode(frame.data(), bytes, decoded));
+            CHECK_EQ(decoded.size(), next - first);
+            for (size_t i = 0; i < decoded.size(); ++i) {
+                expectSameMessage(decoded[i], makeMessage(first + i), step);
+            }
+            ++frames;
+        }
+        return frames;
+    }
+
+    // Block of channels x capacity with length valid samples; the padding between the
+    // end of each column's samples and the next column holds a sentinel
+    SampleBlock makeBlock(size_t channels, size_t capacity, size_t length, uint64_t first) {
+        SampleBlock block(channels, capacity);
+        const std::vector<double> special = specialValues();
+        for (size_t ch = 0; ch < channels; ++ch) {
+            double* column = block.column(ch);
+            for (size_t k = 0; k < block.stride(); ++k) {
+                column[k] = -999.0;
+            }
+            for (size_t s = 0; s < length; ++s) {
+                // Mostly smooth, so compression wins, with a special value now and then
+                column[s] = (s % 4 == 3) ? special[(ch + s) % special.size()]
+                                         : 25.0 + static_cast<double>(ch) + 0.125 * static_cast<double>(s);
+            }
+        }
+        for (size_t s = 0; s < length; ++s) {
+            block.timestamps()[s] = SampleBlock::TimePoint(std::chrono::milliseconds(1700000000000 + 100 * s));
+        }
+        block.setLength(length);
+        block.setFirstSequence(first);
+        block.stages().generated_ns = 42 + first;
+        return block;
+    }
+
+    // Every sample of the block, read through a view laid out column after column
+    void expectSameBlock(const BlockView& view, const SampleBlock& block) {
+        CHECK_EQ(view.first_msg_id, block.firstSequence());
+        CHECK_EQ(view.channels, block.channels());
+        CHECK_EQ(view.length, block.length());
+        CHECK_EQ(view.stages.generated_ns, block.stages().generated_ns);
+        for (size_t s = 0; s < block.length(); ++s) {
+            CHECK(view.timestamps[s] == block.timestamps()[s]);
+        }
+        for (size_t ch = 0; ch < block.channels(); ++ch) {
+            for (size_t s = 0; s < block.length(); ++s) {
+                expectSameBits(view.column(ch)[s], block.column(ch)[s]);
+            }
+        }
+    }
+
+    // Block shapes: capacity, then valid samples (partial blocks leave columns unfilled)
+    struct Shape {
+        size_t capacity;
+        size_t length;
+    };
+    const Shape SHAPES[] = {{1, 1}, {5, 5}, {8, 8}, {8, 5}, {9, 9}, {16, 3}};
+    constexpr size_t BLOCK_CHANNELS = 4;
+}
+
+TEST_CASE(codec_fields_round_trip_special_values) {
+    const std::vector<double> special = specialValues();
+    const std::vector<double> precision = {0.0, STEP, 0.5};
+    TelemetryEncoder encoder(2, precision);
+    TelemetryDecoder decoder(2, precision.size());
+    std::vector<unsigned char> frame(64 * 1024);
+    CHECK(encoder.begin(frame.data(), frame.size()));
+
+    // Integers wrap around and jump by more than 2^32 between records
+    std::vector<uint64_t> integers;
+    const uint64_t jumps[] = {0, 1, 1ull << 40, std::numeric_limits<uint64_t>::max(), 7, 1ull << 63, 3};
+    for (size_t r = 0; r < special.size(); ++r) {
+        const uint64_t record[2] = {jumps[r % 7] + r, r * r * r * 1000003ull};
+        const double values[3] = {special[r], special[r], special[(r + 5) % special.size()]};
+        CHECK(encoder.append(record, values));
+        integers.insert(integers.end(), record, record + 2);
+    }
+    const size_t bytes = encoder.finish();
+
+    CHECK(decoder.begin(frame.data(), bytes));
+    for (size_t r = 0; r < special.size(); ++r) {
+        uint64_t record[2];
+        double values[3];
+        CHECK(decoder.next(record, values));
+        CHECK_EQ(record[0], integers[2 * r]);
+        CHECK_EQ(record[1], integers[2 * r + 1]);
+        expectSameBits(values[0], special[r]);
+        expectQuantized(values[1], special[r], STEP);
+        expectQuantized(values[2], special[(r + 5) % special.size()], 0.5);
+    }
+}
+
+TEST_CASE(codec_lossless_messages_split_across_frames) {
+    // Several messages per frame, and many frames
+    CHECK(splitRoundTrip(0.0, 1000, 4096) > 5);
+}
+
+TEST_CASE(codec_quantized_messages_split_across_frames) {
+    CHECK(splitRoundTrip(STEP, 1000, 4096) > 5);
+}
+
+TEST_CASE(codec_block_round_trip_honours_column_stride) {
+    BlockCodec encoder(std::vector<double>(BLOCK_CHANNELS, 0.0));
+    BlockCodec decoder;
+    DecodedBlock decoded;
+    for (const Shape& shape : SHAPES) {
+        const SampleBlock block = makeBlock(BLOCK_CHANNELS, shape.capacity, shape.length, shape.capacity * 100);
+        std::vector<char> frame(BlockCodec::maxFrameBytes(BLOCK_CHANNELS, shape.length));
+        const size_t bytes = encoder.encode(block.firstSequence(), block.stages(), block.timestamps(),
+                                            block.column(0), block.stride(), block.length(),
+                                            frame.data(), frame.size());
+        CHECK(bytes > 0);
+        CHECK(decoder.decode(frame.data(), bytes, decoded));
+
+        BlockView view;
+        view.first_msg_id = decoded.first_msg_id;
+        view.channels = decoded.channels;
+        view.length = decoded.length;
+        view.stages = decoded.stages;
+        view.timestamps = decoded.timestamps.data();
+        view.values = decoded.values.data();
+        expectSameBlock(view, block);
+    }
+}
+
+TEST_CASE(ipc_blocks_round_trip_with_and_without_compression) {
+    // Uses the production segment name; must not run beside a live pipeline
+    for (bool compress : {false, true}) {
+        const size_t largest = 16;
+        IPCManager sender;
+        IPCManager receiver;
+        CHECK(sender.initialize(true, IPCBackend::SHM,
+                                IPCManager::blockFrameBytes(BLOCK_CHANNELS, largest, compress)) == ErrorCode::SUCCESS);
+        CHECK(receiver.initialize(false, IPCBackend::SHM) == ErrorCode::SUCCESS);
+        if (compress) {
+            CHECK(sender.enableCompression(std::vector<double>(BLOCK_CHANNELS, 0.0)) == ErrorCode::SUCCESS);
+        }
+        for (const Shape& shape : SHAPES) {
+            const SampleBlock block = makeBlock(BLOCK_CHANNELS, shape.capacity, shape.length, shape.capacity);
+            CHECK(sender.sendBlock(block) == ErrorCode::SUCCESS);
+            const std::optional<BlockView> view = receiver.receiveBlock(std::chrono::milliseconds(1000));
+            CHECK(view.has_value());
+            expectSameBlock(*view, block);
+        }
+    }
+}
+
+TEST_CASE(ipc_window_reports_follow_the_messages_they_cover) {
+    // Unbatched ring slots, batched queue messages and compressed frames: the report is
+    // sent after message 2 and must be picked up with message 3, not before
+    struct Setup {
+        IPCBackend backend;
+        size_t batch;
+        bool compress;
+    };
+    for (const Setup& setup : {Setup{IPCBackend::SHM, 1, false}, Setup{IPCBackend::MQUEUE, 8, false},
+                               Setup{IPCBackend::SHM, 8, true}}) {
+        IPCManager sender;
+        IPCManager receiver;
+        CHECK(sender.initialize(true, setup.backend, IPCManager::WINDOW_FRAME_BYTES) == ErrorCode::SUCCESS);
+        CHECK(receiver.initialize(false, setup.backend) == ErrorCode::SUCCESS);
+        if (setup.compress) {
+            CHECK(sender.enableCompression(std::vector<double>(NUM_SENSORS, 0.0)) == ErrorCode::SUCCESS);
+        }
+        if (setup.batch > 1) {
+            size_t limit = 0;
+            CHECK(sender.enableBatching(setup.batch, std::chrono::seconds(10), limit) == ErrorCode::SUCCESS);
+            CHECK_EQ(limit, setup.batch);
+        }
+
+        WindowReport report{};
+        report.next_msg_id = 3;
+        report.window_count = 2;
+        for (size_t w = 0; w < MAX_AGGREGATE_WINDOWS; ++w) {
+            report.windows[w].window_ms = static_cast<uint32_t>(1000 * (w + 1));
+            report.windows[w].samples = static_cast<uint32_t>(10 * (w + 1));
+            report.windows[w].variance.fill(0.5 + static_cast<double>(w));
+        }
+        const std::vector<MQMessage> sent = {makeMessage(0), makeMessage(1), makeMessage(2),
+                                             makeMessage(3), makeMessage(4)};
+        for (size_t i = 0; i < sent.size(); ++i) {
+            if (i == 3) {
+                CHECK(sender.sendWindows(report) == ErrorCode::SUCCESS);
+            }
+            CHECK(sender.sendMessage(sent[i]) == ErrorCode::SUCCESS);
+        }
+        CHECK(sender.flush() == ErrorCode::SUCCESS);
+
+        std::vector<WindowReport> reports;
+        size_t received = 0;
+        for (int attempt = 0; attempt < 10 && received < sent.size(); ++attempt) {
+            const MessageSpan batch = receiver.receiveBatch(std::chrono::milliseconds(100));
+            const size_t taken = receiver.takeWindows(reports);
+            for (const MQMessage& msg : batch) {
+                if (received == 3) {
+                    CHECK_EQ(taken, size_t{1});
+                } else if (&msg == batch.begin()) {
+                    CHECK_EQ(taken, size_t{0});
+                }
+                expectSameMessage(msg, sent[received++], 0.0);
+            }
+            if (taken == 1) {
+                CHECK_EQ(reports[0].next_msg_id, uint64_t{3});
+                CHECK_EQ(reports[0].window_count, uint32_t{2});
+                CHECK_EQ(reports[0].windows[1].window_ms, uint32_t{2000});
+                CHECK_EQ(reports[0].windows[2].variance[5], 2.5);
+            }
+        }
+        CHECK_EQ(received, sent.size());
+    }
+}
+
+TEST_CASE(codec_rejects_counts_the_frame_cannot_hold) {
+    // Message frame claiming far more messages than its bytes could encode
+    MessageCodec codec;
+    std::vector<char> frame(4096);
+    CHECK(codec.begin(frame.data(), frame.size()));
+    CHECK(codec.append(makeMessage(0)));
+    const size_t bytes = codec.finish();
+    CompressedBatchHeader batch;
+    std::memcpy(&batch, frame.data(), sizeof(batch));
+    batch.count = std::numeric_limits<uint32_t>::max();
+    std::memcpy(frame.data(), &batch, sizeof(batch));
+    std::vector<MQMessage> messages;
+    CHECK(!codec.decode(frame.data(), bytes, messages));
+
+    // Block frames claiming huge channel or sample counts
+    BlockCodec encoder(std::vector<double>(BLOCK_CHANNELS, 0.0));
+    BlockCodec decoder;
+    DecodedBlock decoded;
+    const SampleBlock block = makeBlock(BLOCK_CHANNELS, 8, 8, 0);
+    std::vector<char> block_frame(BlockCodec::maxFrameBytes(BLOCK_CHANNELS, 8));
+    const size_t block_bytes = encoder.encode(block.firstSequence(), block.stages(), block.timestamps(),
+                                              block.column(0), block.stride(), block.length(),
+                                              block_frame.data(), block_frame.size());
+    CHECK(decoder.decode(block_frame.data(), block_bytes, decoded));
+    for (int field = 0; field < 2; ++field) {
+        std::vector<char> bad(block_frame.begin(), block_frame.begin() + static_cast<std::ptrdiff_t>(block_bytes));
+        CompressedBlockHeader header;
+        std::memcpy(&header, bad.data(), sizeof(header));
+        (field == 0 ? header.channels : header.length) = std::numeric_limits<uint32_t>::max();
+        std::memcpy(bad.data(), &header, sizeof(header));
+        CHECK(!decoder.decode(bad.data(), bad.size(), decoded));
+    }
+}
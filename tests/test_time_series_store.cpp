@@ -0,0 +1,259 @@
+// TimeSeriesStore queries against a brute-force scan of every sample pushed, across the
+// raw ring and all rollup tiers, and lock-free queries racing the writer.
+
+#include "test_framework.hpp"
+#include "time_series_store.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace sensor;
+
+namespace {
+    constexpr int64_t MS = 1000000LL;
+    constexpr int64_t SECOND = 1000 * MS;
+    constexpr int64_t T0 = 1700000000LL * SECOND;  // Whole second, not a whole hour
+    constexpr size_t CHANNELS = 2;
+
+    // Every sample pushed, in time order
+    struct History {
+        std::vector<int64_t> times;
+        std::vector<double> values[CHANNELS];
+    };
+
+    TimeSeriesStore::TimePoint timePoint(int64_t ns) {
+        return TimeSeriesStore::TimePoint(std::chrono::duration_cast<TimeSeriesStore::TimePoint::duration>(
+            std::chrono::nanoseconds(ns)));
+    }
+
+    // Samples every period_ns for duration_ns; channel 1 is channel 0 negated plus noise
+    History makeHistory(int64_t period_ns, int64_t duration_ns) {
+        History history;
+        std::mt19937_64 rng(23);
+        std::normal_distribution<double> noise(0.0, 1.0);
+        double level = 100.0;
+        for (int64_t t = T0 + period_ns / 3; t < T0 + duration_ns; t += period_ns) {
+            level += noise(rng);
+            history.times.push_back(t);
+            history.values[0].push_back(level);
+            history.values[1].push_back(-level + 0.25 * noise(rng));
+        }
+        return history;
+    }
+
+    // Samples of one channel in [from, to), folded like a SeriesPoint
+    SeriesPoint bruteForce(const History& history, size_t channel, int64_t from, int64_t to) {
+        SeriesPoint point{from, to - from, 0, 0.0, 0.0, 0.0};
+        const auto first = std::lower_bound(history.times.begin(), history.times.end(), from);
+        const auto last = std::lower_bound(history.times.begin(), history.times.end(), to);
+        for (auto it = first; it != last; ++it) {
+            const double v = history.values[channel][static_cast<size_t>(it - history.times.begin())];
+            point.min = point.count ? std::min(point.min, v) : v;
+            point.max = point.count ? std::max(point.max, v) : v;
+            point.mean += v;
+            ++point.count;
+        }
+        if (point.count) {
+            point.mean /= static_cast<double>(point.count);
+        }
+        return point;
+    }
+
+    // Every point must hold exactly the samples of its own interval, points must follow each
+    // other without overlap, and together they must cover every sample from the first point
+    // on to to_ns. A point starting before from_ns only holds the buckets that start inside
+    // the range, so it is checked as a part of its interval. Returns the number of points.
+    size_t checkQuery(const TimeSeriesStore& store, const History& history, size_t channel,
+                      int64_t from_ns, int64_t to_ns, int64_t resolution_ns) {
+        std::vector<SeriesPoint> points;
+        store.query(channel, from_ns, to_ns, resolution_ns, points);
+        CHECK(!points.empty());
+        uint64_t covered = 0;
+        int64_t covered_from = to_ns;
+        for (size_t i = 0; i < points.size(); ++i) {
+            const SeriesPoint& point = points[i];
+            const int64_t end = point.start_ns + std::max<int64_t>(point.duration_ns, 1);
+            if (i + 1 < points.size()) {
+                CHECK(end <= points[i + 1].start_ns);
+            }
+            // Never finer than asked for, except raw samples when asking for raw
+            CHECK(point.duration_ns >= resolution_ns || point.duration_ns == 0);
+            const SeriesPoint expected = bruteForce(history, channel, point.start_ns, end);
+            if (point.start_ns < from_ns) {
+                CHECK(point.count > 0 && point.count <= expected.count);
+                CHECK(point.min >= expected.min && point.max <= expected.max);
+                continue;
+            }
+            CHECK_EQ(point.count, expected.count);
+            CHECK_EQ(point.min, expected.min);
+            CHECK_EQ(point.max, expected.max);
+            CHECK_NEAR(point.mean, expected.mean, 1e-9 * (1.0 + std::fabs(expected.mean)));
+            covered += point.count;
+            covered_from = std::min(covered_from, point.start_ns);
+        }
+        CHECK_EQ(covered, bruteForce(history, channel, covered_from, to_ns).count);
+        return points.size();
+    }
+
+    // Push the history one sample at a time
+    void pushAll(TimeSeriesStore& store, const History& history) {
+        for (size_t i = 0; i < history.times.size(); ++i) {
+            const double values[CHANNELS] = {history.values[0][i], history.values[1][i]};
+            store.push(timePoint(history.times[i]), values);
+        }
+    }
+
+    // Push the history in blocks of block samples
+    void pushBlocks(TimeSeriesStore& store, const History& history, size_t block) {
+        SampleBlock samples(CHANNELS, block);
+        for (size_t first = 0; first < history.times.size(); first += block) {
+            const size_t length = std::min(block, history.times.size() - first);
+            for (size_t k = 0; k < length; ++k) {
+                samples.timestamps()[k] = timePoint(history.times[first + k]);
+                for (size_t ch = 0; ch < CHANNELS; ++ch) {
+                    samples.column(ch)[k] = history.values[ch][first + k];
+                }
+            }
+            samples.setLength(length);
+            store.pushBlock(samples);
+        }
+    }
+}
+
+TEST_CASE(store_raw_queries_match_every_sample) {
+    const History history = makeHistory(100 * MS, 90 * SECOND);
+    TimeSeriesStore store(CHANNELS, history.times.size(), 64);
+    pushAll(store, history);
+
+    for (size_t ch = 0; ch < CHANNELS; ++ch) {
+        // Everything is still raw: one point per sample
+        const int64_t end = history.times.back() + 1;
+        CHECK_EQ(checkQuery(store, history, ch, T0, end, 0), history.times.size());
+        checkQuery(store, history, ch, T0 + 10 * SECOND, T0 + 20 * SECOND, 0);
+        checkQuery(store, history, ch, T0 + 10 * SECOND, T0 + 20 * SECOND, 250 * MS);
+    }
+}
+
+TEST_CASE(store_merges_closed_buckets_with_the_open_tail) {
+    // 1 s buckets close as time moves on; the newest second is only raw
+    const History history = makeHistory(100 * MS, 90 * SECOND + 500 * MS);
+    TimeSeriesStore store(CHANNELS, history.times.size(), 64);
+    pushAll(store, history);
+
+    const int64_t end = history.times.back() + 1;
+    for (int64_t resolution : {SECOND, 5 * SECOND, 30 * SECOND}) {
+        for (size_t ch = 0; ch < CHANNELS; ++ch) {
+            checkQuery(store, history, ch, T0, end, resolution);
+            checkQuery(store, history, ch, T0 + 30 * SECOND, end, resolution);
+        }
+    }
+}
+
+TEST_CASE(store_queries_span_every_tier_after_aging) {
+    // Two and a half hours: the oldest data is left only in the minute and hour tiers
+    const History history = makeHistory(250 * MS, 150 * 60 * SECOND);
+    TimeSeriesStore store(CHANNELS, 2000, 64);
+    pushAll(store, history);
+
+    const int64_t end = history.times.back() + 1;
+    const int64_t hour = 3600 * SECOND;
+    const int64_t first_hour = (T0 / hour + 1) * hour;  // Tier boundaries are epoch aligned
+    for (int64_t resolution : {int64_t{0}, 250 * MS, SECOND, 10 * SECOND, 60 * SECOND, 600 * SECOND, hour}) {
+        checkQuery(store, history, 0, first_hour, end, resolution);
+        checkQuery(store, history, 1, end - 20 * 60 * SECOND, end, resolution);
+    }
+
+    // Asking for raw samples older than the raw ring falls back to 1 s, then 1 min buckets
+    std::vector<SeriesPoint> points;
+    store.query(0, first_hour, end, 0, points);
+    CHECK_EQ(points.front().duration_ns, 60 * SECOND);
+    CHECK_EQ(points.back().duration_ns, int64_t{0});
+    CHECK(std::any_of(points.begin(), points.end(),
+                      [](const SeriesPoint& p) { return p.duration_ns == SECOND; }));
+}
+
+TEST_CASE(store_block_pushes_match_sample_pushes) {
+    const History history = makeHistory(100 * MS, 200 * SECOND);
+    TimeSeriesStore samples(CHANNELS, 500, 37);
+    TimeSeriesStore blocks(CHANNELS, 500, 37);
+    pushAll(samples, history);
+    pushBlocks(blocks, history, 37);
+
+    const int64_t end = history.times.back() + 1;
+    for (int64_t resolution : {int64_t{0}, SECOND, 10 * SECOND}) {
+        for (size_t ch = 0; ch < CHANNELS; ++ch) {
+            std::vector<SeriesPoint> expected;
+            std::vector<SeriesPoint> actual;
+            samples.query(ch, T0, end, resolution, expected);
+            blocks.query(ch, T0, end, resolution, actual);
+            CHECK_EQ(actual.size(), expected.size());
+            for (size_t i = 0; i < actual.size(); ++i) {
+                CHECK_EQ(actual[i].start_ns, expected[i].start_ns);
+                CHECK_EQ(actual[i].duration_ns, expected[i].duration_ns);
+                CHECK_EQ(actual[i].count, expected[i].count);
+                CHECK_EQ(actual[i].min, expected[i].min);
+                CHECK_EQ(actual[i].max, expected[i].max);
+                CHECK_EQ(actual[i].mean, expected[i].mean);
+            }
+            checkQuery(blocks, history, ch, T0, end, resolution);
+        }
+    }
+}
+
+TEST_CASE(store_queries_racing_the_writer_see_only_whole_buckets) {
+    // Channel 0 holds the sample's millisecond, so any point can be checked on its own:
+    // a bucket torn by an overwrite would mix values from another interval. Raw samples and
+    // single buckets are contiguous; merged points may lack buckets overwritten mid-copy.
+    // Two seconds of raw samples, so none leave the ring before their 1 s bucket closes.
+    // Neither side yields: preemption lands mid-copy and the writer laps the raw ring.
+    constexpr uint64_t SAMPLES = 600000;
+    TimeSeriesStore store(CHANNELS, 2048, 64);
+    std::atomic<bool> done{false};
+    std::thread writer([&store, &done]() {
+        for (uint64_t i = 0; i < SAMPLES; ++i) {
+            const double values[CHANNELS] = {static_cast<double>(i), -static_cast<double>(i)};
+            store.push(timePoint(T0 + static_cast<int64_t>(i) * MS), values);
+        }
+        done.store(true, std::memory_order_release);
+    });
+
+    // Failures are collected, so the writer is always joined before the test fails
+    std::vector<SeriesPoint> points;
+    uint64_t queries = 0;
+    uint64_t seen = 0;
+    std::string error;
+    const int64_t resolutions[] = {0, 0, SECOND, 5 * SECOND, 60 * SECOND};
+    while (error.empty() && (!done.load(std::memory_order_acquire) || queries < 50)) {
+        const int64_t resolution = resolutions[queries % 5];
+        store.query(0, T0, T0 + static_cast<int64_t>(SAMPLES) * MS, resolution, points);
+        ++queries;
+        for (size_t i = 0; i < points.size() && error.empty(); ++i) {
+            const SeriesPoint& point = points[i];
+            const double start_ms = static_cast<double>((point.start_ns - T0) / MS);
+            const double end_ms = start_ms + static_cast<double>(std::max(point.duration_ns, MS) / MS);
+            const uint64_t span = static_cast<uint64_t>(point.max - point.min) + 1;
+            const bool merged = resolution > SECOND && point.duration_ns == resolution;
+            const bool whole = point.min >= start_ms && point.max < end_ms
+                && (merged ? point.count <= span && point.mean >= point.min && point.mean <= point.max
+                           : point.count == span && std::fabs(point.mean - (point.min + point.max) / 2.0) < 1e-6);
+            const bool ordered = i == 0
+                || points[i - 1].start_ns + std::max<int64_t>(points[i - 1].duration_ns, 1) <= point.start_ns;
+            if (!whole || !ordered) {
+                error = "point at " + std::to_string(start_ms) + " ms, resolution " + std::to_string(resolution)
+                        + ": count " + std::to_string(point.count) + ", min " + std::to_string(point.min)
+                        + ", max " + std::to_string(point.max) + (ordered ? "" : ", overlaps the previous point");
+            }
+            seen += point.count;
+        }
+    }
+    writer.join();
+    if (!error.empty()) {
+        sensor::test::fail(__FILE__, __LINE__, error);
+    }
+    CHECK(queries >= 50);
+    CHECK(seen > 0);
+}
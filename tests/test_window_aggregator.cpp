@@ -0,0 +1,103 @@
+// WindowAggregator against a naive recomputation of every window after every sample.
+
+#include "test_framework.hpp"
+#include "window_aggregator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace sensor;
+
+namespace {
+    // Input shapes that stress the monotonic deques differently
+    enum class Shape { DECREASING, INCREASING, RANDOM, CONSTANT, SAWTOOTH };
+
+    double sample(Shape shape, size_t i, size_t channel, std::mt19937_64& rng) {
+        const double x = static_cast<double>(i);
+        switch (shape) {
+            case Shape::DECREASING: return 1e6 - x - static_cast<double>(channel);
+            case Shape::INCREASING: return x + static_cast<double>(channel);
+            case Shape::CONSTANT:   return 42.0;
+            case Shape::SAWTOOTH:   return static_cast<double>((i + channel) % 7);
+            default:                return std::uniform_real_distribution<double>(-100.0, 100.0)(rng);
+        }
+    }
+
+    // Push samples of one shape and compare every window with the values it should hold
+    void compareWithNaive(const std::vector<size_t>& lengths, Shape shape, size_t samples) {
+        constexpr size_t CHANNELS = 3;
+        WindowAggregator aggregator(CHANNELS, lengths);
+        std::vector<std::vector<double>> history(CHANNELS);
+        std::mt19937_64 rng(5);
+        std::vector<double> mean(CHANNELS), min(CHANNELS), max(CHANNELS), variance(CHANNELS);
+
+        for (size_t i = 0; i < samples; ++i) {
+            double values[CHANNELS];
+            for (size_t ch = 0; ch < CHANNELS; ++ch) {
+                values[ch] = sample(shape, i, ch, rng);
+                history[ch].push_back(values[ch]);
+            }
+            aggregator.push(values);
+
+            for (size_t w = 0; w < lengths.size(); ++w) {
+                const size_t count = std::min(lengths[w], i + 1);
+                CHECK_EQ(aggregator.count(w), count);
+                aggregator.stats(w, mean.data(), min.data(), max.data(), variance.data());
+                for (size_t ch = 0; ch < CHANNELS; ++ch) {
+                    const auto first = history[ch].end() - static_cast<std::ptrdiff_t>(count);
+                    const auto last = history[ch].end();
+                    CHECK_EQ(min[ch], *std::min_element(first, last));
+                    CHECK_EQ(max[ch], *std::max_element(first, last));
+
+                    double sum = 0.0;
+                    for (auto it = first; it != last; ++it) {
+                        sum += *it;
+                    }
+                    const double expected_mean = sum / static_cast<double>(count);
+                    double m2 = 0.0;
+                    for (auto it = first; it != last; ++it) {
+                        m2 += (*it - expected_mean) * (*it - expected_mean);
+                    }
+                    const double expected_variance = count > 1 ? m2 / static_cast<double>(count - 1) : 0.0;
+                    CHECK_NEAR(mean[ch], expected_mean, 1e-9 * (1.0 + std::fabs(expected_mean)));
+                    CHECK_NEAR(variance[ch], expected_variance, 1e-6 * (1.0 + expected_variance));
+                }
+            }
+        }
+    }
+
+    // Power-of-two lengths, where a deque that outgrows its window wraps onto live entries
+    const std::vector<size_t> LENGTHS = {1, 2, 3, 4, 5, 7, 8, 16, 17, 64};
+}
+
+TEST_CASE(window_min_max_match_naive_on_decreasing_input) {
+    for (size_t length : LENGTHS) {
+        compareWithNaive({length}, Shape::DECREASING, 4 * length + 50);
+    }
+}
+
+TEST_CASE(window_min_max_match_naive_on_increasing_input) {
+    for (size_t length : LENGTHS) {
+        compareWithNaive({length}, Shape::INCREASING, 4 * length + 50);
+    }
+}
+
+TEST_CASE(window_stats_match_naive_on_random_input) {
+    for (size_t length : LENGTHS) {
+        compareWithNaive({length}, Shape::RANDOM, 4 * length + 50);
+    }
+}
+
+TEST_CASE(window_stats_match_naive_with_ties) {
+    for (size_t length : LENGTHS) {
+        compareWithNaive({length}, Shape::CONSTANT, 3 * length + 20);
+        compareWithNaive({length}, Shape::SAWTOOTH, 3 * length + 20);
+    }
+}
+
+TEST_CASE(window_stats_match_naive_with_several_windows) {
+    // Shared history sized for the longest window, shorter ones reading inside it
+    compareWithNaive({2, 4, 16, 5}, Shape::DECREASING, 200);
+    compareWithNaive({64, 1, 8}, Shape::RANDOM, 400);
+}